@@ -126,6 +126,63 @@ typedef struct libvlc_media_stats_t
     uint64_t     i_lost_abuffers;
 } libvlc_media_stats_t;
 
+/** Number of buckets of the metrics histograms */
+#define LIBVLC_MEDIA_METRICS_BUCKETS 12
+/** Maximum number of tracks in the metrics */
+#define LIBVLC_MEDIA_METRICS_MAX_TRACKS 16
+
+/**
+ * Distribution of durations
+ *
+ * The bucket i counts the durations below (250 << i) microseconds, and not
+ * counted in a previous bucket. The last bucket counts all the longer ones.
+ */
+typedef struct libvlc_media_metrics_histogram_t
+{
+    uint64_t    i_buckets[LIBVLC_MEDIA_METRICS_BUCKETS];
+    uint64_t    i_count;
+    int64_t     i_sum_us;
+} libvlc_media_metrics_histogram_t;
+
+/**
+ * Metrics of the decoder of one track
+ */
+typedef struct libvlc_media_metrics_track_t
+{
+    int                 i_id; /**< Track id, as in libvlc_media_track_t */
+    libvlc_track_type_t i_type;
+    uint32_t            i_codec;
+
+    unsigned    i_queue_blocks; /**< Blocks waiting to be decoded */
+    uint64_t    i_queue_bytes; /**< Bytes waiting to be decoded */
+    uint64_t    i_queue_peak_bytes;
+    libvlc_media_metrics_histogram_t decode_time;
+} libvlc_media_metrics_track_t;
+
+/**
+ * Playback health metrics
+ */
+typedef struct libvlc_media_metrics_t
+{
+    /* Decoders */
+    unsigned     i_track_count;
+    libvlc_media_metrics_track_t tracks[LIBVLC_MEDIA_METRICS_MAX_TRACKS];
+
+    /* Demux: reads blocking for 50 ms or more */
+    libvlc_media_metrics_histogram_t demux_stalls;
+
+    /* Video output */
+    uint64_t     i_displayed_pictures;
+    uint64_t     i_late_pictures;
+    uint64_t     i_dropped_pictures;
+    libvlc_media_metrics_histogram_t lateness;
+
+    /* Audio output */
+    bool         b_aout_drift; /**< Whether i_aout_drift_us is known */
+    int64_t      i_aout_drift_us; /**< Negative if the audio plays late */
+    float        f_aout_resampling; /**< 1.0 if not resampling */
+} libvlc_media_metrics_t;
+
 /**
  * Media type
  *
@@ -546,6 +603,25 @@ LIBVLC_API int libvlc_media_save_meta( libvlc_instance_t *inst,
 LIBVLC_API bool libvlc_media_get_stats(libvlc_media_t *p_md,
                                        libvlc_media_stats_t *p_stats);
 
+/**
+ * Get the playback health metrics of the media
+ *
+ * Unlike libvlc_media_get_stats(), the metrics are updated continuously by
+ * the playback threads, and reading them never waits for those threads. This
+ * can be called often, from any thread.
+ *
+ * The metrics are reset when the media starts playing.
+ *
+ * \param p_md media descriptor object
+ * \param p_metrics structure filled with the metrics
+ *                  (this structure must be allocated by the caller)
+ * \retval true metrics are available
+ * \retval false the media was never played
+ * \version LibVLC 4.0.0 or later
+ */
+LIBVLC_API bool libvlc_media_get_metrics(libvlc_media_t *p_md,
+                                         libvlc_media_metrics_t *p_metrics);
+
 /* The following method uses libvlc_media_list_t, however, media_list usage is optional
  * and this is here for convenience */
 #define VLC_FORWARD_DECLARE_OBJECT(a) struct a
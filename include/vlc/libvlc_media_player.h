@@ -534,6 +534,79 @@ void libvlc_video_set_format_callbacks( libvlc_media_player_t *mp,
                                         libvlc_video_format_cb setup,
                                         libvlc_video_cleanup_cb cleanup );
 
+/**
+ * Opaque reference to a decoded video frame.
+ *
+ * \see libvlc_video_set_frame_callbacks()
+ * \version LibVLC 4.0.0 and later.
+ */
+typedef struct libvlc_video_frame_t libvlc_video_frame_t;
+
+/**
+ * Callback prototype to receive a decoded video frame without copy.
+ *
+ * When the video frame needs to be shown, as determined by the media playback
+ * clock, the frame callback is invoked with a reference to the picture buffer
+ * that LibVLC decoded (and possibly converted) the frame into.
+ *
+ * The pixel planes remain valid and unmodified until the frame is released
+ * with libvlc_video_frame_release(). The callback owns the reference and
+ * must release it exactly once, possibly later and from another thread.
+ *
+ * Subtitles and on-screen display are blended into the frame; the frame is
+ * then a copy of the decoded picture.
+ *
+ * \warning Frames are taken from the decoder (or converter) picture pools.
+ * Holding too many of them at once stalls decoding, so an application should
+ * only keep the few frames it is actually rendering.
+ *
+ * \param[in] opaque private pointer as passed to
+ *                   libvlc_video_set_frame_callbacks()
+ * \param[in] frame reference to the frame
+ * \param[in] planes start address of the pixel planes
+ * \param[in] pitches table of scanline pitches in bytes for each pixel plane
+ * \param[in] lines table of scanlines count for each plane
+ *
+ * \version LibVLC 4.0.0 and later.
+ */
+typedef void (*libvlc_video_frame_cb)(void *opaque,
+                                      libvlc_video_frame_t *frame,
+                                      void *const *planes,
+                                      const unsigned *pitches,
+                                      const unsigned *lines);
+
+/**
+ * Set a callback to receive decoded video frames in memory without copy.
+ *
+ * This is an alternative to libvlc_video_set_callbacks(): rather than copying
+ * every frame into application buffers between the lock and unlock
+ * callbacks, LibVLC hands over its own picture buffers on display.
+ * Use libvlc_video_set_format() or libvlc_video_set_format_callbacks()
+ * to configure the chroma and dimensions; the pitches and lines they specify
+ * are ignored, each frame carries its own.
+ *
+ * The limitations listed for libvlc_video_set_callbacks() apply, except for
+ * the memory copy.
+ *
+ * \param mp the media player
+ * \param frame callback to receive frames (must not be NULL)
+ * \param opaque private pointer for the callback (as first parameter)
+ * \version LibVLC 4.0.0 and later.
+ */
+LIBVLC_API
+void libvlc_video_set_frame_callbacks( libvlc_media_player_t *mp,
+                                       libvlc_video_frame_cb frame,
+                                       void *opaque );
+
+/**
+ * Release a frame received from the @ref libvlc_video_frame_cb callback.
+ *
+ * \param frame the frame to release
+ * \version LibVLC 4.0.0 and later.
+ */
+LIBVLC_API
+void libvlc_video_frame_release( libvlc_video_frame_t *frame );
+
 
 typedef struct libvlc_video_setup_device_cfg_t
 {
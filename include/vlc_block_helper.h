@@ -276,9 +276,35 @@ static inline int block_PeekOffsetBytes( block_bytestream_t *p_bytestream,
 typedef const uint8_t * (*block_startcode_helper_t)( const uint8_t *, const uint8_t * );
 typedef bool (*block_startcode_matcher_t)( uint8_t, size_t, const uint8_t * );
 
-static inline int block_FindStartcodeFromOffset(
-    block_bytestream_t *p_bytestream, size_t *pi_offset,
-    const uint8_t *p_startcode, int i_startcode_length,
+/**
+ * Resume position for repeated startcode lookups.
+ *
+ * Remembers the block where the previous lookup ended, so that the next one
+ * does not walk the whole chain from the bytestream position again.
+ * It is only valid as long as the bytestream position does not change:
+ * it must be reset after skipping, getting or flushing data.
+ */
+typedef struct
+{
+    block_t *p_block; /**< block where the last lookup ended, or NULL */
+    size_t   i_offset; /**< that block start, relative to the bytestream position */
+} block_startcode_cursor_t;
+
+static inline void block_StartcodeCursorReset( block_startcode_cursor_t *p_cursor )
+{
+    p_cursor->p_block = NULL;
+    p_cursor->i_offset = 0;
+}
+
+/**
+ * Looks up a startcode from the given offset, like
+ * block_FindStartcodeFromOffset(), optionally resuming from a cursor.
+ *
+ * \param p_cursor resume position updated on failure, or NULL
+ */
+static inline int block_FindStartcodeFromCursor(
+    block_bytestream_t *p_bytestream, block_startcode_cursor_t *p_cursor,
+    size_t *pi_offset, const uint8_t *p_startcode, int i_startcode_length,
     block_startcode_helper_t p_startcode_helper,
     block_startcode_matcher_t p_startcode_matcher )
 {
@@ -288,9 +314,19 @@ static inline int block_FindStartcodeFromOffset(
     int i_caller_offset_backup = 0, i_match;
 
     /* Find the right place */
-    i_size = *pi_offset + p_bytestream->i_block_offset;
-    for( p_block = p_bytestream->p_block;
-         p_block != NULL; p_block = p_block->p_next )
+    if( p_cursor && p_cursor->p_block &&
+        (ssize_t)(*pi_offset - p_cursor->i_offset) >= 0 )
+    {
+        p_block = p_cursor->p_block;
+        i_size = *pi_offset - p_cursor->i_offset;
+    }
+    else
+    {
+        p_block = p_bytestream->p_block;
+        i_size = *pi_offset + p_bytestream->i_block_offset;
+    }
+
+    for( ; p_block != NULL; p_block = p_block->p_next )
     {
         i_size -= p_block->i_buffer;
         if( i_size < 0 ) break;
@@ -310,6 +346,12 @@ static inline int block_FindStartcodeFromOffset(
     i_match = 0;
     for( ; p_block != NULL; p_block = p_block->p_next )
     {
+        if( p_cursor )
+        {
+            p_cursor->p_block = p_block;
+            p_cursor->i_offset = *pi_offset;
+        }
+
         for( i_offset = i_size; i_offset < p_block->i_buffer; i_offset++ )
         {
             /* Use optimized helper when possible */
@@ -355,6 +397,11 @@ static inline int block_FindStartcodeFromOffset(
                 i_offset = i_offset_backup;
                 *pi_offset = i_caller_offset_backup;
                 i_match = 0;
+                if( p_cursor )
+                {
+                    p_cursor->p_block = p_block;
+                    p_cursor->i_offset = *pi_offset;
+                }
             }
 
         }
@@ -362,8 +409,26 @@ static inline int block_FindStartcodeFromOffset(
         *pi_offset += i_offset;
     }
 
+    /* A partial match resumes from the block where it started */
+    if( p_cursor && i_match > 0 )
+    {
+        p_cursor->p_block = p_block_backup;
+        p_cursor->i_offset = i_caller_offset_backup;
+    }
+
     *pi_offset -= i_match;
     return VLC_EGENERIC;
 }
 
+static inline int block_FindStartcodeFromOffset(
+    block_bytestream_t *p_bytestream, size_t *pi_offset,
+    const uint8_t *p_startcode, int i_startcode_length,
+    block_startcode_helper_t p_startcode_helper,
+    block_startcode_matcher_t p_startcode_matcher )
+{
+    return block_FindStartcodeFromCursor( p_bytestream, NULL, pi_offset,
+                                          p_startcode, i_startcode_length,
+                                          p_startcode_helper, p_startcode_matcher );
+}
+
 #endif /* VLC_BLOCK_HELPER_H */
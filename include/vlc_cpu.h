@@ -218,6 +218,51 @@ static inline void vlc_CPU_functions_init_once(const char *name,
 }
 # endif
 
+/**
+ * \defgroup cpu_share CPU budget
+ * \ingroup os
+ *
+ * Process-wide arbitration of the worker threads of the codecs.
+ *
+ * Each multi-threaded decoder or encoder joins the budget when it is opened,
+ * and sizes its thread pool from its share of the CPU cores instead of
+ * vlc_GetCPUCount(). The cores are divided evenly between the active shares,
+ * and are rebalanced whenever a share joins or leaves the budget.
+ * @{
+ */
+
+struct vlc_cpu_share;
+
+/**
+ * Joins the CPU budget.
+ *
+ * \param max maximum number of threads the codec can make use of,
+ *            or 0 if unbounded
+ * \return a CPU share, or NULL on memory error
+ */
+VLC_API struct vlc_cpu_share *vlc_cpu_share_Join(unsigned max);
+
+/**
+ * Gets the number of threads of a CPU share.
+ *
+ * The value can change as other codecs join or leave the budget. Codecs that
+ * cannot resize their thread pool should read it once, when they are opened.
+ *
+ * \return the number of threads, at least 1
+ */
+VLC_API unsigned vlc_cpu_share_Threads(const struct vlc_cpu_share *share);
+
+/**
+ * Leaves the CPU budget.
+ *
+ * The cores of the share are given back to the remaining shares.
+ *
+ * \param share CPU share to release (can be NULL)
+ */
+VLC_API void vlc_cpu_share_Leave(struct vlc_cpu_share *share);
+
+/** @} */
+
 #define set_cpu_funcs(name, activate, priority) \
     set_callback(VLC_CHECKED_TYPE(void (*)(void *), activate)) \
     set_capability(name, priority)
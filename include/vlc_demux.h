@@ -206,7 +206,7 @@ enum demux_query_e
      * es_out_Control()).
      * If you don't know what to do with it, just IGNORE it: it is safe(r). */
     DEMUX_SET_GROUP_DEFAULT,
-    DEMUX_SET_GROUP_ALL,
+    DEMUX_SET_GROUP_ALL,        /* arg1= int, the selected group or 0 */
     DEMUX_SET_GROUP_LIST,       /* arg1= size_t, arg2= const int *, can fail */
     DEMUX_SET_ES,               /* arg1= int                        can fail */
     DEMUX_SET_ES_LIST,          /* arg1= size_t, arg2= const int * (can be NULL) can fail */
@@ -54,6 +54,9 @@ struct filter_audio_callbacks
         void (*on_changed)(filter_t *,
                            const struct vlc_audio_loudness *loudness);
     } meter_loudness;
+
+    /** Allocates an output block, see filter_NewAudioBuffer() */
+    block_t *(*buffer_new)(filter_t *, size_t size);
 };
 
 struct filter_subpicture_callbacks
@@ -314,6 +317,61 @@ static inline vlc_decoder_device * filter_HoldDecoderDeviceType( filter_t *p_fil
     return NULL;
 }
 
+/**
+ * This function will return a new block usable by an audio filter as an
+ * output buffer. The owner may recycle the blocks of the filter chain, rather
+ * than allocating new ones. You have to release it using block_Release or by
+ * returning it to the caller as a ops->filter_audio return value.
+ * Provided for convenience.
+ *
+ * \param p_filter filter_t object
+ * \param size payload size in bytes
+ * \return new block, or NULL on error
+ */
+static inline block_t *filter_NewAudioBuffer( filter_t *p_filter, size_t size )
+{
+    block_t *block = NULL;
+    if ( p_filter->owner.audio != NULL && p_filter->owner.audio->buffer_new != NULL )
+        block = p_filter->owner.audio->buffer_new( p_filter, size );
+    if ( block == NULL )
+        block = block_Alloc( size );
+    if ( block == NULL )
+        msg_Warn( p_filter, "can't get output buffer" );
+    return block;
+}
+
+/**
+ * This function will return an output buffer for an audio filter able to
+ * process its input in place.
+ *
+ * If the allocation of the input block is large enough, it is resized and
+ * returned, and the filter works in place. Otherwise, a new block is returned
+ * as with filter_NewAudioBuffer(), with the properties of the input block, and
+ * the input block is left untouched.
+ *
+ * \note If the output is larger than the input, the filter must process the
+ * samples backward, so as not to overwrite input samples not processed yet.
+ *
+ * \param p_filter filter_t object
+ * \param in input block
+ * \param size output payload size in bytes
+ * \return in, a new block, or NULL on error (in is not released)
+ */
+static inline block_t *filter_GetAudioBufferInPlace( filter_t *p_filter,
+                                                     block_t *in, size_t size )
+{
+    if ( (size_t)(in->p_start + in->i_size - in->p_buffer) >= size )
+    {
+        in->i_buffer = size;
+        return in;
+    }
+
+    block_t *out = filter_NewAudioBuffer( p_filter, size );
+    if ( out != NULL )
+        block_CopyProperties( out, in );
+    return out;
+}
+
 /**
  * This function will drain, then flush an audio filter.
  */
@@ -97,4 +97,31 @@ VLC_API bool vlc_http_cookies_store( vlc_http_cookie_jar_t *jar,
 VLC_API char *vlc_http_cookies_fetch( vlc_http_cookie_jar_t *jar, bool secure,
                                       const char *host, const char *path );
 
+/* Idle connections */
+
+/**
+ * Leaves an idle connection to the LibVLC instance, for a later client of
+ * the same instance to take it over.
+ *
+ * The instance releases the connection after a few seconds, or when it is
+ * destroyed, before unloading the modules.
+ *
+ * @param obj an object of the instance
+ * @param key origin and settings the connection was established with
+ * @param data the connection
+ * @param release callback releasing the connection
+ * @return 0 on success, -1 on error (the connection is left to the caller)
+ */
+VLC_API int vlc_http_pool_put( vlc_object_t *obj, const char *key,
+                               void *data, void (*release)(void *) );
+
+/**
+ * Takes over an idle connection left with vlc_http_pool_put().
+ *
+ * @param obj an object of the instance
+ * @param key origin and settings the connection must match
+ * @return the connection, or NULL if none matches
+ */
+VLC_API void *vlc_http_pool_take( vlc_object_t *obj, const char *key ) VLC_USED;
+
 #endif /* VLC_HTTP_H */
@@ -112,6 +112,7 @@ struct input_item_t
     input_item_es_vector es_vec;     /**< ES formats */
 
     input_stats_t *p_stats;          /**< Statistics */
+    struct input_metrics *p_metrics; /**< Playback metrics (private) */
 
     vlc_meta_t *p_meta;
 
@@ -541,6 +542,7 @@ struct input_stats_t
     /* Decoders */
     uint64_t i_decoded_audio;
     uint64_t i_decoded_video;
+    uint64_t i_decoder_fifo_bytes;
 
     /* Vout */
     uint64_t i_displayed_pictures;
@@ -552,6 +554,104 @@ struct input_stats_t
     uint64_t i_lost_abuffers;
 };
 
+/******************
+ * Input metrics
+ ******************/
+
+/** Number of buckets of the metrics histograms */
+#define VLC_INPUT_METRICS_BUCKETS 12
+/** Maximum number of elementary streams tracked by the metrics */
+#define VLC_INPUT_METRICS_MAX_ES  16
+
+/**
+ * Upper bound of a histogram bucket (exclusive)
+ *
+ * The bounds double from 250 microseconds up to 256 milliseconds. The last
+ * bucket has no upper bound.
+ */
+#define VLC_INPUT_METRICS_BUCKET_BOUND(i) (VLC_TICK_FROM_US(250) << (i))
+
+/**
+ * Returns the histogram bucket of a duration.
+ */
+static inline unsigned vlc_input_metrics_Bucket(vlc_tick_t duration)
+{
+    unsigned i = 0;
+
+    while (i < VLC_INPUT_METRICS_BUCKETS - 1
+        && duration >= VLC_INPUT_METRICS_BUCKET_BOUND(i))
+        i++;
+    return i;
+}
+
+/**
+ * Distribution of durations
+ */
+struct vlc_input_metrics_histogram
+{
+    uint64_t buckets[VLC_INPUT_METRICS_BUCKETS]; /**< Samples per bucket */
+    uint64_t count; /**< Total number of samples */
+    vlc_tick_t sum; /**< Sum of the samples */
+};
+
+/**
+ * Metrics of one elementary stream decoder
+ */
+struct vlc_input_metrics_es
+{
+    int id; /**< ES identifier, as in es_format_t::i_id */
+    enum es_format_category_e cat; /**< ES category */
+    vlc_fourcc_t codec; /**< Codec */
+    unsigned queue_blocks; /**< Blocks waiting in the decoder queue */
+    uint64_t queue_bytes; /**< Bytes waiting in the decoder queue */
+    uint64_t queue_peak_bytes; /**< Highest queue size since the start */
+    struct vlc_input_metrics_histogram decode_time; /**< Time per block */
+};
+
+/**
+ * Playback health metrics
+ *
+ * Unlike the input_stats_t, the metrics are updated as the events happen by
+ * the input, decoder and output threads, and can be read at any time without
+ * locking any of them.
+ */
+struct vlc_input_metrics
+{
+    /* Decoders */
+    unsigned es_count;
+    struct vlc_input_metrics_es es[VLC_INPUT_METRICS_MAX_ES];
+
+    /* Demux */
+    struct vlc_input_metrics_histogram demux_stalls; /**< Blocking reads */
+    vlc_tick_t demux_probe_time; /**< Time spent finding the demuxer of the
+                                      main source, 0 if unknown */
+
+    /* Vout */
+    uint64_t displayed_pictures;
+    uint64_t late_pictures; /**< Pictures displayed late */
+    uint64_t dropped_pictures; /**< Pictures dropped (late or lost) */
+    struct vlc_input_metrics_histogram lateness; /**< Late or dropped */
+
+    /* Aout */
+    vlc_tick_t aout_drift; /**< Last drift, negative if the audio plays late,
+                                VLC_TICK_INVALID if unknown */
+    float aout_resampling; /**< Resampling ratio, 1.f if not resampling */
+};
+
+/**
+ * Reads the playback metrics of an item.
+ *
+ * The metrics are reset whenever the item starts playing, and kept after the
+ * playback ends.
+ *
+ * \param item the item
+ * \param metrics the metrics to fill [OUT]
+ * \retval true on success
+ * \retval false if the item was never played
+ */
+VLC_API bool input_item_GetMetrics(input_item_t *item,
+                                   struct vlc_input_metrics *metrics);
+
 /**
  * Access pf_readdir helper struct
  * \see vlc_readdir_helper_init()
@@ -90,6 +90,41 @@ struct vlc_thumbnailer_cbs
                      void *data);
 };
 
+/** Preparser multiple thumbnails callbacks */
+struct vlc_thumbnailer_storyboard_cbs
+{
+    /**
+     * Event received on thumbnailing completion or error
+     *
+     * This callback will always be called, provided
+     * vlc_preparser_GenerateThumbnails() returned a valid request, and
+     * provided the request is not cancelled before its completion.
+     *
+     * @note This callback is mandatory if calling
+     * vlc_preparser_GenerateThumbnails()
+     *
+     * The pictures are owned by the thumbnailer, and must be acquired by
+     * using \link picture_Hold \endlink to use them past the callback's
+     * scope.
+     *
+     * @param item item used for the thumbnailer
+     *
+     * @param status VLC_SUCCESS if at least one thumbnail was generated,
+     * VLC_ETIMEOUT in case of timeout, -EINTR if cancelled, an error otherwise
+     *
+     * @param thumbnails array of generated thumbnails, in the order of the
+     * seek arguments, an entry is NULL if that thumbnail could not be
+     * generated
+     *
+     * @param count number of entries in the thumbnails array
+     *
+     * @param data opaque pointer passed by
+     * vlc_preparser_GenerateThumbnails()
+     */
+    void (*on_ended)(input_item_t *item, int status,
+                     picture_t *const *thumbnails, size_t count, void *data);
+};
+
 /**
  * Preparser seek argument
  */
@@ -206,6 +241,33 @@ vlc_preparser_GenerateThumbnail( vlc_preparser_t *preparser, input_item_t *item,
                                  const struct vlc_thumbnailer_cbs *cbs,
                                  void *cbs_userdata );
 
+/**
+ * This function enqueues the provided item for generating several thumbnails
+ *
+ * Unlike vlc_preparser_GenerateThumbnail(), no input thread is created: the
+ * item is opened once, then the demuxer is seeked to each requested point and
+ * a single picture is decoded there, synchronously.
+ *
+ * @param preparser the preparser object
+ * @param item a valid item to generate the thumbnails for
+ * @param seek_args array of seek structs, one per thumbnail
+ * @param count number of entries in seek_args, must be at least 1
+ * @param cbs callback to listen to events (can't be NULL)
+ * @param cbs_userdata opaque pointer used by the callbacks
+ * @return VLC_PREPARSER_REQ_ID_INVALID in case of error, or a valid id if the
+ * item was scheduled for thumbnailing. If this returns an
+ * error, the on_ended callback will *not* be invoked
+ *
+ * The provided input_item will be held by the thumbnailer and can safely be
+ * released safely after calling this function.
+ */
+VLC_API vlc_preparser_req_id
+vlc_preparser_GenerateThumbnails( vlc_preparser_t *preparser, input_item_t *item,
+                                  const struct vlc_preparser_seek_arg *seek_args,
+                                  size_t count,
+                                  const struct vlc_thumbnailer_storyboard_cbs *cbs,
+                                  void *cbs_userdata );
+
 /**
  * This function cancel all preparsing requests for a given id
  *
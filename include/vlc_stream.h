@@ -105,7 +105,7 @@ struct vlc_stream_operations {
             int (*set_record_state)(demux_t *, bool, const char *);
             int (*set_rate)(demux_t *, float *);
             int (*set_group_default)(demux_t *);
-            int (*set_group_all)(demux_t *);
+            int (*set_group_all)(demux_t *, int);
             int (*set_group_list)(demux_t *, size_t, const int *);
             int (*set_es)(demux_t *, int);
             int (*set_es_list)(demux_t *, size_t, const int *);
@@ -653,6 +653,66 @@ bool libvlc_media_get_stats(libvlc_media_t *p_md,
     return true;
 }
 
+static void
+metrics_histogram_Convert( libvlc_media_metrics_histogram_t *dst,
+                           const struct vlc_input_metrics_histogram *src )
+{
+    static_assert( LIBVLC_MEDIA_METRICS_BUCKETS == VLC_INPUT_METRICS_BUCKETS,
+                   "Histogram mismatch" );
+    memcpy( dst->i_buckets, src->buckets, sizeof (dst->i_buckets) );
+    dst->i_count = src->count;
+    dst->i_sum_us = US_FROM_VLC_TICK( src->sum );
+}
+
+// Getter for playback metrics
+bool libvlc_media_get_metrics( libvlc_media_t *p_md,
+                               libvlc_media_metrics_t *p_metrics )
+{
+    struct vlc_input_metrics metrics;
+
+    static_assert( LIBVLC_MEDIA_METRICS_MAX_TRACKS == VLC_INPUT_METRICS_MAX_ES,
+                   "Tracks mismatch" );
+
+    if( p_md->p_input_item == NULL
+     || !input_item_GetMetrics( p_md->p_input_item, &metrics ) )
+        return false;
+
+    p_metrics->i_track_count = metrics.es_count;
+    for( unsigned i = 0; i < metrics.es_count; i++ )
+    {
+        const struct vlc_input_metrics_es *es = &metrics.es[i];
+        libvlc_media_metrics_track_t *track = &p_metrics->tracks[i];
+
+        track->i_id = es->id;
+        switch( es->cat )
+        {
+            case VIDEO_ES: track->i_type = libvlc_track_video; break;
+            case AUDIO_ES: track->i_type = libvlc_track_audio; break;
+            case SPU_ES:   track->i_type = libvlc_track_text;  break;
+            default:       track->i_type = libvlc_track_unknown;
+        }
+        track->i_codec = es->codec;
+        track->i_queue_blocks = es->queue_blocks;
+        track->i_queue_bytes = es->queue_bytes;
+        track->i_queue_peak_bytes = es->queue_peak_bytes;
+        metrics_histogram_Convert( &track->decode_time, &es->decode_time );
+    }
+
+    metrics_histogram_Convert( &p_metrics->demux_stalls,
+                               &metrics.demux_stalls );
+
+    p_metrics->i_displayed_pictures = metrics.displayed_pictures;
+    p_metrics->i_late_pictures = metrics.late_pictures;
+    p_metrics->i_dropped_pictures = metrics.dropped_pictures;
+    metrics_histogram_Convert( &p_metrics->lateness, &metrics.lateness );
+
+    p_metrics->b_aout_drift = metrics.aout_drift != VLC_TICK_INVALID;
+    p_metrics->i_aout_drift_us = p_metrics->b_aout_drift
+                               ? US_FROM_VLC_TICK( metrics.aout_drift ) : 0;
+    p_metrics->f_aout_resampling = metrics.aout_resampling;
+    return true;
+}
+
 // Get event manager from a media descriptor object
 libvlc_event_manager_t *
 libvlc_media_event_manager( libvlc_media_t * p_md )
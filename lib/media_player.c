@@ -650,6 +650,7 @@ libvlc_media_player_new( libvlc_instance_t *instance )
     var_Create (mp, "vmem-lock", VLC_VAR_ADDRESS);
     var_Create (mp, "vmem-unlock", VLC_VAR_ADDRESS);
     var_Create (mp, "vmem-display", VLC_VAR_ADDRESS);
+    var_Create (mp, "vmem-frame", VLC_VAR_ADDRESS);
     var_Create (mp, "vmem-data", VLC_VAR_ADDRESS);
     var_Create (mp, "vmem-setup", VLC_VAR_ADDRESS);
     var_Create (mp, "vmem-cleanup", VLC_VAR_ADDRESS);
@@ -1075,12 +1076,33 @@ void libvlc_video_set_callbacks( libvlc_media_player_t *mp,
     var_SetAddress( mp, "vmem-lock", lock_cb );
     var_SetAddress( mp, "vmem-unlock", unlock_cb );
     var_SetAddress( mp, "vmem-display", display_cb );
+    var_SetAddress( mp, "vmem-frame", NULL );
     var_SetAddress( mp, "vmem-data", opaque );
     var_SetString( mp, "dec-dev", "none" );
     var_SetString( mp, "vout", "vmem" );
     var_SetString( mp, "window", "dummy" );
 }
 
+void libvlc_video_set_frame_callbacks( libvlc_media_player_t *mp,
+                                       libvlc_video_frame_cb frame_cb,
+                                       void *opaque )
+{
+    var_SetAddress( mp, "vmem-lock", NULL );
+    var_SetAddress( mp, "vmem-unlock", NULL );
+    var_SetAddress( mp, "vmem-display", NULL );
+    var_SetAddress( mp, "vmem-frame", frame_cb );
+    var_SetAddress( mp, "vmem-data", opaque );
+    var_SetString( mp, "dec-dev", "none" );
+    var_SetString( mp, "vout", "vmem" );
+    var_SetString( mp, "window", "dummy" );
+}
+
+void libvlc_video_frame_release( libvlc_video_frame_t *frame )
+{
+    /* frames are handed out by the vmem display as picture_t references */
+    picture_Release( (picture_t *)frame );
+}
+
 void libvlc_video_set_format_callbacks( libvlc_media_player_t *mp,
                                         libvlc_video_format_cb setup,
                                         libvlc_video_cleanup_cb cleanup )
@@ -24,9 +24,11 @@
 
 #include <assert.h>
 #include <vlc_common.h>
+#include <vlc_threads.h>
 #include <vlc_network.h>
 #include <vlc_tls.h>
 #include <vlc_url.h>
+#include <vlc_http.h>
 #include "transport.h"
 #include "conn.h"
 #include "connmgr.h"
@@ -96,15 +98,130 @@ static char *vlc_http_proxy_find(const char *hostname, unsigned port,
 }
 
 
+/*
+ * TLS settings of the manager object. The credentials are created on an
+ * object of the instance carrying them, as they outlive the manager object
+ * in the pool of idle connections.
+ */
+static const struct
+{
+    const char *name;
+    int type;
+} vlc_http_tls_vars[] = {
+    { "gnutls-system-trust", VLC_VAR_BOOL },
+    { "gnutls-dir-trust", VLC_VAR_STRING },
+    { "gnutls-priorities", VLC_VAR_STRING },
+};
+
+static vlc_tls_client_t *vlc_http_creds_create(vlc_object_t *obj,
+                                               vlc_object_t **parentp)
+{
+    vlc_object_t *parent = vlc_object_create(vlc_object_instance(obj),
+                                             sizeof (*parent));
+    if (unlikely(parent == NULL))
+        return NULL;
+
+    for (size_t i = 0; i < ARRAY_SIZE(vlc_http_tls_vars); i++)
+    {
+        const char *name = vlc_http_tls_vars[i].name;
+        int type = vlc_http_tls_vars[i].type;
+        vlc_value_t val;
+
+        if (var_Inherit(obj, name, type, &val))
+            continue; /* not set, inherited from the instance if ever */
+
+        var_Create(parent, name, type);
+        var_SetChecked(parent, name, type, val);
+        if (type == VLC_VAR_STRING)
+            free(val.psz_string);
+    }
+
+    vlc_tls_client_t *creds = vlc_tls_ClientCreate(parent);
+    if (creds == NULL)
+    {
+        vlc_object_delete(parent);
+        return NULL;
+    }
+    *parentp = parent;
+    return creds;
+}
+
+static void vlc_http_creds_delete(vlc_tls_client_t *creds,
+                                  vlc_object_t *parent)
+{
+    vlc_tls_ClientDelete(creds);
+    vlc_object_delete(parent);
+}
+
+/*
+ * Idle connections are kept by the LibVLC instance. A destroyed manager
+ * leaves its connection there, and the next manager to the same origin takes
+ * it over, e.g. when opening consecutive items of a playlist or preparsing
+ * them.
+ */
+struct vlc_http_idle
+{
+    vlc_tls_client_t *creds;
+    vlc_object_t *creds_parent;
+    struct vlc_http_conn *conn;
+    bool multiplexed;
+};
+
+static void vlc_http_idle_free(void *data)
+{
+    struct vlc_http_idle *idle = data;
+
+    vlc_http_conn_release(idle->conn);
+    if (idle->creds != NULL)
+        vlc_http_creds_delete(idle->creds, idle->creds_parent);
+    free(idle);
+}
+
 struct vlc_http_mgr
 {
     struct vlc_logger *logger;
     vlc_object_t *obj;
     vlc_tls_client_t *creds;
+    vlc_object_t *creds_parent; /**< Carries the TLS settings of obj */
     struct vlc_http_cookie_jar_t *jar;
+    vlc_mutex_t lock; /**< Protects the connection state below */
     struct vlc_http_conn *conn;
+    unsigned generation; /**< Incremented on every new connection */
+    bool multiplexed; /**< Whether conn is an HTTP/2 connection */
+    char *origin; /**< Pool key of conn */
 };
 
+/* Connections are only handed over to managers that would have established
+ * the same ones: HTTPS connections also depend on the TLS settings, which can
+ * be set per input. */
+static char *vlc_http_mgr_origin(const struct vlc_http_mgr *mgr,
+                                 const char *host, unsigned port, bool secure)
+{
+    char *origin;
+    int val;
+
+    if (port == 0)
+        port = secure ? 443 : 80;
+
+    if (secure)
+    {
+        bool system = var_InheritBool(mgr->obj, "gnutls-system-trust");
+        char *dir = var_InheritString(mgr->obj, "gnutls-dir-trust");
+        char *prio = var_InheritString(mgr->obj, "gnutls-priorities");
+
+        /* Length-prefixed, as a directory name can contain anything */
+        val = asprintf(&origin, "https://%s:%u/%d/%zu:%s/%s", host, port,
+                       system, dir ? strlen(dir) : 0, dir ? dir : "",
+                       prio ? prio : "");
+        free(prio);
+        free(dir);
+    }
+    else
+        val = asprintf(&origin, "http://%s:%u", host, port);
+
+    return val >= 0 ? origin : NULL;
+}
+
 static struct vlc_http_conn *vlc_http_mgr_find(struct vlc_http_mgr *mgr,
                                                const char *host, unsigned port)
 {
@@ -117,10 +234,101 @@ static void vlc_http_mgr_release(struct vlc_http_mgr *mgr,
 {
     assert(mgr->conn == conn);
     mgr->conn = NULL;
+    mgr->multiplexed = false;
+    free(mgr->origin);
+    mgr->origin = NULL;
 
     vlc_http_conn_release(conn);
 }
 
+static void vlc_http_mgr_set(struct vlc_http_mgr *mgr,
+                             struct vlc_http_conn *conn, bool multiplexed,
+                             const char *host, unsigned port)
+{
+    if (mgr->conn != NULL)
+        vlc_http_mgr_release(mgr, mgr->conn);
+
+    mgr->conn = conn;
+    mgr->generation++;
+    mgr->multiplexed = multiplexed;
+    mgr->origin = vlc_http_mgr_origin(mgr, host, port, mgr->creds != NULL);
+}
+
+/**
+ * Takes over an idle connection to the origin from the instance, along with
+ * the TLS credentials it was established with.
+ */
+static void vlc_http_mgr_adopt(struct vlc_http_mgr *mgr,
+                               const char *host, unsigned port, bool secure)
+{
+    assert(mgr->conn == NULL && mgr->creds == NULL);
+
+    char *origin = vlc_http_mgr_origin(mgr, host, port, secure);
+    if (unlikely(origin == NULL))
+        return;
+
+    struct vlc_http_idle *idle = vlc_http_pool_take(mgr->obj, origin);
+    if (idle == NULL)
+    {
+        free(origin);
+        return;
+    }
+
+    vlc_http_dbg(mgr->logger, "reusing idle connection to %s", host);
+    mgr->creds = idle->creds;
+    mgr->creds_parent = idle->creds_parent;
+    mgr->conn = idle->conn;
+    mgr->generation++;
+    mgr->multiplexed = idle->multiplexed;
+    mgr->origin = origin;
+    free(idle);
+}
+
+/**
+ * Leaves the connection and its TLS credentials to the instance.
+ */
+static bool vlc_http_mgr_keep(struct vlc_http_mgr *mgr)
+{
+    struct vlc_http_idle *idle = malloc(sizeof (*idle));
+    if (unlikely(idle == NULL))
+        return false;
+
+    idle->creds = mgr->creds;
+    idle->creds_parent = mgr->creds_parent;
+    idle->conn = mgr->conn;
+    idle->multiplexed = mgr->multiplexed;
+
+    if (vlc_http_pool_put(mgr->obj, mgr->origin, idle, vlc_http_idle_free))
+    {
+        free(idle);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Waits for the response header of a request.
+ *
+ * The manager lock is released meanwhile, so that other threads can send
+ * their own requests on the same HTTP/2 connection. The stream keeps the
+ * connection alive even if the manager lets go of it in the mean time.
+ */
+static struct vlc_http_msg *vlc_http_mgr_wait(struct vlc_http_mgr *mgr,
+                                              struct vlc_http_stream *stream)
+{
+    struct vlc_http_conn *conn = mgr->conn;
+    unsigned generation = mgr->generation;
+
+    vlc_mutex_unlock(&mgr->lock);
+    struct vlc_http_msg *m = vlc_http_msg_get_initial(stream);
+    vlc_mutex_lock(&mgr->lock);
+
+    if (m == NULL && mgr->conn == conn && mgr->generation == generation)
+        /* Get rid of closing or reset connection */
+        vlc_http_mgr_release(mgr, conn);
+    return m;
+}
+
 static
 struct vlc_http_msg *vlc_http_mgr_reuse(struct vlc_http_mgr *mgr,
                                         const char *host, unsigned port,
@@ -133,12 +341,9 @@ struct vlc_http_msg *vlc_http_mgr_reuse(struct vlc_http_mgr *mgr,
 
     struct vlc_http_stream *stream = vlc_http_stream_open(conn, req, payload);
     if (stream != NULL)
-    {
-        struct vlc_http_msg *m = vlc_http_msg_get_initial(stream);
-        if (m != NULL)
-            return m;
-    }
-    /* Get rid of closing or reset connection */
+        return vlc_http_mgr_wait(mgr, stream);
+
+    /* Get rid of closing, reset or busy HTTP/1 connection */
     vlc_http_mgr_release(mgr, conn);
     return NULL;
 }
@@ -154,9 +359,12 @@ static struct vlc_http_msg *vlc_https_request(struct vlc_http_mgr *mgr,
     if (mgr->creds == NULL && mgr->conn != NULL)
         return NULL; /* switch from HTTP to HTTPS not implemented */
 
+    if (mgr->creds == NULL && idempotent)
+        vlc_http_mgr_adopt(mgr, host, port, true);
+
     if (mgr->creds == NULL)
     {   /* First TLS connection: load x509 credentials */
-        mgr->creds = vlc_tls_ClientCreate(mgr->obj);
+        mgr->creds = vlc_http_creds_create(mgr->obj, &mgr->creds_parent);
         if (mgr->creds == NULL)
             return NULL;
     }
@@ -173,6 +381,8 @@ static struct vlc_http_msg *vlc_https_request(struct vlc_http_mgr *mgr,
             return resp; /* existing connection reused */
     }
 
+    /* The lock is held while connecting, so that concurrent requests wait
+     * for the new connection and are multiplexed on it if possible. */
     char *proxy = vlc_http_proxy_find(host, port, true);
     if (proxy != NULL)
     {
@@ -206,10 +416,7 @@ static struct vlc_http_msg *vlc_https_request(struct vlc_http_mgr *mgr,
         return NULL;
     }
 
-    if (mgr->conn != NULL)
-        vlc_http_mgr_release(mgr, mgr->conn);
-
-    mgr->conn = conn;
+    vlc_http_mgr_set(mgr, conn, http2, host, port);
     return vlc_http_mgr_reuse(mgr, host, port, req, payload);
 }
 
@@ -221,6 +428,9 @@ static struct vlc_http_msg *vlc_http_request(struct vlc_http_mgr *mgr,
     if (mgr->creds != NULL && mgr->conn != NULL)
         return NULL; /* switch from HTTPS to HTTP not implemented */
 
+    if (mgr->creds == NULL && mgr->conn == NULL && idempotent)
+        vlc_http_mgr_adopt(mgr, host, port, false);
+
     if (idempotent)
     {
         struct vlc_http_msg *resp = vlc_http_mgr_reuse(mgr, host, port, req,
@@ -256,18 +466,8 @@ static struct vlc_http_msg *vlc_http_request(struct vlc_http_mgr *mgr,
     if (stream == NULL)
         return NULL;
 
-    struct vlc_http_msg *resp = vlc_http_msg_get_initial(stream);
-    if (resp == NULL)
-    {
-        vlc_http_conn_release(conn);
-        return NULL;
-    }
-
-    if (mgr->conn != NULL)
-        vlc_http_mgr_release(mgr, mgr->conn);
-
-    mgr->conn = conn;
-    return resp;
+    vlc_http_mgr_set(mgr, conn, false, host, port);
+    return vlc_http_mgr_wait(mgr, stream);
 }
 
 struct vlc_http_msg *vlc_http_mgr_request(struct vlc_http_mgr *mgr, bool https,
@@ -278,8 +478,20 @@ struct vlc_http_msg *vlc_http_mgr_request(struct vlc_http_mgr *mgr, bool https,
     if (port && vlc_http_port_blocked(port))
         return NULL;
 
-    return (https ? vlc_https_request : vlc_http_request)(mgr, host, port, m,
-                                                          idempotent, payload);
+    vlc_mutex_lock(&mgr->lock);
+    struct vlc_http_msg *resp =
+        (https ? vlc_https_request : vlc_http_request)(mgr, host, port, m,
+                                                       idempotent, payload);
+    vlc_mutex_unlock(&mgr->lock);
+    return resp;
+}
+
+bool vlc_http_mgr_is_multiplexed(struct vlc_http_mgr *mgr)
+{
+    vlc_mutex_lock(&mgr->lock);
+    bool multiplexed = mgr->multiplexed;
+    vlc_mutex_unlock(&mgr->lock);
+    return multiplexed;
 }
 
 struct vlc_http_cookie_jar_t *vlc_http_mgr_get_jar(struct vlc_http_mgr *mgr)
@@ -297,16 +509,28 @@ struct vlc_http_mgr *vlc_http_mgr_create(vlc_object_t *obj,
     mgr->logger = obj->logger;
     mgr->obj = obj;
     mgr->creds = NULL;
+    mgr->creds_parent = NULL;
     mgr->jar = jar;
+    vlc_mutex_init(&mgr->lock);
     mgr->conn = NULL;
+    mgr->generation = 0;
+    mgr->multiplexed = false;
+    mgr->origin = NULL;
     return mgr;
 }
 
 void vlc_http_mgr_destroy(struct vlc_http_mgr *mgr)
 {
+    if (mgr->conn != NULL && mgr->origin != NULL && vlc_http_mgr_keep(mgr))
+    {   /* Connection and credentials now belong to the pool */
+        free(mgr->origin);
+        free(mgr);
+        return;
+    }
+
     if (mgr->conn != NULL)
         vlc_http_mgr_release(mgr, mgr->conn);
     if (mgr->creds != NULL)
-        vlc_tls_ClientDelete(mgr->creds);
+        vlc_http_creds_delete(mgr->creds, mgr->creds_parent);
     free(mgr);
 }
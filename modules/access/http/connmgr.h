@@ -57,6 +57,17 @@ struct vlc_http_msg *vlc_http_mgr_request(struct vlc_http_mgr *mgr, bool https,
 
 struct vlc_http_cookie_jar_t *vlc_http_mgr_get_jar(struct vlc_http_mgr *);
 
+/**
+ * Checks whether requests are multiplexed
+ *
+ * The manager can be used from several threads at once. Concurrent requests
+ * share a single connection if it is an HTTP/2 one. Otherwise they replace
+ * each other's HTTP/1 connection, which then cannot be kept alive.
+ *
+ * @return true if the current connection is an HTTP/2 one
+ */
+bool vlc_http_mgr_is_multiplexed(struct vlc_http_mgr *);
+
 /**
  * Creates an HTTP connection manager
  *
@@ -72,7 +83,10 @@ struct vlc_http_mgr *vlc_http_mgr_create(vlc_object_t *obj,
  * Destroys an HTTP connection manager
  *
  * Deallocates an HTTP client connections manager created by
- * vlc_http_msg_destroy(). Any remaining connection is closed and destroyed.
+ * vlc_http_msg_destroy(). Any remaining connection is kept idle for a few
+ * seconds by the LibVLC instance, and the next manager of the instance with
+ * requests to the same origin and TLS settings takes it over. It is closed
+ * and destroyed otherwise.
  */
 void vlc_http_mgr_destroy(struct vlc_http_mgr *mgr);
 
@@ -0,0 +1,302 @@
+/*****************************************************************************
+ * connmgr_test.c: HTTP connection manager tests
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#undef NDEBUG
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef HAVE_SYS_SOCKET_H
+#include <sys/socket.h>
+#endif
+
+#include <vlc_common.h>
+#include <vlc_http.h>
+#include <vlc_threads.h>
+#include <vlc_tls.h>
+#include "h2frame.h"
+#include "connmgr.h"
+#include "message.h"
+
+#if defined(PF_UNIX) && !defined(PF_LOCAL)
+#    define PF_LOCAL PF_UNIX
+#endif
+
+#define REQUESTS 4
+
+const char vlc_module_name[] = "test_connmgr";
+
+static vlc_tls_t *server_tls;
+static vlc_tls_t *client_tls;
+static unsigned connections = 0;
+static bool greeted = false;
+static bool system_trust = true;
+
+/*
+ * The "server" is a local HTTP/2 stand-in behind a socket pair. Cleartext
+ * HTTP/2 is not supported by the client, so TLS is short-circuited and ALPN
+ * pretends that "h2" was negotiated.
+ */
+vlc_tls_client_t *vlc_tls_ClientCreate(vlc_object_t *obj)
+{
+    (void) obj;
+    return (vlc_tls_client_t *)&connections;
+}
+
+void vlc_tls_ClientDelete(vlc_tls_client_t *crd)
+{
+    assert(crd == (vlc_tls_client_t *)&connections);
+}
+
+vlc_tls_t *vlc_tls_SocketOpenTLS(vlc_tls_client_t *crd, const char *hostname,
+                                 unsigned port, const char *service,
+                                 const char *const *alpn, char **alp)
+{
+    assert(crd == (vlc_tls_client_t *)&connections);
+    assert(!strcmp(hostname, "www.example.com"));
+    assert(port == 443);
+    assert(!strcmp(service, "https"));
+    assert(alpn != NULL && !strcmp(alpn[0], "h2"));
+
+    vlc_tls_t *tls = client_tls;
+
+    client_tls = NULL;
+    connections++;
+    if (tls != NULL)
+        *alp = strdup("h2");
+    return tls;
+}
+
+char *vlc_getProxyUrl(const char *url)
+{
+    (void) url;
+    return NULL;
+}
+
+vlc_object_t *(vlc_object_parent)(vlc_object_t *obj)
+{
+    (void) obj;
+    return NULL;
+}
+
+/* The only TLS setting of the input */
+int var_Inherit(vlc_object_t *obj, const char *name, int type,
+                vlc_value_t *val)
+{
+    (void) obj;
+    if (strcmp(name, "gnutls-system-trust"))
+        return VLC_ENOENT;
+    assert(type == VLC_VAR_BOOL);
+    val->b_bool = system_trust;
+    return VLC_SUCCESS;
+}
+
+/* Idle connections of the instance, down to a single one */
+static struct
+{
+    char *key;
+    void *data;
+    void (*release)(void *);
+} idle;
+
+int vlc_http_pool_put(vlc_object_t *obj, const char *key, void *data,
+                      void (*release)(void *))
+{
+    (void) obj;
+    assert(idle.key == NULL);
+    assert(!strncmp(key, "https://www.example.com:443/", 28));
+    idle.key = strdup(key);
+    assert(idle.key != NULL);
+    idle.data = data;
+    idle.release = release;
+    return 0;
+}
+
+void *vlc_http_pool_take(vlc_object_t *obj, const char *key)
+{
+    (void) obj;
+    if (idle.key == NULL || strcmp(idle.key, key))
+        return NULL;
+
+    free(idle.key);
+    idle.key = NULL;
+    return idle.data;
+}
+
+static void conn_send(struct vlc_h2_frame *f)
+{
+    assert(f != NULL);
+
+    size_t len = vlc_h2_frame_size(f);
+    ssize_t val = vlc_tls_Write(server_tls, f->data, len);
+    assert((size_t)val == len);
+    free(f);
+}
+
+enum {
+    DATA, HEADERS, PRIORITY, RST_STREAM, SETTINGS, PUSH_PROMISE, PING, GOAWAY,
+    WINDOW_UPDATE, CONTINUATION,
+};
+
+static void *server_thread(void *data)
+{
+    unsigned requests = (uintptr_t)data;
+    uint_fast32_t ids[REQUESTS];
+    char hello[24];
+    ssize_t val;
+
+    assert(requests <= REQUESTS);
+
+    if (!greeted)
+    {
+        greeted = true;
+        conn_send(vlc_h2_frame_settings());
+        val = vlc_tls_Read(server_tls, hello, 24, true);
+        assert(val == 24);
+        assert(!memcmp(hello, "PRI * HTTP/2.0\r\n", 16));
+    }
+
+    /* Only reply once every request is in flight: this deadlocks if the
+     * connection manager serializes the requests. */
+    for (unsigned n = 0; n < requests;)
+    {
+        uint8_t hdr[9];
+
+        val = vlc_tls_Read(server_tls, hdr, 9, true);
+        assert(val == 9);
+
+        size_t len = (hdr[0] << 16) | (hdr[1] << 8) | hdr[2];
+        if (len > 0)
+        {
+            char buf[len];
+
+            val = vlc_tls_Read(server_tls, buf, len, true);
+            assert(val == (ssize_t)len);
+        }
+
+        if (hdr[3] == HEADERS)
+            ids[n++] = GetDWBE(hdr + 5) & 0x7fffffff;
+    }
+
+    for (unsigned n = requests; n > 0; n--)
+    {
+        struct vlc_http_msg *m = vlc_http_resp_create(200);
+        assert(m != NULL);
+        vlc_http_msg_add_agent(m, "VLC-h2-tester");
+        conn_send(vlc_http_msg_h2_frame(m, ids[n - 1], true));
+        vlc_http_msg_destroy(m);
+    }
+    return NULL;
+}
+
+static void *request_thread(void *data)
+{
+    struct vlc_http_mgr *mgr = data;
+    struct vlc_http_msg *req = vlc_http_req_create("GET", "https",
+                                                   "www.example.com", "/");
+    assert(req != NULL);
+
+    struct vlc_http_msg *resp = vlc_http_mgr_request(mgr, true,
+                                                     "www.example.com", 0,
+                                                     req, true, false);
+    assert(resp != NULL);
+    assert(vlc_http_msg_get_status(resp) == 200);
+    vlc_http_msg_destroy(resp);
+    vlc_http_msg_destroy(req);
+    return NULL;
+}
+
+int main(void)
+{
+    struct vlc_object_t obj = { .logger = NULL };
+    vlc_thread_t server, th[REQUESTS];
+    vlc_tls_t *tlsv[2];
+
+    if (vlc_tls_SocketPair(PF_LOCAL, 0, tlsv))
+        return 77;
+
+    server_tls = tlsv[0];
+    client_tls = tlsv[1];
+
+    struct vlc_http_mgr *mgr = vlc_http_mgr_create(&obj, NULL);
+    assert(mgr != NULL);
+    assert(!vlc_http_mgr_is_multiplexed(mgr));
+
+    if (vlc_clone(&server, server_thread, (void *)(uintptr_t)REQUESTS))
+        assert(!"Thread error");
+
+    /* Concurrent requests share a single HTTP/2 connection */
+    for (unsigned i = 0; i < REQUESTS; i++)
+        if (vlc_clone(&th[i], request_thread, mgr))
+            assert(!"Thread error");
+
+    for (unsigned i = 0; i < REQUESTS; i++)
+        vlc_join(th[i], NULL);
+    vlc_join(server, NULL);
+
+    assert(connections == 1);
+    assert(vlc_http_mgr_is_multiplexed(mgr));
+    vlc_http_mgr_destroy(mgr);
+    assert(idle.key != NULL);
+
+    /* The connection is not handed over with other TLS settings */
+    system_trust = false;
+    mgr = vlc_http_mgr_create(&obj, NULL);
+    assert(mgr != NULL);
+
+    struct vlc_http_msg *req = vlc_http_req_create("GET", "https",
+                                                   "www.example.com", "/");
+    assert(req != NULL);
+    assert(vlc_http_mgr_request(mgr, true, "www.example.com", 0, req,
+                                true, false) == NULL);
+    vlc_http_msg_destroy(req);
+    assert(connections == 2);
+    assert(idle.key != NULL);
+    vlc_http_mgr_destroy(mgr);
+    system_trust = true;
+
+    /* The connection outlives its manager and serves the next one */
+    mgr = vlc_http_mgr_create(&obj, NULL);
+    assert(mgr != NULL);
+
+    if (vlc_clone(&server, server_thread, (void *)(uintptr_t)1))
+        assert(!"Thread error");
+    request_thread(mgr);
+    vlc_join(server, NULL);
+
+    assert(idle.key == NULL);
+    assert(connections == 2);
+    assert(vlc_http_mgr_is_multiplexed(mgr));
+
+    vlc_tls_Shutdown(server_tls, false);
+    vlc_http_mgr_destroy(mgr);
+
+    /* The instance releases the idle connection when destroyed */
+    assert(idle.key != NULL);
+    free(idle.key);
+    idle.release(idle.data);
+    vlc_tls_SessionDelete(server_tls);
+    return 0;
+}
@@ -30,6 +30,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <vlc_common.h>
+#include <vlc_threads.h>
 #include <vlc_tls.h>
 #include <vlc_block.h>
 
@@ -113,6 +114,7 @@ struct vlc_h1_conn
     struct vlc_http_stream stream;
     uintmax_t content_length;
     bool connection_close;
+    vlc_mutex_t lock; /**< Protects conn.tls, active and released */
     bool active;
     bool released;
     bool proxy;
@@ -125,12 +127,16 @@ static void vlc_h1_conn_destroy(struct vlc_h1_conn *conn);
 
 static void *vlc_h1_stream_fatal(struct vlc_h1_conn *conn)
 {
-    if (conn->conn.tls != NULL)
+    vlc_mutex_lock(&conn->lock);
+    vlc_tls_t *tls = conn->conn.tls;
+    conn->conn.tls = NULL;
+    vlc_mutex_unlock(&conn->lock);
+
+    if (tls != NULL)
     {
         vlc_http_dbg(CO(conn), "connection failed");
-        vlc_tls_Shutdown(conn->conn.tls, true);
-        vlc_tls_Close(conn->conn.tls);
-        conn->conn.tls = NULL;
+        vlc_tls_Shutdown(tls, true);
+        vlc_tls_Close(tls);
     }
     return NULL;
 }
@@ -147,21 +153,28 @@ static struct vlc_http_stream *vlc_h1_stream_open(struct vlc_http_conn *c,
     size_t len;
     ssize_t val;
 
-    if (conn->active || conn->conn.tls == NULL)
-        return NULL;
+    vlc_mutex_lock(&conn->lock);
+    vlc_tls_t *tls = conn->conn.tls;
+    bool busy = conn->active;
+    vlc_mutex_unlock(&conn->lock);
+
+    if (busy || tls == NULL)
+        return NULL; /* Busy with another stream or failed */
 
     char *payload = vlc_http_msg_format(req, &len, conn->proxy, has_data);
     if (unlikely(payload == NULL))
         return NULL;
 
     vlc_http_dbg(CO(conn), "outgoing request:\n%.*s", (int)len, payload);
-    val = vlc_tls_Write(conn->conn.tls, payload, len);
+    val = vlc_tls_Write(tls, payload, len);
     free(payload);
 
     if (val < (ssize_t)len)
         return vlc_h1_stream_fatal(conn);
 
+    vlc_mutex_lock(&conn->lock);
     conn->active = true;
+    vlc_mutex_unlock(&conn->lock);
     conn->content_length = 0;
     conn->connection_close = false;
     return &conn->stream;
@@ -302,9 +315,13 @@ static void vlc_h1_stream_close(struct vlc_http_stream *stream, bool abort)
         /* Shut the underlying connection down and prevent reuse. */
         vlc_h1_stream_fatal(conn);
 
+    /* The owner can release the connection from another thread */
+    vlc_mutex_lock(&conn->lock);
     conn->active = false;
+    bool destroy = conn->released;
+    vlc_mutex_unlock(&conn->lock);
 
-    if (conn->released)
+    if (destroy)
         vlc_h1_conn_destroy(conn);
 }
 
@@ -333,10 +350,13 @@ static void vlc_h1_conn_release(struct vlc_http_conn *c)
 {
     struct vlc_h1_conn *conn = container_of(c, struct vlc_h1_conn, conn);
 
+    vlc_mutex_lock(&conn->lock);
     assert(!conn->released);
     conn->released = true;
+    bool destroy = !conn->active;
+    vlc_mutex_unlock(&conn->lock);
 
-    if (!conn->active)
+    if (destroy)
         vlc_h1_conn_destroy(conn);
 }
 
@@ -355,6 +375,7 @@ struct vlc_http_conn *vlc_h1_conn_create(void *ctx, vlc_tls_t *tls, bool proxy)
     conn->conn.cbs = &vlc_h1_conn_callbacks;
     conn->conn.tls = tls;
     conn->stream.cbs = &vlc_h1_stream_callbacks;
+    vlc_mutex_init(&conn->lock);
     conn->active = false;
     conn->released = false;
     conn->proxy = proxy;
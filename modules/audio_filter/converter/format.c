@@ -38,6 +38,9 @@
 #include <vlc_aout.h>
 #include <vlc_block.h>
 #include <vlc_filter.h>
+#include <vlc_cpu.h>
+
+#include "format_kernels.h"
 
 /*****************************************************************************
  * Module descriptor
@@ -57,6 +60,7 @@ vlc_module_end()
 
 typedef block_t *(*cvt_t)(filter_t *, block_t *);
 static const struct vlc_filter_operations *FindConversion(vlc_fourcc_t src, vlc_fourcc_t dst);
+static const struct vlc_filter_operations *FindSIMDConversion(vlc_fourcc_t src, vlc_fourcc_t dst);
 
 static int Open(vlc_object_t *object)
 {
@@ -74,7 +78,10 @@ static int Open(vlc_object_t *object)
     if (filter_ops == NULL)
         return VLC_EGENERIC;
 
-    filter->ops = filter_ops;
+    /* Prefer the vectorized version of the conversion, if any */
+    const struct vlc_filter_operations *simd_ops =
+        FindSIMDConversion(src->i_codec, dst->i_codec);
+    filter->ops = simd_ops != NULL ? simd_ops : filter_ops;
 
     msg_Dbg(filter, "%4.4s->%4.4s, bits per sample: %i->%i",
             (char *)&src->i_codec, (char *)&dst->i_codec,
@@ -86,69 +93,89 @@ static int Open(vlc_object_t *object)
 /*** from U8 ***/
 static block_t *U8toS16(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 2);
+    size_t count = bsrc->i_buffer;
+    block_t *bdst = filter_GetAudioBufferInPlace(filter, bsrc,
+                                                 count * sizeof (int16_t));
     if (unlikely(bdst == NULL))
         goto out;
 
-    block_CopyProperties(bdst, bsrc);
-    uint8_t *src = (uint8_t *)bsrc->p_buffer;
-    int16_t *dst = (int16_t *)bdst->p_buffer;
-    for (size_t i = bsrc->i_buffer; i--;)
-        *dst++ = ((*src++) << 8) - 0x8000;
+    /* Backward, as the output may overlap the input */
+    const uint8_t *src = (const uint8_t *)bsrc->p_buffer + count;
+    int16_t *dst = (int16_t *)bdst->p_buffer + count;
+    while (count--)
+    {
+        uint8_t v = *--src;
+        *--dst = (v << 8) - 0x8000;
+    }
 out:
-    block_Release(bsrc);
-    VLC_UNUSED(filter);
+    if (bdst != bsrc)
+        block_Release(bsrc);
     return bdst;
 }
 
 static block_t *U8toFl32(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 4);
+    size_t count = bsrc->i_buffer;
+    block_t *bdst = filter_GetAudioBufferInPlace(filter, bsrc,
+                                                 count * sizeof (float));
     if (unlikely(bdst == NULL))
         goto out;
 
-    block_CopyProperties(bdst, bsrc);
-    uint8_t *src = (uint8_t *)bsrc->p_buffer;
-    float   *dst = (float *)bdst->p_buffer;
-    for (size_t i = bsrc->i_buffer; i--;)
-        *dst++ = ((float)((*src++) - 128)) / 128.f;
+    /* Backward, as the output may overlap the input */
+    const uint8_t *src = (const uint8_t *)bsrc->p_buffer + count;
+    float *dst = (float *)bdst->p_buffer + count;
+    while (count--)
+    {
+        uint8_t v = *--src;
+        *--dst = ((float)(v - 128)) / 128.f;
+    }
 out:
-    block_Release(bsrc);
-    VLC_UNUSED(filter);
+    if (bdst != bsrc)
+        block_Release(bsrc);
     return bdst;
 }
 
 static block_t *U8toS32(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 4);
+    size_t count = bsrc->i_buffer;
+    block_t *bdst = filter_GetAudioBufferInPlace(filter, bsrc,
+                                                 count * sizeof (int32_t));
     if (unlikely(bdst == NULL))
         goto out;
 
-    block_CopyProperties(bdst, bsrc);
-    uint8_t *src = (uint8_t *)bsrc->p_buffer;
-    int32_t *dst = (int32_t *)bdst->p_buffer;
-    for (size_t i = bsrc->i_buffer; i--;)
-        *dst++ = ((*src++) << 24) - 0x80000000;
+    /* Backward, as the output may overlap the input */
+    const uint8_t *src = (const uint8_t *)bsrc->p_buffer + count;
+    int32_t *dst = (int32_t *)bdst->p_buffer + count;
+    while (count--)
+    {
+        uint8_t v = *--src;
+        *--dst = (v << 24) - 0x80000000;
+    }
 out:
-    block_Release(bsrc);
-    VLC_UNUSED(filter);
+    if (bdst != bsrc)
+        block_Release(bsrc);
     return bdst;
 }
 
 static block_t *U8toFl64(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 8);
+    size_t count = bsrc->i_buffer;
+    block_t *bdst = filter_GetAudioBufferInPlace(filter, bsrc,
+                                                 count * sizeof (double));
     if (unlikely(bdst == NULL))
         goto out;
 
-    block_CopyProperties(bdst, bsrc);
-    uint8_t *src = (uint8_t *)bsrc->p_buffer;
-    double  *dst = (double *)bdst->p_buffer;
-    for (size_t i = bsrc->i_buffer; i--;)
-        *dst++ = ((double)((*src++) - 128)) / 128.;
+    /* Backward, as the output may overlap the input */
+    const uint8_t *src = (const uint8_t *)bsrc->p_buffer + count;
+    double *dst = (double *)bdst->p_buffer + count;
+    while (count--)
+    {
+        uint8_t v = *--src;
+        *--dst = ((double)(v - 128)) / 128.;
+    }
 out:
-    block_Release(bsrc);
-    VLC_UNUSED(filter);
+    if (bdst != bsrc)
+        block_Release(bsrc);
     return bdst;
 }
 
@@ -168,63 +195,58 @@ static block_t *S16toU8(filter_t *filter, block_t *b)
 
 static block_t *S16toFl32(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 2);
-    if (unlikely(bdst == NULL))
-        goto out;
-
-    block_CopyProperties(bdst, bsrc);
-    int16_t *src = (int16_t *)bsrc->p_buffer;
-    float   *dst = (float *)bdst->p_buffer;
-    for (size_t i = bsrc->i_buffer / 2; i--;)
-#if 0
-        /* Slow version */
-        *dst++ = (float)*src++ / 32768.f;
-#else
-    {   /* This is Walken's trick based on IEEE float format. On my PIII
-         * this takes 16 seconds to perform one billion conversions, instead
-         * of 19 seconds for the above division. */
-        union { float f; int32_t i; } u;
-        u.i = *src++ + 0x43c00000;
-        *dst++ = u.f - 384.f;
-    }
-#endif
-out:
-    block_Release(bsrc);
-    VLC_UNUSED(filter);
+    size_t count = bsrc->i_buffer / 2;
+    block_t *bdst = filter_GetAudioBufferInPlace(filter, bsrc,
+                                                 count * sizeof (float));
+    if (likely(bdst != NULL))
+        S16toFl32_C_kernel((float *)bdst->p_buffer,
+                           (const int16_t *)bsrc->p_buffer, count);
+    if (bdst != bsrc)
+        block_Release(bsrc);
     return bdst;
 }
 
 static block_t *S16toS32(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 2);
+    size_t count = bsrc->i_buffer / 2;
+    block_t *bdst = filter_GetAudioBufferInPlace(filter, bsrc,
+                                                 count * sizeof (int32_t));
     if (unlikely(bdst == NULL))
         goto out;
 
-    block_CopyProperties(bdst, bsrc);
-    int16_t *src = (int16_t *)bsrc->p_buffer;
-    int32_t *dst = (int32_t *)bdst->p_buffer;
-    for (int i = bsrc->i_buffer / 2; i--;)
-        *dst++ = *src++ << 16;
+    /* Backward, as the output may overlap the input */
+    const int16_t *src = (const int16_t *)bsrc->p_buffer + count;
+    int32_t *dst = (int32_t *)bdst->p_buffer + count;
+    while (count--)
+    {
+        int16_t v = *--src;
+        *--dst = v << 16;
+    }
 out:
-    block_Release(bsrc);
-    VLC_UNUSED(filter);
+    if (bdst != bsrc)
+        block_Release(bsrc);
     return bdst;
 }
 
 static block_t *S16toFl64(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 4);
+    size_t count = bsrc->i_buffer / 2;
+    block_t *bdst = filter_GetAudioBufferInPlace(filter, bsrc,
+                                                 count * sizeof (double));
     if (unlikely(bdst == NULL))
         goto out;
 
-    block_CopyProperties(bdst, bsrc);
-    int16_t *src = (int16_t *)bsrc->p_buffer;
-    float   *dst = (float *)bdst->p_buffer;
-    for (size_t i = bsrc->i_buffer / 2; i--;)
-        *dst++ = (double)*src++ / 32768.;
+    /* Backward, as the output may overlap the input */
+    const int16_t *src = (const int16_t *)bsrc->p_buffer + count;
+    double *dst = (double *)bdst->p_buffer + count;
+    while (count--)
+    {
+        int16_t v = *--src;
+        *--dst = (double)v / 32768.;
+    }
 out:
-    block_Release(bsrc);
-    VLC_UNUSED(filter);
+    if (bdst != bsrc)
+        block_Release(bsrc);
     return bdst;
 }
 
@@ -253,64 +275,39 @@ static block_t *Fl32toU8(filter_t *filter, block_t *b)
 static block_t *Fl32toS16(filter_t *filter, block_t *b)
 {
     VLC_UNUSED(filter);
-    float   *src = (float *)b->p_buffer;
-    int16_t *dst = (int16_t *)src;
-    for (int i = b->i_buffer / 4; i--;) {
-#if 0
-        /* Slow version. */
-        if (*src >= 1.0) *dst = 32767;
-        else if (*src < -1.0) *dst = -32768;
-        else *dst = lroundf(*src * 32768.f);
-        src++; dst++;
-#else
-        /* This is Walken's trick based on IEEE float format. */
-        union { float f; int32_t i; } u;
-        u.f = *src++ + 384.f;
-        if (u.i > 0x43c07fff)
-            *dst++ = 32767;
-        else if (u.i < 0x43bf8000)
-            *dst++ = -32768;
-        else
-            *dst++ = u.i - 0x43c00000;
-#endif
-    }
+    Fl32toS16_C_kernel((int16_t *)b->p_buffer, (const float *)b->p_buffer,
+                       b->i_buffer / 4);
     b->i_buffer /= 2;
     return b;
 }
 
 static block_t *Fl32toS32(filter_t *filter, block_t *b)
 {
-    float   *src = (float *)b->p_buffer;
-    int32_t *dst = (int32_t *)src;
-    for (size_t i = b->i_buffer / 4; i--;)
-    {
-        float s = *(src++) * -((float)INT32_MIN);
-        if (s >= ((float)INT32_MAX))
-            *(dst++) = INT32_MAX;
-        else
-        if (s <= ((float)INT32_MIN))
-            *(dst++) = INT32_MIN;
-        else
-            *(dst++) = lroundf(s);
-    }
+    Fl32toS32_C_kernel((int32_t *)b->p_buffer, (const float *)b->p_buffer,
+                       b->i_buffer / 4);
     VLC_UNUSED(filter);
     return b;
 }
 
 static block_t *Fl32toFl64(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 2);
+    size_t count = bsrc->i_buffer / 4;
+    block_t *bdst = filter_GetAudioBufferInPlace(filter, bsrc,
+                                                 count * sizeof (double));
     if (unlikely(bdst == NULL))
         goto out;
 
-    block_CopyProperties(bdst, bsrc);
-    float  *src = (float *)bsrc->p_buffer;
-    double *dst = (double *)bdst->p_buffer;
-    for (size_t i = bsrc->i_buffer / 4; i--;)
-        *(dst++) = *(src++);
+    /* Backward, as the output may overlap the input */
+    const float *src = (const float *)bsrc->p_buffer + count;
+    double *dst = (double *)bdst->p_buffer + count;
+    while (count--)
+    {
+        float v = *--src;
+        *--dst = v;
+    }
 out:
-    block_Release(bsrc);
-    VLC_UNUSED(filter);
+    if (bdst != bsrc)
+        block_Release(bsrc);
     return bdst;
 }
 
@@ -343,27 +340,30 @@ static block_t *S32toS16(filter_t *filter, block_t *b)
 static block_t *S32toFl32(filter_t *filter, block_t *b)
 {
     VLC_UNUSED(filter);
-    int32_t *src = (int32_t*)b->p_buffer;
-    float   *dst = (float *)src;
-    for (int i = b->i_buffer / 4; i--;)
-        *dst++ = (float)(*src++) / -((float)INT32_MIN);
+    S32toFl32_C_kernel((float *)b->p_buffer, (const int32_t *)b->p_buffer,
+                       b->i_buffer / 4);
     return b;
 }
 
 static block_t *S32toFl64(filter_t *filter, block_t *bsrc)
 {
-    block_t *bdst = block_Alloc(bsrc->i_buffer * 2);
+    size_t count = bsrc->i_buffer / 4;
+    block_t *bdst = filter_GetAudioBufferInPlace(filter, bsrc,
+                                                 count * sizeof (double));
     if (unlikely(bdst == NULL))
         goto out;
 
-    block_CopyProperties(bdst, bsrc);
-    int32_t *src = (int32_t*)bsrc->p_buffer;
-    double  *dst = (double *)bdst->p_buffer;
-    for (size_t i = bsrc->i_buffer / 4; i--;)
-        *dst++ = (double)(*src++) / -(double)INT32_MIN;
+    /* Backward, as the output may overlap the input */
+    const int32_t *src = (const int32_t *)bsrc->p_buffer + count;
+    double *dst = (double *)bdst->p_buffer + count;
+    while (count--)
+    {
+        int32_t v = *--src;
+        *--dst = (double)v / -(double)INT32_MIN;
+    }
 out:
-    VLC_UNUSED(filter);
-    block_Release(bsrc);
+    if (bdst != bsrc)
+        block_Release(bsrc);
     return bdst;
 }
 
@@ -441,6 +441,94 @@ static block_t *Fl64toS32(filter_t *filter, block_t *b)
 }
 
 
+#if defined(__i386__) || defined(__x86_64__)
+/*** x86 SIMD ***/
+
+/* Block wrappers around the kernels of one instruction set */
+# define SIMD_CONVERTERS(isa) \
+static block_t *S16toFl32_##isa(filter_t *filter, block_t *bsrc) \
+{ \
+    size_t count = bsrc->i_buffer / 2; \
+    block_t *bdst = filter_GetAudioBufferInPlace(filter, bsrc, \
+                                                 count * sizeof (float)); \
+    if (likely(bdst != NULL)) \
+        S16toFl32_##isa##_kernel((float *)bdst->p_buffer, \
+                                 (const int16_t *)bsrc->p_buffer, count); \
+    if (bdst != bsrc) \
+        block_Release(bsrc); \
+    return bdst; \
+} \
+\
+static block_t *Fl32toS16_##isa(filter_t *filter, block_t *b) \
+{ \
+    VLC_UNUSED(filter); \
+    Fl32toS16_##isa##_kernel((int16_t *)b->p_buffer, \
+                             (const float *)b->p_buffer, b->i_buffer / 4); \
+    b->i_buffer /= 2; \
+    return b; \
+} \
+\
+static block_t *S32toFl32_##isa(filter_t *filter, block_t *b) \
+{ \
+    VLC_UNUSED(filter); \
+    S32toFl32_##isa##_kernel((float *)b->p_buffer, \
+                             (const int32_t *)b->p_buffer, b->i_buffer / 4); \
+    return b; \
+} \
+\
+static block_t *Fl32toS32_##isa(filter_t *filter, block_t *b) \
+{ \
+    VLC_UNUSED(filter); \
+    Fl32toS32_##isa##_kernel((int32_t *)b->p_buffer, \
+                             (const float *)b->p_buffer, b->i_buffer / 4); \
+    return b; \
+}
+
+# ifdef HAVE_SSE2_INTRINSICS
+SIMD_CONVERTERS(SSE2)
+# endif
+# ifdef HAVE_AVX2_INTRINSICS
+SIMD_CONVERTERS(AVX2)
+# endif
+#endif
+
+static const struct vlc_filter_operations *FindSIMDConversion(vlc_fourcc_t src,
+                                                              vlc_fourcc_t dst)
+{
+#if defined(__i386__) || defined(__x86_64__)
+# define SIMD_OPS(isa) \
+    static const struct vlc_filter_operations \
+        s16_fl32_##isa = { .filter_audio = S16toFl32_##isa }, \
+        fl32_s16_##isa = { .filter_audio = Fl32toS16_##isa }, \
+        s32_fl32_##isa = { .filter_audio = S32toFl32_##isa }, \
+        fl32_s32_##isa = { .filter_audio = Fl32toS32_##isa }; \
+    if (src == VLC_CODEC_S16N && dst == VLC_CODEC_FL32) \
+        return &s16_fl32_##isa; \
+    if (src == VLC_CODEC_FL32 && dst == VLC_CODEC_S16N) \
+        return &fl32_s16_##isa; \
+    if (src == VLC_CODEC_S32N && dst == VLC_CODEC_FL32) \
+        return &s32_fl32_##isa; \
+    if (src == VLC_CODEC_FL32 && dst == VLC_CODEC_S32N) \
+        return &fl32_s32_##isa; \
+    return NULL
+
+# ifdef HAVE_AVX2_INTRINSICS
+    if (vlc_CPU_AVX2())
+    {
+        SIMD_OPS(AVX2);
+    }
+# endif
+# ifdef HAVE_SSE2_INTRINSICS
+    if (vlc_CPU_SSE2())
+    {
+        SIMD_OPS(SSE2);
+    }
+# endif
+#endif
+    VLC_UNUSED(src); VLC_UNUSED(dst);
+    return NULL;
+}
+
 /* */
 /* */
 static const struct {
@@ -0,0 +1,286 @@
+/*****************************************************************************
+ * format_kernels.h: PCM sample conversion kernels
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifndef VLC_AUDIO_FORMAT_KERNELS_H_
+#define VLC_AUDIO_FORMAT_KERNELS_H_
+
+#include <math.h>
+#include <stdint.h>
+
+/* The output of the kernels may start at the same address as the input */
+
+static inline void S16toFl32_C_kernel(float *dst, const int16_t *src,
+                                      size_t count)
+{
+    /* Backward, as the output may overlap the input */
+    src += count;
+    dst += count;
+    while (count--)
+#if 0
+        /* Slow version */
+        *--dst = (float)*--src / 32768.f;
+#else
+    {   /* This is Walken's trick based on IEEE float format. On my PIII
+         * this takes 16 seconds to perform one billion conversions, instead
+         * of 19 seconds for the above division. */
+        union { float f; int32_t i; } u;
+        u.i = *--src + 0x43c00000;
+        *--dst = u.f - 384.f;
+    }
+#endif
+}
+
+static inline void Fl32toS16_C_kernel(int16_t *dst, const float *src,
+                                      size_t count)
+{
+    while (count--) {
+#if 0
+        /* Slow version. */
+        if (*src >= 1.0) *dst = 32767;
+        else if (*src < -1.0) *dst = -32768;
+        else *dst = lroundf(*src * 32768.f);
+        src++; dst++;
+#else
+        /* This is Walken's trick based on IEEE float format. */
+        union { float f; int32_t i; } u;
+        u.f = *src++ + 384.f;
+        if (u.i > 0x43c07fff)
+            *dst++ = 32767;
+        else if (u.i < 0x43bf8000)
+            *dst++ = -32768;
+        else
+            *dst++ = u.i - 0x43c00000;
+#endif
+    }
+}
+
+static inline void S32toFl32_C_kernel(float *dst, const int32_t *src,
+                                      size_t count)
+{
+    while (count--)
+        *dst++ = (float)(*src++) / -((float)INT32_MIN);
+}
+
+static inline void Fl32toS32_C_kernel(int32_t *dst, const float *src,
+                                      size_t count)
+{
+    while (count--)
+    {
+        float s = *(src++) * -((float)INT32_MIN);
+        if (s >= ((float)INT32_MAX))
+            *(dst++) = INT32_MAX;
+        else
+        if (s <= ((float)INT32_MIN))
+            *(dst++) = INT32_MIN;
+        else
+            *(dst++) = lroundf(s);
+    }
+}
+
+#if defined(__i386__) || defined(__x86_64__)
+/* The x86 kernels are built with per function target attributes, and must
+ * only be called if the CPU supports the instruction set. The clipping
+ * matches the C kernels, the samples are rounded to nearest even. */
+# ifdef HAVE_SSE2_INTRINSICS
+#  include <emmintrin.h>
+#  define VLC_TARGET_SSE2 __attribute__ ((__target__ ("sse2")))
+
+VLC_TARGET_SSE2
+static inline void S16toFl32_SSE2_kernel(float *dst, const int16_t *src, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(1.f / 32768.f);
+
+    /* Backward, as the output may overlap the input */
+    while (count & 7)
+    {
+        count--;
+        dst[count] = (float)src[count] / 32768.f;
+    }
+    while (count > 0)
+    {
+        count -= 8;
+        __m128i v = _mm_loadu_si128((const __m128i *)&src[count]);
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(&dst[count + 4], _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+        _mm_storeu_ps(&dst[count], _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+    }
+}
+
+VLC_TARGET_SSE2
+static inline void Fl32toS16_SSE2_kernel(int16_t *dst, const float *src, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(32768.f);
+    const __m128 max = _mm_set1_ps(32767.f);
+    const __m128 min = _mm_set1_ps(-32768.f);
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128 a = _mm_mul_ps(_mm_loadu_ps(&src[i]), scale);
+        __m128 b = _mm_mul_ps(_mm_loadu_ps(&src[i + 4]), scale);
+        a = _mm_max_ps(_mm_min_ps(a, max), min);
+        b = _mm_max_ps(_mm_min_ps(b, max), min);
+        _mm_storeu_si128((__m128i *)&dst[i],
+                         _mm_packs_epi32(_mm_cvtps_epi32(a),
+                                         _mm_cvtps_epi32(b)));
+    }
+    for (; i < count; i++)
+    {
+        float v = src[i] * 32768.f;
+        dst[i] = (v >= 32767.f) ? 32767 : (v <= -32768.f) ? -32768
+                                                             : lrintf(v);
+    }
+}
+
+VLC_TARGET_SSE2
+static inline void S32toFl32_SSE2_kernel(float *dst, const int32_t *src, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(1.f / -((float)INT32_MIN));
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)&src[i]);
+        _mm_storeu_ps(&dst[i], _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+    }
+    for (; i < count; i++)
+        dst[i] = (float)src[i] / -((float)INT32_MIN);
+}
+
+VLC_TARGET_SSE2
+static inline void Fl32toS32_SSE2_kernel(int32_t *dst, const float *src, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(-((float)INT32_MIN));
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 s = _mm_mul_ps(_mm_loadu_ps(&src[i]), scale);
+        /* Out of range values convert to INT32_MIN: flip the positive ones
+         * to INT32_MAX */
+        __m128i over = _mm_castps_si128(_mm_cmpge_ps(s, scale));
+        _mm_storeu_si128((__m128i *)&dst[i],
+                         _mm_xor_si128(_mm_cvtps_epi32(s), over));
+    }
+    for (; i < count; i++)
+    {
+        float s = src[i] * -((float)INT32_MIN);
+        dst[i] = (s >= (float)INT32_MAX) ? INT32_MAX
+               : (s <= (float)INT32_MIN) ? INT32_MIN : lrintf(s);
+    }
+}
+# endif
+
+# ifdef HAVE_AVX2_INTRINSICS
+#  include <immintrin.h>
+#  define VLC_TARGET_AVX2 __attribute__ ((__target__ ("avx2")))
+
+VLC_TARGET_AVX2
+static inline void S16toFl32_AVX2_kernel(float *dst, const int16_t *src, size_t count)
+{
+    const __m256 scale = _mm256_set1_ps(1.f / 32768.f);
+
+    /* Backward, as the output may overlap the input */
+    while (count & 15)
+    {
+        count--;
+        dst[count] = (float)src[count] / 32768.f;
+    }
+    while (count > 0)
+    {
+        count -= 16;
+        __m256i lo = _mm256_cvtepi16_epi32(
+                         _mm_loadu_si128((const __m128i *)&src[count]));
+        __m256i hi = _mm256_cvtepi16_epi32(
+                         _mm_loadu_si128((const __m128i *)&src[count + 8]));
+        _mm256_storeu_ps(&dst[count + 8],
+                         _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale));
+        _mm256_storeu_ps(&dst[count],
+                         _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale));
+    }
+}
+
+VLC_TARGET_AVX2
+static inline void Fl32toS16_AVX2_kernel(int16_t *dst, const float *src, size_t count)
+{
+    const __m256 scale = _mm256_set1_ps(32768.f);
+    const __m256 max = _mm256_set1_ps(32767.f);
+    const __m256 min = _mm256_set1_ps(-32768.f);
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16)
+    {
+        __m256 a = _mm256_mul_ps(_mm256_loadu_ps(&src[i]), scale);
+        __m256 b = _mm256_mul_ps(_mm256_loadu_ps(&src[i + 8]), scale);
+        a = _mm256_max_ps(_mm256_min_ps(a, max), min);
+        b = _mm256_max_ps(_mm256_min_ps(b, max), min);
+        /* The pack works per 128-bits lane: put the quadwords back in order */
+        __m256i v = _mm256_packs_epi32(_mm256_cvtps_epi32(a),
+                                       _mm256_cvtps_epi32(b));
+        _mm256_storeu_si256((__m256i *)&dst[i],
+                            _mm256_permute4x64_epi64(v, 0xD8));
+    }
+    for (; i < count; i++)
+    {
+        float v = src[i] * 32768.f;
+        dst[i] = (v >= 32767.f) ? 32767 : (v <= -32768.f) ? -32768
+                                                             : lrintf(v);
+    }
+}
+
+VLC_TARGET_AVX2
+static inline void S32toFl32_AVX2_kernel(float *dst, const int32_t *src, size_t count)
+{
+    const __m256 scale = _mm256_set1_ps(1.f / -((float)INT32_MIN));
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)&src[i]);
+        _mm256_storeu_ps(&dst[i], _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+    }
+    for (; i < count; i++)
+        dst[i] = (float)src[i] / -((float)INT32_MIN);
+}
+
+VLC_TARGET_AVX2
+static inline void Fl32toS32_AVX2_kernel(int32_t *dst, const float *src, size_t count)
+{
+    const __m256 scale = _mm256_set1_ps(-((float)INT32_MIN));
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 s = _mm256_mul_ps(_mm256_loadu_ps(&src[i]), scale);
+        __m256i over = _mm256_castps_si256(_mm256_cmp_ps(s, scale, _CMP_GE_OQ));
+        _mm256_storeu_si256((__m256i *)&dst[i],
+                            _mm256_xor_si256(_mm256_cvtps_epi32(s), over));
+    }
+    for (; i < count; i++)
+    {
+        float s = src[i] * -((float)INT32_MIN);
+        dst[i] = (s >= (float)INT32_MAX) ? INT32_MAX
+               : (s <= (float)INT32_MIN) ? INT32_MIN : lrintf(s);
+    }
+}
+# endif
+#endif
+
+#endif
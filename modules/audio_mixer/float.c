@@ -33,6 +33,9 @@
 #include <vlc_plugin.h>
 #include <vlc_aout.h>
 #include <vlc_aout_volume.h>
+#include <vlc_cpu.h>
+
+#include "float_kernels.h"
 
 /*****************************************************************************
  * Local prototypes
@@ -52,32 +55,34 @@ vlc_module_end ()
 /**
  * Mixes a new output buffer
  */
-static void FilterFL32( audio_volume_t *p_volume, block_t *p_buffer,
-                        float f_multiplier )
-{
-    if( f_multiplier == 1.f )
-        return; /* nothing to do */
-
-    float *p = (float *)p_buffer->p_buffer;
-    for( size_t i = p_buffer->i_buffer / sizeof(*p); i > 0; i-- )
-        *(p++) *= f_multiplier;
-
-    (void) p_volume;
+#define DEFINE_FILTER( name, type ) \
+static void Filter##name( audio_volume_t *p_volume, block_t *p_buffer, \
+                          float f_multiplier ) \
+{ \
+    type mult = f_multiplier; \
+    if( mult == 1. ) \
+        return; /* nothing to do */ \
+ \
+    Amplify##name( (type *)p_buffer->p_buffer, \
+                   p_buffer->i_buffer / sizeof(type), mult ); \
+    (void) p_volume; \
 }
 
-static void FilterFL64( audio_volume_t *p_volume, block_t *p_buffer,
-                        float f_multiplier )
-{
-    double *p = (double *)p_buffer->p_buffer;
-    double mult = f_multiplier;
-    if( mult == 1. )
-        return; /* nothing to do */
+DEFINE_FILTER( FL32, float )
+DEFINE_FILTER( FL64, double )
 
-    for( size_t i = p_buffer->i_buffer / sizeof(*p); i > 0; i-- )
-        *(p++) *= mult;
+#if defined(__i386__) || defined(__x86_64__)
+# ifdef HAVE_SSE2_INTRINSICS
+DEFINE_FILTER( FL32_SSE, float )
+DEFINE_FILTER( FL64_SSE2, double )
+# endif
+# ifdef HAVE_AVX2_INTRINSICS
+DEFINE_FILTER( FL32_AVX, float )
+DEFINE_FILTER( FL64_AVX, double )
+# endif
+#endif
 
-    (void) p_volume;
-}
+#undef DEFINE_FILTER
 
 /**
  * Initializes the mixer
@@ -90,9 +95,31 @@ static int Create( vlc_object_t *p_this )
     {
         case VLC_CODEC_FL32:
             p_volume->amplify = FilterFL32;
+#if defined(__i386__) || defined(__x86_64__)
+# ifdef HAVE_AVX2_INTRINSICS
+            if( vlc_CPU_AVX() )
+                p_volume->amplify = FilterFL32_AVX;
+            else
+# endif
+# ifdef HAVE_SSE2_INTRINSICS
+            if( vlc_CPU_SSE2() )
+                p_volume->amplify = FilterFL32_SSE;
+# endif
+#endif
             break;
         case VLC_CODEC_FL64:
             p_volume->amplify = FilterFL64;
+#if defined(__i386__) || defined(__x86_64__)
+# ifdef HAVE_AVX2_INTRINSICS
+            if( vlc_CPU_AVX() )
+                p_volume->amplify = FilterFL64_AVX;
+            else
+# endif
+# ifdef HAVE_SSE2_INTRINSICS
+            if( vlc_CPU_SSE2() )
+                p_volume->amplify = FilterFL64_SSE2;
+# endif
+#endif
             break;
         default:
             return -1;
@@ -0,0 +1,107 @@
+/*****************************************************************************
+ * float_kernels.h: floating point samples amplification kernels
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifndef VLC_AUDIO_FLOAT_KERNELS_H_
+#define VLC_AUDIO_FLOAT_KERNELS_H_
+
+#include <stddef.h>
+
+#include <vlc_cpu.h>
+
+static inline void AmplifyFL32( float *p, size_t i_count, float f_mult )
+{
+    for( ; i_count > 0; i_count-- )
+        *(p++) *= f_mult;
+}
+
+static inline void AmplifyFL64( double *p, size_t i_count, double f_mult )
+{
+    for( ; i_count > 0; i_count-- )
+        *(p++) *= f_mult;
+}
+
+#if defined(__i386__) || defined(__x86_64__)
+/* The x86 kernels must only be called if the CPU supports the instruction
+ * set. They give the same results as the C kernels. */
+# ifdef HAVE_SSE2_INTRINSICS
+#  include <emmintrin.h>
+
+VLC_SSE
+static inline void AmplifyFL32_SSE( float *p, size_t i_count, float f_mult )
+{
+    const __m128 mult = _mm_set1_ps( f_mult );
+
+    for( ; i_count >= 8; i_count -= 8, p += 8 )
+    {
+        _mm_storeu_ps( p, _mm_mul_ps( _mm_loadu_ps( p ), mult ) );
+        _mm_storeu_ps( p + 4, _mm_mul_ps( _mm_loadu_ps( p + 4 ), mult ) );
+    }
+    AmplifyFL32( p, i_count, f_mult );
+}
+
+__attribute__ ((__target__ ("sse2")))
+static inline void AmplifyFL64_SSE2( double *p, size_t i_count,
+                                     double f_mult )
+{
+    const __m128d mult = _mm_set1_pd( f_mult );
+
+    for( ; i_count >= 4; i_count -= 4, p += 4 )
+    {
+        _mm_storeu_pd( p, _mm_mul_pd( _mm_loadu_pd( p ), mult ) );
+        _mm_storeu_pd( p + 2, _mm_mul_pd( _mm_loadu_pd( p + 2 ), mult ) );
+    }
+    AmplifyFL64( p, i_count, f_mult );
+}
+# endif
+
+# ifdef HAVE_AVX2_INTRINSICS
+#  include <immintrin.h>
+
+VLC_AVX
+static inline void AmplifyFL32_AVX( float *p, size_t i_count, float f_mult )
+{
+    const __m256 mult = _mm256_set1_ps( f_mult );
+
+    for( ; i_count >= 16; i_count -= 16, p += 16 )
+    {
+        _mm256_storeu_ps( p, _mm256_mul_ps( _mm256_loadu_ps( p ), mult ) );
+        _mm256_storeu_ps( p + 8,
+                          _mm256_mul_ps( _mm256_loadu_ps( p + 8 ), mult ) );
+    }
+    AmplifyFL32( p, i_count, f_mult );
+}
+
+VLC_AVX
+static inline void AmplifyFL64_AVX( double *p, size_t i_count,
+                                    double f_mult )
+{
+    const __m256d mult = _mm256_set1_pd( f_mult );
+
+    for( ; i_count >= 8; i_count -= 8, p += 8 )
+    {
+        _mm256_storeu_pd( p, _mm256_mul_pd( _mm256_loadu_pd( p ), mult ) );
+        _mm256_storeu_pd( p + 4,
+                          _mm256_mul_pd( _mm256_loadu_pd( p + 4 ), mult ) );
+    }
+    AmplifyFL64( p, i_count, f_mult );
+}
+# endif
+#endif
+
+#endif
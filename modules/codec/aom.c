@@ -31,6 +31,7 @@
 #include <vlc_common.h>
 #include <vlc_plugin.h>
 #include <vlc_codec.h>
+#include <vlc_cpu.h>
 
 #include <aom/aom_decoder.h>
 #include <aom/aomdx.h>
@@ -161,6 +162,7 @@ typedef struct
     aom_codec_ctx_t ctx;
     struct frame_priv_s frame_priv[AOM_MAX_FRAMES_DEPTH];
     unsigned i_next_frame_priv;
+    struct vlc_cpu_share *cpu_share;
 } decoder_sys_t;
 
 static const struct
@@ -387,9 +389,11 @@ static int OpenDecoder(vlc_object_t *p_this)
     dec->p_sys = sys;
 
     sys->i_next_frame_priv = 0;
+    sys->cpu_share = vlc_cpu_share_Join(16);
 
     struct aom_codec_dec_cfg deccfg = {
-        .threads = __MIN(vlc_GetCPUCount(), 16),
+        .threads = sys->cpu_share != NULL ? vlc_cpu_share_Threads(sys->cpu_share)
+                                          : __MIN(vlc_GetCPUCount(), 16),
         .allow_lowbitdepth = 1
     };
 
@@ -398,6 +402,7 @@ static int OpenDecoder(vlc_object_t *p_this)
 
     if (aom_codec_dec_init(&sys->ctx, iface, &deccfg, 0) != AOM_CODEC_OK) {
         AOM_ERR(p_this, &sys->ctx, "Failed to initialize decoder");
+        vlc_cpu_share_Leave(sys->cpu_share);
         free(sys);
         return VLC_EGENERIC;
     }
@@ -440,6 +445,7 @@ static void CloseDecoder(vlc_object_t *p_this)
 
     destroy_context(p_this, &sys->ctx);
 
+    vlc_cpu_share_Leave(sys->cpu_share);
     free(sys);
 }
 
@@ -455,6 +461,7 @@ static void CloseDecoder(vlc_object_t *p_this)
 typedef struct
 {
     struct aom_codec_ctx ctx;
+    struct vlc_cpu_share *cpu_share;
 } encoder_sys_t;
 
 /*****************************************************************************
@@ -483,7 +490,10 @@ static int OpenEncoder(vlc_object_t *p_this)
     enccfg.g_pass = AOM_RC_ONE_PASS;
     enccfg.g_timebase.num = p_enc->fmt_in.video.i_frame_rate_base;
     enccfg.g_timebase.den = p_enc->fmt_in.video.i_frame_rate;
-    enccfg.g_threads = __MIN(vlc_GetCPUCount(), 4);
+    p_sys->cpu_share = vlc_cpu_share_Join(4);
+    enccfg.g_threads = p_sys->cpu_share != NULL
+                     ? vlc_cpu_share_Threads(p_sys->cpu_share)
+                     : __MIN(vlc_GetCPUCount(), 4);
     enccfg.g_w = p_enc->fmt_in.video.i_visible_width;
     enccfg.g_h = p_enc->fmt_in.video.i_visible_height;
     enccfg.rc_end_usage = var_InheritInteger( p_enc, SOUT_CFG_PREFIX "rc-end-usage" );
@@ -591,6 +601,7 @@ static int OpenEncoder(vlc_object_t *p_this)
 error:
     destroy_context(p_this, ctx);
 error_nocontext:
+    vlc_cpu_share_Leave(p_sys->cpu_share);
     free(p_sys);
     return VLC_EGENERIC;
 }
@@ -667,6 +678,7 @@ static void CloseEncoder(encoder_t *p_enc)
 {
     encoder_sys_t *p_sys = p_enc->p_sys;
     destroy_context(&p_enc->obj, &p_sys->ctx);
+    vlc_cpu_share_Leave(p_sys->cpu_share);
     free(p_sys);
 }
 
@@ -146,6 +146,8 @@ typedef struct
     int        i_aac_profile; /* AAC profile to use.*/
 
     AVFrame    *frame;
+
+    struct vlc_cpu_share *cpu_share;
 } encoder_sys_t;
 
 
@@ -886,6 +888,10 @@ int InitVideoEnc( vlc_object_t *p_this )
 
     if( p_enc->i_threads >= 1)
         p_context->thread_count = p_enc->i_threads;
+    else
+    if( p_enc->fmt_in.i_cat == VIDEO_ES &&
+        ( p_sys->cpu_share = vlc_cpu_share_Join( 0 ) ) != NULL )
+        p_context->thread_count = vlc_cpu_share_Threads( p_sys->cpu_share );
     else
         p_context->thread_count = vlc_GetCPUCount();
 
@@ -1082,6 +1088,7 @@ error:
     av_free( p_sys->p_buffer );
     av_free( p_sys->p_interleave_buf );
     avcodec_free_context( &p_context );
+    vlc_cpu_share_Leave( p_sys->cpu_share );
     free( p_sys );
     return VLC_ENOMEM;
 }
@@ -1514,5 +1521,6 @@ void EndVideoEnc( encoder_t *p_enc )
     av_free( p_sys->p_interleave_buf );
     av_free( p_sys->p_buffer );
 
+    vlc_cpu_share_Leave( p_sys->cpu_share );
     free( p_sys );
 }
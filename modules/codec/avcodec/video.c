@@ -136,6 +136,8 @@ typedef struct
     /* Protect dec->fmt_out, decoder_Update*() and decoder_NewPicture()
      * functions */
     vlc_mutex_t lock;
+
+    struct vlc_cpu_share *cpu_share;
 } decoder_sys_t;
 
 /*****************************************************************************
@@ -631,10 +633,6 @@ static int InitVideoDecCommon( decoder_t *p_dec )
     int i_thread_count = p_sys->b_hardware_only ? 1 : var_InheritInteger( p_dec, "avcodec-threads" );
     if( i_thread_count <= 0 )
     {
-        i_thread_count = vlc_GetCPUCount();
-        if( i_thread_count > 1 )
-            i_thread_count++;
-
         //FIXME: take in count the decoding time
         max_thread_count = p_codec->id == AV_CODEC_ID_HEVC ? 10 : 6;
 #if defined(_WIN32)
@@ -643,6 +641,11 @@ static int InitVideoDecCommon( decoder_t *p_dec )
         max_thread_count = 6 ;
 # endif
 #endif
+        /* Share the cores with the other codecs of the process */
+        p_sys->cpu_share = vlc_cpu_share_Join( max_thread_count );
+        i_thread_count = p_sys->cpu_share != NULL
+                       ? vlc_cpu_share_Threads( p_sys->cpu_share )
+                       : vlc_GetCPUCount();
     }
     else
         max_thread_count = p_codec->id == AV_CODEC_ID_HEVC ? 32 : 16;
@@ -701,6 +704,7 @@ static int InitVideoDecCommon( decoder_t *p_dec )
     /* ***** Open the codec ***** */
     if( OpenVideoCodec( p_dec ) < 0 )
     {
+        vlc_cpu_share_Leave( p_sys->cpu_share );
         free( p_sys );
         avcodec_free_context( &p_context );
         return VLC_EGENERIC;
@@ -1697,6 +1701,7 @@ void EndVideoDec( vlc_object_t *obj )
         p_sys->vctx_out = NULL;
     }
 
+    vlc_cpu_share_Leave( p_sys->cpu_share );
     free( p_sys );
 }
 
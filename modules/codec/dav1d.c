@@ -32,6 +32,7 @@
 #include <vlc_common.h>
 #include <vlc_plugin.h>
 #include <vlc_codec.h>
+#include <vlc_cpu.h>
 #include <vlc_timestamp_helper.h>
 
 #include <errno.h>
@@ -85,6 +86,7 @@ typedef struct
     Dav1dSettings s;
     Dav1dContext *c;
     cc_data_t cc;
+    struct vlc_cpu_share *cpu_share;
 } decoder_sys_t;
 
 struct user_data_s
@@ -418,6 +420,15 @@ static int Decode(decoder_t *dec, block_t *block)
     return i_ret;
 }
 
+/* Threads from the share of the process CPU budget */
+static int GetThreads(decoder_sys_t *p_sys)
+{
+    p_sys->cpu_share = vlc_cpu_share_Join(0);
+    if (p_sys->cpu_share == NULL)
+        return __MAX(1, vlc_GetCPUCount());
+    return vlc_cpu_share_Threads(p_sys->cpu_share);
+}
+
 /*****************************************************************************
  * OpenDecoder: probe the decoder
  *****************************************************************************/
@@ -433,10 +444,11 @@ static int OpenDecoder(vlc_object_t *p_this)
         return VLC_ENOMEM;
 
     dav1d_default_settings(&p_sys->s);
+    p_sys->cpu_share = NULL;
 #if DAV1D_API_VERSION_MAJOR >= 6
     p_sys->s.n_threads = var_InheritInteger(p_this, "dav1d-thread-frames");
     if (p_sys->s.n_threads == 0)
-        p_sys->s.n_threads = __MAX(1, vlc_GetCPUCount());
+        p_sys->s.n_threads = GetThreads(p_sys);
 
 #if DAV1D_API_VERSION_MAJOR > 6 || DAV1D_API_VERSION_MINOR >= 7
     // after dav1d 1.0.0
@@ -464,7 +476,7 @@ static int OpenDecoder(vlc_object_t *p_this)
         p_sys->s.n_tile_threads = VLC_CLIP(vlc_GetCPUCount(), 1, 4);
     p_sys->s.n_frame_threads = var_InheritInteger(p_this, "dav1d-thread-frames");
     if (p_sys->s.n_frame_threads == 0)
-        p_sys->s.n_frame_threads = __MAX(1, vlc_GetCPUCount());
+        p_sys->s.n_frame_threads = GetThreads(p_sys);
 #endif
     p_sys->s.all_layers = var_InheritBool( p_this, "dav1d-all-layers" );
     p_sys->s.allocator.cookie = dec;
@@ -510,6 +522,7 @@ static int OpenDecoder(vlc_object_t *p_this)
     if (dav1d_open(&p_sys->c, &p_sys->s) < 0)
     {
         msg_Err(p_this, "Could not open the Dav1d decoder");
+        vlc_cpu_share_Leave(p_sys->cpu_share);
         return VLC_EGENERIC;
     }
 
@@ -574,4 +587,5 @@ static void CloseDecoder(vlc_object_t *p_this)
     FlushDecoder(dec);
 
     dav1d_close(&p_sys->c);
+    vlc_cpu_share_Leave(p_sys->cpu_share);
 }
@@ -31,6 +31,7 @@
 #include <vlc_configuration.h>
 #include <vlc_plugin.h>
 #include <vlc_codec.h>
+#include <vlc_cpu.h>
 
 #include <vpx/vpx_decoder.h>
 #include <vpx/vp8dx.h>
@@ -114,6 +115,7 @@ static void vpx_err_msg(vlc_object_t *this, struct vpx_codec_ctx *ctx,
 typedef struct
 {
     struct vpx_codec_ctx ctx;
+    struct vlc_cpu_share *cpu_share;
 } decoder_sys_t;
 
 static const struct
@@ -339,8 +341,16 @@ static int OpenDecoder(vlc_object_t *p_this)
     dec->p_sys = sys;
 
     int i_thread_count = var_InheritInteger(p_this, "vpx-threads");
+    sys->cpu_share = NULL;
+    if (i_thread_count == 0)
+    {
+        sys->cpu_share = vlc_cpu_share_Join(16);
+        i_thread_count = sys->cpu_share != NULL
+                       ? (int)vlc_cpu_share_Threads(sys->cpu_share)
+                       : __MIN(vlc_GetCPUCount(), 16);
+    }
     struct vpx_codec_dec_cfg deccfg = {
-        .threads = i_thread_count ? i_thread_count : __MIN(vlc_GetCPUCount(), 16)
+        .threads = i_thread_count
     };
 
     msg_Dbg(p_this, "VP%d: using libvpx version %s (build options %s)",
@@ -348,6 +358,7 @@ static int OpenDecoder(vlc_object_t *p_this)
 
     if (vpx_codec_dec_init(&sys->ctx, iface, &deccfg, 0) != VPX_CODEC_OK) {
         VPX_ERR(p_this, &sys->ctx, "Failed to initialize decoder");
+        vlc_cpu_share_Leave(sys->cpu_share);
         free(sys);
         return VLC_EGENERIC;
     }
@@ -384,6 +395,7 @@ static void CloseDecoder(vlc_object_t *p_this)
 
     vpx_codec_destroy(&sys->ctx);
 
+    vlc_cpu_share_Leave(sys->cpu_share);
     free(sys);
 }
 
@@ -396,6 +408,7 @@ typedef struct
 {
     struct vpx_codec_ctx ctx;
     unsigned long quality;
+    struct vlc_cpu_share *cpu_share;
 } encoder_sys_t;
 
 /*****************************************************************************
@@ -440,7 +453,10 @@ static int OpenEncoder(vlc_object_t *p_this)
 
     struct vpx_codec_enc_cfg enccfg = {0};
     vpx_codec_enc_config_default(iface, &enccfg, 0);
-    enccfg.g_threads = __MIN(vlc_GetCPUCount(), 4);
+    p_sys->cpu_share = vlc_cpu_share_Join(4);
+    enccfg.g_threads = p_sys->cpu_share != NULL
+                     ? vlc_cpu_share_Threads(p_sys->cpu_share)
+                     : __MIN(vlc_GetCPUCount(), 4);
     enccfg.g_w = p_enc->fmt_in.video.i_visible_width;
     enccfg.g_h = p_enc->fmt_in.video.i_visible_height;
 
@@ -480,6 +496,7 @@ static int OpenEncoder(vlc_object_t *p_this)
 
     return VLC_SUCCESS;
 error:
+    vlc_cpu_share_Leave(p_sys->cpu_share);
     free(p_sys);
     return VLC_EGENERIC;
 }
@@ -608,6 +625,7 @@ static void CloseEncoder(encoder_t *p_enc)
     encoder_sys_t *p_sys = p_enc->p_sys;
     if (vpx_codec_destroy(&p_sys->ctx))
         VPX_ERR(&p_enc->obj, &p_sys->ctx, "Failed to destroy codec");
+    vlc_cpu_share_Leave(p_sys->cpu_share);
     free(p_sys);
 }
 
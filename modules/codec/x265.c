@@ -33,6 +33,7 @@
 #include <vlc_threads.h>
 #include <vlc_sout.h>
 #include <vlc_codec.h>
+#include <vlc_cpu.h>
 
 #include <x265.h>
 
@@ -59,6 +60,7 @@ typedef struct
     x265_param      param;
 
     unsigned        frame_count;
+    struct vlc_cpu_share *cpu_share;
 #ifndef NDEBUG
     vlc_tick_t      start;
 #endif
@@ -163,7 +165,10 @@ static int  Open (vlc_object_t *p_this)
     x265_param *param = &p_sys->param;
     x265_param_default(param);
 
-    param->frameNumThreads = vlc_GetCPUCount();
+    p_sys->cpu_share = vlc_cpu_share_Join(X265_MAX_FRAME_THREADS);
+    param->frameNumThreads = p_sys->cpu_share != NULL
+                           ? vlc_cpu_share_Threads(p_sys->cpu_share)
+                           : vlc_GetCPUCount();
     if(param->frameNumThreads > X265_MAX_FRAME_THREADS)
         param->frameNumThreads = X265_MAX_FRAME_THREADS;
     param->bEnableWavefront = 0; // buggy in x265, use frame threading for now
@@ -190,11 +195,13 @@ static int  Open (vlc_object_t *p_this)
     if (param->sourceWidth & (param->maxCUSize - 1)) {
         msg_Err(p_enc, "Width (%d) must be a multiple of %d",
             param->sourceWidth, param->maxCUSize);
+        vlc_cpu_share_Leave(p_sys->cpu_share);
         free(p_sys);
         return VLC_EGENERIC;
     }
     if (param->sourceHeight & 7) {
         msg_Err(p_enc, "Height (%d) must be a multiple of 8", param->sourceHeight);
+        vlc_cpu_share_Leave(p_sys->cpu_share);
         free(p_sys);
         return VLC_EGENERIC;
     }
@@ -207,9 +214,11 @@ static int  Open (vlc_object_t *p_this)
     p_sys->h = x265_encoder_open(param);
     if (p_sys->h == NULL) {
         msg_Err(p_enc, "cannot open x265 encoder");
+        vlc_cpu_share_Leave(p_sys->cpu_share);
         free(p_sys);
         return VLC_EGENERIC;
     }
+    p_enc->p_sys = p_sys; /* for Close() on error */
 
     x265_nal *nal;
     uint32_t i_nal;
@@ -258,5 +267,6 @@ static void Close(encoder_t *p_enc)
 
     x265_encoder_close(p_sys->h);
 
+    vlc_cpu_share_Leave(p_sys->cpu_share);
     free(p_sys);
 }
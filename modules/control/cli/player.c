@@ -910,6 +910,8 @@ static int Statistics(struct cli_client *cl, const char *const *args,
                    item->p_stats->i_demux_corrupted);
         cli_printf(cl, _("| discontinuities  :    %5"PRIi64),
                   item->p_stats->i_demux_discontinuity);
+        cli_printf(cl, _("| decoder buffers  : %8.0f KiB"),
+                   (float)(item->p_stats->i_decoder_fifo_bytes) / 1024.f);
         cli_printf(cl, "|");
 
         /* Video */
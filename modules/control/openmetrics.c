@@ -0,0 +1,345 @@
+/*****************************************************************************
+ * openmetrics.c: playback metrics exporter
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*
+ * Serves the playback metrics of the current item in the OpenMetrics text
+ * format, for instance for a Prometheus scraper:
+ *   vlc --extraintf openmetrics --openmetrics-host 127.0.0.1:9464
+ *   curl http://127.0.0.1:9464/metrics
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_interface.h>
+#include <vlc_input_item.h>
+#include <vlc_interrupt.h>
+#include <vlc_memstream.h>
+#include <vlc_network.h>
+#include <vlc_player.h>
+#include <vlc_playlist.h>
+#include <vlc_url.h>
+
+#ifdef HAVE_POLL_H
+# include <poll.h>
+#endif
+
+#define OPENMETRICS_PORT 9464
+/* Time given to a client to send its request, in milliseconds */
+#define OPENMETRICS_TIMEOUT 5000
+
+struct intf_sys_t
+{
+    int *listen_fds;
+    vlc_interrupt_t *interrupt;
+    vlc_thread_t thread;
+};
+
+static void PrintHistogram(struct vlc_memstream *ms, const char *name,
+                           const char *labels,
+                           const struct vlc_input_metrics_histogram *h)
+{
+    uint64_t total = 0;
+
+    for (unsigned i = 0; i < VLC_INPUT_METRICS_BUCKETS - 1; i++)
+    {
+        total += h->buckets[i];
+        vlc_memstream_printf(ms, "%s_bucket{%s%sle=\"%g\"} %"PRIu64"\n",
+                             name, labels, *labels ? "," : "",
+                    secf_from_vlc_tick(VLC_INPUT_METRICS_BUCKET_BOUND(i)),
+                             total);
+    }
+    vlc_memstream_printf(ms, "%s_bucket{%s%sle=\"+Inf\"} %"PRIu64"\n",
+                         name, labels, *labels ? "," : "", h->count);
+    vlc_memstream_printf(ms, "%s_count{%s} %"PRIu64"\n", name, labels,
+                         h->count);
+    vlc_memstream_printf(ms, "%s_sum{%s} %f\n", name, labels,
+                         secf_from_vlc_tick(h->sum));
+}
+
+static const char *CategoryName(enum es_format_category_e cat)
+{
+    switch (cat)
+    {
+        case VIDEO_ES: return "video";
+        case AUDIO_ES: return "audio";
+        case SPU_ES:   return "spu";
+        case DATA_ES:  return "data";
+        default:       return "unknown";
+    }
+}
+
+static void PrintMetrics(struct vlc_memstream *ms,
+                         const struct vlc_input_metrics *m)
+{
+    char labels[VLC_INPUT_METRICS_MAX_ES][64];
+
+    for (unsigned i = 0; i < m->es_count; i++)
+        snprintf(labels[i], sizeof (labels[i]),
+                 "es=\"%d\",type=\"%s\",codec=\"%4.4s\"", m->es[i].id,
+                 CategoryName(m->es[i].cat), (const char *)&m->es[i].codec);
+
+    vlc_memstream_puts(ms,
+        "# TYPE vlc_decoder_queue_blocks gauge\n"
+        "# HELP vlc_decoder_queue_blocks Blocks waiting to be decoded.\n");
+    for (unsigned i = 0; i < m->es_count; i++)
+        vlc_memstream_printf(ms, "vlc_decoder_queue_blocks{%s} %u\n",
+                             labels[i], m->es[i].queue_blocks);
+
+    vlc_memstream_puts(ms,
+        "# TYPE vlc_decoder_queue_bytes gauge\n"
+        "# UNIT vlc_decoder_queue_bytes bytes\n"
+        "# HELP vlc_decoder_queue_bytes Bytes waiting to be decoded.\n");
+    for (unsigned i = 0; i < m->es_count; i++)
+        vlc_memstream_printf(ms, "vlc_decoder_queue_bytes{%s} %"PRIu64"\n",
+                             labels[i], m->es[i].queue_bytes);
+
+    vlc_memstream_puts(ms,
+        "# TYPE vlc_decoder_queue_peak_bytes gauge\n"
+        "# UNIT vlc_decoder_queue_peak_bytes bytes\n"
+        "# HELP vlc_decoder_queue_peak_bytes Highest decoder queue size.\n");
+    for (unsigned i = 0; i < m->es_count; i++)
+        vlc_memstream_printf(ms,
+                             "vlc_decoder_queue_peak_bytes{%s} %"PRIu64"\n",
+                             labels[i], m->es[i].queue_peak_bytes);
+
+    vlc_memstream_puts(ms,
+        "# TYPE vlc_decoder_decode_seconds histogram\n"
+        "# UNIT vlc_decoder_decode_seconds seconds\n"
+        "# HELP vlc_decoder_decode_seconds Decoding time per block.\n");
+    for (unsigned i = 0; i < m->es_count; i++)
+        PrintHistogram(ms, "vlc_decoder_decode_seconds", labels[i],
+                       &m->es[i].decode_time);
+
+    vlc_memstream_puts(ms,
+        "# TYPE vlc_demux_stall_seconds histogram\n"
+        "# UNIT vlc_demux_stall_seconds seconds\n"
+        "# HELP vlc_demux_stall_seconds Demuxer calls blocked waiting for "
+        "data.\n");
+    PrintHistogram(ms, "vlc_demux_stall_seconds", "", &m->demux_stalls);
+
+    vlc_memstream_printf(ms,
+        "# TYPE vlc_demux_probe_seconds gauge\n"
+        "# UNIT vlc_demux_probe_seconds seconds\n"
+        "# HELP vlc_demux_probe_seconds Time spent finding the demuxer.\n"
+        "vlc_demux_probe_seconds %f\n",
+        secf_from_vlc_tick(m->demux_probe_time));
+
+    vlc_memstream_printf(ms,
+        "# TYPE vlc_vout_displayed_pictures counter\n"
+        "vlc_vout_displayed_pictures_total %"PRIu64"\n"
+        "# TYPE vlc_vout_late_pictures counter\n"
+        "vlc_vout_late_pictures_total %"PRIu64"\n"
+        "# TYPE vlc_vout_dropped_pictures counter\n"
+        "vlc_vout_dropped_pictures_total %"PRIu64"\n",
+        m->displayed_pictures, m->late_pictures, m->dropped_pictures);
+
+    vlc_memstream_puts(ms,
+        "# TYPE vlc_vout_lateness_seconds histogram\n"
+        "# UNIT vlc_vout_lateness_seconds seconds\n"
+        "# HELP vlc_vout_lateness_seconds Lateness of the late and dropped "
+        "pictures.\n");
+    PrintHistogram(ms, "vlc_vout_lateness_seconds", "", &m->lateness);
+
+    if (m->aout_drift != VLC_TICK_INVALID)
+        vlc_memstream_printf(ms,
+            "# TYPE vlc_aout_drift_seconds gauge\n"
+            "# UNIT vlc_aout_drift_seconds seconds\n"
+            "vlc_aout_drift_seconds %f\n", secf_from_vlc_tick(m->aout_drift));
+    vlc_memstream_printf(ms,
+        "# TYPE vlc_aout_resampling_ratio gauge\n"
+        "vlc_aout_resampling_ratio %f\n", m->aout_resampling);
+}
+
+static input_item_t *HoldCurrentItem(intf_thread_t *intf)
+{
+    vlc_playlist_t *playlist = vlc_intf_GetMainPlaylist(intf);
+    vlc_player_t *player = vlc_playlist_GetPlayer(playlist);
+
+    vlc_player_Lock(player);
+    input_item_t *item = vlc_player_GetCurrentMedia(player);
+    if (item != NULL)
+        input_item_Hold(item);
+    vlc_player_Unlock(player);
+    return item;
+}
+
+static void Serve(intf_thread_t *intf, int fd)
+{
+    char req[1024];
+    struct pollfd ufd = { .fd = fd, .events = POLLIN };
+
+    /* Neither wait forever for a silent client, nor past the closing */
+    if (vlc_poll_i11e(&ufd, 1, OPENMETRICS_TIMEOUT) <= 0)
+        return;
+
+    ssize_t len = recv(fd, req, sizeof (req) - 1, MSG_DONTWAIT);
+
+    if (len <= 0)
+        return;
+    req[len] = '\0';
+
+    const char *status = "200 OK";
+    struct vlc_memstream body;
+
+    vlc_memstream_open(&body);
+    if (strncmp(req, "GET ", 4))
+        status = "405 Method Not Allowed";
+    else
+    if (strncmp(req + 4, "/ ", 2) && strncmp(req + 4, "/metrics ", 9)
+     && strncmp(req + 4, "/metrics?", 9))
+        status = "404 Not Found";
+    else
+    {
+        input_item_t *item = HoldCurrentItem(intf);
+        struct vlc_input_metrics metrics;
+
+        if (item != NULL)
+        {
+            /* Does not lock the input nor the player */
+            if (input_item_GetMetrics(item, &metrics))
+                PrintMetrics(&body, &metrics);
+            input_item_Release(item);
+        }
+        vlc_memstream_puts(&body, "# EOF\n");
+    }
+
+    if (vlc_memstream_close(&body))
+        return;
+
+    char *header;
+    int hlen = asprintf(&header, "HTTP/1.0 %s\r\n"
+        "Content-Type: application/openmetrics-text; version=1.0.0; "
+        "charset=utf-8\r\n"
+        "Content-Length: %zu\r\n"
+        "Connection: close\r\n\r\n", status, body.length);
+    if (hlen >= 0)
+    {
+        net_Write(intf, fd, header, hlen);
+        net_Write(intf, fd, body.ptr, body.length);
+        free(header);
+    }
+    free(body.ptr);
+}
+
+static void *Run(void *data)
+{
+    intf_thread_t *intf = data;
+    intf_sys_t *sys = intf->p_sys;
+
+    vlc_thread_set_name("vlc-openmetrics");
+    vlc_interrupt_set(sys->interrupt);
+
+    for (;;)
+    {
+        int fd = net_Accept(intf, sys->listen_fds);
+        if (fd == -1)
+            continue;
+
+        int canc = vlc_savecancel();
+        Serve(intf, fd);
+        net_Close(fd);
+        vlc_restorecancel(canc);
+    }
+    vlc_assert_unreachable();
+}
+
+static int Open(vlc_object_t *obj)
+{
+    intf_thread_t *intf = (intf_thread_t *)obj;
+    intf_sys_t *sys = malloc(sizeof (*sys));
+    if (unlikely(sys == NULL))
+        return VLC_ENOMEM;
+
+    char *host = var_InheritString(intf, "openmetrics-host");
+    char *url_str;
+    vlc_url_t url;
+
+    if (host == NULL || asprintf(&url_str, "//%s", host) < 0)
+        url_str = NULL;
+    free(host);
+    if (url_str == NULL)
+        goto error;
+
+    vlc_UrlParse(&url, url_str);
+    free(url_str);
+
+    sys->listen_fds = net_ListenTCP(obj, url.psz_host,
+                                    url.i_port ? (int)url.i_port
+                                               : OPENMETRICS_PORT);
+    if (sys->listen_fds == NULL)
+    {
+        msg_Err(intf, "cannot listen on %s port %u",
+                url.psz_host ? url.psz_host : "*",
+                url.i_port ? url.i_port : OPENMETRICS_PORT);
+        vlc_UrlClean(&url);
+        goto error;
+    }
+    vlc_UrlClean(&url);
+
+    sys->interrupt = vlc_interrupt_create();
+    if (unlikely(sys->interrupt == NULL))
+    {
+        net_ListenClose(sys->listen_fds);
+        goto error;
+    }
+
+    intf->p_sys = sys;
+    if (vlc_clone(&sys->thread, Run, intf))
+    {
+        vlc_interrupt_destroy(sys->interrupt);
+        net_ListenClose(sys->listen_fds);
+        goto error;
+    }
+    return VLC_SUCCESS;
+
+error:
+    free(sys);
+    return VLC_EGENERIC;
+}
+
+static void Close(vlc_object_t *obj)
+{
+    intf_thread_t *intf = (intf_thread_t *)obj;
+    intf_sys_t *sys = intf->p_sys;
+
+    /* Aborts the request being served, if any, then the wait for the next */
+    vlc_interrupt_kill(sys->interrupt);
+    vlc_cancel(sys->thread);
+    vlc_join(sys->thread, NULL);
+    vlc_interrupt_destroy(sys->interrupt);
+    net_ListenClose(sys->listen_fds);
+    free(sys);
+}
+
+#define HOST_TEXT N_("Listening address")
+#define HOST_LONGTEXT N_("Address and port the metrics are served on.")
+
+vlc_module_begin()
+    set_shortname(N_("OpenMetrics"))
+    set_description(N_("OpenMetrics playback metrics exporter"))
+    set_subcategory(SUBCAT_INTERFACE_CONTROL)
+    add_string("openmetrics-host", "127.0.0.1:9464", HOST_TEXT, HOST_LONGTEXT)
+    set_capability("interface", 0)
+    set_callbacks(Open, Close)
+vlc_module_end()
@@ -81,6 +81,20 @@ static void Close   (vlc_object_t *);
 #define ADAPT_ACCESS_TEXT N_("Use regular HTTP modules")
 #define ADAPT_ACCESS_LONGTEXT N_("Connect using HTTP access instead of custom HTTP code")
 
+#define ADAPT_PARALLEL_TEXT N_("Parallel segment downloads")
+#define ADAPT_PARALLEL_LONGTEXT N_("Maximum number of segments downloaded " \
+    "at once. Requests share a single connection with HTTP/2 servers.")
+
+#define ADAPT_CACHE_TEXT N_("Segments cache size (KiB)")
+#define ADAPT_CACHE_LONGTEXT N_("Memory kept for the downloaded segments, " \
+    "which are not downloaded again when seeking back or switching back " \
+    "to a representation.")
+
+#define ADAPT_DISKCACHE_TEXT N_("Segments disk cache size (MiB)")
+#define ADAPT_DISKCACHE_LONGTEXT N_("Disk space for the segments evicted " \
+    "from the memory cache, in a temporary file of the cache directory. " \
+    "0 disables it.")
+
 #define ADAPT_LOWLATENCY_TEXT N_("Low latency")
 #define ADAPT_LOWLATENCY_LONGTEXT N_("Overrides low latency parameters")
 
@@ -141,6 +155,12 @@ vlc_module_begin ()
         add_integer( "adaptive-maxbuffer",
                      MS_FROM_VLC_TICK(AbstractBufferingLogic::DEFAULT_MAX_BUFFERING),
                      ADAPT_MAXBUFFER_TEXT, nullptr )
+        add_integer_with_range( "adaptive-http-parallel", 3, 1, 8,
+                                ADAPT_PARALLEL_TEXT, ADAPT_PARALLEL_LONGTEXT )
+        add_integer( "adaptive-cache-size", 16384,
+                     ADAPT_CACHE_TEXT, ADAPT_CACHE_LONGTEXT )
+        add_integer( "adaptive-cache-disk", 0,
+                     ADAPT_DISKCACHE_TEXT, ADAPT_DISKCACHE_LONGTEXT )
         add_integer( "adaptive-lowlatency", -1, ADAPT_LOWLATENCY_TEXT, ADAPT_LOWLATENCY_LONGTEXT )
             change_integer_list(rgi_latency, ppsz_latency)
         set_callbacks( Open, Close )
@@ -34,6 +34,7 @@
 #include <vlc_block.h>
 
 #include <algorithm>
+#include <cassert>
 
 using namespace adaptive::http;
 using vlc::threads::mutex_locker;
@@ -155,6 +156,7 @@ HTTPChunkSource::HTTPChunkSource(const std::string& url, AbstractConnectionManag
 {
     prepared = false;
     eof = false;
+    transferredAtStart = 0;
     sourceid = id;
     setUseAccess(access);
     setIdentifier(url, range);
@@ -235,6 +237,7 @@ block_t * HTTPChunkSource::read(size_t readsize)
     {
         p_block->i_buffer = (size_t) ret;
         consumed += p_block->i_buffer;
+        connManager->accountTransfer(ret);
         if((size_t)ret < readsize)
         {
             eof = true;
@@ -244,7 +247,7 @@ block_t * HTTPChunkSource::read(size_t readsize)
            downloadEndTime > requestStartTime && type == ChunkType::Segment)
         {
             connManager->updateDownloadRate(sourceid,
-                                            connection->getBytesRead(),
+                                            getLinkSize(connection->getBytesRead(), consumed),
                                             downloadEndTime - requestStartTime,
                                             downloadEndTime - responseTime);
         }
@@ -269,7 +272,7 @@ std::string HTTPChunkSource::getContentType() const
     if(connection)
         return connection->getContentType();
     else
-        return std::string();
+        return contentType;
 }
 
 void HTTPChunkSource::setIdentifier(const std::string &s, const BytesRange &r)
@@ -277,6 +280,17 @@ void HTTPChunkSource::setIdentifier(const std::string &s, const BytesRange &r)
     storeid =  makeStorageID(s, r);
 }
 
+/* Parallel transfers share the link: scale the size of this transfer by the
+   bytes received by all of them in the meantime, so that the observer gets
+   the aggregated throughput and not a fraction of it */
+size_t HTTPChunkSource::getLinkSize(size_t size, size_t received) const
+{
+    const uint64_t total = connManager->getTransferred() - transferredAtStart;
+    if(received == 0 || total <= received)
+        return size;
+    return size * total / received;
+}
+
 bool HTTPChunkSource::prepare()
 {
     if(prepared)
@@ -288,6 +302,7 @@ bool HTTPChunkSource::prepare()
     ConnectionParams connparams = params; /* can be changed on 301 */
 
     requestStartTime = vlc_tick_now();
+    transferredAtStart = connManager->getTransferred();
 
     unsigned int i_redirects = 0;
     while(i_redirects++ < http::MAX_REDIRECTS)
@@ -299,6 +314,24 @@ bool HTTPChunkSource::prepare()
                 break;
         }
 
+        /* Playlists and keys block the playback, then the init segments
+           without which the media segments cannot be parsed */
+        switch(getChunkType())
+        {
+            case ChunkType::Playlist:
+            case ChunkType::Key:
+                connection->setUrgency(1, false);
+                break;
+            case ChunkType::Init:
+            case ChunkType::Index:
+                connection->setUrgency(2, false);
+                break;
+            case ChunkType::Segment:
+            default:
+                connection->setUrgency(3, true);
+                break;
+        }
+
         requeststatus = connection->request(connparams.getPath(), bytesRange);
         if(requeststatus != RequestStatus::Success)
         {
@@ -339,10 +372,13 @@ HTTPChunkBufferedSource::HTTPChunkBufferedSource(const std::string& url, Abstrac
     buffered     (0)
 {
     done = false;
+    complete = false;
     eof = false;
     held = false;
     p_read = nullptr;
     inblockreadoffset = 0;
+    activeBytes = 0;
+    activeTime = 0;
 }
 
 HTTPChunkBufferedSource::~HTTPChunkBufferedSource()
@@ -386,6 +422,7 @@ void HTTPChunkBufferedSource::release()
 
 void HTTPChunkBufferedSource::bufferize(size_t readsize)
 {
+    bool progressive;
     {
         mutex_locker locker {lock};
         if(!prepare())
@@ -401,6 +438,11 @@ void HTTPChunkBufferedSource::bufferize(size_t readsize)
 
         if(contentLength && readsize > contentLength - buffered)
             readsize = contentLength - buffered;
+
+        /* Unknown length means chunked transfer, ie. low latency CMAF
+           segments still being produced: hand out data as it arrives
+           instead of waiting for a full read */
+        progressive = (contentLength == 0);
     }
 
     block_t *p_block = block_Alloc(readsize);
@@ -417,22 +459,40 @@ void HTTPChunkBufferedSource::bufferize(size_t readsize)
         vlc_tick_t latency;
     } rate = {0,0,0};
 
-    ssize_t ret = connection->read(p_block->p_buffer, readsize);
+    const vlc_tick_t readStartTime = vlc_tick_now();
+    ssize_t ret = progressive ? connection->readPartial(p_block->p_buffer, readsize)
+                              : connection->read(p_block->p_buffer, readsize);
+    const vlc_tick_t readEndTime = vlc_tick_now();
+
+    if(ret > 0 && progressive && (size_t) ret < readsize / 2)
+    {
+        /* don't keep mostly empty blocks in the read cache */
+        block_t *p_fit = block_Alloc(ret);
+        if(p_fit)
+        {
+            memcpy(p_fit->p_buffer, p_block->p_buffer, ret);
+            block_Release(p_block);
+            p_block = p_fit;
+        }
+    }
+
     if(ret <= 0)
     {
         block_Release(p_block);
         p_block = nullptr;
         mutex_locker locker {lock};
         done = true;
+        /* A read error or a connection closed early is not the content */
+        complete = contentLength ? buffered == contentLength : ret == 0;
         downloadEndTime = vlc_tick_now();
-        rate.size = buffered;
-        rate.time = downloadEndTime - requestStartTime;
+        getDownloadRate(&rate.size, &rate.time);
         rate.latency = responseTime - requestStartTime;
         avail.signal();
     }
     else
     {
         p_block->i_buffer = (size_t) ret;
+        connManager->accountTransfer(ret);
         mutex_locker locker {lock};
         buffered += p_block->i_buffer;
         block_ChainLastAppend(&pp_tail, p_block);
@@ -441,12 +501,14 @@ void HTTPChunkBufferedSource::bufferize(size_t readsize)
             p_read = p_block;
             inblockreadoffset = 0;
         }
-        if((size_t) ret < readsize)
+        if(progressive)
+            accountRead((size_t) ret, readEndTime - readStartTime);
+        if(!progressive && (size_t) ret < readsize)
         {
             done = true;
+            complete = (buffered == contentLength);
             downloadEndTime = vlc_tick_now();
-            rate.size = buffered;
-            rate.time = downloadEndTime - requestStartTime;
+            getDownloadRate(&rate.size, &rate.time);
             rate.latency = responseTime - requestStartTime;
         }
         avail.signal();
@@ -459,18 +521,88 @@ void HTTPChunkBufferedSource::bufferize(size_t readsize)
     }
 }
 
+void HTTPChunkBufferedSource::accountRead(size_t size, vlc_tick_t duration)
+{
+    /* A read blocking longer than the idle gap threshold was mostly waiting
+       for the server to produce the next chunk, not for the network: only
+       its first part is accounted as transfer time, but its data still is,
+       so that a slow link still lowers the estimate. */
+    if(duration > IDLE_GAP_THRESHOLD)
+        duration = IDLE_GAP_THRESHOLD;
+    activeBytes += size;
+    activeTime += duration;
+}
+
+void HTTPChunkBufferedSource::getDownloadRate(size_t *size, vlc_tick_t *time) const
+{
+    /* Trickled transfers: leave out the server idle gaps between chunks,
+       otherwise they would collapse the estimate */
+    if(activeTime > 0 && activeBytes >= IDLE_GAP_MIN_BYTES)
+    {
+        *size = getLinkSize(activeBytes, buffered);
+        *time = activeTime;
+    }
+    else
+    {
+        *size = getLinkSize(buffered, buffered);
+        *time = downloadEndTime - requestStartTime;
+    }
+}
+
 bool HTTPChunkBufferedSource::hasMoreData() const
 {
     mutex_locker locker {lock};
     return !eof;
 }
 
-void HTTPChunkBufferedSource::recycle()
+void HTTPChunkBufferedSource::restore(block_t *p_data, const std::string &type)
 {
+    mutex_locker locker {lock};
+    assert(p_head == nullptr);
+    block_ChainLastAppend(&pp_tail, p_data);
     p_read = p_head;
-    inblockreadoffset = 0;
-    consumed = 0;
+    block_ChainProperties(p_head, nullptr, &buffered, nullptr);
     contentLength = buffered;
+    contentType = type;
+    prepared = true;
+    done = true;
+    complete = true;
+}
+
+block_t * HTTPChunkBufferedSource::detach()
+{
+    mutex_locker locker {lock};
+    block_t *p_data = p_head;
+    p_head = nullptr;
+    pp_tail = &p_head;
+    p_read = nullptr;
+    inblockreadoffset = 0;
+    buffered = 0;
+    return p_data;
+}
+
+void HTTPChunkBufferedSource::recycle()
+{
+    {
+        mutex_locker locker {lock};
+        p_read = p_head;
+        inblockreadoffset = 0;
+        consumed = 0;
+        eof = false;
+        /* Only a complete download can be served again */
+        if(done && !held && complete)
+        {
+            contentLength = buffered;
+            /* Hand the connection back, the content is all there */
+            if(connection)
+            {
+                contentType = connection->getContentType();
+                connection->setUsed(false);
+                connection = nullptr;
+            }
+        }
+        else contentLength = 0;
+    }
     connManager->recycleSource(this);
 }
 
@@ -524,7 +656,7 @@ block_t * HTTPChunkBufferedSource::read(size_t readsize)
         copied += toconsume;
         readsize -= toconsume;
         inblockreadoffset += toconsume;
-        if(inblockreadoffset >= p_head->i_buffer)
+        if(inblockreadoffset >= p_read->i_buffer)
         {
             p_read = p_read->p_next;
             inblockreadoffset = 0;
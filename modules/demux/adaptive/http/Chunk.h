@@ -139,6 +139,7 @@ namespace adaptive
 
                 virtual bool        prepare();
                 void                setIdentifier(const std::string &, const BytesRange &);
+                size_t              getLinkSize(size_t, size_t) const;
                 AbstractConnection    *connection;
                 AbstractConnectionManager *connManager;
                 mutable vlc::threads::mutex lock;
@@ -146,9 +147,11 @@ namespace adaptive
                 bool                prepared;
                 bool                eof;
                 ID                  sourceid;
+                std::string         contentType; /* once the connection is released */
                 vlc_tick_t          requestStartTime;
                 vlc_tick_t          responseTime;
                 vlc_tick_t          downloadEndTime;
+                uint64_t            transferredAtStart;
 
             private:
                 bool init(const std::string &);
@@ -159,6 +162,7 @@ namespace adaptive
         {
             friend class HTTPConnectionManager;
             friend class Downloader;
+            friend class SegmentCache;
 
             public:
                 virtual ~HTTPChunkBufferedSource();
@@ -172,20 +176,30 @@ namespace adaptive
                                         const ID &, ChunkType, const BytesRange &,
                                         bool = false);
                 void               bufferize(size_t);
+                void               restore(block_t *, const std::string &);
+                block_t *          detach();
                 bool               isDone() const;
                 void               hold();
                 void               release();
 
+                static const vlc_tick_t IDLE_GAP_THRESHOLD = VLC_TICK_FROM_MS(50);
+                static const size_t IDLE_GAP_MIN_BYTES = 65536;
+
             private:
+                void               accountRead(size_t, vlc_tick_t);
+                void               getDownloadRate(size_t *, vlc_tick_t *) const;
                 block_t            *p_head; /* read cache buffer */
                 block_t           **pp_tail;
                 const block_t      *p_read;
                 size_t              inblockreadoffset;
                 size_t              buffered; /* read cache size */
                 bool                done;
+                bool                complete; /* all the content, no error */
                 bool                eof;
                 vlc::threads::condition_variable avail;
                 bool                held;
+                size_t              activeBytes; /* chunked transfers rate */
+                vlc_tick_t          activeTime;
         };
 
         class HTTPChunk : public AbstractChunk
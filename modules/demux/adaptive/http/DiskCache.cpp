@@ -0,0 +1,329 @@
+/*
+ * DiskCache.cpp
+ *****************************************************************************
+ * Copyright (C) 2026 - VideoLAN Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "DiskCache.hpp"
+
+#include <vlc_block.h>
+#include <vlc_fs.h>
+#ifdef _WIN32
+# include <windows.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <vector>
+#include <unistd.h>
+
+using namespace adaptive::http;
+using vlc::threads::mutex_locker;
+
+/* Positioned I/O, as the file offset is shared by the cache and demux
+   threads */
+#ifdef _WIN32
+static ssize_t writeAt(int fd, const void *buf, size_t len, uint64_t offset)
+{
+    HANDLE handle = (HANDLE)(intptr_t)_get_osfhandle(fd);
+    OVERLAPPED olap = {};
+    olap.Offset = (DWORD)(offset & 0xFFFFFFFF);
+    olap.OffsetHigh = (DWORD)(offset >> 32);
+    DWORD written;
+    if(!WriteFile(handle, buf, (DWORD)std::min(len, (size_t)MAXDWORD),
+                  &written, &olap))
+    {
+        errno = EIO;
+        return -1;
+    }
+    return written;
+}
+
+static ssize_t readAt(int fd, void *buf, size_t len, uint64_t offset)
+{
+    HANDLE handle = (HANDLE)(intptr_t)_get_osfhandle(fd);
+    OVERLAPPED olap = {};
+    olap.Offset = (DWORD)(offset & 0xFFFFFFFF);
+    olap.OffsetHigh = (DWORD)(offset >> 32);
+    DWORD read;
+    if(!ReadFile(handle, buf, (DWORD)std::min(len, (size_t)MAXDWORD),
+                 &read, &olap))
+    {
+        errno = EIO;
+        return -1;
+    }
+    return read;
+}
+#else
+static ssize_t writeAt(int fd, const void *buf, size_t len, uint64_t offset)
+{
+    return pwrite(fd, buf, len, offset);
+}
+
+static ssize_t readAt(int fd, void *buf, size_t len, uint64_t offset)
+{
+    return pread(fd, buf, len, offset);
+}
+#endif
+
+DiskCache::DiskCache(const std::string &dir, size_t maxsize_)
+{
+    fd = -1;
+    maxsize = maxsize_;
+    usage = 0;
+    writepos = 0;
+    pendingsize = 0;
+    running = false;
+    killed = false;
+    if(maxsize == 0)
+        return;
+
+    std::string name = dir + DIR_SEP "adaptive-XXXXXX";
+    std::vector<char> tmpl(name.begin(), name.end());
+    tmpl.push_back('\0');
+    fd = vlc_mkstemp(tmpl.data());
+    if(fd == -1)
+        return;
+
+    /* Nothing to clean up afterwards, even after a crash, where the
+       system allows removing an opened file */
+    if(vlc_unlink(tmpl.data()) != 0)
+        path = tmpl.data();
+
+    running = !vlc_clone(&thread, writerThread, this);
+}
+
+DiskCache::~DiskCache()
+{
+    if(running)
+    {
+        lock.lock();
+        killed = true;
+        wait_cond.signal();
+        lock.unlock();
+        vlc_join(thread, nullptr);
+    }
+
+    for(Pending &p : pending)
+        block_ChainRelease(p.p_data);
+
+    if(fd != -1)
+        close(fd);
+    if(!path.empty())
+        vlc_unlink(path.c_str());
+}
+
+bool DiskCache::isValid() const
+{
+    return fd != -1;
+}
+
+void DiskCache::remove(const StorageID &id)
+{
+    auto it = std::find_if(entries.begin(), entries.end(),
+                           [&id](const Entry &e) { return e.id == id; });
+    if(it != entries.end())
+    {
+        usage -= it->size;
+        entries.erase(it);
+    }
+}
+
+void * DiskCache::writerThread(void *opaque)
+{
+    vlc_thread_set_name("vlc-adapt-disk");
+    static_cast<DiskCache *>(opaque)->Run();
+    return nullptr;
+}
+
+void DiskCache::Run()
+{
+    lock.lock();
+    while(!killed)
+    {
+        if(pending.empty())
+        {
+            wait_cond.wait(lock);
+            continue;
+        }
+
+        Pending p = pending.front();
+        pending.pop_front();
+        pendingsize -= p.size;
+        writing = p.id;
+        lock.unlock();
+        put(p.id, p.p_data, p.contenttype);
+        block_ChainRelease(p.p_data);
+        lock.lock();
+        writing.clear();
+        written_cond.broadcast();
+    }
+    lock.unlock();
+}
+
+void DiskCache::store(const StorageID &id, block_t *p_chain,
+                      const std::string &contenttype)
+{
+    size_t size;
+    block_ChainProperties(p_chain, nullptr, &size, nullptr);
+
+    mutex_locker locker {lock};
+    /* Drop what the disk cannot keep up with */
+    if(!running || size == 0 || pendingsize + size > maxsize)
+    {
+        block_ChainRelease(p_chain);
+        return;
+    }
+
+    pending.push_back(Pending{id, p_chain, size, contenttype});
+    pendingsize += size;
+    wait_cond.signal();
+}
+
+bool DiskCache::put(const StorageID &id, const block_t *p_chain,
+                    const std::string &contenttype)
+{
+    size_t size = 0;
+    for(const block_t *p = p_chain; p; p = p->p_next)
+        size += p->i_buffer;
+
+    if(fd == -1 || size == 0 || size > maxsize)
+        return false;
+
+    /* Reserve the region */
+    lock.lock();
+    remove(id);
+
+    if(writepos + size > maxsize)
+        writepos = 0;
+
+    /* Drop whatever the new entry overwrites */
+    for(auto it = entries.begin(); it != entries.end();)
+    {
+        if(it->offset < writepos + size && writepos < it->offset + it->size)
+        {
+            usage -= it->size;
+            it = entries.erase(it);
+        }
+        else ++it;
+    }
+
+    const uint64_t offset = writepos;
+    entries.push_back(Entry{id, offset, size, contenttype, false});
+    usage += size;
+    writepos += size;
+    lock.unlock();
+
+    uint64_t pos = offset;
+    bool b_ok = true;
+    for(const block_t *p = p_chain; p && b_ok; p = p->p_next)
+    {
+        size_t written = 0;
+        while(written < p->i_buffer)
+        {
+            ssize_t ret = writeAt(fd, &p->p_buffer[written],
+                                  p->i_buffer - written, pos);
+            if(ret < 0 && errno == EINTR)
+                continue;
+            if(ret <= 0)
+            {
+                b_ok = false;
+                break;
+            }
+            written += ret;
+            pos += ret;
+        }
+    }
+
+    /* Only readable once written, unless dropped meanwhile */
+    mutex_locker locker {lock};
+    auto it = std::find_if(entries.begin(), entries.end(),
+                           [&id, offset](const Entry &e) {
+                               return e.id == id && e.offset == offset && !e.valid;
+                           });
+    if(it == entries.end())
+        return false;
+    if(!b_ok)
+    {
+        usage -= it->size;
+        entries.erase(it);
+        return false;
+    }
+    it->valid = true;
+    return true;
+}
+
+block_t * DiskCache::get(const StorageID &id, std::string *contenttype)
+{
+    mutex_locker locker {lock};
+
+    while(!writing.empty() && writing == id)
+        written_cond.wait(lock);
+
+    /* Not written yet: still in memory */
+    auto pit = std::find_if(pending.begin(), pending.end(),
+                            [&id](const Pending &p) { return p.id == id; });
+    if(pit != pending.end())
+    {
+        block_t *p_data = pit->p_data;
+        *contenttype = pit->contenttype;
+        pendingsize -= pit->size;
+        pending.erase(pit);
+        return p_data;
+    }
+
+    auto it = std::find_if(entries.begin(), entries.end(),
+                           [&id](const Entry &e) { return e.id == id; });
+    if(it == entries.end() || !it->valid)
+        return nullptr;
+
+    /* Moves back to memory */
+    Entry entry = *it;
+    usage -= entry.size;
+    entries.erase(it);
+
+    block_t *p_block = block_Alloc(entry.size);
+    if(!p_block)
+        return nullptr;
+
+    size_t total = 0;
+    while(total < entry.size)
+    {
+        ssize_t ret = readAt(fd, &p_block->p_buffer[total], entry.size - total,
+                             entry.offset + total);
+        if(ret < 0 && errno == EINTR)
+            continue;
+        if(ret <= 0)
+        {
+            block_Release(p_block);
+            return nullptr;
+        }
+        total += ret;
+    }
+
+    *contenttype = entry.contenttype;
+    return p_block;
+}
+
+size_t DiskCache::getUsage() const
+{
+    mutex_locker locker {lock};
+    return usage;
+}
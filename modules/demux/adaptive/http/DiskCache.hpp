@@ -0,0 +1,94 @@
+/*
+ * DiskCache.hpp
+ *****************************************************************************
+ * Copyright (C) 2026 - VideoLAN Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifndef DISKCACHE_HPP
+#define DISKCACHE_HPP
+
+#include "Chunk.h"
+
+#include <vlc_common.h>
+#include <vlc_threads.h>
+#include <vlc_cxx_helpers.hpp>
+
+#include <list>
+#include <string>
+
+namespace adaptive
+{
+    namespace http
+    {
+        /* Second tier of the chunks cache: the chunks evicted from memory
+           are appended to a single temporary file used as a ring, so that
+           the oldest entries get overwritten first. An entry read back
+           leaves the file, and is appended again on its next eviction.
+           Chunks given to store() are written by the cache thread, away
+           from the demux thread. The lock only guards the bookkeeping:
+           the file region is reserved first, then written without it. */
+        class DiskCache
+        {
+            public:
+                DiskCache(const std::string &dir, size_t maxsize);
+                ~DiskCache();
+                bool     isValid() const;
+                bool     put(const StorageID &, const block_t *,
+                             const std::string &contenttype);
+                void     store(const StorageID &, block_t *,
+                               const std::string &contenttype);
+                block_t *get(const StorageID &, std::string *contenttype);
+                size_t   getUsage() const;
+
+            private:
+                struct Entry
+                {
+                    StorageID id;
+                    uint64_t offset;
+                    size_t size;
+                    std::string contenttype;
+                    bool valid; /* written */
+                };
+                struct Pending
+                {
+                    StorageID id;
+                    block_t *p_data;
+                    size_t size;
+                    std::string contenttype;
+                };
+                static void * writerThread(void *);
+                void Run();
+                void remove(const StorageID &);
+                mutable vlc::threads::mutex lock;
+                vlc::threads::condition_variable wait_cond;
+                vlc::threads::condition_variable written_cond;
+                std::list<Entry> entries;
+                std::list<Pending> pending; /* not written yet */
+                StorageID writing; /* being written */
+                size_t pendingsize;
+                vlc_thread_t thread;
+                bool running;
+                bool killed;
+                std::string path;
+                int fd;
+                size_t maxsize;
+                size_t usage;
+                uint64_t writepos;
+        };
+    }
+}
+
+#endif // DISKCACHE_HPP
@@ -29,22 +29,21 @@
 
 using namespace adaptive::http;
 
-Downloader::Downloader()
+Downloader::Downloader(unsigned threads)
 {
     killed = false;
-    thread_handle_valid = false;
-    current = nullptr;
-    cancel_current = false;
+    thread_count = threads ? threads : 1;
 }
 
 bool Downloader::start()
 {
-    if(!thread_handle_valid &&
-       vlc_clone(&thread_handle, downloaderThread, static_cast<void *>(this)))
+    while(thread_handles.size() < thread_count)
     {
-        return false;
+        vlc_thread_t th;
+        if(vlc_clone(&th, downloaderThread, static_cast<void *>(this)))
+            return !thread_handles.empty();
+        thread_handles.push_back(th);
     }
-    thread_handle_valid = true;
     return true;
 }
 
@@ -52,15 +51,15 @@ Downloader::~Downloader()
 {
     kill();
 
-    if(thread_handle_valid)
-        vlc_join(thread_handle, nullptr);
+    for(vlc_thread_t th : thread_handles)
+        vlc_join(th, nullptr);
 }
 
 void Downloader::kill()
 {
     vlc::threads::mutex_locker locker {lock};
     killed = true;
-    wait_cond.signal();
+    wait_cond.broadcast();
 }
 
 void Downloader::schedule(HTTPChunkBufferedSource *source)
@@ -74,10 +73,11 @@ void Downloader::schedule(HTTPChunkBufferedSource *source)
 void Downloader::cancel(HTTPChunkBufferedSource *source)
 {
     vlc::threads::mutex_locker locker {lock};
-    while (current == source)
+    if(isCurrent(source))
     {
-        cancel_current = true;
-        updated_cond.wait(lock);
+        cancelled.push_back(source);
+        while(isCurrent(source))
+            updated_cond.wait(lock);
     }
 
     if(!source->isDone())
@@ -87,6 +87,24 @@ void Downloader::cancel(HTTPChunkBufferedSource *source)
     }
 }
 
+bool Downloader::isCurrent(const HTTPChunkBufferedSource *source) const
+{
+    for(const HTTPChunkBufferedSource *src : current)
+        if(src == source)
+            return true;
+    return false;
+}
+
+/* Queue order is priority order: each thread takes the first source
+ * that no other thread is downloading */
+HTTPChunkBufferedSource * Downloader::getNext() const
+{
+    for(HTTPChunkBufferedSource *source : chunks)
+        if(!isCurrent(source))
+            return source;
+    return nullptr;
+}
+
 void * Downloader::downloaderThread(void *opaque)
 {
     vlc_thread_set_name("vlc-adapt-dl");
@@ -101,7 +119,8 @@ void Downloader::Run()
     {
         lock.lock();
 
-        while(chunks.empty() && !killed)
+        HTTPChunkBufferedSource *source;
+        while((source = getNext()) == nullptr && !killed)
             wait_cond.wait(lock);
 
         if(killed)
@@ -110,18 +129,22 @@ void Downloader::Run()
             break;
         }
 
-        current = chunks.front();
+        current.push_back(source);
         lock.unlock();
-        current->bufferize(HTTPChunkSource::CHUNK_SIZE);
+        source->bufferize(HTTPChunkSource::CHUNK_SIZE);
         lock.lock();
-        if(current->isDone() || cancel_current)
+        current.remove(source);
+        const size_t pending = cancelled.size();
+        cancelled.remove(source);
+        const bool b_cancel = cancelled.size() != pending;
+        if(source->isDone() || b_cancel)
         {
-            chunks.pop_front();
-            current->release();
+            chunks.remove(source);
+            source->release();
         }
-        cancel_current = false;
-        current = nullptr;
-        updated_cond.signal();
+        else /* available again for any thread */
+            wait_cond.signal();
+        updated_cond.broadcast();
         lock.unlock();
     }
 }
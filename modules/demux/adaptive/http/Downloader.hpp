@@ -26,6 +26,7 @@
 #include <vlc_threads.h>
 #include <vlc_cxx_helpers.hpp>
 #include <list>
+#include <vector>
 
 namespace adaptive
 {
@@ -36,7 +37,7 @@ namespace adaptive
         class Downloader
         {
             public:
-                Downloader();
+                Downloader(unsigned = 1);
                 ~Downloader();
                 bool start();
                 void schedule(HTTPChunkBufferedSource *);
@@ -46,15 +47,18 @@ namespace adaptive
                 static void * downloaderThread(void *);
                 void Run();
                 void kill();
-                vlc_thread_t thread_handle;
+                HTTPChunkBufferedSource * getNext() const;
+                bool isCurrent(const HTTPChunkBufferedSource *) const;
+                std::vector<vlc_thread_t> thread_handles;
+                unsigned     thread_count;
                 vlc::threads::mutex lock;
                 vlc::threads::condition_variable wait_cond;
                 vlc::threads::condition_variable updated_cond;
-                bool         thread_handle_valid;
                 bool         killed;
-                bool         cancel_current;
                 std::list<HTTPChunkBufferedSource *> chunks;
-                HTTPChunkBufferedSource *current;
+                /* sources being downloaded, one per thread */
+                std::list<HTTPChunkBufferedSource *> current;
+                std::list<HTTPChunkBufferedSource *> cancelled;
         };
 
     }
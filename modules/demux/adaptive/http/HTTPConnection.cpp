@@ -46,6 +46,8 @@ AbstractConnection::AbstractConnection(vlc_object_t *p_object_)
     available = true;
     bytesRead = 0;
     contentLength = 0;
+    urgency = 3;
+    incremental = false;
 }
 
 AbstractConnection::~AbstractConnection()
@@ -63,6 +65,17 @@ bool AbstractConnection::prepare(const ConnectionParams &params_)
     return true;
 }
 
+void AbstractConnection::setUrgency(unsigned u, bool i)
+{
+    urgency = u;
+    incremental = i;
+}
+
+ssize_t AbstractConnection::readPartial(void *p_buffer, size_t len)
+{
+    return read(p_buffer, len);
+}
+
 size_t AbstractConnection::getContentLength() const
 {
     return contentLength;
@@ -88,15 +101,19 @@ class adaptive::http::LibVLCHTTPSource : public adaptive::AbstractSource
      friend class LibVLCHTTPConnection;
 
      public:
-        LibVLCHTTPSource(vlc_object_t *p_object, struct vlc_http_cookie_jar_t *jar)
+        LibVLCHTTPSource(vlc_object_t *p_object, struct vlc_http_cookie_jar_t *jar,
+                         struct vlc_http_mgr *shared)
         {
-            http_mgr = vlc_http_mgr_create(p_object, jar);
+            http_mgr = shared ? shared : vlc_http_mgr_create(p_object, jar);
+            owned = (shared == nullptr);
             http_res = nullptr;
             totalRead = 0;
+            urgency = 3;
+            incremental = false;
         }
         virtual ~LibVLCHTTPSource()
         {
-            if(http_mgr)
+            if(http_mgr && owned)
                 vlc_http_mgr_destroy(http_mgr);
         }
         block_t *readNextBlock() override
@@ -132,6 +149,10 @@ class adaptive::http::LibVLCHTTPSource : public adaptive::AbstractSource
         {
             vlc_http_msg_add_header(req, "Accept-Encoding", "deflate, gzip");
             vlc_http_msg_add_header(req, "Cache-Control", "no-cache");
+            /* RFC 9218, lets an HTTP/2 server order the multiplexed responses */
+            if(vlc_http_msg_add_header(req, "Priority", incremental ? "u=%u, i" : "u=%u",
+                                       urgency))
+                return -1;
             if(range.isValid())
             {
                 if(range.getEndByte() > 0)
@@ -186,12 +207,16 @@ class adaptive::http::LibVLCHTTPSource : public adaptive::AbstractSource
         static const struct vlc_http_resource_cbs callbacks;
         size_t totalRead;
         struct vlc_http_mgr *http_mgr;
+        bool owned;
         BytesRange range;
+        unsigned urgency;
+        bool incremental;
 
     public:
         struct vlc_http_resource *http_res;
         int create(const char *uri,const std::string &ua,
-                   const std::string &ref, const BytesRange &range)
+                   const std::string &ref, const BytesRange &range,
+                   unsigned urgency, bool incremental)
         {
             auto *tpl = static_cast<struct restuple *>(
                 std::malloc(sizeof(struct restuple)));
@@ -200,6 +225,8 @@ class adaptive::http::LibVLCHTTPSource : public adaptive::AbstractSource
 
             tpl->source = this;
             this->range = range;
+            this->urgency = urgency;
+            this->incremental = incremental;
             if (vlc_http_res_init(&tpl->resource, &this->callbacks, http_mgr, uri,
                                   ua.empty() ? nullptr : ua.c_str(),
                                   ref.empty() ? nullptr : ref.c_str()))
@@ -239,10 +266,13 @@ const struct vlc_http_resource_cbs LibVLCHTTPSource::callbacks =
     LibVLCHTTPSource::validateresponse_handler,
 };
 
-LibVLCHTTPConnection::LibVLCHTTPConnection(vlc_object_t *p_object_, AuthStorage *auth)
+LibVLCHTTPConnection::LibVLCHTTPConnection(vlc_object_t *p_object_, AuthStorage *auth,
+                                           LibVLCHTTPConnectionFactory *factory_,
+                                           struct vlc_http_mgr *shared)
     : AbstractConnection( p_object_ )
 {
-    source = new adaptive::http::LibVLCHTTPSource(p_object_, auth->getJar());
+    factory = factory_;
+    source = new adaptive::http::LibVLCHTTPSource(p_object_, auth->getJar(), shared);
     sourceStream = new ChunksSourceStream(p_object, source);
     stream = nullptr;
     char *psz_useragent = var_InheritString(p_object_, "http-user-agent");
@@ -307,7 +337,8 @@ RequestStatus LibVLCHTTPConnection::request(const std::string &path,
     else
         msg_Dbg(p_object, "Retrieving %s", params.getUrl().c_str());
 
-    if(source->create(params.getUrl().c_str(), useragent,referer, range))
+    if(source->create(params.getUrl().c_str(), useragent,referer, range,
+                      urgency, incremental))
         return RequestStatus::GenericError;
 
     struct vlc_credential crd;
@@ -336,6 +367,12 @@ RequestStatus LibVLCHTTPConnection::request(const std::string &path,
         return RequestStatus::GenericError;
     }
 
+    /* The server multiplexes: the next connections to this origin will
+       send their requests through this manager instead of their own */
+    if(source->owned && vlc_http_mgr_is_multiplexed(source->http_mgr) &&
+       factory->share(params, source->http_mgr))
+        source->owned = false;
+
     char *psz_realm = nullptr;
     if (status == 401) /* authentication */
     {
@@ -424,6 +461,13 @@ ssize_t LibVLCHTTPConnection::read(void *p_buffer, size_t len)
     return read;
 }
 
+ssize_t LibVLCHTTPConnection::readPartial(void *p_buffer, size_t len)
+{
+    ssize_t read = vlc_stream_ReadPartial(stream, p_buffer, len);
+    bytesRead = source->totalRead;
+    return read;
+}
+
 void LibVLCHTTPConnection::setUsed( bool b )
 {
     available = !b;
@@ -511,6 +555,16 @@ RequestStatus StreamUrlConnection::request(const std::string &path,
 }
 
 ssize_t StreamUrlConnection::read(void *p_buffer, size_t len)
+{
+    return doRead(p_buffer, len, false);
+}
+
+ssize_t StreamUrlConnection::readPartial(void *p_buffer, size_t len)
+{
+    return doRead(p_buffer, len, true);
+}
+
+ssize_t StreamUrlConnection::doRead(void *p_buffer, size_t len, bool partial)
 {
     if( !p_streamurl )
         return VLC_EGENERIC;
@@ -525,11 +579,12 @@ ssize_t StreamUrlConnection::read(void *p_buffer, size_t len)
     if(len > toRead)
         len = toRead;
 
-    ssize_t ret = vlc_stream_Read(p_streamurl, p_buffer, len);
+    ssize_t ret = partial ? vlc_stream_ReadPartial(p_streamurl, p_buffer, len)
+                          : vlc_stream_Read(p_streamurl, p_buffer, len);
     if(ret >= 0)
         bytesRead += ret;
 
-    if(ret < 0 || (size_t)ret < len || /* set EOF */
+    if(ret < 0 || (partial ? ret == 0 : (size_t)ret < len) || /* set EOF */
        contentLength == bytesRead )
     {
         reset();
@@ -552,13 +607,42 @@ LibVLCHTTPConnectionFactory::LibVLCHTTPConnectionFactory( AuthStorage *auth )
     authStorage = auth;
 }
 
+LibVLCHTTPConnectionFactory::~LibVLCHTTPConnectionFactory()
+{
+    for(auto &it : multiplexed)
+        vlc_http_mgr_destroy(it.second);
+}
+
+std::string LibVLCHTTPConnectionFactory::origin(const ConnectionParams &params)
+{
+    return params.getScheme() + "://" + params.getHostname() + ":" +
+           std::to_string(params.getPort());
+}
+
+bool LibVLCHTTPConnectionFactory::share(const ConnectionParams &params,
+                                        struct vlc_http_mgr *mgr)
+{
+    vlc::threads::mutex_locker locker {lock};
+    return multiplexed.emplace(origin(params), mgr).second;
+}
+
 AbstractConnection * LibVLCHTTPConnectionFactory::createConnection(vlc_object_t *p_object,
                                                                   const ConnectionParams &params)
 {
     if((params.getScheme() != "http" && params.getScheme() != "https") ||
        params.getHostname().empty())
         return nullptr;
-    return new LibVLCHTTPConnection(p_object, authStorage);
+
+    /* Without a shared HTTP/2 manager, each connection keeps its own
+       HTTP/1.1 connection alive and is pooled by the connection manager */
+    struct vlc_http_mgr *shared = nullptr;
+    {
+        vlc::threads::mutex_locker locker {lock};
+        auto it = multiplexed.find(origin(params));
+        if(it != multiplexed.end())
+            shared = it->second;
+    }
+    return new LibVLCHTTPConnection(p_object, authStorage, this, shared);
 }
 
 StreamUrlConnectionFactory::StreamUrlConnectionFactory()
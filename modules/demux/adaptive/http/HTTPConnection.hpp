@@ -28,7 +28,12 @@
 #include "ConnectionParams.hpp"
 #include "BytesRange.hpp"
 #include <vlc_common.h>
+#include <vlc_threads.h>
+#include <vlc_cxx_helpers.hpp>
 #include <string>
+#include <map>
+
+struct vlc_http_mgr;
 
 namespace adaptive
 {
@@ -37,6 +42,7 @@ namespace adaptive
     namespace http
     {
         class AuthStorage;
+        class LibVLCHTTPConnectionFactory;
 
         constexpr unsigned MAX_REDIRECTS = 3;
 
@@ -52,12 +58,16 @@ namespace adaptive
                 virtual RequestStatus request(const std::string& path,
                                               const BytesRange & = BytesRange()) = 0;
                 virtual ssize_t read        (void *p_buffer, size_t len) = 0;
+                /* returns as soon as some data is available, 0 on EOF */
+                virtual ssize_t readPartial (void *p_buffer, size_t len);
 
                 virtual size_t  getContentLength() const;
                 virtual size_t  getBytesRead() const;
                 virtual const std::string & getContentType() const;
                 virtual const ConnectionParams &getRedirection() const;
                 virtual void    setUsed( bool ) = 0;
+                /* RFC 9218 urgency of the next requests, 0 is the highest */
+                void            setUrgency(unsigned, bool incremental);
 
             protected:
                 vlc_object_t      *p_object;
@@ -68,6 +78,8 @@ namespace adaptive
                 std::string        contentType;
                 BytesRange         bytesRange;
                 size_t             bytesRead;
+                unsigned           urgency;
+                bool               incremental;
         };
 
        class LibVLCHTTPSource;
@@ -75,18 +87,22 @@ namespace adaptive
        class LibVLCHTTPConnection : public AbstractConnection
        {
             public:
-               LibVLCHTTPConnection(vlc_object_t *, AuthStorage *);
+               LibVLCHTTPConnection(vlc_object_t *, AuthStorage *,
+                                    LibVLCHTTPConnectionFactory *,
+                                    struct vlc_http_mgr *);
                virtual ~LibVLCHTTPConnection();
                bool    canReuse     (const ConnectionParams &) const override;
                RequestStatus request(const std::string& path,
                                      const BytesRange & = BytesRange()) override;
                ssize_t read         (void *p_buffer, size_t len) override;
+               ssize_t readPartial  (void *p_buffer, size_t len) override;
                void    setUsed      ( bool ) override;
 
             private:
                void reset();
                std::string useragent;
                std::string referer;
+               LibVLCHTTPConnectionFactory *factory;
                LibVLCHTTPSource *source;
                ChunksSourceStream *sourceStream;
                stream_t *stream;
@@ -103,11 +119,13 @@ namespace adaptive
                 RequestStatus request(const std::string& path,
                                       const BytesRange & = BytesRange()) override;
                 ssize_t read        (void *p_buffer, size_t len) override;
+                ssize_t readPartial (void *p_buffer, size_t len) override;
 
                 void    setUsed( bool ) override;
 
             protected:
                 void reset();
+                ssize_t doRead(void *p_buffer, size_t len, bool partial);
                 stream_t *p_streamurl;
        };
 
@@ -123,10 +141,15 @@ namespace adaptive
        {
            public:
                LibVLCHTTPConnectionFactory( AuthStorage * );
-               virtual ~LibVLCHTTPConnectionFactory() = default;
+               virtual ~LibVLCHTTPConnectionFactory();
                AbstractConnection * createConnection(vlc_object_t *, const ConnectionParams &) override;
+               bool share(const ConnectionParams &, struct vlc_http_mgr *);
            private:
+               static std::string origin(const ConnectionParams &);
                AuthStorage *authStorage;
+               /* HTTP/2 managers, shared by all the connections to an origin */
+               std::map<std::string, struct vlc_http_mgr *> multiplexed;
+               vlc::threads::mutex lock;
        };
 
        class StreamUrlConnectionFactory : public AbstractConnectionFactory
@@ -29,7 +29,12 @@
 #include "HTTPConnection.hpp"
 #include "ConnectionParams.hpp"
 #include "Downloader.hpp"
+#include "DiskCache.hpp"
+#include "SegmentCache.hpp"
 #include "../tools/Debug.hpp"
+#include <vlc_block.h>
+#include <vlc_configuration.h>
+#include <vlc_fs.h>
 #include <vlc_url.h>
 #include <vlc_http.h>
 
@@ -42,6 +47,7 @@ AbstractConnectionManager::AbstractConnectionManager(vlc_object_t *p_object_)
 {
     p_object = p_object_;
     rateObserver = nullptr;
+    transferred = 0;
 }
 
 AbstractConnectionManager::~AbstractConnectionManager()
@@ -67,6 +73,18 @@ void AbstractConnectionManager::setDownloadRateObserver(IDownloadRateObserver *o
     rateObserver = obs;
 }
 
+/* Bytes received by all the sources, so that concurrent transfers can
+   measure the throughput of the link they share */
+void AbstractConnectionManager::accountTransfer(size_t size)
+{
+    transferred += size;
+}
+
+uint64_t AbstractConnectionManager::getTransferred() const
+{
+    return transferred;
+}
+
 void AbstractConnectionManager::deleteSource(AbstractChunkSource *source)
 {
     delete source;
@@ -77,26 +95,47 @@ HTTPConnectionManager::HTTPConnectionManager    (vlc_object_t *p_object_)
       localAllowed(false)
 {
     vlc_mutex_init(&lock);
-    downloader = new Downloader();
+    /* Segments of the different streams are fetched in parallel,
+       and multiplexed when the server speaks HTTP/2 */
+    int64_t parallel = var_InheritInteger(p_object, "adaptive-http-parallel");
+    downloader = new Downloader(parallel > 0 ? parallel : 1);
     downloaderhp = new Downloader();
     downloader->start();
     downloaderhp->start();
-    cache_total = 0;
-    cache_max = 1 << 19;
+    vlc_mutex_init(&cache_lock);
+    int64_t size = var_InheritInteger(p_object, "adaptive-cache-size");
+    cache = new SegmentCache(size > 0 ? (size_t) size * 1024 : 0, 1 << 19);
+    stats = {};
+    diskcache = nullptr;
+    size = var_InheritInteger(p_object, "adaptive-cache-disk");
+    if(size > 0)
+    {
+        char *dir = config_GetUserDir(VLC_CACHE_DIR);
+        if(dir)
+        {
+            vlc_mkdir_parent(dir, 0700);
+            diskcache = new DiskCache(dir, (size_t) size << 20);
+            if(!diskcache->isValid())
+            {
+                msg_Warn(p_object, "cannot create segments disk cache in %s", dir);
+                delete diskcache;
+                diskcache = nullptr;
+            }
+            free(dir);
+        }
+    }
 }
 
 HTTPConnectionManager::~HTTPConnectionManager   ()
 {
-    while(!cache.empty())
-    {
-        HTTPChunkBufferedSource *purged = cache.back();
-        cache.pop_back();
-        assert(cache_total >= purged->contentLength);
-        cache_total -= purged->contentLength;
-        CacheDebug(msg_Dbg(p_object, "Cache DEL '%s' usage %zu bytes",
-                            purged->getStorageID().c_str(), cache_total));
-        deleteSource(purged);
-    }
+    msg_Dbg(p_object, "Cache stats: %u hits, %u from disk, %u misses, %zu KiB reused",
+            stats.hits + stats.diskhits, stats.diskhits, stats.misses, stats.bytes / 1024);
+    std::list<HTTPChunkBufferedSource *> purged;
+    cache->clear(purged);
+    for(HTTPChunkBufferedSource *source : purged)
+        deleteSource(source);
+    delete cache;
+    delete diskcache;
     delete downloader;
     delete downloaderhp;
     this->closeAllConnections();
@@ -173,71 +212,84 @@ AbstractChunkSource *HTTPConnectionManager::makeSource(const std::string &url,
                                                        const BytesRange &range)
 {
     StorageID storageid = HTTPChunkSource::makeStorageID(url, range);
+    block_t *p_data = nullptr;
+    std::string contenttype;
     switch(type)
     {
         case ChunkType::Init:
         case ChunkType::Index:
-            for(HTTPChunkBufferedSource *s : cache)
+        case ChunkType::Segment:
+        {
+            HTTPChunkBufferedSource *s = cache->get(storageid, type);
+            if(s)
             {
-                if(s->getStorageID() == storageid)
-                {
-                    cache.remove(s);
-                    assert(cache_total >= s->contentLength);
-                    cache_total -= s->contentLength;
-                    CacheDebug(msg_Dbg(p_object, "Cache GET '%s' usage %zu bytes",
-                                       storageid.c_str(), cache_total));
-                    return s;
-                }
+                vlc_mutex_locker locker(&cache_lock);
+                stats.hits++;
+                stats.bytes += s->contentLength;
+                CacheDebug(msg_Dbg(p_object, "Cache GET '%s' usage %zu bytes",
+                                   storageid.c_str(), cache->getUsage(type)));
+                return s;
             }
-            // fallthrough
-        case ChunkType::Segment:
+            /* Second chance from the disk */
+            if(diskcache)
+                p_data = diskcache->get(storageid, &contenttype);
+
+            vlc_mutex_locker locker(&cache_lock);
+            if(p_data)
+            {
+                stats.diskhits++;
+                stats.bytes += p_data->i_buffer;
+                CacheDebug(msg_Dbg(p_object, "Cache disk GET '%s'", storageid.c_str()));
+            }
+            else
+                stats.misses++;
+            break;
+        }
         case ChunkType::Key:
         case ChunkType::Playlist:
         default:
-            return new HTTPChunkBufferedSource(url, this, id, type, range);
+            break;
     }
+
+    HTTPChunkBufferedSource *source = new HTTPChunkBufferedSource(url, this, id, type, range);
+    if(p_data)
+        source->restore(p_data, contenttype);
+    return source;
 }
 
 void HTTPConnectionManager::recycleSource(AbstractChunkSource *source)
 {
-    bool b_cacheable;
-    switch(source->getChunkType())
+    std::list<HTTPChunkBufferedSource *> purged;
+    HTTPChunkBufferedSource *buf = dynamic_cast<HTTPChunkBufferedSource *>(source);
+    if(buf && cache->put(buf, purged))
     {
-        case ChunkType::Index:
-        case ChunkType::Init:
-            b_cacheable = true;
-            break;
-        case ChunkType::Key:
-        case ChunkType::Playlist:
-        case ChunkType::Segment:
-        default:
-            b_cacheable = false;
-            break;
+        CacheDebug(msg_Dbg(p_object, "Cache PUT '%s' usage %zu bytes",
+                           buf->getStorageID().c_str(),
+                           cache->getUsage(buf->getChunkType())));
+        source = nullptr;
     }
 
-    HTTPChunkBufferedSource *buf = dynamic_cast<HTTPChunkBufferedSource *>(source);
-    if(buf && b_cacheable && !buf->getStorageID().empty() &&
-       buf->contentLength && buf->contentLength < cache_max)
+    /* Evicted from memory, written to the disk by its own thread */
+    for(HTTPChunkBufferedSource *purgedsrc : purged)
     {
-        while(cache_max < cache_total + buf->contentLength)
+        if(diskcache)
         {
-            HTTPChunkBufferedSource *purged = cache.back();
-            cache.pop_back();
-            assert(cache_total >= purged->contentLength);
-            cache_total -= purged->contentLength;
-            CacheDebug(msg_Dbg(p_object, "Cache DEL '%s' usage %zu bytes",
-                               purged->getStorageID().c_str(), cache_total));
-            deleteSource(purged);
+            std::string contenttype = purgedsrc->getContentType();
+            diskcache->store(purgedsrc->getStorageID(), purgedsrc->detach(),
+                             contenttype);
         }
-        cache.push_front(buf);
-        cache_total += buf->contentLength;
-        CacheDebug(msg_Dbg(p_object, "Cache PUT '%s' usage %zu bytes",
-                           buf->getStorageID().c_str(), cache_total));
+        deleteSource(purgedsrc);
     }
-    else
+    if(source)
         deleteSource(source);
 }
 
+CacheStats HTTPConnectionManager::getCacheStats() const
+{
+    vlc_mutex_locker locker(&cache_lock);
+    return stats;
+}
+
 Downloader * HTTPConnectionManager::getDownloadQueue(const AbstractChunkSource *source) const
 {
     switch(source->getChunkType())
@@ -31,6 +31,7 @@
 #include <vlc_common.h>
 #include <vlc_threads.h>
 
+#include <atomic>
 #include <vector>
 #include <list>
 #include <string>
@@ -43,6 +44,8 @@ namespace adaptive
         class AbstractConnectionFactory;
         class AbstractConnection;
         class Downloader;
+        class DiskCache;
+        class SegmentCache;
         class AbstractChunkSource;
         class HTTPChunkBufferedSource;
         enum class ChunkType;
@@ -65,6 +68,8 @@ namespace adaptive
                 virtual void updateDownloadRate(const ID &, size_t,
                                                 vlc_tick_t, vlc_tick_t) override;
                 void setDownloadRateObserver(IDownloadRateObserver *);
+                void accountTransfer(size_t);
+                uint64_t getTransferred() const;
 
             protected:
                 void deleteSource(AbstractChunkSource *);
@@ -72,6 +77,15 @@ namespace adaptive
 
             private:
                 IDownloadRateObserver                              *rateObserver;
+                std::atomic<uint64_t>                               transferred;
+        };
+
+        struct CacheStats
+        {
+            unsigned hits;      /* served from memory */
+            unsigned diskhits;  /* served from the disk */
+            unsigned misses;
+            size_t   bytes;     /* not downloaded again */
         };
 
         class HTTPConnectionManager : public AbstractConnectionManager
@@ -91,6 +105,7 @@ namespace adaptive
                 void cancel(AbstractChunkSource *)  override;
                 void         setLocalConnectionsAllowed();
                 void         addFactory(AbstractConnectionFactory *);
+                CacheStats   getCacheStats() const;
 
             private:
                 void    releaseAllConnections ();
@@ -102,9 +117,10 @@ namespace adaptive
                 bool                                                localAllowed;
                 AbstractConnection * reuseConnection(ConnectionParams &);
                 Downloader * getDownloadQueue(const AbstractChunkSource *) const;
-                std::list<HTTPChunkBufferedSource *> cache;
-                size_t cache_total;
-                size_t cache_max;
+                mutable vlc_mutex_t cache_lock; /* protects stats */
+                SegmentCache *cache;
+                DiskCache *diskcache;
+                CacheStats stats;
         };
     }
 }
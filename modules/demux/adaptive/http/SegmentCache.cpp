@@ -0,0 +1,138 @@
+/*
+ * SegmentCache.cpp
+ *****************************************************************************
+ * Copyright (C) 2026 - VideoLAN Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "SegmentCache.hpp"
+
+#include <cassert>
+
+using namespace adaptive::http;
+using vlc::threads::mutex_locker;
+
+SegmentCache::SegmentCache(size_t maxsize, size_t pinnedmaxsize)
+{
+    segments.total = 0;
+    segments.max = maxsize;
+    pinned.total = 0;
+    pinned.max = pinnedmaxsize;
+}
+
+SegmentCache::~SegmentCache()
+{
+    assert(segments.sources.empty() && pinned.sources.empty());
+}
+
+SegmentCache::Tier * SegmentCache::getTier(ChunkType type)
+{
+    switch(type)
+    {
+        case ChunkType::Init:
+        case ChunkType::Index:
+            return &pinned;
+        case ChunkType::Segment:
+            return &segments;
+        case ChunkType::Key:
+        case ChunkType::Playlist:
+        default:
+            return nullptr;
+    }
+}
+
+void SegmentCache::evict(Tier &tier, size_t limit,
+                         std::list<HTTPChunkBufferedSource *> &purged)
+{
+    while(tier.total > limit)
+    {
+        HTTPChunkBufferedSource *source = tier.sources.back();
+        tier.sources.pop_back();
+        assert(tier.total >= source->contentLength);
+        tier.total -= source->contentLength;
+        purged.push_back(source);
+    }
+}
+
+/* Takes over a recycled source that can be served again. The sources
+   evicted to make room, or too large for the budget, are handed back for
+   the next tier. Returns false if the source is left to the caller. */
+bool SegmentCache::put(HTTPChunkBufferedSource *source,
+                       std::list<HTTPChunkBufferedSource *> &purged)
+{
+    Tier *tier = getTier(source->getChunkType());
+    /* The content length is only kept by complete downloads */
+    if(!tier || source->getStorageID().empty() || !source->contentLength)
+        return false;
+
+    if(source->contentLength >= tier->max)
+    {
+        purged.push_back(source);
+        return true;
+    }
+
+    mutex_locker locker {lock};
+    evict(*tier, tier->max - source->contentLength, purged);
+    tier->sources.push_front(source);
+    tier->total += source->contentLength;
+    return true;
+}
+
+HTTPChunkBufferedSource * SegmentCache::get(const StorageID &id, ChunkType type)
+{
+    Tier *tier = getTier(type);
+    if(!tier)
+        return nullptr;
+
+    mutex_locker locker {lock};
+    for(auto it = tier->sources.begin(); it != tier->sources.end(); ++it)
+    {
+        HTTPChunkBufferedSource *source = *it;
+        if(source->getStorageID() == id)
+        {
+            tier->sources.erase(it);
+            assert(tier->total >= source->contentLength);
+            tier->total -= source->contentLength;
+            return source;
+        }
+    }
+    return nullptr;
+}
+
+void SegmentCache::clear(std::list<HTTPChunkBufferedSource *> &purged)
+{
+    mutex_locker locker {lock};
+    evict(segments, 0, purged);
+    evict(pinned, 0, purged);
+}
+
+size_t SegmentCache::getUsage(ChunkType type) const
+{
+    mutex_locker locker {lock};
+    switch(type)
+    {
+        case ChunkType::Init:
+        case ChunkType::Index:
+            return pinned.total;
+        case ChunkType::Segment:
+            return segments.total;
+        default:
+            return 0;
+    }
+}
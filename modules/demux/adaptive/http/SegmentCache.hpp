@@ -0,0 +1,64 @@
+/*
+ * SegmentCache.hpp
+ *****************************************************************************
+ * Copyright (C) 2026 - VideoLAN Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifndef SEGMENTCACHE_HPP
+#define SEGMENTCACHE_HPP
+
+#include "Chunk.h"
+
+#include <vlc_common.h>
+#include <vlc_cxx_helpers.hpp>
+
+#include <list>
+
+namespace adaptive
+{
+    namespace http
+    {
+        /* Memory tier of the chunks cache. Segments are kept in a LRU list,
+           while init and index chunks are pinned: they have their own
+           budget, so that segments never evict them. */
+        class SegmentCache
+        {
+            public:
+                SegmentCache(size_t maxsize, size_t pinnedmaxsize);
+                ~SegmentCache();
+                bool put(HTTPChunkBufferedSource *,
+                         std::list<HTTPChunkBufferedSource *> &);
+                HTTPChunkBufferedSource * get(const StorageID &, ChunkType);
+                void clear(std::list<HTTPChunkBufferedSource *> &);
+                size_t getUsage(ChunkType) const;
+
+            private:
+                struct Tier
+                {
+                    std::list<HTTPChunkBufferedSource *> sources; /* MRU first */
+                    size_t total;
+                    size_t max;
+                };
+                Tier * getTier(ChunkType);
+                void evict(Tier &, size_t, std::list<HTTPChunkBufferedSource *> &);
+                mutable vlc::threads::mutex lock;
+                Tier segments;
+                Tier pinned;
+        };
+    }
+}
+
+#endif // SEGMENTCACHE_HPP
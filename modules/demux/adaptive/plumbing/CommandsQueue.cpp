@@ -27,8 +27,8 @@
 #include <vlc_es_out.h>
 #include <vlc_block.h>
 #include <vlc_meta.h>
+#include <vlc_cxx_helpers.hpp>
 #include <algorithm>
-#include <set>
 
 using namespace adaptive;
 
@@ -43,6 +43,108 @@ enum
     ES_OUT_PRIVATE_COMMAND_PROGRESS,
 };
 
+/*
+ * Commands storage pool
+ */
+namespace
+{
+    class CommandsPoolStorage
+    {
+        public:
+            CommandsPoolStorage()
+            {
+                head = nullptr;
+                count = 0;
+            }
+            ~CommandsPoolStorage()
+            {
+                while( head )
+                {
+                    Slot *next = head->next;
+                    ::operator delete( head );
+                    head = next;
+                }
+            }
+
+            struct Slot
+            {
+                Slot *next;
+            };
+
+            /* Covers the commands issued per access unit */
+            static const std::size_t SLOT_SIZE =
+                    std::max( { sizeof(EsOutSendCommand),
+                                sizeof(EsOutControlPCRCommand),
+                                sizeof(EsOutMediaProgressCommand),
+                                sizeof(Slot) } );
+            static const std::size_t MAX_SLOTS = 4096;
+
+            vlc::threads::mutex lock;
+            Slot *head;
+            std::size_t count;
+    };
+
+    CommandsPoolStorage poolstorage;
+}
+
+void * CommandsPool::allocate( std::size_t size )
+{
+    if( size > CommandsPoolStorage::SLOT_SIZE )
+        return ::operator new( size, std::nothrow );
+
+    {
+        vlc::threads::mutex_locker locker( poolstorage.lock );
+        CommandsPoolStorage::Slot *slot = poolstorage.head;
+        if( slot )
+        {
+            poolstorage.head = slot->next;
+            poolstorage.count--;
+            return slot;
+        }
+    }
+
+    return ::operator new( CommandsPoolStorage::SLOT_SIZE, std::nothrow );
+}
+
+void CommandsPool::release( void *p, std::size_t size )
+{
+    if( p == nullptr )
+        return;
+
+    if( size <= CommandsPoolStorage::SLOT_SIZE )
+    {
+        vlc::threads::mutex_locker locker( poolstorage.lock );
+        if( poolstorage.count < CommandsPoolStorage::MAX_SLOTS )
+        {
+            CommandsPoolStorage::Slot *slot = new (p) CommandsPoolStorage::Slot;
+            slot->next = poolstorage.head;
+            poolstorage.head = slot;
+            poolstorage.count++;
+            return;
+        }
+    }
+
+    ::operator delete( p );
+}
+
+void * AbstractCommand::operator new( std::size_t size )
+{
+    void *p = CommandsPool::allocate( size );
+    if( p == nullptr )
+        throw std::bad_alloc();
+    return p;
+}
+
+void * AbstractCommand::operator new( std::size_t size, const std::nothrow_t & ) noexcept
+{
+    return CommandsPool::allocate( size );
+}
+
+void AbstractCommand::operator delete( void *p, std::size_t size ) noexcept
+{
+    CommandsPool::release( p, size );
+}
+
 AbstractCommand::AbstractCommand( int type_ )
 {
     type = type_;
@@ -260,15 +362,73 @@ EsOutMediaProgressCommand * CommandsFactory::createEsOutMediaProgressCommand( co
  */
 #if 0
 /* For queue printing/debugging */
-std::ostream& operator<<(std::ostream& ostr, const std::list<AbstractCommand *>& list)
+std::ostream& operator<<(std::ostream& ostr, const QueueentryRing& ring)
 {
-    for (auto &i : list) {
-        ostr << "[" << i->getType() << "]" << SEC_FROM_VLC_TICK(i->getTimes().continuous) << " ";
+    for (size_t i = 0; i < ring.size(); i++) {
+        const AbstractCommand *c = ring.at(i).second;
+        ostr << "[" << c->getType() << "]" << SEC_FROM_VLC_TICK(c->getTimes().continuous) << " ";
     }
     return ostr;
 }
 #endif
 
+QueueentryRing::QueueentryRing()
+{
+    head = 0;
+    count = 0;
+}
+
+bool QueueentryRing::empty() const
+{
+    return count == 0;
+}
+
+std::size_t QueueentryRing::size() const
+{
+    return count;
+}
+
+const Queueentry & QueueentryRing::front() const
+{
+    return storage[head];
+}
+
+const Queueentry & QueueentryRing::at( std::size_t i ) const
+{
+    return storage[(head + i) % storage.size()];
+}
+
+Queueentry QueueentryRing::pop_front()
+{
+    Queueentry entry = storage[head];
+    head = (head + 1) % storage.size();
+    count--;
+    return entry;
+}
+
+void QueueentryRing::push_back( const Queueentry &entry )
+{
+    if( count == storage.size() )
+        grow();
+    storage[(head + count) % storage.size()] = entry;
+    count++;
+}
+
+void QueueentryRing::clear()
+{
+    head = 0;
+    count = 0;
+}
+
+void QueueentryRing::grow()
+{
+    std::vector<Queueentry> larger( std::max( storage.size() * 2, std::size_t(64) ) );
+    for( std::size_t i = 0; i < count; i++ )
+        larger[i] = at( i );
+    storage.swap( larger );
+    head = 0;
+}
+
 AbstractCommandsQueue::AbstractCommandsQueue()
 {
     b_drop = false;
@@ -362,14 +522,23 @@ void CommandsQueue::Schedule( AbstractCommand *command, EsType )
     }
     else
     {
-        incoming.push_back( Queueentry(nextsequence++, command) );
+        /* Reuse the list nodes of the previous commits */
+        const Queueentry entry(nextsequence++, command);
+        if( spare.empty() )
+        {
+            incoming.push_back( entry );
+        }
+        else
+        {
+            spare.front() = entry;
+            incoming.splice( incoming.end(), spare, spare.begin() );
+        }
     }
 }
 
 Times CommandsQueue::Process( Times barrier )
 {
     Times lastdts = barrier;
-    std::set<const void *> disabled_esids;
     bool b_datasent = false;
 
     /* We need to filter the current commands list
@@ -379,16 +548,16 @@ Times CommandsQueue::Process( Times barrier )
        ex: for a target time of 2, you must dequeue <= 2 until >= PCR2
        A0,A1,A2,B0,PCR0,B1,B2,PCR2,B3,A3,PCR3
     */
-    std::list<Queueentry> output;
-    std::list<Queueentry> in;
-
-
-    in.splice( in.end(), commands );
-
-    while( !in.empty() )
+    disabled_esids.clear();
+    output.clear();
+
+    /* Entries are examined in place: the ones not for now are requeued
+       at the back, after all the ones we had on entry */
+    const std::size_t pending = commands.size();
+    std::size_t examined = 0;
+    for( ; examined < pending; examined++ )
     {
-        Queueentry entry = in.front();
-        AbstractCommand *command = entry.second;
+        AbstractCommand *command = commands.front().second;
 
         if( command->getType() == ES_OUT_PRIVATE_COMMAND_DEL && b_datasent )
             break;
@@ -399,7 +568,7 @@ Times CommandsQueue::Process( Times barrier )
         if(command->getType() == ES_OUT_SET_GROUP_PCR && command->getTimes().continuous > barrier.continuous )
             break;
 
-        in.pop_front();
+        Queueentry entry = commands.pop_front();
         b_datasent = true;
 
         if( command->getType() == ES_OUT_PRIVATE_COMMAND_SEND )
@@ -413,12 +582,15 @@ Times CommandsQueue::Process( Times barrier )
             {
                 /* ensure no more non dated for that ES is sent
                  * since we're sure that data is above barrier */
-                disabled_esids.insert( id );
+                if( std::find( disabled_esids.begin(), disabled_esids.end(), id )
+                        == disabled_esids.end() )
+                    disabled_esids.push_back( id );
                 commands.push_back( entry );
             }
             else if( command->getTimes().continuous == VLC_TICK_INVALID )
             {
-                if( disabled_esids.find( id ) == disabled_esids.end() )
+                if( std::find( disabled_esids.begin(), disabled_esids.end(), id )
+                        == disabled_esids.end() )
                     output.push_back( entry );
                 else
                     commands.push_back( entry );
@@ -432,7 +604,8 @@ Times CommandsQueue::Process( Times barrier )
     }
 
     /* push remaining ones if broke above */
-    commands.splice( commands.end(), in );
+    for( ; examined < pending; examined++ )
+        commands.push_back( commands.pop_front() );
 
     if(commands.empty() && b_draining)
         b_draining = false;
@@ -440,8 +613,7 @@ Times CommandsQueue::Process( Times barrier )
     /* Now execute our selected commands */
     while( !output.empty() )
     {
-        AbstractCommand *command = output.front().second;
-        output.pop_front();
+        AbstractCommand *command = output.pop_front().second;
 
         if( command->getType() == ES_OUT_PRIVATE_COMMAND_SEND )
         {
@@ -461,9 +633,13 @@ Times CommandsQueue::Process( Times barrier )
 
 void CommandsQueue::LockedCommit()
 {
-    /* reorder all blocks by time between 2 PCR and merge with main list */
+    /* reorder all blocks by time between 2 PCR and merge with main list.
+       The order does not only depend on the comparison, as it is not
+       transitive with non dated blocks, but on the merge sort itself */
     incoming.sort( compareCommands );
-    commands.splice( commands.end(), incoming );
+    for( const Queueentry &entry : incoming )
+        commands.push_back( entry );
+    spare.splice( spare.end(), incoming );
 }
 
 void CommandsQueue::Commit()
@@ -473,12 +649,9 @@ void CommandsQueue::Commit()
 
 void CommandsQueue::Abort( bool b_reset )
 {
-    commands.splice( commands.end(), incoming );
+    LockedCommit();
     while( !commands.empty() )
-    {
-        delete commands.front().second;
-        commands.pop_front();
-    }
+        delete commands.pop_front().second;
 
     if( b_reset )
     {
@@ -533,10 +706,9 @@ Times CommandsQueue::getBufferingLevel() const
 Times CommandsQueue::getFirstTimes() const
 {
     Times first = pcr;
-    std::list<Queueentry>::const_iterator it;
-    for( it = commands.begin(); it != commands.end(); ++it )
+    for( std::size_t i = 0; i < commands.size(); i++ )
     {
-        const Times times = (*it).second->getTimes();
+        const Times times = commands.at( i ).second->getTimes();
         if( times.continuous != VLC_TICK_INVALID )
         {
             if( times.continuous < first.continuous || first.continuous == VLC_TICK_INVALID )
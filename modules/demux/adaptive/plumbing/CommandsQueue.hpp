@@ -28,6 +28,8 @@
 
 #include <atomic>
 #include <list>
+#include <new>
+#include <vector>
 
 namespace adaptive
 {
@@ -42,6 +44,11 @@ namespace adaptive
             virtual const Times & getTimes() const;
             int getType() const;
 
+            /* commands storage is recycled, see CommandsPool */
+            static void * operator new( std::size_t );
+            static void * operator new( std::size_t, const std::nothrow_t & ) noexcept;
+            static void operator delete( void *, std::size_t ) noexcept;
+
         protected:
             AbstractCommand( int );
             Times times;
@@ -177,8 +184,38 @@ namespace adaptive
             virtual EsOutMediaProgressCommand * createEsOutMediaProgressCommand( const SegmentTimes & ) const;
     };
 
+    /* Commands are created and destroyed at the access unit rate:
+       keep a bounded number of released slots for reuse */
+    class CommandsPool
+    {
+        public:
+            static void * allocate( std::size_t );
+            static void release( void *, std::size_t );
+    };
+
     using Queueentry = std::pair<uint64_t, AbstractCommand *>;
 
+    /* Growable ring buffer. Storage is never shrunk so that
+       scheduling and processing do not allocate once warmed up */
+    class QueueentryRing
+    {
+        public:
+            QueueentryRing();
+            bool empty() const;
+            std::size_t size() const;
+            const Queueentry & front() const;
+            const Queueentry & at( std::size_t ) const;
+            Queueentry pop_front();
+            void push_back( const Queueentry & );
+            void clear();
+
+        private:
+            void grow();
+            std::vector<Queueentry> storage;
+            std::size_t head;
+            std::size_t count;
+    };
+
     class AbstractCommandsQueue
     {
         public:
@@ -228,7 +265,10 @@ namespace adaptive
             void LockedCommit();
             void LockedSetDraining();
             std::list<Queueentry> incoming;
-            std::list<Queueentry> commands;
+            std::list<Queueentry> spare; /* recycled incoming nodes */
+            QueueentryRing commands;
+            QueueentryRing output;
+            std::vector<const void *> disabled_esids;
             SegmentTimes bufferinglevel_media;
             Times bufferinglevel;
             Times pcr;
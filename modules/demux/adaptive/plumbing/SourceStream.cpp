@@ -142,6 +142,12 @@ ssize_t ChunksSourceStream::Read(uint8_t *buf, size_t size)
 
     while(i_toread && !b_eof)
     {
+        /* Partial read: don't block on the source once we have data,
+           so chunked transfers can be consumed as soon as they arrive.
+           vlc_stream_Read() will loop if it needs the full size. */
+        if(!p_block && i_copied)
+            break;
+
         if(!p_block && !(p_block = source->readNextBlock()))
         {
             b_eof = true;
@@ -0,0 +1,144 @@
+/*****************************************************************************
+ *
+ *****************************************************************************
+ * Copyright (C) 2026 VideoLabs, VideoLAN and VLC Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "../../http/DiskCache.hpp"
+
+#include "../test.hpp"
+
+#include <vlc_block.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+using namespace adaptive::http;
+
+static block_t * makeData(size_t size, uint8_t fill)
+{
+    block_t *p_block = block_Alloc(size);
+    if(p_block)
+        memset(p_block->p_buffer, fill, size);
+    return p_block;
+}
+
+static bool checkData(block_t *p_block, size_t size, uint8_t fill)
+{
+    bool ok = p_block && p_block->i_buffer == size;
+    for(size_t i = 0; ok && i < size; i++)
+        ok = p_block->p_buffer[i] == fill;
+    if(p_block)
+        block_Release(p_block);
+    return ok;
+}
+
+int DiskCache_test()
+{
+    block_t *a = makeData(400, 'a');
+    block_t *b = makeData(300, 'b');
+    block_t *c = makeData(400, 'c');
+    if(!a || !b || !c)
+        return 1;
+
+    /* chained chunks are stored as one */
+    b->p_next = makeData(100, 'b');
+    if(!b->p_next)
+        return 1;
+
+    char dir[] = "/tmp/vlc-adaptive-cache-XXXXXX";
+    if(mkdtemp(dir) == nullptr)
+    {
+        std::cerr << "DiskCache: no temporary directory, skipped" << std::endl;
+        block_Release(a);
+        block_ChainRelease(b);
+        block_Release(c);
+        return 0;
+    }
+
+    DiskCache *cache = nullptr;
+    try
+    {
+        cache = new DiskCache(dir, 1000);
+        Expect(cache->isValid());
+
+        std::string type;
+        Expect(cache->get("a", &type) == nullptr);
+        Expect(cache->put("a", a, "video/mp4"));
+        Expect(cache->put("b", b, "audio/mp4"));
+        Expect(cache->getUsage() == 800);
+
+        /* no room left after b: wraps and overwrites a */
+        Expect(cache->put("c", c, "video/mp4"));
+        Expect(cache->getUsage() == 800);
+        Expect(cache->get("a", &type) == nullptr);
+
+        Expect(checkData(cache->get("b", &type), 400, 'b'));
+        Expect(type == "audio/mp4");
+        Expect(cache->getUsage() == 400);
+        /* an entry read back leaves the cache */
+        Expect(cache->get("b", &type) == nullptr);
+
+        Expect(checkData(cache->get("c", &type), 400, 'c'));
+        Expect(cache->getUsage() == 0);
+
+        /* larger than the whole cache */
+        block_t *big = makeData(1001, 'd');
+        Expect(big);
+        Expect(!cache->put("d", big, ""));
+        block_Release(big);
+
+        /* storing again replaces */
+        Expect(cache->put("a", a, "video/mp4"));
+        Expect(cache->put("a", c, "video/mp4"));
+        Expect(cache->getUsage() == 400);
+        Expect(checkData(cache->get("a", &type), 400, 'c'));
+
+        /* stored from the cache thread, and readable meanwhile */
+        block_t *e = makeData(200, 'e');
+        Expect(e);
+        cache->store("e", e, "video/mp2t");
+        Expect(checkData(cache->get("e", &type), 200, 'e'));
+        Expect(type == "video/mp2t");
+        Expect(cache->get("e", &type) == nullptr);
+
+        /* more than the cache can keep up with is dropped */
+        block_t *f = makeData(1001, 'f');
+        Expect(f);
+        cache->store("f", f, "");
+        Expect(cache->get("f", &type) == nullptr);
+    } catch(...) {
+        delete cache;
+        rmdir(dir);
+        block_Release(a);
+        block_ChainRelease(b);
+        block_Release(c);
+        return 1;
+    }
+
+    delete cache;
+    block_Release(a);
+    block_ChainRelease(b);
+    block_Release(c);
+
+    /* the file is gone with the cache */
+    return rmdir(dir) == 0 ? 0 : 1;
+}
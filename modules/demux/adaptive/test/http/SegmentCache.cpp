@@ -0,0 +1,275 @@
+/*****************************************************************************
+ *
+ *****************************************************************************
+ * Copyright (C) 2026 VideoLabs, VideoLAN and VLC Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "../../http/SegmentCache.hpp"
+#include "../../http/HTTPConnection.hpp"
+#include "../../http/HTTPConnectionManager.h"
+
+#include "../test.hpp"
+
+#include <vlc_block.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace adaptive;
+using namespace adaptive::http;
+
+/* Serves length bytes, then ends with the last value: 0 for EOF, -1 for
+   an error. The announced content length can differ. */
+class TestConnection : public AbstractConnection
+{
+    public:
+        TestConnection() : AbstractConnection(nullptr)
+        {
+            announced = 0;
+            length = 0;
+            last = 0;
+        }
+        bool canReuse(const ConnectionParams &) const override { return false; }
+        RequestStatus request(const std::string &, const BytesRange &) override
+        {
+            contentLength = announced;
+            bytesRead = 0;
+            return RequestStatus::Success;
+        }
+        ssize_t read(void *p_buffer, size_t len) override
+        {
+            if(bytesRead >= length)
+                return last;
+            len = std::min(len, length - bytesRead);
+            memset(p_buffer, 'x', len);
+            bytesRead += len;
+            return len;
+        }
+        void setUsed(bool b) override { available = !b; }
+
+        size_t announced;
+        size_t length;
+        ssize_t last;
+};
+
+class TestSource : public HTTPChunkBufferedSource
+{
+    public:
+        TestSource(AbstractConnectionManager *manager, const std::string &url,
+                   ChunkType type)
+            : HTTPChunkBufferedSource(url, manager, ID(), type, BytesRange()) {}
+
+        using HTTPChunkBufferedSource::bufferize;
+        using HTTPChunkBufferedSource::isDone;
+
+        void fill(size_t size)
+        {
+            block_t *p_block = block_Alloc(size);
+            if(p_block)
+                restore(p_block, "");
+        }
+};
+
+class TestConnectionManager : public AbstractConnectionManager
+{
+    public:
+        TestConnectionManager(size_t maxsize, size_t pinnedmaxsize)
+            : AbstractConnectionManager(nullptr), cache(maxsize, pinnedmaxsize) {}
+        virtual ~TestConnectionManager()
+        {
+            std::list<HTTPChunkBufferedSource *> all;
+            cache.clear(all);
+            for(HTTPChunkBufferedSource *source : all)
+                deleteSource(source);
+        }
+        void closeAllConnections () override {}
+        AbstractConnection * getConnection(ConnectionParams &) override
+        {
+            connection.setUsed(true);
+            return &connection;
+        }
+        AbstractChunkSource *makeSource(const std::string &,
+                                        const ID &, ChunkType,
+                                        const BytesRange &) override
+        {
+            return nullptr;
+        }
+        void recycleSource(AbstractChunkSource *source) override
+        {
+            put(static_cast<HTTPChunkBufferedSource *>(source));
+        }
+        void start(AbstractChunkSource *) override {}
+        void cancel(AbstractChunkSource *) override {}
+
+        /* Returns the IDs of the evicted sources */
+        std::list<StorageID> put(HTTPChunkBufferedSource *source)
+        {
+            std::list<HTTPChunkBufferedSource *> purged;
+            std::list<StorageID> ids;
+            if(!cache.put(source, purged))
+                deleteSource(source);
+            for(HTTPChunkBufferedSource *purgedsrc : purged)
+            {
+                ids.push_back(purgedsrc->getStorageID());
+                deleteSource(purgedsrc);
+            }
+            return ids;
+        }
+        bool has(const StorageID &id, ChunkType type)
+        {
+            HTTPChunkBufferedSource *source = cache.get(id, type);
+            if(!source)
+                return false;
+            put(source);
+            return true;
+        }
+
+        SegmentCache cache;
+        TestConnection connection;
+};
+
+static TestSource * makeSource(TestConnectionManager *manager,
+                               const std::string &url, ChunkType type,
+                               size_t size)
+{
+    TestSource *source = new TestSource(manager, url, type);
+    source->fill(size);
+    return source;
+}
+
+static void LRU_test()
+{
+    TestConnectionManager manager(1000, 500);
+    TestSource *a = makeSource(&manager, "http://host/a", ChunkType::Segment, 400);
+    TestSource *b = makeSource(&manager, "http://host/b", ChunkType::Segment, 400);
+    TestSource *c = makeSource(&manager, "http://host/c", ChunkType::Segment, 400);
+    const StorageID ida = a->getStorageID();
+    const StorageID idb = b->getStorageID();
+    const StorageID idc = c->getStorageID();
+
+    Expect(manager.put(a).empty());
+    Expect(manager.put(b).empty());
+    Expect(manager.cache.getUsage(ChunkType::Segment) == 800);
+
+    /* a served again becomes the most recent */
+    Expect(manager.has(ida, ChunkType::Segment));
+    std::list<StorageID> evicted = manager.put(c);
+    Expect(evicted.size() == 1 && evicted.front() == idb);
+    Expect(manager.cache.getUsage(ChunkType::Segment) == 800);
+    Expect(!manager.has(idb, ChunkType::Segment));
+    Expect(manager.has(ida, ChunkType::Segment));
+    Expect(manager.has(idc, ChunkType::Segment));
+
+    /* looked up by type too */
+    Expect(!manager.has(ida, ChunkType::Init));
+
+    /* never served from memory */
+    TestSource *key = makeSource(&manager, "http://host/key", ChunkType::Key, 16);
+    manager.put(key);
+    Expect(manager.cache.getUsage(ChunkType::Key) == 0);
+}
+
+static void Pinned_test()
+{
+    TestConnectionManager manager(1000, 500);
+    TestSource *init = makeSource(&manager, "http://host/init", ChunkType::Init, 300);
+    const StorageID idinit = init->getStorageID();
+
+    Expect(manager.put(init).empty());
+    Expect(manager.cache.getUsage(ChunkType::Init) == 300);
+
+    /* segments only evict segments */
+    for(int i = 0; i < 5; i++)
+    {
+        std::string url = "http://host/seg" + std::to_string(i);
+        manager.put(makeSource(&manager, url, ChunkType::Segment, 400));
+    }
+    Expect(manager.cache.getUsage(ChunkType::Segment) == 800);
+    Expect(manager.cache.getUsage(ChunkType::Init) == 300);
+    Expect(manager.has(idinit, ChunkType::Init));
+
+    /* and init chunks only evict init chunks */
+    TestSource *index = makeSource(&manager, "http://host/index", ChunkType::Index, 300);
+    const StorageID idindex = index->getStorageID();
+    std::list<StorageID> evicted = manager.put(index);
+    Expect(evicted.size() == 1 && evicted.front() == idinit);
+    Expect(manager.cache.getUsage(ChunkType::Segment) == 800);
+    Expect(manager.has(idindex, ChunkType::Index));
+
+    /* larger than the budget: handed back right away */
+    TestSource *big = makeSource(&manager, "http://host/big", ChunkType::Init, 500);
+    const StorageID idbig = big->getStorageID();
+    evicted = manager.put(big);
+    Expect(evicted.size() == 1 && evicted.front() == idbig);
+    Expect(manager.cache.getUsage(ChunkType::Init) == 300);
+}
+
+static size_t download(TestConnectionManager &manager, size_t announced,
+                       size_t length, ssize_t last)
+{
+    manager.connection.announced = announced;
+    manager.connection.length = length;
+    manager.connection.last = last;
+
+    TestSource *source = new TestSource(&manager, "http://host/seg",
+                                        ChunkType::Segment);
+    while(!source->isDone())
+        source->bufferize(HTTPChunkSource::CHUNK_SIZE);
+    source->recycle();
+
+    size_t usage = manager.cache.getUsage(ChunkType::Segment);
+    std::list<HTTPChunkBufferedSource *> purged;
+    manager.cache.clear(purged);
+    for(HTTPChunkBufferedSource *purgedsrc : purged)
+        delete purgedsrc;
+    return usage;
+}
+
+static void Partial_test()
+{
+    TestConnectionManager manager(1000, 500);
+
+    /* read error */
+    Expect(download(manager, 300, 0, -1) == 0);
+    Expect(download(manager, 300, 100, -1) == 0);
+    /* connection closed early */
+    Expect(download(manager, 300, 100, 0) == 0);
+    /* unknown length, ended by an error */
+    Expect(download(manager, 0, 100, -1) == 0);
+
+    /* all the content */
+    Expect(download(manager, 300, 300, 0) == 300);
+    Expect(download(manager, 300, 300, -1) == 300);
+    Expect(download(manager, 0, 100, 0) == 100);
+}
+
+int SegmentCache_test()
+{
+    try
+    {
+        LRU_test();
+        Pinned_test();
+        Partial_test();
+    } catch(...) {
+        return 1;
+    }
+
+    return 0;
+}
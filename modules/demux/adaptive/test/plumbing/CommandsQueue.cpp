@@ -32,6 +32,8 @@
 #include <limits>
 #include <list>
 #include <algorithm>
+#include <chrono>
+#include <iostream>
 
 using namespace adaptive;
 
@@ -318,6 +320,34 @@ int CommandsQueue_test()
         }
         queue.Process(DT(VLC_TICK_0 + OFFSET + vlc_tick_from_sec(0)));
         Expect(esout.output.size() == 1);
+        queue.Abort(true);
+        esout.cleanup();
+
+        /* reordering around a non dated block: dated ones sort between
+           themselves even across it */
+        const vlc_tick_t reorder[3] = { VLC_TICK_0 + vlc_tick_from_sec(10),
+                                        VLC_TICK_INVALID,
+                                        VLC_TICK_0 + vlc_tick_from_sec(5) };
+        for(size_t i=0; i<3; i++)
+        {
+            block_t *data = block_Alloc(0);
+            Expect(data);
+            data->i_dts = reorder[i];
+            cmd = factory.createEsOutSendCommand(i ? id1 : id0, SegmentTimes(), data);
+            queue.Schedule(cmd);
+        }
+        queue.Commit();
+        queue.Process(Times(SegmentTimes(), std::numeric_limits<vlc_tick_t>::max()));
+        Expect(esout.output.size() == 3);
+        const size_t expected[3] = { 2, 0, 1 };
+        for(size_t i=0; i<3; i++)
+        {
+            OutputVal val = esout.output.front();
+            Expect(val.first == (expected[i] ? id1 : id0));
+            Expect(val.second->i_dts == reorder[expected[i]]);
+            block_Release(val.second);
+            esout.output.pop_front();
+        }
 
     } catch(...) {
         delete id0;
@@ -330,3 +360,82 @@ int CommandsQueue_test()
 
     return 0;
 }
+
+class CountingEsOutID : public AbstractFakeESOutID
+{
+    public:
+        CountingEsOutID() { count = 0; lastdts = VLC_TICK_INVALID; ordered = true; }
+        virtual ~CountingEsOutID() {}
+        es_out_id_t * realESID() const override { return nullptr; }
+        void create() override {}
+        void release() override {}
+        void sendData(block_t *b) override
+        {
+            if(lastdts != VLC_TICK_INVALID && b->i_dts < lastdts)
+                ordered = false;
+            lastdts = b->i_dts;
+            count++;
+            block_Release(b);
+        }
+        EsType esType() const override { return EsType::Other; }
+
+        size_t count;
+        vlc_tick_t lastdts;
+        bool ordered;
+};
+
+/* Feeds a million sends through the queue, interleaving two ES
+   and a PCR every 20 access units, as a demuxer would. Only run with
+   VLC_BENCH set, see test.cpp */
+int CommandsQueueBench_test()
+{
+    const size_t SENDS = 1000000;
+    const size_t PCR_INTERVAL = 20;
+
+    CommandsFactory factory;
+    CommandsQueue queue;
+    CountingEsOutID ids[2];
+
+    try
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        for(size_t i=0; i<SENDS; i++)
+        {
+            block_t *data = block_Alloc(0);
+            Expect(data);
+            /* second ES lags by one frame */
+            data->i_dts = VLC_TICK_0 + VLC_TICK_FROM_MS(i / 2 * 10 + (i % 2) * 5);
+            AbstractCommand *cmd = factory.createEsOutSendCommand(&ids[i % 2],
+                                                                  SegmentTimes(), data);
+            Expect(cmd);
+            queue.Schedule(cmd);
+
+            if((i + 1) % PCR_INTERVAL == 0)
+            {
+                cmd = factory.createEsOutControlPCRCommand(0, SegmentTimes(), data->i_dts);
+                Expect(cmd);
+                queue.Schedule(cmd);
+                queue.Process(queue.getBufferingLevel());
+            }
+        }
+        queue.Commit();
+        queue.Process(Times(SegmentTimes(), std::numeric_limits<vlc_tick_t>::max()));
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>
+                             (std::chrono::steady_clock::now() - start).count();
+
+        Expect(queue.isEmpty());
+        Expect(ids[0].count + ids[1].count == SENDS);
+        Expect(ids[0].ordered && ids[1].ordered);
+
+        std::cerr << "  " << SENDS << " sends in " << elapsed << " ms";
+        if(elapsed)
+            std::cerr << " (" << SENDS / elapsed << " sends/ms)";
+        std::cerr << std::endl;
+    } catch(...) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -28,11 +28,14 @@
 #include "test.hpp"
 
 #include <iostream>
+#include <cstdlib>
 
 extern const char vlc_module_name[] = "foobar";
 
 #define TEST(func) []() { std::cerr << "Testing "#func << std::endl;\
                           return func##_test(); }()
+/* Benchmarks are too long for the unit tests, opt in with VLC_BENCH=1 */
+#define BENCH(func) (getenv("VLC_BENCH") != nullptr && TEST(func))
 
 int main()
 {
@@ -47,8 +50,11 @@ int main()
     TEST(TemplatedUri) ||
     TEST(BufferingLogic) ||
     TEST(CommandsQueue) ||
+    BENCH(CommandsQueueBench) ||
     TEST(M3U8MasterPlaylist) ||
     TEST(M3U8Playlist) ||
-    TEST(SegmentTracker)
+    TEST(SegmentTracker) ||
+    TEST(DiskCache) ||
+    TEST(SegmentCache)
     ;
 }
@@ -46,8 +46,11 @@ int Conversions_test();
 int M3U8MasterPlaylist_test();
 int M3U8Playlist_test();
 int CommandsQueue_test();
+int CommandsQueueBench_test();
 int BufferingLogic_test();
 int FakeEsOut_test();
 int SegmentTracker_test();
+int DiskCache_test();
+int SegmentCache_test();
 
 #endif
@@ -44,6 +44,8 @@
 #include <vlc_codecs.h>
 #include <vlc_charset.h>
 #include <vlc_arrays.h>
+#include <vlc_interrupt.h>
+#include <vlc_threads.h>
 
 #include "libavi.h"
 #include "../rawdv.h"
@@ -65,12 +67,13 @@
 static int  Open ( vlc_object_t * );
 static void Close( vlc_object_t * );
 
-static const int pi_index[] = {0,1,2,3};
+static const int pi_index[] = {0,1,2,3,4};
 
 static const char *const ppsz_indexes[] = { N_("Ask for action"),
                                             N_("Always fix"),
                                             N_("Never fix"),
-                                            N_("Fix when necessary")};
+                                            N_("Fix when necessary"),
+                                            N_("Fix in the background")};
 
 vlc_module_begin ()
     set_shortname( "AVI" )
@@ -173,6 +176,11 @@ typedef struct
     unsigned int    i_blockno;
     unsigned int    i_blocksize;
 
+    /* After a coarse seek beyond the background index, the counters above
+     * start from this estimated date */
+    bool            b_coarse;
+    vlc_tick_t      i_coarse_date;
+
     struct
     {
         bool b_ok;
@@ -195,6 +203,8 @@ typedef struct
     bool  b_seekable;
     bool  b_fastseekable;
     bool  b_indexloaded; /* if we read indexes from end of file before starting */
+    struct avi_indexer *p_indexer; /* background index creation, if running */
+    bool  b_coarse; /* demuxing beyond the index, after a coarse seek */
     vlc_tick_t i_read_increment;
     uint32_t i_avih_flags;
     avi_chunk_t ck_root;
@@ -216,6 +226,34 @@ typedef struct
     input_attachment_t **attachment;
 } demux_sys_t;
 
+/* Background index reconstruction, scanning the LIST-movi through its own
+ * stream while the demuxer plays from the partial index */
+typedef struct avi_indexer
+{
+    vlc_thread_t    thread;
+    vlc_interrupt_t *interrupt;
+    vlc_object_t    *p_obj;
+    const char      *psz_url;
+    stream_t        *s;
+    uint64_t        i_movi_start;
+    uint64_t        i_movi_end;
+    uint64_t        i_riffx_pos; /* start of the AVIX data, 0 if none */
+    atomic_bool     b_stop;
+
+    /* copies of the track properties used by the scan, so that the thread
+     * never reads the demuxer state */
+    unsigned int    i_track;
+    bool            b_odml;
+    avi_track_t     *tracks;
+    const avi_track_t **pp_tracks;
+
+    vlc_mutex_t     lock;
+    vlc_cond_t      wait;
+    bool            b_done;
+    uint64_t        i_pos;      /* last scanned chunk */
+    avi_index_t     *pending;   /* per track entries not merged yet */
+} avi_indexer_t;
+
 #define __EVEN(x) (((x) & 1) ? (x) + 1 : (x))
 
 static int64_t AVI_PTSToChunk( avi_track_t *, vlc_tick_t i_pts );
@@ -231,12 +269,20 @@ static int AVI_StreamBytesSet ( demux_t *, avi_track_t *, uint64_t i_byte );
 vlc_fourcc_t AVI_FourccGetCodec( unsigned int i_cat, vlc_fourcc_t );
 static int   AVI_GetKeyFlag    ( const avi_track_t *, const uint8_t * );
 
-static int AVI_PacketGetHeader( demux_t *, avi_packet_t *p_pk );
-static int AVI_PacketNext     ( demux_t * );
-static int AVI_PacketSearch   ( demux_t * );
+static int AVI_PacketGetHeader( stream_t *, avi_packet_t *p_pk );
+static int AVI_PacketNext     ( stream_t * );
+static int AVI_PacketSearch   ( stream_t *, unsigned int i_track );
 
 static void AVI_IndexLoad    ( demux_t * );
 static void AVI_IndexCreate  ( demux_t * );
+static int  AVI_IndexerNew   ( demux_t * );
+static void AVI_IndexerDelete( avi_indexer_t * );
+static void AVI_IndexerMerge ( demux_t * );
+static void AVI_IndexerWait  ( demux_t *, vlc_tick_t i_date, uint64_t i_pos );
+static int  AVI_IndexerSeek  ( demux_t *, vlc_tick_t i_date, double f_ratio );
+static bool AVI_IndexerReached( demux_t *, uint64_t i_pos );
+static void AVI_CoarseStop   ( demux_sys_t * );
+static void AVI_CoarseResume ( demux_t * );
 
 static void AVI_ExtractSubtitle( demux_t *, unsigned int i_stream, avi_chunk_list_t *, avi_chunk_STRING_t * );
 static avi_track_t * AVI_GetVideoTrackForXsub( demux_sys_t * );
@@ -244,6 +290,7 @@ static int AVI_SeekSubtitleTrack( demux_sys_t *, avi_track_t * );
 
 static void AVI_DvHandleAudio( demux_t *, avi_track_t *, block_t * );
 
+static vlc_tick_t  AVI_TrackGetIndexedLength( avi_track_t * );
 static vlc_tick_t  AVI_MovieGetLength( demux_t * );
 
 static void AVI_MetaLoad( demux_t *, avi_chunk_list_t *p_riff, avi_chunk_avih_t *p_avih );
@@ -252,6 +299,7 @@ static void AVI_MetaLoad( demux_t *, avi_chunk_list_t *p_riff, avi_chunk_avih_t
  * Stream management
  *****************************************************************************/
 static int        AVI_TrackSeek  ( demux_t *, int, vlc_tick_t );
+static vlc_tick_t AVI_TracksSeek ( demux_t *, vlc_tick_t );
 static int        AVI_TrackStopFinishedStreams( demux_t *);
 
 /* Remarks:
@@ -331,6 +379,9 @@ static void Close ( vlc_object_t * p_this )
     demux_t *    p_demux = (demux_t *)p_this;
     demux_sys_t *p_sys = p_demux->p_sys  ;
 
+    if( p_sys->p_indexer )
+        AVI_IndexerDelete( p_sys->p_indexer );
+
     for( unsigned int i = 0; i < p_sys->i_track; i++ )
     {
         if( p_sys->track[i] )
@@ -776,7 +827,8 @@ static int Open( vlc_object_t * p_this )
 aviindex:
         if( p_sys->b_fastseekable )
         {
-            AVI_IndexCreate( p_demux );
+            if( i_do_index != 4 || AVI_IndexerNew( p_demux ) )
+                AVI_IndexCreate( p_demux );
         }
         else if( p_sys->b_seekable )
         {
@@ -794,6 +846,12 @@ aviindex:
 
     /* *** movie length in vlc_tick_t *** */
     p_sys->i_length = AVI_MovieGetLength( p_demux );
+    if( p_sys->p_indexer && p_sys->i_length == 0 )
+    {
+        /* Trust the header until the index is built */
+        p_sys->i_length = VLC_TICK_FROM_US( (uint64_t)p_avih->i_totalframes *
+                                            p_avih->i_microsecperframe );
+    }
 
     /* Check the index completeness */
     unsigned int i_idx_totalframes = 0;
@@ -803,13 +861,14 @@ aviindex:
         if( tk->fmt.i_cat == VIDEO_ES && tk->idx.p_entry )
             i_idx_totalframes = __MAX(i_idx_totalframes, tk->idx.i_size);
     }
-    if( i_idx_totalframes != p_avih->i_totalframes &&
+    if( p_sys->p_indexer == NULL &&
+        i_idx_totalframes != p_avih->i_totalframes &&
         p_sys->i_length < VLC_TICK_FROM_US( p_avih->i_totalframes *
                                             p_avih->i_microsecperframe ) )
     {
         msg_Warn( p_demux, "broken or missing index, 'seek' will be "
                            "approximative or will exhibit strange behavior" );
-        if( (i_do_index == 0 || i_do_index == 3) && !b_index )
+        if( (i_do_index == 0 || i_do_index == 3 || i_do_index == 4) && !b_index )
         {
             if( !p_sys->b_fastseekable ) {
                 b_index = true;
@@ -1083,6 +1142,17 @@ static int Demux_Seekable( demux_t *p_demux )
 
     unsigned int i_track_count = 0;
 
+    if( p_sys->p_indexer )
+        AVI_IndexerMerge( p_demux );
+
+    if( p_sys->b_coarse )
+    {
+        /* Read in sequence until the index reaches the current position */
+        if( !AVI_IndexerReached( p_demux, vlc_stream_Tell( p_demux->s ) ) )
+            return Demux_UnSeekable( p_demux );
+        AVI_CoarseResume( p_demux );
+    }
+
     /* detect new selected/unselected streams */
     for( unsigned int i = 0; i < p_sys->i_track; i++ )
     {
@@ -1244,7 +1314,7 @@ static int Demux_Seekable( demux_t *p_demux )
                 if (vlc_stream_Seek(p_demux->s, p_sys->i_movi_lastchunk_pos))
                     return VLC_DEMUXER_EGENERIC;
 
-                if( AVI_PacketNext( p_demux ) )
+                if( AVI_PacketNext( p_demux->s ) )
                 {
                     return( AVI_TrackStopFinishedStreams( p_demux ) ? 0 : 1 );
                 }
@@ -1259,7 +1329,7 @@ static int Demux_Seekable( demux_t *p_demux )
             {
                 avi_packet_t avi_pk;
 
-                if( AVI_PacketGetHeader( p_demux, &avi_pk ) )
+                if( AVI_PacketGetHeader( p_demux->s, &avi_pk ) )
                 {
                     msg_Warn( p_demux,
                              "cannot get packet header, track disabled" );
@@ -1268,7 +1338,7 @@ static int Demux_Seekable( demux_t *p_demux )
                 if( avi_pk.i_stream >= p_sys->i_track ||
                     ( avi_pk.i_cat != AUDIO_ES && avi_pk.i_cat != VIDEO_ES ) )
                 {
-                    if( AVI_PacketNext( p_demux ) )
+                    if( AVI_PacketNext( p_demux->s ) )
                     {
                         msg_Warn( p_demux,
                                   "cannot skip packet, track disabled" );
@@ -1302,7 +1372,7 @@ static int Demux_Seekable( demux_t *p_demux )
                     }
                     else
                     {
-                        if( AVI_PacketNext( p_demux ) )
+                        if( AVI_PacketNext( p_demux->s ) )
                         {
                             msg_Warn( p_demux,
                                       "cannot skip packet, track disabled" );
@@ -1488,7 +1558,7 @@ static int Demux_UnSeekable( demux_t *p_demux )
     {
         avi_packet_t    avi_pk;
 
-        if( AVI_PacketGetHeader( p_demux, &avi_pk ) )
+        if( AVI_PacketGetHeader( p_demux->s, &avi_pk ) )
         {
             return VLC_DEMUXER_EOF;
         }
@@ -1505,18 +1575,18 @@ static int Demux_UnSeekable( demux_t *p_demux )
                 case AVIFOURCC_JUNK:
                 case AVIFOURCC_LIST:
                 case AVIFOURCC_RIFF:
-                    return( !AVI_PacketNext( p_demux ) ? 1 : 0 );
+                    return( !AVI_PacketNext( p_demux->s ) ? 1 : 0 );
                 case AVIFOURCC_idx1:
                     if( p_sys->b_odml )
                     {
-                        return( !AVI_PacketNext( p_demux ) ? 1 : 0 );
+                        return( !AVI_PacketNext( p_demux->s ) ? 1 : 0 );
                     }
                     return VLC_DEMUXER_EOF;
                 default:
                     msg_Warn( p_demux,
                               "seems to have lost position @%"PRIu64", resync",
                               vlc_stream_Tell(p_demux->s) );
-                    if( AVI_PacketSearch( p_demux ) )
+                    if( AVI_PacketSearch( p_demux->s, p_sys->i_track ) )
                     {
                         msg_Err( p_demux, "resync failed" );
                         return VLC_DEMUXER_EGENERIC;
@@ -1547,7 +1617,7 @@ static int Demux_UnSeekable( demux_t *p_demux )
             }
             else
             {
-                if( AVI_PacketNext( p_demux ) )
+                if( AVI_PacketNext( p_demux->s ) )
                 {
                     return VLC_DEMUXER_EOF;
                 }
@@ -1610,6 +1680,11 @@ static int Seek( demux_t *p_demux, vlc_tick_t i_date, double f_ratio, bool b_acc
             p_sys->b_indexloaded = true; /* we don't want to try each time */
         }
 
+        if( p_sys->p_indexer &&
+            AVI_IndexerSeek( p_demux, i_date, f_ratio ) == VLC_SUCCESS )
+            return VLC_SUCCESS;
+        AVI_CoarseStop( p_sys );
+
         if( p_sys->i_length == 0 )
         {
             avi_track_t *p_stream = NULL;
@@ -1633,6 +1708,7 @@ static int Seek( demux_t *p_demux, vlc_tick_t i_date, double f_ratio, bool b_acc
             /* try to find chunk that is at i_percent or the file */
             i_pos = __MAX( f_ratio * stream_Size( p_demux->s ),
                            p_sys->i_movi_begin );
+            AVI_IndexerWait( p_demux, VLC_TICK_INVALID, i_pos );
             /* search first selected stream (and prefer non-EOF ones) */
             for( unsigned i = 0; i < p_sys->i_track; i++ )
             {
@@ -1674,38 +1750,9 @@ static int Seek( demux_t *p_demux, vlc_tick_t i_date, double f_ratio, bool b_acc
             msg_Dbg( p_demux, "estimate date %"PRId64, i_date );
         }
 
-        /* */
-        vlc_tick_t i_wanted = i_date;
-        vlc_tick_t i_start = i_date;
-        /* Do a 2 pass seek, first with video (can seek ahead due to keyframes),
-           so we can seek audio to the same starting time */
-        for(int i=0; i<2; i++)
-        {
-            for( unsigned i_stream = 0; i_stream < p_sys->i_track; i_stream++ )
-            {
-                avi_track_t *p_stream = p_sys->track[i_stream];
-
-                if( !p_stream->b_activated )
-                    continue;
-
-                if( (i==0 && p_stream->fmt.i_cat != VIDEO_ES) ||
-                    (i!=0 && p_stream->fmt.i_cat == VIDEO_ES) )
-                    continue;
-
-                p_stream->b_eof = AVI_TrackSeek( p_demux, i_stream, i_wanted ) != 0;
-                if( !p_stream->b_eof )
-                {
-                    p_stream->i_next_block_flags |= BLOCK_FLAG_DISCONTINUITY;
-
-                    if( p_stream->fmt.i_cat == AUDIO_ES || p_stream->fmt.i_cat == VIDEO_ES )
-                        i_start = __MIN(i_start, AVI_GetPTS( p_stream ));
+        AVI_IndexerWait( p_demux, i_date, 0 );
 
-                    if( i == 0 && p_stream->fmt.i_cat == VIDEO_ES )
-                        i_wanted = i_start;
-                }
-            }
-        }
-        p_sys->i_time = i_start;
+        p_sys->i_time = AVI_TracksSeek( p_demux, i_date );
         es_out_SetPCR( p_demux->out, VLC_TICK_0 + p_sys->i_time );
         if( b_accurate )
             es_out_Control( p_demux->out, ES_OUT_SET_NEXT_DISPLAY_TIME, VLC_TICK_0 + i_date );
@@ -1726,6 +1773,44 @@ failandresetpos:
     }
 }
 
+/* Seeks the activated tracks and returns the date they start from */
+static vlc_tick_t AVI_TracksSeek( demux_t *p_demux, vlc_tick_t i_date )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+    vlc_tick_t i_wanted = i_date;
+    vlc_tick_t i_start = i_date;
+
+    /* Do a 2 pass seek, first with video (can seek ahead due to keyframes),
+       so we can seek audio to the same starting time */
+    for(int i=0; i<2; i++)
+    {
+        for( unsigned i_stream = 0; i_stream < p_sys->i_track; i_stream++ )
+        {
+            avi_track_t *p_stream = p_sys->track[i_stream];
+
+            if( !p_stream->b_activated )
+                continue;
+
+            if( (i==0 && p_stream->fmt.i_cat != VIDEO_ES) ||
+                (i!=0 && p_stream->fmt.i_cat == VIDEO_ES) )
+                continue;
+
+            p_stream->b_eof = AVI_TrackSeek( p_demux, i_stream, i_wanted ) != 0;
+            if( !p_stream->b_eof )
+            {
+                p_stream->i_next_block_flags |= BLOCK_FLAG_DISCONTINUITY;
+
+                if( p_stream->fmt.i_cat == AUDIO_ES || p_stream->fmt.i_cat == VIDEO_ES )
+                    i_start = __MIN(i_start, AVI_GetPTS( p_stream ));
+
+                if( i == 0 && p_stream->fmt.i_cat == VIDEO_ES )
+                    i_wanted = i_start;
+            }
+        }
+    }
+    return i_start;
+}
+
 /*****************************************************************************
  * Control:
  *****************************************************************************/
@@ -1921,6 +2006,16 @@ static vlc_tick_t AVI_GetDPTS( avi_track_t *tk, int64_t i_count )
 
 static vlc_tick_t AVI_GetPTS( avi_track_t *tk )
 {
+    /* Counted from the coarse seek, as in Demux_UnSeekable */
+    if( tk->b_coarse )
+    {
+        if( tk->i_samplesize )
+            return tk->i_coarse_date + AVI_GetDPTS( tk, tk->i_idxposb );
+        if( tk->fmt.i_cat == AUDIO_ES )
+            return tk->i_coarse_date + AVI_GetDPTS( tk, tk->i_blockno );
+        return tk->i_coarse_date + AVI_GetDPTS( tk, tk->i_idxposc );
+    }
+
     /* Lookup samples index */
     if( tk->i_samplesize && tk->idx.i_size )
     {
@@ -1960,7 +2055,7 @@ static int AVI_StreamChunkFind( demux_t *p_demux, avi_track_t *tk )
     {
         if (vlc_stream_Seek(p_demux->s, p_sys->i_movi_lastchunk_pos))
             return VLC_EGENERIC;
-        if( AVI_PacketNext( p_demux ) )
+        if( AVI_PacketNext( p_demux->s ) )
         {
             return VLC_EGENERIC;
         }
@@ -1973,7 +2068,7 @@ static int AVI_StreamChunkFind( demux_t *p_demux, avi_track_t *tk )
 
     for( ;; )
     {
-        if( AVI_PacketGetHeader( p_demux, &avi_pk ) )
+        if( AVI_PacketGetHeader( p_demux->s, &avi_pk ) )
         {
             msg_Warn( p_demux, "cannot get packet header" );
             return VLC_EGENERIC;
@@ -1981,7 +2076,7 @@ static int AVI_StreamChunkFind( demux_t *p_demux, avi_track_t *tk )
         if( avi_pk.i_stream >= p_sys->i_track ||
             ( avi_pk.i_cat != AUDIO_ES && avi_pk.i_cat != VIDEO_ES ) )
         {
-            if( AVI_PacketNext( p_demux ) )
+            if( AVI_PacketNext( p_demux->s ) )
             {
                 return VLC_EGENERIC;
             }
@@ -2006,7 +2101,7 @@ static int AVI_StreamChunkFind( demux_t *p_demux, avi_track_t *tk )
                 return VLC_SUCCESS;
             }
 
-            if( AVI_PacketNext( p_demux ) )
+            if( AVI_PacketNext( p_demux->s ) )
             {
                 return VLC_EGENERIC;
             }
@@ -2318,17 +2413,17 @@ static void AVI_ParseStreamHeader( vlc_fourcc_t i_id,
 /****************************************************************************
  *
  ****************************************************************************/
-static int AVI_PacketGetHeader( demux_t *p_demux, avi_packet_t *p_pk )
+static int AVI_PacketGetHeader( stream_t *s, avi_packet_t *p_pk )
 {
     const uint8_t *p_peek;
 
-    if( vlc_stream_Peek( p_demux->s, &p_peek, 16 ) < 16 )
+    if( vlc_stream_Peek( s, &p_peek, 16 ) < 16 )
     {
         return VLC_EGENERIC;
     }
     p_pk->i_fourcc  = VLC_FOURCC( p_peek[0], p_peek[1], p_peek[2], p_peek[3] );
     p_pk->i_size    = GetDWLE( p_peek + 4 );
-    p_pk->i_pos     = vlc_stream_Tell( p_demux->s );
+    p_pk->i_pos     = vlc_stream_Tell( s );
     if( p_pk->i_fourcc == AVIFOURCC_LIST || p_pk->i_fourcc == AVIFOURCC_RIFF )
     {
         p_pk->i_type = VLC_FOURCC( p_peek[8],  p_peek[9],
@@ -2345,12 +2440,12 @@ static int AVI_PacketGetHeader( demux_t *p_demux, avi_packet_t *p_pk )
     return VLC_SUCCESS;
 }
 
-static int AVI_PacketNext( demux_t *p_demux )
+static int AVI_PacketNext( stream_t *s )
 {
     avi_packet_t    avi_ck;
     uint32_t        i_skip = 0;
 
-    if( AVI_PacketGetHeader( p_demux, &avi_ck ) )
+    if( AVI_PacketGetHeader( s, &avi_ck ) )
     {
         return VLC_EGENERIC;
     }
@@ -2377,27 +2472,26 @@ static int AVI_PacketNext( demux_t *p_demux )
         return VLC_EGENERIC;
 #endif
 
-    if( vlc_stream_Read( p_demux->s, NULL, i_skip ) != i_skip )
+    if( vlc_stream_Read( s, NULL, i_skip ) != i_skip )
     {
         return VLC_EGENERIC;
     }
     return VLC_SUCCESS;
 }
 
-static int AVI_PacketSearch( demux_t *p_demux )
+static int AVI_PacketSearch( stream_t *s, unsigned int i_track )
 {
-    demux_sys_t     *p_sys = p_demux->p_sys;
     avi_packet_t    avi_pk;
     unsigned short  i_count = 0;
 
     for( ;; )
     {
-        if( vlc_stream_Read( p_demux->s, NULL, 1 ) != 1 )
+        if( vlc_stream_Read( s, NULL, 1 ) != 1 )
         {
             return VLC_EGENERIC;
         }
-        AVI_PacketGetHeader( p_demux, &avi_pk );
-        if( avi_pk.i_stream < p_sys->i_track &&
+        AVI_PacketGetHeader( s, &avi_pk );
+        if( avi_pk.i_stream < i_track &&
             ( avi_pk.i_cat == AUDIO_ES || avi_pk.i_cat == VIDEO_ES ) )
         {
             return VLC_SUCCESS;
@@ -2412,7 +2506,7 @@ static int AVI_PacketSearch( demux_t *p_demux )
         }
 
         if( !++i_count )
-            msg_Warn( p_demux, "trying to resync..." );
+            msg_Warn( s, "trying to resync..." );
     }
 }
 
@@ -2750,6 +2844,117 @@ static void AVI_IndexLoad( demux_t *p_demux )
     }
 }
 
+/* Scans the LIST-movi from the current position of s, passing every chunk
+ * of a known track to pf_append until it returns false */
+static void AVI_IndexScan( vlc_object_t *p_obj, stream_t *s,
+                           unsigned int i_track,
+                           const avi_track_t *const *pp_tracks, bool b_odml,
+                           uint64_t i_movi_end, uint64_t i_riffx_pos,
+                           bool (*pf_append)( void *, unsigned int,
+                                              avi_entry_t * ),
+                           void *opaque )
+{
+    for( ;; )
+    {
+        avi_packet_t pk;
+
+        if( AVI_PacketGetHeader( s, &pk ) )
+            break;
+
+        if( pk.i_stream < i_track &&
+            pk.i_cat == pp_tracks[pk.i_stream]->fmt.i_cat )
+        {
+            const avi_track_t *tk = pp_tracks[pk.i_stream];
+
+            avi_entry_t index;
+            index.i_flags   = AVI_GetKeyFlag(tk, pk.i_peek);
+            index.i_pos     = pk.i_pos;
+            index.i_length  = pk.i_size;
+            index.i_lengthtotal = pk.i_size;
+            if( !pf_append( opaque, pk.i_stream, &index ) )
+                break;
+        }
+        else
+        {
+            switch( pk.i_fourcc )
+            {
+            case AVIFOURCC_idx1:
+                if( b_odml )
+                {
+                    msg_Dbg( p_obj, "looking for new RIFF chunk" );
+                    if( i_riffx_pos == 0 || vlc_stream_Seek( s, i_riffx_pos ) )
+                        return;
+                    break;
+                }
+                return;
+
+            case AVIFOURCC_RIFF:
+                    msg_Dbg( p_obj, "new RIFF chunk found" );
+                    break;
+
+            case AVIFOURCC_rec:
+            case AVIFOURCC_JUNK:
+                break;
+
+            default:
+                msg_Warn( p_obj, "need resync, probably broken avi" );
+                if( AVI_PacketSearch( s, i_track ) )
+                {
+                    msg_Warn( p_obj, "lost sync, abord index creation" );
+                    return;
+                }
+            }
+        }
+
+        if( ( !b_odml && pk.i_pos + pk.i_size >= i_movi_end ) ||
+            AVI_PacketNext( s ) )
+        {
+            break;
+        }
+    }
+}
+
+static uint64_t AVI_IndexGetRIFFXPos( demux_sys_t *p_sys )
+{
+    avi_chunk_list_t *p_sysx = AVI_ChunkFind( &p_sys->ck_root,
+                                              AVIFOURCC_RIFF, 1, true );
+    return p_sysx ? p_sysx->i_chunk_pos + 24 : 0;
+}
+
+struct avi_index_create
+{
+    demux_t         *p_demux;
+    vlc_dialog_id   *p_dialog_id;
+    vlc_tick_t      i_dialog_update;
+};
+
+static bool AVI_IndexCreateAppend( void *opaque, unsigned int i_stream,
+                                   avi_entry_t *p_entry )
+{
+    struct avi_index_create *ctx = opaque;
+    demux_t *p_demux = ctx->p_demux;
+    demux_sys_t *p_sys = p_demux->p_sys;
+
+    /* Don't update/check dialog too often */
+    if( ctx->p_dialog_id != NULL &&
+        vlc_tick_now() - ctx->i_dialog_update > VLC_TICK_FROM_MS(100) )
+    {
+        if( vlc_dialog_is_cancelled( p_demux, ctx->p_dialog_id ) )
+            return false;
+
+        double f_current = vlc_stream_Tell( p_demux->s );
+        double f_size    = stream_Size( p_demux->s );
+        double f_pos     = f_current / f_size;
+        vlc_dialog_update_progress( p_demux, ctx->p_dialog_id, f_pos );
+
+        ctx->i_dialog_update = vlc_tick_now();
+    }
+
+    avi_index_Append( &p_sys->track[i_stream]->idx,
+                      &p_sys->i_movi_lastchunk_pos, p_entry );
+    return true;
+}
+
 static void AVI_IndexCreate( demux_t *p_demux )
 {
     demux_sys_t *p_sys = p_demux->p_sys;
@@ -2760,8 +2965,7 @@ static void AVI_IndexCreate( demux_t *p_demux )
     unsigned int i_stream;
     uint32_t i_movi_end;
 
-    vlc_tick_t i_dialog_update;
-    vlc_dialog_id *p_dialog_id = NULL;
+    struct avi_index_create ctx = { .p_demux = p_demux };
 
     p_riff = AVI_ChunkFind( &p_sys->ck_root, AVIFOURCC_RIFF, 0, true );
     p_movi = AVI_ChunkFind( p_riff, AVIFOURCC_movi, 0, true );
@@ -2783,101 +2987,410 @@ static void AVI_IndexCreate( demux_t *p_demux )
 
 
     /* Only show dialog if AVI is > 10MB */
-    i_dialog_update = vlc_tick_now();
+    ctx.i_dialog_update = vlc_tick_now();
     if( stream_Size( p_demux->s ) > 10000000 )
     {
-        p_dialog_id =
+        ctx.p_dialog_id =
             vlc_dialog_display_progress( p_demux, false, 0.0, _("Cancel"),
                                          _("Broken or missing AVI Index"),
                                          _("Fixing AVI Index...") );
     }
 
-    for( ;; )
+    AVI_IndexScan( VLC_OBJECT(p_demux), p_demux->s, p_sys->i_track,
+                   (const avi_track_t *const *)p_sys->track, p_sys->b_odml,
+                   i_movi_end, AVI_IndexGetRIFFXPos( p_sys ),
+                   AVI_IndexCreateAppend, &ctx );
+
+    if( ctx.p_dialog_id != NULL )
+        vlc_dialog_release( p_demux, ctx.p_dialog_id );
+
+    for( i_stream = 0; i_stream < p_sys->i_track; i_stream++ )
     {
-        avi_packet_t pk;
+        msg_Dbg( p_demux, "stream[%d] creating %d index entries",
+                i_stream, p_sys->track[i_stream]->idx.i_size );
+    }
+}
 
-        /* Don't update/check dialog too often */
-        if( p_dialog_id != NULL && vlc_tick_now() - i_dialog_update > VLC_TICK_FROM_MS(100) )
-        {
-            if( vlc_dialog_is_cancelled( p_demux, p_dialog_id ) )
-                break;
+/*****************************************************************************
+ * Background index creation:
+ *  The indexer thread scans the LIST-movi through its own stream and queues
+ *  the entries, which the demuxer merges into the track indexes from its own
+ *  thread. Chunks found meanwhile by the demuxer itself are skipped, as the
+ *  entries of a track are always appended by increasing position.
+ *****************************************************************************/
+static bool AVI_IndexerAppend( void *opaque, unsigned int i_stream,
+                               avi_entry_t *p_entry )
+{
+    avi_indexer_t *p_indexer = opaque;
+    uint64_t i_last_pos = 0;
 
-            double f_current = vlc_stream_Tell( p_demux->s );
-            double f_size    = stream_Size( p_demux->s );
-            double f_pos     = f_current / f_size;
-            vlc_dialog_update_progress( p_demux, p_dialog_id, f_pos );
+    vlc_mutex_lock( &p_indexer->lock );
+    avi_index_Append( &p_indexer->pending[i_stream], &i_last_pos, p_entry );
+    p_indexer->i_pos = p_entry->i_pos;
+    if( p_indexer->pending[i_stream].i_size % 1024 == 0 )
+        vlc_cond_signal( &p_indexer->wait );
+    vlc_mutex_unlock( &p_indexer->lock );
 
-            i_dialog_update = vlc_tick_now();
-        }
+    return !atomic_load_explicit( &p_indexer->b_stop, memory_order_relaxed );
+}
 
-        if( AVI_PacketGetHeader( p_demux, &pk ) )
-            break;
+static void *AVI_IndexerThread( void *data )
+{
+    avi_indexer_t *p_indexer = data;
+
+    vlc_thread_set_name( "vlc-avi-index" );
+    vlc_interrupt_set( p_indexer->interrupt );
+
+    /* Opened from here, so that a slow access does not hold the demuxer */
+    p_indexer->s = vlc_stream_NewURL( p_indexer->p_obj, p_indexer->psz_url );
+    if( p_indexer->s == NULL ||
+        vlc_stream_Seek( p_indexer->s, p_indexer->i_movi_start ) )
+        msg_Warn( p_indexer->p_obj, "cannot index in the background" );
+    else
+        AVI_IndexScan( p_indexer->p_obj, p_indexer->s, p_indexer->i_track,
+                       p_indexer->pp_tracks, p_indexer->b_odml,
+                       p_indexer->i_movi_end, p_indexer->i_riffx_pos,
+                       AVI_IndexerAppend, p_indexer );
+
+    vlc_mutex_lock( &p_indexer->lock );
+    p_indexer->b_done = true;
+    vlc_cond_signal( &p_indexer->wait );
+    vlc_mutex_unlock( &p_indexer->lock );
+    return NULL;
+}
+
+static int AVI_IndexerNew( demux_t *p_demux )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+
+    avi_chunk_list_t *p_riff = AVI_ChunkFind( &p_sys->ck_root,
+                                              AVIFOURCC_RIFF, 0, true );
+    avi_chunk_list_t *p_movi = AVI_ChunkFind( p_riff, AVIFOURCC_movi, 0, true );
+
+    if( !p_movi || p_demux->psz_url == NULL )
+        return VLC_EGENERIC;
+
+    avi_indexer_t *p_indexer = malloc( sizeof(*p_indexer) );
+    if( unlikely(p_indexer == NULL) )
+        return VLC_ENOMEM;
+
+    p_indexer->pending = calloc( p_sys->i_track, sizeof(avi_index_t) );
+    p_indexer->tracks = calloc( p_sys->i_track, sizeof(avi_track_t) );
+    p_indexer->pp_tracks = calloc( p_sys->i_track, sizeof(avi_track_t *) );
+    p_indexer->interrupt = vlc_interrupt_create();
+    if( unlikely(p_indexer->pending == NULL || p_indexer->tracks == NULL ||
+                 p_indexer->pp_tracks == NULL || p_indexer->interrupt == NULL) )
+        goto error;
+
+    for( unsigned i = 0; i < p_sys->i_track; i++ )
+    {
+        avi_track_t *tk = &p_indexer->tracks[i];
+
+        tk->fmt.i_cat = p_sys->track[i]->fmt.i_cat;
+        tk->fmt.i_codec = p_sys->track[i]->fmt.i_codec;
+        tk->is_qnap = p_sys->track[i]->is_qnap;
+        p_indexer->pp_tracks[i] = tk;
+    }
+    p_indexer->i_track = p_sys->i_track;
+    p_indexer->b_odml = p_sys->b_odml;
+
+    p_indexer->p_obj = VLC_OBJECT(p_demux);
+    p_indexer->psz_url = p_demux->psz_url;
+    p_indexer->s = NULL;
+    p_indexer->i_movi_start = p_movi->i_chunk_pos + 12;
+    p_indexer->i_movi_end = __MIN( (uint32_t)(p_movi->i_chunk_pos + p_movi->i_chunk_size),
+                                   stream_Size( p_demux->s ) );
+    p_indexer->i_riffx_pos = AVI_IndexGetRIFFXPos( p_sys );
+    atomic_init( &p_indexer->b_stop, false );
+    vlc_mutex_init( &p_indexer->lock );
+    vlc_cond_init( &p_indexer->wait );
+    p_indexer->b_done = false;
+    p_indexer->i_pos = 0;
+
+    /* Start from scratch, the demuxer indexes from the beginning too */
+    for( unsigned i = 0; i < p_sys->i_track; i++ )
+    {
+        avi_index_Clean( &p_sys->track[i]->idx );
+        avi_index_Init( &p_sys->track[i]->idx );
+    }
+    p_sys->i_movi_lastchunk_pos = 0;
+    p_sys->b_indexloaded = true;
+
+    if( vlc_clone( &p_indexer->thread, AVI_IndexerThread, p_indexer ) )
+        goto error;
+
+    msg_Dbg( p_demux, "creating index from LIST-movi in the background" );
+    p_sys->p_indexer = p_indexer;
+    return VLC_SUCCESS;
+
+error:
+    if( p_indexer->interrupt )
+        vlc_interrupt_destroy( p_indexer->interrupt );
+    free( p_indexer->pp_tracks );
+    free( p_indexer->tracks );
+    free( p_indexer->pending );
+    free( p_indexer );
+    return VLC_EGENERIC;
+}
 
-        if( pk.i_stream < p_sys->i_track &&
-            pk.i_cat == p_sys->track[pk.i_stream]->fmt.i_cat )
+static void AVI_IndexerDelete( avi_indexer_t *p_indexer )
+{
+    atomic_store_explicit( &p_indexer->b_stop, true, memory_order_relaxed );
+    vlc_interrupt_kill( p_indexer->interrupt );
+    vlc_join( p_indexer->thread, NULL );
+    vlc_interrupt_destroy( p_indexer->interrupt );
+    if( p_indexer->s )
+        vlc_stream_Delete( p_indexer->s );
+
+    for( unsigned i = 0; i < p_indexer->i_track; i++ )
+        avi_index_Clean( &p_indexer->pending[i] );
+    free( p_indexer->pp_tracks );
+    free( p_indexer->tracks );
+    free( p_indexer->pending );
+    free( p_indexer );
+}
+
+static void AVI_IndexerMergeLocked( demux_t *p_demux )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+    avi_indexer_t *p_indexer = p_sys->p_indexer;
+
+    for( unsigned i = 0; i < p_sys->i_track; i++ )
+    {
+        avi_index_t *p_pending = &p_indexer->pending[i];
+        avi_index_t *p_index = &p_sys->track[i]->idx;
+
+        for( uint32_t j = 0; j < p_pending->i_size; j++ )
         {
-            avi_track_t *tk = p_sys->track[pk.i_stream];
+            avi_entry_t index = p_pending->p_entry[j];
 
-            avi_entry_t index;
-            index.i_flags   = AVI_GetKeyFlag(tk, pk.i_peek);
-            index.i_pos     = pk.i_pos;
-            index.i_length  = pk.i_size;
-            index.i_lengthtotal = pk.i_size;
-            avi_index_Append( &tk->idx, &p_sys->i_movi_lastchunk_pos, &index );
+            /* already found while demuxing */
+            if( p_index->i_size > 0 &&
+                index.i_pos <= p_index->p_entry[p_index->i_size - 1].i_pos )
+                continue;
+
+            avi_index_Append( p_index, &p_sys->i_movi_lastchunk_pos, &index );
         }
-        else
-        {
-            switch( pk.i_fourcc )
-            {
-            case AVIFOURCC_idx1:
-                if( p_sys->b_odml )
-                {
-                    avi_chunk_list_t *p_sysx;
-                    p_sysx = AVI_ChunkFind( &p_sys->ck_root,
-                                            AVIFOURCC_RIFF, 1, true );
-
-                    msg_Dbg( p_demux, "looking for new RIFF chunk" );
-                    if( !p_sysx || vlc_stream_Seek( p_demux->s,
-                                         p_sysx->i_chunk_pos + 24 ) )
-                        goto print_stat;
-                    break;
-                }
-                goto print_stat;
+        p_pending->i_size = 0;
+    }
+}
 
-            case AVIFOURCC_RIFF:
-                    msg_Dbg( p_demux, "new RIFF chunk found" );
-                    break;
+/* Moves the new entries into the track indexes, and reaps the indexer once
+ * the whole LIST-movi has been scanned */
+static void AVI_IndexerMerge( demux_t *p_demux )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+    avi_indexer_t *p_indexer = p_sys->p_indexer;
 
-            case AVIFOURCC_rec:
-            case AVIFOURCC_JUNK:
-                break;
+    vlc_mutex_lock( &p_indexer->lock );
+    AVI_IndexerMergeLocked( p_demux );
+    bool b_done = p_indexer->b_done;
+    vlc_mutex_unlock( &p_indexer->lock );
 
-            default:
-                msg_Warn( p_demux, "need resync, probably broken avi" );
-                if( AVI_PacketSearch( p_demux ) )
-                {
-                    msg_Warn( p_demux, "lost sync, abord index creation" );
-                    goto print_stat;
-                }
-            }
-        }
+    if( !b_done )
+        return;
 
-        if( ( !p_sys->b_odml && pk.i_pos + pk.i_size >= i_movi_end ) ||
-            AVI_PacketNext( p_demux ) )
-        {
+    AVI_IndexerDelete( p_indexer );
+    p_sys->p_indexer = NULL;
+
+    for( unsigned i = 0; i < p_sys->i_track; i++ )
+    {
+        msg_Dbg( p_demux, "stream[%u] created %"PRIu32" index entries",
+                 i, p_sys->track[i]->idx.i_size );
+    }
+
+    vlc_tick_t i_length = AVI_MovieGetLength( p_demux );
+    if( i_length > 0 )
+        p_sys->i_length = i_length;
+}
+
+/* Tells if the indexes of the selected tracks reach the given date */
+static bool AVI_IndexerCovers( demux_sys_t *p_sys, vlc_tick_t i_date )
+{
+    for( unsigned i = 0; i < p_sys->i_track; i++ )
+    {
+        avi_track_t *tk = p_sys->track[i];
+
+        if( !tk->b_activated ||
+            ( tk->fmt.i_cat != AUDIO_ES && tk->fmt.i_cat != VIDEO_ES ) )
+            continue;
+
+        if( AVI_TrackGetIndexedLength( tk ) <= i_date )
+            return false;
+    }
+    return true;
+}
+
+/* Waits for the background indexer to reach the seek target, when
+ * AVI_IndexerSeek() cannot estimate it: the partial index is used as is when
+ * it covers it, and scanning the end of the movi from the demuxer too would
+ * only compete with the indexer */
+static void AVI_IndexerWait( demux_t *p_demux, vlc_tick_t i_date,
+                             uint64_t i_pos )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+    avi_indexer_t *p_indexer = p_sys->p_indexer;
+
+    if( p_indexer == NULL )
+        return;
+
+    vlc_mutex_lock( &p_indexer->lock );
+    while( !p_indexer->b_done && !vlc_killed() )
+    {
+        AVI_IndexerMergeLocked( p_demux );
+        if( i_pos > 0 ? p_indexer->i_pos >= i_pos
+                      : AVI_IndexerCovers( p_sys, i_date ) )
             break;
-        }
+        vlc_cond_timedwait( &p_indexer->wait, &p_indexer->lock,
+                            vlc_tick_now() + VLC_TICK_FROM_MS(100) );
     }
+    vlc_mutex_unlock( &p_indexer->lock );
 
-print_stat:
-    if( p_dialog_id != NULL )
-        vlc_dialog_release( p_demux, p_dialog_id );
+    AVI_IndexerMerge( p_demux );
+}
 
-    for( i_stream = 0; i_stream < p_sys->i_track; i_stream++ )
+/* Tells if the background indexer scanned up to the given position */
+static bool AVI_IndexerReached( demux_t *p_demux, uint64_t i_pos )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+    avi_indexer_t *p_indexer = p_sys->p_indexer;
+
+    if( p_indexer == NULL )
+        return true;
+
+    vlc_mutex_lock( &p_indexer->lock );
+    bool b_reached = p_indexer->b_done || p_indexer->i_pos >= i_pos;
+    vlc_mutex_unlock( &p_indexer->lock );
+    return b_reached;
+}
+
+/* Serves the seeks beyond the part of the LIST-movi indexed so far, instead
+ * of waiting for the indexer: the position is estimated from the byte ratio
+ * over the movi, and the chunks are then read in sequence with estimated
+ * timestamps until the index reaches them. Fails if the index covers the
+ * target already. */
+static int AVI_IndexerSeek( demux_t *p_demux, vlc_tick_t i_date,
+                            double f_ratio )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+
+    AVI_IndexerMerge( p_demux );
+
+    avi_indexer_t *p_indexer = p_sys->p_indexer;
+    if( p_indexer == NULL || p_indexer->i_movi_end <= p_indexer->i_movi_start )
+        return VLC_EGENERIC;
+
+    const uint64_t i_movi_size = p_indexer->i_movi_end - p_indexer->i_movi_start;
+    uint64_t i_pos;
+
+    if( p_sys->i_length > 0 )
     {
-        msg_Dbg( p_demux, "stream[%d] creating %d index entries",
-                i_stream, p_sys->track[i_stream]->idx.i_size );
+        if( AVI_IndexerCovers( p_sys, i_date ) )
+            return VLC_EGENERIC;
+        i_date = __MIN( __MAX( i_date, 0 ), p_sys->i_length );
+        i_pos = p_indexer->i_movi_start +
+                i_movi_size * ( (double)i_date / p_sys->i_length );
+    }
+    else
+    {
+        /* No length to tell the date: take the bitrate of the indexed part */
+        vlc_tick_t i_indexed = 0;
+        for( unsigned i = 0; i < p_sys->i_track; i++ )
+            i_indexed = __MAX( i_indexed,
+                               AVI_TrackGetIndexedLength( p_sys->track[i] ) );
+
+        f_ratio = __MIN( __MAX( f_ratio, 0 ), 1.0 );
+        i_pos = p_indexer->i_movi_start + i_movi_size * f_ratio;
+        if( i_indexed <= 0 || i_pos <= p_sys->i_movi_lastchunk_pos ||
+            p_sys->i_movi_lastchunk_pos <= p_indexer->i_movi_start )
+            return VLC_EGENERIC;
+        i_date = i_indexed * ( (double)( i_pos - p_indexer->i_movi_start ) /
+                   ( p_sys->i_movi_lastchunk_pos - p_indexer->i_movi_start ) );
+    }
+
+    if( vlc_stream_Seek( p_demux->s, i_pos ) ||
+        AVI_PacketSearch( p_demux->s, p_sys->i_track ) )
+    {
+        msg_Warn( p_demux, "cannot resync at %"PRIu64, i_pos );
+        return VLC_EGENERIC;
     }
+
+    msg_Dbg( p_demux, "coarse seek at %"PRIu64", %"PRId64" seconds estimated",
+             vlc_stream_Tell( p_demux->s ), SEC_FROM_VLC_TICK(i_date) );
+
+    for( unsigned i = 0; i < p_sys->i_track; i++ )
+    {
+        avi_track_t *tk = p_sys->track[i];
+
+        tk->b_coarse = true;
+        tk->i_coarse_date = i_date;
+        tk->i_idxposc = 0;
+        tk->i_idxposb = 0;
+        tk->i_blockno = 0;
+        tk->b_eof = false;
+        tk->i_next_block_flags |= BLOCK_FLAG_DISCONTINUITY;
+    }
+    p_sys->b_coarse = true;
+    p_sys->i_time = i_date;
+    es_out_SetPCR( p_demux->out, VLC_TICK_0 + p_sys->i_time );
+    return VLC_SUCCESS;
+}
+
+static void AVI_CoarseStop( demux_sys_t *p_sys )
+{
+    for( unsigned i = 0; i < p_sys->i_track; i++ )
+        p_sys->track[i]->b_coarse = false;
+    p_sys->b_coarse = false;
+}
+
+/* Leaves the coarse seek once the index reaches the current position: the
+ * tracks are sought again, from the date the index gives to it */
+static void AVI_CoarseResume( demux_t *p_demux )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+    const uint64_t i_pos = vlc_stream_Tell( p_demux->s );
+    avi_track_t *p_master = NULL;
+
+    if( p_sys->p_indexer )
+        AVI_IndexerMerge( p_demux );
+    AVI_CoarseStop( p_sys );
+
+    for( unsigned i = 0; i < p_sys->i_track; i++ )
+    {
+        avi_track_t *tk = p_sys->track[i];
+
+        if( !tk->b_activated ||
+            ( tk->fmt.i_cat != AUDIO_ES && tk->fmt.i_cat != VIDEO_ES ) )
+            continue;
+        if( p_master == NULL || tk->fmt.i_cat == VIDEO_ES )
+            p_master = tk;
+        if( tk->fmt.i_cat == VIDEO_ES )
+            break;
+    }
+
+    if( p_master != NULL )
+    {
+        /* first indexed chunk from the position */
+        avi_index_t *p_index = &p_master->idx;
+        uint32_t i_min = 0, i_max = p_index->i_size;
+
+        while( i_min < i_max )
+        {
+            uint32_t i_mid = ( i_min + i_max ) / 2;
+            if( p_index->p_entry[i_mid].i_pos < i_pos )
+                i_min = i_mid + 1;
+            else
+                i_max = i_mid;
+        }
+        p_master->i_idxposc = i_min;
+        p_master->i_idxposb = 0;
+        p_master->i_blockno = i_min;
+        p_sys->i_time = AVI_GetPTS( p_master );
+    }
+
+    msg_Dbg( p_demux, "index reached, resuming at %"PRId64" seconds",
+             SEC_FROM_VLC_TICK(p_sys->i_time) );
+    p_sys->i_time = AVI_TracksSeek( p_demux, p_sys->i_time );
 }
 
 /* */
@@ -3222,6 +3735,20 @@ static int AVI_TrackStopFinishedStreams( demux_t *p_demux )
 /****************************************************************************
  * AVI_MovieGetLength give max streams length in ticks
  ****************************************************************************/
+static vlc_tick_t  AVI_TrackGetIndexedLength( avi_track_t *tk )
+{
+    if( tk->idx.i_size < 1 || !tk->idx.p_entry )
+        return 0;
+
+    if( tk->i_samplesize )
+    {
+        return AVI_GetDPTS( tk,
+                            tk->idx.p_entry[tk->idx.i_size-1].i_lengthtotal +
+                                tk->idx.p_entry[tk->idx.i_size-1].i_length );
+    }
+    return AVI_GetDPTS( tk, tk->idx.i_size );
+}
+
 static vlc_tick_t  AVI_MovieGetLength( demux_t *p_demux )
 {
     demux_sys_t  *p_sys = p_demux->p_sys;
@@ -3239,16 +3766,7 @@ static vlc_tick_t  AVI_MovieGetLength( demux_t *p_demux )
             continue;
         }
 
-        if( tk->i_samplesize )
-        {
-            i_length = AVI_GetDPTS( tk,
-                                    tk->idx.p_entry[tk->idx.i_size-1].i_lengthtotal +
-                                        tk->idx.p_entry[tk->idx.i_size-1].i_length );
-        }
-        else
-        {
-            i_length = AVI_GetDPTS( tk, tk->idx.i_size );
-        }
+        i_length = AVI_TrackGetIndexedLength( tk );
 
         msg_Dbg( p_demux,
                  "stream[%d] length:%"PRId64" (based on index)",
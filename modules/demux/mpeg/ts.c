@@ -391,6 +391,7 @@ static int Open( vlc_object_t *p_this )
     p_sys->b_end_preparse = false;
     ARRAY_INIT( p_sys->programs );
     p_sys->b_default_selection = false;
+    p_sys->i_selected_program = 0;
     p_sys->i_network_time = 0;
     p_sys->i_network_time_update = 0;
 
@@ -913,6 +914,16 @@ static int Control( demux_t *p_demux, int i_query, va_list args )
     const ts_pmt_t *p_pmt = NULL;
     const ts_pat_t *p_pat = GetPID(p_sys, 0)->u.p_pat;
 
+    /* Every program is selected in all ES mode, prefer the one selected by
+     * the es_out when known */
+    const int i_selected = p_sys->seltype == PROGRAM_ALL ?
+                           p_sys->i_selected_program : 0;
+    for( int i=0; i<p_pat->programs.i_size && !p_pmt && i_selected > 0; i++ )
+    {
+        if( p_pat->programs.p_elems[i]->u.p_pmt->i_number == i_selected )
+            p_pmt = p_pat->programs.p_elems[i]->u.p_pmt;
+    }
+
     for( int i=0; i<p_pat->programs.i_size && !p_pmt; i++ )
     {
         if( p_pat->programs.p_elems[i]->u.p_pmt->b_selected )
@@ -1104,8 +1115,10 @@ static int Control( demux_t *p_demux, int i_query, va_list args )
 
     case DEMUX_SET_GROUP_ALL: // All ES Mode
     {
-        msg_Dbg( p_demux, "DEMUX_SET_GROUP_%s", "ALL" );
+        i_int = va_arg( args, int );
+        msg_Dbg( p_demux, "DEMUX_SET_GROUP_%s %d", "ALL", i_int );
 
+        p_sys->i_selected_program = i_int;
         ARRAY_RESET( p_sys->programs );
         p_pat = GetPID(p_sys, 0)->u.p_pat;
         for( int i = 0; i < p_pat->programs.i_size; i++ )
@@ -127,6 +127,7 @@ struct demux_sys_t
     } seltype; /* reflects the DEMUX_SET_GROUP */
     DECL_ARRAY( int ) programs; /* List of selected/access-filtered programs */
     bool        b_default_selection; /* True if set by default to first pmt seen (to get data from filtered access) */
+    int         i_selected_program; /* with PROGRAM_ALL, the program the time refers to, or 0 */
 
     struct
     {
@@ -308,7 +308,7 @@ void MissingPATPMTFixup( demux_t *p_demux )
         return;
 
     BuildPAT( handle,
-            &p_sys->pids.pat, BuildPATCallback,
+            &p_sys->pids.pat, BuildPATCallback, NULL,
             0, 1,
             &patstream,
             1, &pmtprogramstream, &i_program_number );
@@ -365,7 +365,7 @@ void MissingPATPMTFixup( demux_t *p_demux )
 
         BuildPMT( handle, VLC_OBJECT(p_demux),
                  mux_standard,
-                p_program_pid, BuildPMTCallback,
+                p_program_pid, BuildPMTCallback, NULL,
                 0, 1,
                 i_pcr_pid,
                 NULL,
@@ -2303,9 +2303,6 @@ static int Ogg_BeginningOfStream( demux_t *p_demux )
 
         p_stream->p_es = NULL;
 
-        /* initialise kframe index */
-        p_stream->idx=NULL;
-
         if ( p_stream->fmt.i_bitrate == 0  &&
              ( p_stream->fmt.i_cat == VIDEO_ES ||
                p_stream->fmt.i_cat == AUDIO_ES ) )
@@ -2390,6 +2387,7 @@ static void Ogg_LogicalStreamInit( logical_stream_t *p_stream )
     p_stream->b_initializing = true;
     p_stream->b_contiguous = true; /* default */
     p_stream->queue.pp_append = &p_stream->queue.p_blocks;
+    vlc_vector_init( &p_stream->idx );
 }
 
 /**
@@ -2410,10 +2408,7 @@ static void Ogg_LogicalStreamDelete( demux_t *p_demux, logical_stream_t *p_strea
     es_format_Clean( &p_stream->fmt_old );
     es_format_Clean( &p_stream->fmt );
 
-    if ( p_stream->idx != NULL)
-    {
-        oggseek_index_entries_free( p_stream->idx );
-    }
+    vlc_vector_destroy( &p_stream->idx );
 
     Ogg_FreeSkeleton( p_stream->p_skel );
     p_stream->p_skel = NULL;
@@ -3309,27 +3304,6 @@ static void Ogg_ReadSkeletonBones( demux_t *p_demux, ogg_packet *p_oggpacket )
 
 }
 
-/* Unpacks the 7bit variable encoding used in skeleton indexes */
-unsigned const char * Read7BitsVariableLE( unsigned const char *p_begin,
-                                           unsigned const char *p_end,
-                                           uint64_t *pi_value )
-{
-    int i_shift = 0;
-    int64_t i_read = 0;
-    *pi_value = 0;
-
-    while ( p_begin < p_end )
-    {
-        i_read = *p_begin & 0x7F; /* High bit is start of integer */
-        *pi_value = *pi_value | ( i_read << i_shift );
-        i_shift += 7;
-        if ( (*p_begin++ & 0x80) == 0x80 ) break; /* see prev */
-    }
-
-    *pi_value = GetQWLE( pi_value );
-    return p_begin;
-}
-
 static void Ogg_ReadSkeletonIndex( demux_t *p_demux, ogg_packet *p_oggpacket )
 {
     demux_sys_t *p_sys = p_demux->p_sys;
@@ -3381,6 +3355,11 @@ static void Ogg_ReadSkeletonIndex( demux_t *p_demux, ogg_packet *p_oggpacket )
             p_oggpacket->bytes - 42 );
     p_stream->p_skel->i_index = i_keypoints_found;
     p_stream->p_skel->i_index_size = p_oggpacket->bytes - 42;
+
+    /* Seed our own seek index with the keypoints */
+    OggIndex_AddKeypoints( &p_stream->idx, p_stream->p_skel->p_index,
+                           p_stream->p_skel->i_index_size, i_keypoints_found,
+                           p_stream->p_skel->i_indexstampden );
 }
 
 static void Ogg_FreeSkeleton( ogg_skeleton_t *p_skel )
@@ -27,6 +27,9 @@
  *****************************************************************************/
 
 #include <vlc_tick.h>
+#include <vlc_vector.h>
+
+#include "ogg_index.h"
 
 //#define OGG_DEMUX_DEBUG 1
 #ifdef OGG_DEMUX_DEBUG
@@ -44,7 +47,6 @@
 
 #define OGGDS_RESOLUTION     10000000
 
-typedef struct oggseek_index_entry demux_index_entry_t;
 typedef struct ogg_skeleton_t ogg_skeleton_t;
 
 typedef struct backup_queue
@@ -99,8 +101,9 @@ typedef struct logical_stream_s
     /* offset of first keyframe for theora; can be 0 or 1 depending on version number */
     int8_t i_first_frame_index;
 
-    /* keyframe index for seeking, created as we discover keyframes */
-    demux_index_entry_t *idx;
+    /* keyframe index for seeking, sorted by page position, seeded from the
+     * skeleton and completed as we discover keyframes */
+    ogg_index_t idx;
 
     /* Skeleton data */
     ogg_skeleton_t *p_skel;
@@ -234,8 +237,5 @@ typedef struct
 } demux_sys_t;
 
 
-unsigned const char * Read7BitsVariableLE( unsigned const char *,
-                                           unsigned const char *,
-                                           uint64_t * );
 bool Ogg_GetBoundsUsingSkeletonIndex( logical_stream_t *p_stream, vlc_tick_t i_time,
                                       int64_t *pi_lower, int64_t *pi_upper );
@@ -0,0 +1,146 @@
+/*****************************************************************************
+ * ogg_index.c : ogg seek index functions
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+
+#include "ogg_index.h"
+
+/* Returns the position of the first entry whose page is not before
+   i_pagepos */
+static size_t OggIndexLowerBound( const ogg_index_t *p_index,
+                                  int64_t i_pagepos )
+{
+    size_t i_lower = 0, i_upper = p_index->size;
+
+    while ( i_lower < i_upper )
+    {
+        size_t i_mid = i_lower + ( i_upper - i_lower ) / 2;
+        if ( p_index->data[i_mid].i_pagepos < i_pagepos )
+            i_lower = i_mid + 1;
+        else
+            i_upper = i_mid;
+    }
+    return i_lower;
+}
+
+/* We insert into index, sorting by pagepos (as a page can match multiple
+   time stamps). Entries that would break the time ordering are dropped so
+   that the index can also be bisected by time. */
+const demux_index_entry_t *OggIndex_Add( ogg_index_t *p_index,
+                                         vlc_tick_t i_timestamp,
+                                         int64_t i_pagepos )
+{
+    if ( i_timestamp == VLC_TICK_INVALID || i_pagepos < 1 )
+        return NULL;
+
+    size_t i = OggIndexLowerBound( p_index, i_pagepos );
+    if ( i < p_index->size )
+    {
+        if ( p_index->data[i].i_pagepos == i_pagepos ||
+             p_index->data[i].i_value < i_timestamp )
+            return NULL;
+    }
+    if ( i > 0 && p_index->data[i - 1].i_value > i_timestamp )
+        return NULL;
+
+    demux_index_entry_t ie = {
+        .i_value = i_timestamp,
+        .i_pagepos = i_pagepos,
+    };
+    if ( !vlc_vector_insert( p_index, i, ie ) )
+        return NULL;
+
+    return &p_index->data[i];
+}
+
+/* Finds the entries around i_timestamp: the upper bound is only set when
+   there is an entry after it */
+bool OggIndex_Find( const ogg_index_t *p_index, vlc_tick_t i_timestamp,
+                    int64_t *pi_pos_lower, int64_t *pi_pos_upper,
+                    vlc_tick_t *pi_lower_timestamp )
+{
+    /* find the first entry after i_timestamp */
+    size_t i_lower = 0, i_upper = p_index->size;
+
+    while ( i_lower < i_upper )
+    {
+        size_t i_mid = i_lower + ( i_upper - i_lower ) / 2;
+        if ( p_index->data[i_mid].i_value <= i_timestamp )
+            i_lower = i_mid + 1;
+        else
+            i_upper = i_mid;
+    }
+
+    if ( i_lower == 0 )
+        return false;
+
+    const demux_index_entry_t *idx = &p_index->data[i_lower - 1];
+    *pi_pos_lower = idx->i_pagepos;
+    *pi_lower_timestamp = idx->i_value;
+    if ( i_lower < p_index->size ) /* not found on last index */
+        *pi_pos_upper = p_index->data[i_lower].i_pagepos;
+    return true;
+}
+
+/* Seeds the index with the keypoints of a skeleton index, as pairs of
+   position and time deltas */
+void OggIndex_AddKeypoints( ogg_index_t *p_index,
+                            unsigned const char *p_keypoints, size_t i_size,
+                            uint64_t i_count, int64_t i_stampden )
+{
+    unsigned const char *p_boundary = p_keypoints + i_size;
+    int64_t i_pos = 0;
+    vlc_tick_t i_time = 0;
+
+    for( uint64_t i = 0; i < i_count && p_keypoints < p_boundary; i++ )
+    {
+        uint64_t i_val;
+        p_keypoints = Read7BitsVariableLE( p_keypoints, p_boundary, &i_val );
+        i_pos += i_val;
+        p_keypoints = Read7BitsVariableLE( p_keypoints, p_boundary, &i_val );
+        i_time += i_val * i_stampden;
+        if ( i_pos < 0 || i_time < 0 ) break;
+        OggIndex_Add( p_index, VLC_TICK_0 + i_time, i_pos );
+    }
+}
+
+/* Unpacks the 7bit variable encoding used in skeleton indexes */
+unsigned const char * Read7BitsVariableLE( unsigned const char *p_begin,
+                                           unsigned const char *p_end,
+                                           uint64_t *pi_value )
+{
+    int i_shift = 0;
+    int64_t i_read = 0;
+    *pi_value = 0;
+
+    while ( p_begin < p_end )
+    {
+        i_read = *p_begin & 0x7F; /* High bit is start of integer */
+        *pi_value = *pi_value | ( i_read << i_shift );
+        i_shift += 7;
+        if ( (*p_begin++ & 0x80) == 0x80 ) break; /* see prev */
+    }
+
+    *pi_value = GetQWLE( pi_value );
+    return p_begin;
+}
@@ -0,0 +1,49 @@
+/*****************************************************************************
+ * ogg_index.h : ogg seek index functions
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifndef VLC_OGG_INDEX_H
+#define VLC_OGG_INDEX_H
+
+#include <vlc_tick.h>
+#include <vlc_vector.h>
+
+typedef struct oggseek_index_entry
+{
+    /* value is highest granulepos for theora, sync frame for dirac */
+    vlc_tick_t i_value;
+    int64_t i_pagepos;
+} demux_index_entry_t;
+
+/* keyframe index, sorted by page position and time */
+typedef struct VLC_VECTOR(demux_index_entry_t) ogg_index_t;
+
+const demux_index_entry_t *OggIndex_Add( ogg_index_t *, vlc_tick_t i_timestamp,
+                                         int64_t i_pagepos );
+bool OggIndex_Find( const ogg_index_t *, vlc_tick_t i_timestamp,
+                    int64_t *pi_pos_lower, int64_t *pi_pos_upper,
+                    vlc_tick_t *pi_lower_timestamp );
+void OggIndex_AddKeypoints( ogg_index_t *, unsigned const char *p_keypoints,
+                            size_t i_size, uint64_t i_count,
+                            int64_t i_stampden );
+
+unsigned const char * Read7BitsVariableLE( unsigned const char *,
+                                           unsigned const char *,
+                                           uint64_t * );
+
+#endif
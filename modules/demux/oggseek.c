@@ -57,100 +57,6 @@ typedef struct packetStartCoordinates
     int64_t i_skip;
 } packetStartCoordinates;
 
-/************************************************************
-* index entries
-*************************************************************/
-
-/* free all entries in index list */
-
-void oggseek_index_entries_free ( demux_index_entry_t *idx )
-{
-    demux_index_entry_t *idx_next;
-
-    while ( idx != NULL )
-    {
-        idx_next = idx->p_next;
-        free( idx );
-        idx = idx_next;
-    }
-}
-
-
-/* internal function to create a new list member */
-
-static demux_index_entry_t *index_entry_new( vlc_tick_t i_timestamp, int64_t i_pagepos )
-{
-    if ( i_timestamp == VLC_TICK_INVALID || i_pagepos < 1 )
-        return NULL;
-
-    demux_index_entry_t *idx = malloc( sizeof(*idx) );
-    if ( idx )
-    {
-        idx->i_value = i_timestamp;
-        idx->i_pagepos = i_pagepos;
-        idx->p_next = NULL;
-    }
-    return idx;
-}
-
-/* We insert into index, sorting by pagepos (as a page can match multiple
-   time stamps) */
-const demux_index_entry_t *OggSeek_IndexAdd ( logical_stream_t *p_stream,
-                                             vlc_tick_t i_timestamp,
-                                             int64_t i_pagepos )
-{
-    demux_index_entry_t **pp_next = &p_stream->idx;
-    for( ; *pp_next; )
-    {
-        if( (*pp_next)->i_pagepos >= i_pagepos )
-        {
-            if( (*pp_next)->i_pagepos == i_pagepos )
-                return NULL;
-            break;
-        }
-        pp_next = &((*pp_next)->p_next);
-    }
-
-    demux_index_entry_t *ie = index_entry_new( i_timestamp, i_pagepos );
-    if ( ie )
-    {
-        ie->p_next = *pp_next;
-        *pp_next = ie;
-    }
-
-    return ie;
-}
-
-static bool OggSeekIndexFind ( logical_stream_t *p_stream, vlc_tick_t i_timestamp,
-                               int64_t *pi_pos_lower, int64_t *pi_pos_upper,
-                               vlc_tick_t *pi_lower_timestamp )
-{
-    demux_index_entry_t *idx = p_stream->idx;
-
-    while ( idx != NULL )
-    {
-        if ( idx->i_value <= i_timestamp )
-        {
-            if ( !idx->p_next ) /* found on last index */
-            {
-                *pi_pos_lower = idx->i_pagepos;
-                *pi_lower_timestamp = idx->i_value;
-                return true;
-            }
-            if ( idx->p_next->i_value > i_timestamp )
-            {
-                *pi_pos_lower = idx->i_pagepos;
-                *pi_lower_timestamp = idx->i_value;
-                *pi_pos_upper = idx->p_next->i_pagepos;
-                return true;
-            }
-        }
-        idx = idx->p_next;
-    }
-
-    return false;
-}
-
 /*********************************************************************
  * private functions
  **********************************************************************/
@@ -807,7 +713,7 @@ int Oggseek_BlindSeektoAbsoluteTime( demux_t *p_demux, logical_stream_t *p_strea
 
     /* And also search in our own index */
     vlc_tick_t foo;
-    if ( !b_found && OggSeekIndexFind( p_stream, i_time, &i_lowerpos, &i_upperpos, &foo ) )
+    if ( !b_found && OggIndex_Find( &p_stream->idx, i_time, &i_lowerpos, &i_upperpos, &foo ) )
     {
         b_found = true;
     }
@@ -908,7 +814,7 @@ int Oggseek_SeektoAbsolutetime( demux_t *p_demux, logical_stream_t *p_stream,
 
 
     vlc_tick_t i_lower_index;
-    if(!OggSeekIndexFind( p_stream, i_time, &i_offset_lower, &i_offset_upper, &i_lower_index ))
+    if(!OggIndex_Find( &p_stream->idx, i_time, &i_offset_lower, &i_offset_upper, &i_lower_index ))
         i_lower_index = 0;
 
     i_offset_lower = __MAX( i_offset_lower, p_stream->i_data_start );
@@ -930,7 +836,7 @@ int Oggseek_SeektoAbsolutetime( demux_t *p_demux, logical_stream_t *p_stream,
               ? vlc_tick_from_sec( ceil( sqrt( SEC_FROM_VLC_TICK( p_sys->i_length ) ) / 2 ) )
               : vlc_tick_from_sec( 5 );
     if ( i_pagepos >= p_stream->i_data_start && ( i_sync_time - i_lower_index >= index_interval ) )
-        OggSeek_IndexAdd( p_stream, i_sync_time, i_pagepos );
+        OggIndex_Add( &p_stream->idx, i_sync_time, i_pagepos );
 
     OggDebug( msg_Dbg( p_demux, "=================== Seeked To %"PRId64" time %"PRId64, i_pagepos, i_time ) );
     return i_pagepos;
@@ -21,13 +21,21 @@
 //namespace vlc {
 //namespace playlist {
 
-PlaylistItem::PlaylistItem(vlc_playlist_item_t* item)
+PlaylistItem::PlaylistItem(vlc_playlist_item_t* item, bool lazy)
 {
     d = new Data();
     if (item)
     {
         d->item.reset(item);
-        sync();
+        if (lazy)
+        {
+            /* the duration is needed right away for the playlist total */
+            input_item_t *media = inputItem();
+            vlc_mutex_locker locker(&media->lock);
+            d->duration = media->i_duration;
+        }
+        else
+            sync();
     }
 }
 
@@ -43,21 +51,25 @@ void PlaylistItem::setSelected(bool selected)
 
 QString PlaylistItem::getTitle() const
 {
+    load();
     return d->title;
 }
 
 QString PlaylistItem::getArtist() const
 {
+    load();
     return d->artist;
 }
 
 QString PlaylistItem::getAlbum() const
 {
+    load();
     return d->album;
 }
 
 QUrl PlaylistItem::getArtwork() const
 {
+    load();
     return d->artwork;
 }
 
@@ -68,6 +80,7 @@ vlc_tick_t PlaylistItem::getDuration() const
 
 QUrl PlaylistItem::getUrl() const
 {
+    load();
     return d->url;
 }
 
@@ -76,6 +89,21 @@ void PlaylistItem::sync() {
     assert(media);
     vlc_mutex_locker locker(&media->lock);
     d->duration = media->i_duration;
+    loadLocked(media);
+}
+
+void PlaylistItem::load() const
+{
+    if (d->loaded || !d->item)
+        return;
+
+    input_item_t *media = inputItem();
+    vlc_mutex_locker locker(&media->lock);
+    loadLocked(media);
+}
+
+void PlaylistItem::loadLocked(input_item_t *media) const
+{
     d->url      = media->psz_uri;
 
     if (media->p_meta) {
@@ -88,6 +116,8 @@ void PlaylistItem::sync() {
     if (d->title.isNull())
         /* If there is no title, use the item name */
         d->title = media->psz_name;
+
+    d->loaded = true;
 }
 
 PlaylistItem::operator bool() const
@@ -44,6 +44,10 @@ using SharedPlaylistItem = vlc_shared_data_ptr_type(vlc_playlist_item_t,
  * It contains both the SharedPlaylistItem and cached data saved while the playlist
  * is locked, so that the fields may be read without synchronization or race
  * conditions.
+ *
+ * A lazy item only caches the duration on creation, the other fields are
+ * loaded from the media on first access, which must then happen from a single
+ * thread (the UI thread).
  */
 class PlaylistItem
 {
@@ -56,7 +60,7 @@ public:
     Q_PROPERTY(vlc_tick_t duration READ getDuration CONSTANT  FINAL)
     Q_PROPERTY(QUrl url READ getUrl CONSTANT  FINAL)
 
-    PlaylistItem(vlc_playlist_item_t *item = nullptr);
+    PlaylistItem(vlc_playlist_item_t *item = nullptr, bool lazy = false);
 
     operator bool() const;
 
@@ -90,10 +94,14 @@ public:
     void sync();
 
 private:
+    void load() const;
+    void loadLocked(input_item_t *media) const;
+
     struct Data : public QSharedData {
         SharedPlaylistItem item;
 
         bool selected = false;
+        bool loaded = false;
 
         /* cached values */
         QString title;
@@ -24,6 +24,8 @@
 #include "playlist_model_p.hpp"
 #include <algorithm>
 #include <cassert>
+#include <QHash>
+#include <vlc_diffutil.h>
 #include "util/shared_input_item.hpp"
 #include "playlist_controller.hpp"
 
@@ -32,12 +34,22 @@ namespace playlist {
 
 namespace {
 
+/* Above this number of insertions, removals and moves in a batch, the model
+ * is diffed against the content of the playlist instead of replaying them */
+constexpr size_t REPLAY_MAX = 16;
+/* Upper bound of the diff cost, O((N+M)D), above which the model is reset */
+constexpr uint64_t DIFF_COST_MAX = UINT64_C(1) << 24;
+
+using Change = PlaylistListModelPrivate::Change;
+
 static QVector<PlaylistItem> toVec(vlc_playlist_item_t *const items[],
                                    size_t len)
 {
     QVector<PlaylistItem> vec;
+    vec.reserve(len);
+    /* the metadata are only loaded for the rows actually displayed */
     for (size_t i = 0; i < len; ++i)
-        vec.push_back(items[i]);
+        vec.push_back(PlaylistItem(items[i], true));
     return vec;
 }
 
@@ -51,22 +63,126 @@ static QVector<RAW> toRaw(const QVector<WRAPPER> &items)
         vec.push_back(items[i].raw());
     return vec;
 }
+
+static void insertItems(QVector<PlaylistItem> &vec, size_t index,
+                        const QVector<PlaylistItem> &items)
+{
+    vec.insert(index, items.size(), nullptr);
+    std::copy(items.cbegin(), items.cend(), vec.begin() + index);
+}
+
+/**
+ * Merge a change into the previous pending one, when they touch contiguous
+ * ranges (typically a bulk insertion or removal notified by slices)
+ */
+static bool mergeChange(Change &last, const Change &next)
+{
+    switch (next.type)
+    {
+    case Change::Added:
+        if (last.type == Change::Reset
+         && next.index <= static_cast<size_t>(last.items.size()))
+        {
+            insertItems(last.items, next.index, next.items);
+            return true;
+        }
+        if (last.type == Change::Added && next.index >= last.index
+         && next.index <= last.index + last.count)
+        {
+            insertItems(last.items, next.index - last.index, next.items);
+            last.count += next.count;
+            return true;
+        }
+        return false;
+
+    case Change::Removed:
+        if (last.type == Change::Reset)
+        {
+            last.items.remove(next.index, next.count);
+            return true;
+        }
+        if (last.type == Change::Added && next.index >= last.index
+         && next.index + next.count <= last.index + last.count)
+        {
+            /* removed before being ever shown */
+            last.items.remove(next.index - last.index, next.count);
+            last.count -= next.count;
+            return true;
+        }
+        if (last.type == Change::Removed && next.index == last.index)
+        {
+            last.count += next.count;
+            return true;
+        }
+        if (last.type == Change::Removed
+         && next.index + next.count == last.index)
+        {
+            last.index = next.index;
+            last.count += next.count;
+            return true;
+        }
+        return false;
+
+    case Change::Updated:
+        if ((last.type == Change::Reset || last.type == Change::Added)
+         && next.index >= last.index
+         && next.index + next.count <= last.index + last.items.size())
+        {
+            std::copy(next.items.cbegin(), next.items.cend(),
+                      last.items.begin() + (next.index - last.index));
+            return true;
+        }
+        if (last.type == Change::Updated
+         && next.index == last.index + last.count)
+        {
+            last.items.append(next.items);
+            last.count += next.count;
+            return true;
+        }
+        return false;
+
+    case Change::Current:
+        if (last.type == Change::Current)
+        {
+            last.current = next.current;
+            return true;
+        }
+        return false;
+
+    default:
+        return false;
+    }
+}
+
+static uint32_t itemsLength(const void *list)
+{
+    return static_cast<const QVector<PlaylistItem> *>(list)->size();
+}
+
+static bool itemsCompare(const void *listOld, uint32_t oldIndex,
+                         const void *listNew, uint32_t newIndex)
+{
+    auto oldItems = static_cast<const QVector<PlaylistItem> *>(listOld);
+    auto newItems = static_cast<const QVector<PlaylistItem> *>(listNew);
+    return oldItems->at(oldIndex).raw() == newItems->at(newIndex).raw();
+}
 }
 
 extern "C" { // for C callbacks
 
+/* The callbacks are called with the playlist locked, which protects the
+ * pending changes */
+
 static void
 on_playlist_items_reset(vlc_playlist_t *playlist,
                         vlc_playlist_item_t *const items[],
                         size_t len, void *userdata)
 {
+    VLC_UNUSED(playlist);
     PlaylistListModelPrivate *that = static_cast<PlaylistListModelPrivate *>(userdata);
-    QVector<PlaylistItem> newContent = toVec(items, len);
-    that->callAsync([=]() {
-        if (that->m_playlist != playlist)
-            return;
-        that->onItemsReset(newContent);
-    });
+    Change change { Change::Reset, 0, len };
+    change.items = toVec(items, len);
+    that->pushChange(std::move(change));
 }
 
 static void
@@ -74,37 +190,29 @@ on_playlist_items_added(vlc_playlist_t *playlist, size_t index,
                         vlc_playlist_item_t *const items[], size_t len,
                         void *userdata)
 {
+    VLC_UNUSED(playlist);
     PlaylistListModelPrivate *that = static_cast<PlaylistListModelPrivate *>(userdata);
-    QVector<PlaylistItem> added = toVec(items, len);
-    that->callAsync([=]() {
-        if (that->m_playlist != playlist)
-            return;
-        that->onItemsAdded(added, index);
-    });
+    Change change { Change::Added, index, len };
+    change.items = toVec(items, len);
+    that->pushChange(std::move(change));
 }
 
 static void
 on_playlist_items_moved(vlc_playlist_t *playlist, size_t index, size_t count,
                         size_t target, void *userdata)
 {
+    VLC_UNUSED(playlist);
     PlaylistListModelPrivate *that = static_cast<PlaylistListModelPrivate *>(userdata);
-    that->callAsync([=]() {
-        if (that->m_playlist != playlist)
-            return;
-        that->onItemsMoved(index, count, target);
-    });
+    that->pushChange({ Change::Moved, index, count, target });
 }
 
 static void
 on_playlist_items_removed(vlc_playlist_t *playlist, size_t index, size_t count,
                           void *userdata)
 {
+    VLC_UNUSED(playlist);
     PlaylistListModelPrivate *that = static_cast<PlaylistListModelPrivate *>(userdata);
-    that->callAsync([=](){
-        if (that->m_playlist != playlist)
-            return;
-        that->onItemsRemoved(index, count);
-    });
+    that->pushChange({ Change::Removed, index, count });
 }
 
 static void
@@ -112,34 +220,20 @@ on_playlist_items_updated(vlc_playlist_t *playlist, size_t index,
                           vlc_playlist_item_t *const items[], size_t len,
                           void *userdata)
 {
+    VLC_UNUSED(playlist);
     PlaylistListModelPrivate *that = static_cast<PlaylistListModelPrivate *>(userdata);
-    QVector<PlaylistItem> updated = toVec(items, len);
-    that->callAsync([=](){
-        if (that->m_playlist != playlist)
-            return;
-        int count = updated.size();
-        for (int i = 0; i < count; ++i)
-            that->m_items[index + i] = updated[i]; /* sync metadata */
-        that->notifyItemsChanged(index, count);
-    });
+    Change change { Change::Updated, index, len };
+    change.items = toVec(items, len);
+    that->pushChange(std::move(change));
 }
 
 static void
 on_playlist_current_item_changed(vlc_playlist_t *playlist, ssize_t index,
                                  void *userdata)
 {
+    VLC_UNUSED(playlist);
     PlaylistListModelPrivate *that = static_cast<PlaylistListModelPrivate *>(userdata);
-    that->callAsync([=](){
-        if (that->m_playlist != playlist)
-            return;
-        ssize_t oldCurrent = that->m_current;
-        that->m_current = index;
-        if (oldCurrent != -1)
-            that->notifyItemsChanged(oldCurrent, 1, {PlaylistListModel::IsCurrentRole});
-        if (index != -1)
-            that->notifyItemsChanged(index, 1, {PlaylistListModel::IsCurrentRole});
-        emit that->q_func()->currentIndexChanged(index);
-    });
+    that->pushChange({ Change::Current, 0, 0, 0, index });
 }
 
 } // extern "C"
@@ -171,6 +265,248 @@ PlaylistListModelPrivate::~PlaylistListModelPrivate()
     }
 }
 
+void PlaylistListModelPrivate::pushChange(Change &&change)
+{
+    if (change.type == Change::Reset)
+    {
+        /* The reset replaces the items, not the current index: its last
+         * pending change must still be applied, after the reset */
+        auto current = std::find_if(m_pendingChanges.rbegin(),
+                                    m_pendingChanges.rend(),
+                                    [](const Change &pending) {
+            return pending.type == Change::Current;
+        });
+
+        std::vector<Change> changes;
+        changes.push_back(std::move(change));
+        if (current != m_pendingChanges.rend())
+            changes.push_back(std::move(*current));
+        m_pendingChanges.swap(changes);
+    }
+    else if (!m_pendingChanges.empty()
+          && mergeChange(m_pendingChanges.back(), change))
+        return;
+    else
+        m_pendingChanges.push_back(std::move(change));
+
+    /* apply all the changes notified until the next UI event loop iteration
+     * at once */
+    if (!m_flushPending)
+    {
+        m_flushPending = true;
+        callAsync([this]() { flushChanges(); });
+    }
+}
+
+void PlaylistListModelPrivate::flushChanges()
+{
+    if (!m_playlist)
+        return;
+
+    std::vector<Change> changes;
+    std::vector<SharedPlaylistItem> snapshot;
+    ssize_t current = -1;
+    size_t structural = 0;
+    size_t edits = 0;
+    bool reset = false;
+    bool updated = false;
+
+    {
+        vlc_playlist_locker locker(m_playlist);
+        changes.swap(m_pendingChanges);
+        m_flushPending = false;
+
+        for (const Change &change : changes)
+        {
+            switch (change.type)
+            {
+            case Change::Reset:
+                reset = true;
+                break;
+            case Change::Added:
+            case Change::Removed:
+                structural++;
+                edits += change.count;
+                break;
+            case Change::Moved:
+                structural++;
+                edits += 2 * change.count;
+                break;
+            case Change::Updated:
+                updated = true;
+                break;
+            case Change::Current:
+                break;
+            }
+        }
+
+        if (structural > REPLAY_MAX)
+        {
+            /* The pending changes lead to the current content of the
+             * playlist, no new change may be notified while it is locked */
+            size_t count = vlc_playlist_Count(m_playlist);
+            snapshot.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+                snapshot.emplace_back(vlc_playlist_Get(m_playlist, i));
+            current = vlc_playlist_GetCurrentIndex(m_playlist);
+        }
+    }
+
+    if (structural <= REPLAY_MAX)
+    {
+        for (const Change &change : changes)
+            applyChange(change);
+        return;
+    }
+
+    /* Reuse the wrappers already known, with their cached metadata and their
+     * selection state, the most recent ones win */
+    QHash<vlc_playlist_item_t *, PlaylistItem> known;
+    known.reserve(m_items.size());
+    for (const PlaylistItem &item : m_items)
+        known.insert(item.raw(), item);
+    for (const Change &change : changes)
+        for (const PlaylistItem &item : change.items)
+            known.insert(item.raw(), item);
+
+    QVector<PlaylistItem> content;
+    content.reserve(snapshot.size());
+    for (const SharedPlaylistItem &item : snapshot)
+    {
+        auto it = known.constFind(item.get());
+        content.push_back(it != known.cend() ? *it
+                                             : PlaylistItem(item.get(), true));
+    }
+
+    if (reset)
+        edits = m_items.size() + content.size();
+    applyContent(std::move(content), current, edits, updated);
+}
+
+void PlaylistListModelPrivate::applyChange(const Change &change)
+{
+    switch (change.type)
+    {
+    case Change::Reset:
+        onItemsReset(change.items);
+        break;
+    case Change::Added:
+        if (change.count > 0)
+            onItemsAdded(change.items, change.index);
+        break;
+    case Change::Moved:
+        onItemsMoved(change.index, change.count, change.target);
+        break;
+    case Change::Removed:
+        onItemsRemoved(change.index, change.count);
+        break;
+    case Change::Updated:
+    {
+        int count = change.items.size();
+        for (int i = 0; i < count; ++i)
+            m_items[change.index + i] = change.items[i]; /* sync metadata */
+        notifyItemsChanged(change.index, count);
+        break;
+    }
+    case Change::Current:
+        onCurrentIndexChanged(change.current);
+        break;
+    }
+}
+
+void PlaylistListModelPrivate::applyContent(QVector<PlaylistItem> &&content,
+                                            ssize_t current, size_t edits,
+                                            bool updated)
+{
+    Q_Q(PlaylistListModel);
+
+    uint64_t cost = uint64_t(edits) * (m_items.size() + content.size());
+    diffutil_snake_t *snake = nullptr;
+    vlc_diffutil_changelist_t *diff = nullptr;
+
+    if (!m_items.isEmpty() && !content.isEmpty() && cost <= DIFF_COST_MAX)
+    {
+        vlc_diffutil_callback_t diffOp = {
+            itemsLength,
+            itemsLength,
+            itemsCompare
+        };
+
+        snake = vlc_diffutil_build_snake(&diffOp, &m_items, &content);
+        if (snake)
+            diff = vlc_diffutil_build_change_list(snake, &diffOp, &m_items,
+                                                  &content,
+                                                  VLC_DIFFUTIL_RESULT_AGGREGATE);
+    }
+
+    if (!diff)
+    {
+        /* too many changes (or nothing to compare to) */
+        if (snake)
+            vlc_diffutil_free_snake(snake);
+        onItemsReset(content);
+        onCurrentIndexChanged(current);
+        return;
+    }
+
+    for (size_t i = 0; i < diff->size; ++i)
+    {
+        const vlc_diffutil_change_t &op = diff->data[i];
+        switch (op.type)
+        {
+        case VLC_DIFFUTIL_OP_INSERT:
+        {
+            int index = op.op.insert.index;
+            q->beginInsertRows({}, index, index + op.count - 1);
+            m_items.insert(index, op.count, nullptr);
+            std::copy_n(content.cbegin() + op.op.insert.y, op.count,
+                        m_items.begin() + index);
+            q->endInsertRows();
+            break;
+        }
+        case VLC_DIFFUTIL_OP_REMOVE:
+        {
+            int index = op.op.remove.index;
+            q->beginRemoveRows({}, index, index + op.count - 1);
+            m_items.remove(index, op.count);
+            q->endRemoveRows();
+            break;
+        }
+        default:
+            /* moves are not requested */
+            vlc_assert_unreachable();
+        }
+    }
+    vlc_diffutil_free_change_list(diff);
+    vlc_diffutil_free_snake(snake);
+
+    /* same items, but the wrappers of the updated ones are more recent */
+    m_items = std::move(content);
+    m_duration = VLC_TICK_FROM_SEC(0);
+    for (const PlaylistItem &item : m_items)
+        m_duration += item.getDuration();
+    if (updated && !m_items.isEmpty())
+        notifyItemsChanged(0, m_items.size());
+    emit q->countChanged(m_items.size());
+
+    onCurrentIndexChanged(current);
+}
+
+void PlaylistListModelPrivate::onCurrentIndexChanged(ssize_t index)
+{
+    Q_Q(PlaylistListModel);
+    ssize_t oldCurrent = m_current;
+    if (oldCurrent == index)
+        return;
+
+    m_current = index;
+    if (oldCurrent != -1 && oldCurrent < static_cast<ssize_t>(m_items.size()))
+        notifyItemsChanged(oldCurrent, 1, {PlaylistListModel::IsCurrentRole});
+    if (index != -1)
+        notifyItemsChanged(index, 1, {PlaylistListModel::IsCurrentRole});
+    emit q->currentIndexChanged(index);
+}
+
 void PlaylistListModelPrivate::onItemsReset(const QVector<PlaylistItem>& newContent)
 {
     Q_Q(PlaylistListModel);
@@ -444,6 +780,8 @@ void PlaylistListModel::setPlaylist(vlc_playlist_t* playlist)
     {
         vlc_playlist_locker locker(d->m_playlist);
         vlc_playlist_RemoveListener(d->m_playlist, d->m_listener);
+        d->m_pendingChanges.clear();
+        d->m_flushPending = false;
         d->m_playlist = nullptr;
         d->m_listener = nullptr;
     }
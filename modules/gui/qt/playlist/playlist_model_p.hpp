@@ -22,6 +22,8 @@
 
 #include "playlist_model.hpp"
 
+#include <vector>
+
 namespace vlc {
 namespace playlist {
 
@@ -51,6 +53,32 @@ public:
 #endif
     }
 
+    /**
+     * Playlist change, as notified by the core
+     *
+     * The changes are queued from the playlist callbacks and applied by
+     * batches on the UI thread, so that a bulk edit of the playlist does not
+     * flood the views with one model signal per callback.
+     */
+    struct Change
+    {
+        enum Type { Reset, Added, Moved, Removed, Updated, Current };
+
+        Type type;
+        size_t index = 0;
+        size_t count = 0;
+        size_t target = 0; /* Moved */
+        ssize_t current = -1; /* Current */
+        QVector<PlaylistItem> items; /* Reset, Added and Updated */
+    };
+
+    void pushChange(Change &&change);
+    void flushChanges();
+    void applyChange(const Change &change);
+    void applyContent(QVector<PlaylistItem> &&content, ssize_t current,
+                      size_t edits, bool updated);
+    void onCurrentIndexChanged(ssize_t index);
+
     void onItemsReset(const QVector<PlaylistItem>& items);
     void onItemsAdded(const QVector<PlaylistItem>& added, size_t index);
     void onItemsMoved(size_t index, size_t count, size_t target);
@@ -62,6 +90,10 @@ public:
     vlc_playlist_t* m_playlist = nullptr;
     vlc_playlist_listener_id *m_listener = nullptr;
 
+    /* protected by the playlist lock */
+    std::vector<Change> m_pendingChanges;
+    bool m_flushPending = false;
+
     /* access only from the UI thread */
     QVector<PlaylistItem> m_items;
     ssize_t m_current = -1;
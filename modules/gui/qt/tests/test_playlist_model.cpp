@@ -0,0 +1,207 @@
+/*****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#include "vlc_stub_modules.hpp"
+
+#include <QTest>
+#include <QSignalSpy>
+#include <QElapsedTimer>
+#include <QAbstractItemModelTester>
+
+#include "../playlist/playlist_model.hpp"
+
+using vlc::playlist::PlaylistListModel;
+
+class TestPlaylistModel : public QObject
+{
+    Q_OBJECT
+
+private:
+    //append count network items (never preparsed), by chunks of 1000
+    void appendItems(size_t count)
+    {
+        std::vector<input_item_t *> media;
+        vlc_playlist_locker locker(m_playlist);
+        size_t base = vlc_playlist_Count(m_playlist);
+        for (size_t i = 0; i < count; i += media.size())
+        {
+            media.clear();
+            for (size_t j = i; j < count && media.size() < 1000; ++j)
+            {
+                QByteArray name = QString("item %1").arg(base + j).toUtf8();
+                input_item_t *item = input_item_NewExt("mock://", name.constData(),
+                                                       VLC_TICK_FROM_SEC(1),
+                                                       ITEM_TYPE_STREAM, ITEM_NET);
+                QVERIFY(item != nullptr);
+                media.push_back(item);
+            }
+            int ret = vlc_playlist_Append(m_playlist, media.data(), media.size());
+            for (input_item_t *item : media)
+                input_item_Release(item);
+            QCOMPARE(ret, VLC_SUCCESS);
+        }
+    }
+
+    //remove every step-th item of the range, one callback each
+    void removeScattered(size_t first, size_t count, size_t step)
+    {
+        vlc_playlist_locker locker(m_playlist);
+        for (size_t i = 0; i < count; ++i)
+            vlc_playlist_Remove(m_playlist, first + i * (step - 1), 1);
+    }
+
+    void checkContent()
+    {
+        vlc_playlist_locker locker(m_playlist);
+        size_t count = vlc_playlist_Count(m_playlist);
+        QCOMPARE(static_cast<size_t>(m_model->rowCount()), count);
+        for (size_t i = 0; i < count; ++i)
+            QVERIFY(m_model->itemAt(i).raw() == vlc_playlist_Get(m_playlist, i));
+        QCOMPARE(static_cast<ssize_t>(m_model->getCurrentIndex()),
+                 vlc_playlist_GetCurrentIndex(m_playlist));
+    }
+
+private slots:
+    void initTestCase() {
+        m_env = std::make_unique<VLCTestingEnv>();
+        QVERIFY(m_env->init());
+        m_playlist = m_env->intf->p_playlist;
+    }
+
+    void cleanupTestCase() {
+        m_playlist = nullptr;
+        m_env.reset();
+    }
+
+    void init() {
+        m_model = new PlaylistListModel(m_playlist);
+        QCOMPARE(m_model->rowCount(), 0);
+    }
+
+    void cleanup() {
+        {
+            vlc_playlist_locker locker(m_playlist);
+            vlc_playlist_Clear(m_playlist);
+        }
+        QTRY_COMPARE(m_model->rowCount(), 0);
+        m_modelTester.reset();
+        delete m_model;
+    }
+
+    //few changes: the callbacks are replayed, contiguous ones are merged
+    void testReplay() {
+        m_modelTester = std::make_unique<QAbstractItemModelTester>(m_model);
+        appendItems(100);
+        QTRY_COMPARE(m_model->rowCount(), 100);
+        checkContent();
+
+        QSignalSpy removed(m_model, &QAbstractItemModel::rowsRemoved);
+        QSignalSpy moved(m_model, &QAbstractItemModel::rowsMoved);
+        {
+            vlc_playlist_locker locker(m_playlist);
+            vlc_playlist_Remove(m_playlist, 10, 5);
+            vlc_playlist_Remove(m_playlist, 10, 5);
+            vlc_playlist_Remove(m_playlist, 5, 5);
+            vlc_playlist_Move(m_playlist, 0, 2, 50);
+            vlc_playlist_GoTo(m_playlist, 3);
+        }
+        QTRY_COMPARE(m_model->rowCount(), 85);
+        QCOMPARE(removed.count(), 1);
+        QCOMPARE(moved.count(), 1);
+        checkContent();
+
+        //the metadata are loaded on access
+        QCOMPARE(m_model->data(m_model->index(0), PlaylistListModel::TitleRole).toString(),
+                 QString("item 2"));
+    }
+
+    //many changes: the model is diffed against the playlist content
+    void testDiff() {
+        m_modelTester = std::make_unique<QAbstractItemModelTester>(m_model);
+        appendItems(1000);
+        QTRY_COMPARE(m_model->rowCount(), 1000);
+
+        QSignalSpy reset(m_model, &QAbstractItemModel::modelReset);
+        QSignalSpy removed(m_model, &QAbstractItemModel::rowsRemoved);
+        removeScattered(0, 100, 10);
+        QTRY_COMPARE(m_model->rowCount(), 900);
+        QCOMPARE(reset.count(), 0);
+        QCOMPARE(removed.count(), 100);
+        checkContent();
+    }
+
+    //a reset does not notify the current index if it did not change
+    void testResetKeepsCurrent() {
+        m_modelTester = std::make_unique<QAbstractItemModelTester>(m_model);
+        appendItems(10);
+        QTRY_COMPARE(m_model->rowCount(), 10);
+
+        QSignalSpy reset(m_model, &QAbstractItemModel::modelReset);
+        {
+            //already sorted: the current item keeps its index
+            const struct vlc_playlist_sort_criterion criterion = {
+                VLC_PLAYLIST_SORT_KEY_TITLE, VLC_PLAYLIST_SORT_ORDER_ASCENDING
+            };
+            vlc_playlist_locker locker(m_playlist);
+            vlc_playlist_GoTo(m_playlist, 3);
+            QCOMPARE(vlc_playlist_Sort(m_playlist, &criterion, 1), VLC_SUCCESS);
+            QCOMPARE(vlc_playlist_GetCurrentIndex(m_playlist), ssize_t(3));
+        }
+        QTRY_COMPARE(reset.count(), 1);
+        checkContent();
+    }
+
+    void benchmarkBulkEdits() {
+        QElapsedTimer timer;
+        timer.start();
+        appendItems(200000);
+        QTRY_COMPARE(m_model->rowCount(), 200000);
+        qInfo("200k items appended in %lld ms", timer.elapsed());
+
+        QSignalSpy changes(m_model, &QAbstractItemModel::rowsRemoved);
+        QSignalSpy reset(m_model, &QAbstractItemModel::modelReset);
+        QBENCHMARK_ONCE {
+            //11k callbacks, applied at once
+            removeScattered(0, 10000, 20);
+            {
+                vlc_playlist_locker locker(m_playlist);
+                for (size_t i = 0; i < 1000; ++i)
+                    vlc_playlist_Move(m_playlist, 0, 1, 150000);
+            }
+            QTRY_COMPARE(m_model->rowCount(), 190000);
+        }
+        QVERIFY(changes.count() + reset.count() < 100);
+        checkContent();
+
+        timer.restart();
+        {
+            vlc_playlist_locker locker(m_playlist);
+            vlc_playlist_Remove(m_playlist, 0, 100000);
+        }
+        QTRY_COMPARE(m_model->rowCount(), 90000);
+        qInfo("100k items removed in %lld ms", timer.elapsed());
+    }
+
+private:
+    std::unique_ptr<VLCTestingEnv> m_env;
+    vlc_playlist_t* m_playlist = nullptr;
+    std::unique_ptr<QAbstractItemModelTester> m_modelTester;
+    PlaylistListModel* m_model = nullptr;
+};
+
+QTEST_GUILESS_MAIN(TestPlaylistModel)
+#include "test_playlist_model.moc"
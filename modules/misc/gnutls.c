@@ -38,15 +38,40 @@
 #include <vlc_tls.h>
 #include <vlc_block.h>
 #include <vlc_dialog.h>
+#include <vlc_list.h>
+#include <vlc_threads.h>
 
 #include <gnutls/gnutls.h>
 #include <gnutls/x509.h>
 
+/**
+ * Client-side TLS credentials private data
+ */
+typedef struct gnutls_client_sys
+{
+    gnutls_certificate_credentials_t x509;
+    vlc_mutex_t lock;
+    struct vlc_list sessions; /**< Resumption data, most recent first */
+    unsigned count;
+} gnutls_client_sys_t;
+
+#define GNUTLS_RESUMPTION_MAX 16
+
+struct gnutls_resumption
+{
+    struct vlc_list node;
+    gnutls_datum_t data;
+    char host[];
+};
+
 typedef struct vlc_tls_gnutls
 {
     vlc_tls_t tls;
     gnutls_session_t session;
     vlc_object_t *obj;
+    gnutls_client_sys_t *client; /**< Client credentials (or NULL) */
+    char *host; /**< Server name, for session resumption */
+    bool resumable;
 } vlc_tls_gnutls_t;
 
 static void gnutls_Banner(vlc_object_t *obj)
@@ -203,11 +228,81 @@ static int gnutls_Shutdown(vlc_tls_t *tls, bool duplex)
     return 0;
 }
 
+static struct gnutls_resumption *
+gnutls_ResumptionFind(gnutls_client_sys_t *sys, const char *host)
+{
+    struct gnutls_resumption *r;
+
+    vlc_list_foreach(r, &sys->sessions, node)
+        if (!strcmp(r->host, host))
+            return r;
+    return NULL;
+}
+
+static void gnutls_ResumptionFree(struct gnutls_resumption *r)
+{
+    gnutls_free(r->data.data);
+    free(r);
+}
+
+/**
+ * Restores the last session with a server, so that the handshake can skip
+ * the key exchange and the certificates.
+ */
+static void gnutls_ResumptionLoad(gnutls_client_sys_t *sys,
+                                  gnutls_session_t session, const char *host)
+{
+    vlc_mutex_lock(&sys->lock);
+    struct gnutls_resumption *r = gnutls_ResumptionFind(sys, host);
+    if (r != NULL)
+        gnutls_session_set_data(session, r->data.data, r->data.size);
+    vlc_mutex_unlock(&sys->lock);
+}
+
+static void gnutls_ResumptionStore(gnutls_client_sys_t *sys,
+                                   gnutls_session_t session, const char *host)
+{
+    size_t len = strlen(host) + 1;
+    struct gnutls_resumption *r = malloc(sizeof (*r) + len);
+    if (unlikely(r == NULL))
+        return;
+
+    if (gnutls_session_get_data2(session, &r->data) != 0)
+    {
+        free(r);
+        return;
+    }
+    memcpy(r->host, host, len);
+
+    vlc_mutex_lock(&sys->lock);
+    struct gnutls_resumption *old = gnutls_ResumptionFind(sys, host);
+    if (old == NULL && sys->count >= GNUTLS_RESUMPTION_MAX)
+        old = vlc_list_last_entry_or_null(&sys->sessions,
+                                          struct gnutls_resumption, node);
+    if (old != NULL)
+    {
+        vlc_list_remove(&old->node);
+        sys->count--;
+    }
+    vlc_list_prepend(&r->node, &sys->sessions);
+    sys->count++;
+    vlc_mutex_unlock(&sys->lock);
+
+    if (old != NULL)
+        gnutls_ResumptionFree(old);
+}
+
 static void gnutls_Close (vlc_tls_t *tls)
 {
     vlc_tls_gnutls_t *priv = (vlc_tls_gnutls_t *)tls;
 
+    /* TLS 1.3 session tickets come after the handshake: save the session
+     * for resumption only once done with it. */
+    if (priv->resumable)
+        gnutls_ResumptionStore(priv->client, priv->session, priv->host);
+
     gnutls_deinit(priv->session);
+    free(priv->host);
     free(priv);
 }
 
@@ -297,6 +392,9 @@ static vlc_tls_gnutls_t *gnutls_SessionOpen(vlc_object_t *obj, int type,
 
     priv->session = session;
     priv->obj = obj;
+    priv->client = NULL;
+    priv->host = NULL;
+    priv->resumable = false;
 
     vlc_tls_t *tls = &priv->tls;
 
@@ -354,6 +452,8 @@ static int gnutls_Handshake(vlc_tls_t *tls, char **restrict alp)
         msg_Dbg(obj, " - encrypt then MAC (RFC7366) enabled");
     if (flags & GNUTLS_SFLAGS_FALSE_START)
         msg_Dbg(obj, " - false start (RFC7918) enabled");
+    if (gnutls_session_is_resumed(session))
+        msg_Dbg(obj, " - session resumed");
 
     if (alp != NULL)
     {
@@ -379,8 +479,9 @@ static vlc_tls_t *gnutls_ClientSessionOpen(vlc_tls_client_t *crd,
                                            vlc_tls_t *sk, const char *hostname,
                                            const char *const *alpn)
 {
+    gnutls_client_sys_t *sys = crd->sys;
     vlc_tls_gnutls_t *priv = gnutls_SessionOpen(VLC_OBJECT(crd), GNUTLS_CLIENT,
-                                                crd->sys, sk, alpn);
+                                                sys->x509, sk, alpn);
     if (priv == NULL)
         return NULL;
 
@@ -390,10 +491,17 @@ static vlc_tls_t *gnutls_ClientSessionOpen(vlc_tls_client_t *crd,
     gnutls_dh_set_prime_bits (session, 1024);
 
     if (likely(hostname != NULL))
+    {
         /* fill Server Name Indication */
         gnutls_server_name_set (session, GNUTLS_NAME_DNS,
                                 hostname, strlen (hostname));
 
+        priv->client = sys;
+        priv->host = strdup(hostname);
+        if (likely(priv->host != NULL))
+            gnutls_ResumptionLoad(sys, session, hostname);
+    }
+
     return &priv->tls;
 }
 
@@ -421,7 +529,10 @@ static int gnutls_ClientHandshake(vlc_tls_t *tls,
     }
 
     if (status == 0) /* Good certificate */
+    {
+        priv->resumable = priv->host != NULL;
         return 0;
+    }
 
     /* Bad certificate */
     gnutls_datum_t desc;
@@ -533,9 +644,13 @@ error:
 
 static void gnutls_ClientDestroy(vlc_tls_client_t *crd)
 {
-    gnutls_certificate_credentials_t x509 = crd->sys;
+    gnutls_client_sys_t *sys = crd->sys;
+    struct gnutls_resumption *r;
 
-    gnutls_certificate_free_credentials(x509);
+    vlc_list_foreach(r, &sys->sessions, node)
+        gnutls_ResumptionFree(r);
+    gnutls_certificate_free_credentials(sys->x509);
+    free(sys);
 }
 
 static const struct vlc_tls_client_operations gnutls_ClientOps =
@@ -550,6 +665,10 @@ static const struct vlc_tls_client_operations gnutls_ClientOps =
  */
 static int OpenClient(vlc_tls_client_t *crd)
 {
+    gnutls_client_sys_t *sys = malloc(sizeof (*sys));
+    if (unlikely(sys == NULL))
+        return VLC_ENOMEM;
+
     gnutls_certificate_credentials_t x509;
 
     gnutls_Banner(VLC_OBJECT(crd));
@@ -559,6 +678,7 @@ static int OpenClient(vlc_tls_client_t *crd)
     {
         msg_Err (crd, "cannot allocate credentials: %s",
                  gnutls_strerror (val));
+        free(sys);
         return VLC_EGENERIC;
     }
 
@@ -588,8 +708,13 @@ static int OpenClient(vlc_tls_client_t *crd)
     gnutls_certificate_set_verify_flags (x509,
                                          GNUTLS_VERIFY_ALLOW_X509_V1_CA_CRT);
 
+    sys->x509 = x509;
+    vlc_mutex_init(&sys->lock);
+    vlc_list_init(&sys->sessions);
+    sys->count = 0;
+
     crd->ops = &gnutls_ClientOps;
-    crd->sys = x509;
+    crd->sys = sys;
     return VLC_SUCCESS;
 }
 
@@ -48,14 +48,16 @@ Thumbnailer::Thumbnailer( vlc_medialibrary_module_t* ml )
         throw std::runtime_error( "Failed to instantiate a vlc_preparser_t" );
 }
 
-void Thumbnailer::onThumbnailComplete( input_item_t *, int, picture_t* thumbnail, void *data )
+void Thumbnailer::onThumbnailComplete( input_item_t *, int,
+                                       picture_t *const *thumbnails,
+                                       size_t count, void *data )
 {
     ThumbnailerCtx* ctx = static_cast<ThumbnailerCtx*>( data );
 
     vlc::threads::mutex_locker lock( ctx->thumbnailer->m_mutex );
     ctx->done = true;
-    if (thumbnail != nullptr)
-        ctx->thumbnail = picture_Hold(thumbnail);
+    if ( count > 0 && thumbnails[0] != nullptr )
+        ctx->thumbnail = picture_Hold( thumbnails[0] );
     ctx->thumbnailer->m_currentContext = nullptr;
     ctx->thumbnailer->m_cond.signal();
 }
@@ -82,12 +84,14 @@ bool Thumbnailer::generate( const medialibrary::IMedia&, const std::string& mrl,
             .speed = vlc_preparser_seek_arg::VLC_PREPARSER_SEEK_FAST,
         };
 
-        static const struct vlc_thumbnailer_cbs cbs = {
+        /* Decoded synchronously from the nearest keyframe, without spawning
+         * an input thread per media */
+        static const struct vlc_thumbnailer_storyboard_cbs cbs = {
             .on_ended = onThumbnailComplete,
         };
         vlc_preparser_req_id requestId =
-            vlc_preparser_GenerateThumbnail( m_thumbnailer.get(), item.get(),
-                                             &seek_arg, &cbs, &ctx );
+            vlc_preparser_GenerateThumbnails( m_thumbnailer.get(), item.get(),
+                                              &seek_arg, 1, &cbs, &ctx );
 
         if (requestId == VLC_PREPARSER_REQ_ID_INVALID)
         {
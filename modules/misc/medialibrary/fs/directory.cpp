@@ -37,6 +37,7 @@
 #include <algorithm>
 #include <cassert>
 #include <medialibrary/filesystem/Errors.h>
+#include <fcntl.h>
 #include <sys/stat.h>
 #include <system_error>
 #include <vector>
@@ -65,16 +66,14 @@ SDDirectory::mrl() const
 const std::vector<std::shared_ptr<IFile>> &
 SDDirectory::files() const
 {
-    if ( !m_read_done )
-        read();
+    ensureRead();
     return m_files;
 }
 
 const std::vector<std::shared_ptr<IDirectory>> &
 SDDirectory::dirs() const
 {
-    if ( !m_read_done )
-        read();
+    ensureRead();
     return m_dirs;
 }
 
@@ -194,6 +193,92 @@ static bool request_metadata_sync( libvlc_int_t *libvlc, input_item_t *media,
     return req.success;
 }
 
+bool
+SDDirectory::beginRead( bool wait ) const
+{
+    vlc::threads::mutex_locker lock( m_mutex );
+    while ( m_state == State::Reading )
+    {
+        if ( !wait )
+            return false;
+        m_cond.wait( m_mutex );
+    }
+    if ( m_state == State::Done )
+        return false;
+    m_state = State::Reading;
+    return true;
+}
+
+void
+SDDirectory::endRead( bool success ) const
+{
+    vlc::threads::mutex_locker lock( m_mutex );
+    if ( success )
+        m_state = State::Done;
+    else
+    {
+        m_files.clear();
+        m_dirs.clear();
+        m_state = State::Idle;
+    }
+    m_cond.broadcast();
+}
+
+void
+SDDirectory::ensureRead() const
+{
+    /* Wait for the prefetch of this directory, if any */
+    if ( !beginRead( true ) )
+        return;
+
+    try
+    {
+        read();
+    }
+    catch ( ... )
+    {
+        endRead( false );
+        throw;
+    }
+    endRead( true );
+
+    /* The discoverer is going to browse the subdirectories next */
+    m_fs.prefetch( m_dirs );
+}
+
+void
+SDDirectory::prefetch() const
+{
+    if ( !beginRead( false ) )
+        return;
+
+    bool success = true;
+    try
+    {
+        read();
+    }
+    catch ( ... )
+    {
+        /* Retried, and reported, when the directory is actually browsed */
+        success = false;
+    }
+    endRead( success );
+}
+
+namespace {
+
+struct DirFd
+{
+    ~DirFd()
+    {
+        if ( fd != -1 )
+            vlc_close( fd );
+    }
+    int fd = -1;
+};
+
+}
+
 void
 SDDirectory::read() const
 {
@@ -213,6 +298,18 @@ SDDirectory::read() const
         throw medialibrary::fs::errors::System(
             EIO, "Failed to browse directory: Unknown error" );
 
+    /* Stat the files by batch, relative to the directory, rather than
+     * resolving the full path of each file */
+    DirFd dir;
+#ifdef HAVE_FSTATAT
+    if ( m_fs.isNetworkFileSystem() == false )
+    {
+        const auto path = vlc::wrap_cptr( vlc_uri2path( m_mrl.c_str() ) );
+        if ( path != nullptr )
+            dir.fd = vlc_open( path.get(), O_RDONLY | O_DIRECTORY );
+    }
+#endif
+
     for ( const InputItemPtr& m : children )
     {
         const char* mrl = m.get()->psz_uri;
@@ -223,7 +320,7 @@ SDDirectory::read() const
         }
         else if ( type == ITEM_TYPE_FILE )
         {
-            addFile( mrl, IFile::LinkedFileType::None, {} );
+            addFile( mrl, IFile::LinkedFileType::None, {}, dir.fd );
             for ( auto i = 0; i < m->i_slaves; ++i )
             {
                 const auto* slave = m->pp_slaves[i];
@@ -231,16 +328,17 @@ SDDirectory::read() const
                                              ? IFile::LinkedFileType::SoundTrack
                                              : IFile::LinkedFileType::Subtitles;
 
-                addFile( slave->psz_uri, linked_type, mrl );
+                addFile( slave->psz_uri, linked_type, mrl, dir.fd );
             }
         }
     }
 
-    m_read_done = true;
+    m_fs.addFilesListed( m_files.size() );
 }
 
 void
-SDDirectory::addFile(std::string mrl, IFile::LinkedFileType fType, std::string linkedFile) const
+SDDirectory::addFile(std::string mrl, IFile::LinkedFileType fType, std::string linkedFile,
+                     int dirfd) const
 {
     time_t lastModificationDate = 0;
     uint64_t fileSize = 0;
@@ -249,8 +347,23 @@ SDDirectory::addFile(std::string mrl, IFile::LinkedFileType fType, std::string l
     {
         const auto path = vlc::wrap_cptr( vlc_uri2path( mrl.c_str() ) );
         struct stat stat;
+        int ret;
+
+        if ( path == nullptr )
+            throw errors::System{ EINVAL, "Failed to get file path" };
+
+#ifdef HAVE_FSTATAT
+        /* Slaves may be located in another directory */
+        if ( dirfd != -1 && mrl.compare( 0, m_mrl.length(), m_mrl ) == 0
+          && mrl.find( '/', m_mrl.length() ) == std::string::npos )
+            ret = fstatat( dirfd, strrchr( path.get(), '/' ) + 1, &stat, 0 );
+        else
+#else
+        VLC_UNUSED( dirfd );
+#endif
+            ret = vlc_stat( path.get(), &stat );
 
-        if ( vlc_stat( path.get(), &stat ) != 0 )
+        if ( ret != 0 )
         {
             if ( errno == EACCES )
                 return;
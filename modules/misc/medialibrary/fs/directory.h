@@ -24,6 +24,9 @@
 #include <medialibrary/filesystem/IDirectory.h>
 #include <medialibrary/filesystem/IFile.h>
 
+#include <vlc_common.h>
+#include <vlc_cxx_helpers.hpp>
+
 #include "fs.h"
 
 namespace vlc {
@@ -42,14 +45,25 @@ public:
     std::shared_ptr<fs::IFile> file( const std::string& mrl ) const override;
     bool contains( const std::string& file ) const override;
 
+    /* Read the listing in advance, from a worker thread */
+    void prefetch() const;
+
 private:
+    enum class State { Idle, Reading, Done };
+
+    void ensureRead() const;
+    bool beginRead( bool wait ) const;
+    void endRead( bool success ) const;
     void read() const;
-    void addFile( std::string mrl, fs::IFile::LinkedFileType, std::string linkedWith ) const;
+    void addFile( std::string mrl, fs::IFile::LinkedFileType, std::string linkedWith,
+                  int dirfd ) const;
 
     std::string m_mrl;
     SDFileSystemFactory &m_fs;
 
-    mutable bool m_read_done = false;
+    mutable vlc::threads::mutex m_mutex;
+    mutable vlc::threads::condition_variable m_cond;
+    mutable State m_state = State::Idle; /* protected by m_mutex */
     mutable std::vector<std::shared_ptr<fs::IFile>> m_files;
     mutable std::vector<std::shared_ptr<fs::IDirectory>> m_dirs;
     mutable std::shared_ptr<IDevice> m_device;
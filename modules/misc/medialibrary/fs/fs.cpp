@@ -23,6 +23,7 @@
 #endif
 
 #include <algorithm>
+#include <new>
 #include <vlc_services_discovery.h>
 #include <medialibrary/IDeviceLister.h>
 #include <medialibrary/filesystem/IDevice.h>
@@ -38,6 +39,16 @@ namespace vlc {
 
 using namespace ::medialibrary;
 
+/* Directories being listed or waiting to be, in advance of the discoverer */
+#define PREFETCH_MAX 256
+
+struct SDFileSystemFactory::PrefetchTask
+{
+    SDFileSystemFactory *fs;
+    std::shared_ptr<SDDirectory> dir;
+    struct vlc_runnable runnable;
+};
+
 SDFileSystemFactory::SDFileSystemFactory(vlc_object_t *parent,
                                          const std::string &scheme)
     : m_parent(parent)
@@ -48,6 +59,11 @@ SDFileSystemFactory::SDFileSystemFactory(vlc_object_t *parent,
                                m_scheme.length() ) != 0;
 }
 
+SDFileSystemFactory::~SDFileSystemFactory()
+{
+    stopPrefetch();
+}
+
 bool SDFileSystemFactory::initialize(const IMediaLibrary* ml)
 {
     m_deviceLister = ml->deviceLister(m_scheme);
@@ -116,6 +132,14 @@ SDFileSystemFactory::start(IFileSystemFactoryCb *callbacks)
 {
     assert( isStarted() == false );
     m_callbacks = callbacks;
+
+    int64_t threads = var_InheritInteger( m_parent, "ml-discovery-threads" );
+    if ( threads > 0 )
+    {
+        /* Not fatal, the directories are then only read on demand */
+        vlc::threads::mutex_locker lock( m_prefetchMutex );
+        m_executor = vlc_executor_New( threads );
+    }
     return m_deviceLister->start( this );
 }
 
@@ -123,10 +147,92 @@ void
 SDFileSystemFactory::stop()
 {
     assert( isStarted() == true );
+    stopPrefetch();
     m_deviceLister->stop();
     m_callbacks = nullptr;
 }
 
+void
+SDFileSystemFactory::stopPrefetch()
+{
+    vlc_executor_t *executor;
+    {
+        vlc::threads::mutex_locker lock( m_prefetchMutex );
+        executor = m_executor;
+        if ( executor == nullptr )
+            return;
+        m_executor = nullptr;
+
+        for ( auto it = begin( m_prefetchTasks ); it != end( m_prefetchTasks ); )
+        {
+            PrefetchTask *task = *it;
+            if ( vlc_executor_Cancel( executor, &task->runnable ) )
+            {
+                it = m_prefetchTasks.erase( it );
+                delete task;
+            }
+            else
+                ++it;
+        }
+    }
+    /* The running tasks remove themselves */
+    vlc_executor_WaitIdle( executor );
+    vlc_executor_Delete( executor );
+    assert( m_prefetchTasks.empty() );
+}
+
+void
+SDFileSystemFactory::prefetch(const std::vector<std::shared_ptr<IDirectory>> &dirs)
+{
+    vlc::threads::mutex_locker lock( m_prefetchMutex );
+    if ( m_executor == nullptr )
+        return;
+
+    for ( const auto& dir : dirs )
+    {
+        /* Bound the listings kept in memory ahead of the discoverer */
+        if ( m_prefetchTasks.size() >= PREFETCH_MAX )
+            break;
+
+        auto task = new (std::nothrow) PrefetchTask{
+            this, std::static_pointer_cast<SDDirectory>( dir ), {} };
+        if ( unlikely( task == nullptr ) )
+            break;
+        task->runnable.run = runPrefetch;
+        task->runnable.userdata = task;
+        m_prefetchTasks.push_back( task );
+        vlc_executor_Submit( m_executor, &task->runnable );
+    }
+}
+
+void
+SDFileSystemFactory::runPrefetch(void *data)
+{
+    auto task = static_cast<PrefetchTask *>( data );
+    SDFileSystemFactory *fs = task->fs;
+
+    task->dir->prefetch();
+
+    vlc::threads::mutex_locker lock( fs->m_prefetchMutex );
+    auto it = std::find( begin( fs->m_prefetchTasks ), end( fs->m_prefetchTasks ),
+                         task );
+    assert( it != end( fs->m_prefetchTasks ) );
+    fs->m_prefetchTasks.erase( it );
+    delete task;
+}
+
+void
+SDFileSystemFactory::addFilesListed(size_t count)
+{
+    m_filesListed.fetch_add( count, std::memory_order_relaxed );
+}
+
+uint64_t
+SDFileSystemFactory::filesListed() const
+{
+    return m_filesListed.load( std::memory_order_relaxed );
+}
+
 libvlc_int_t *
 SDFileSystemFactory::libvlc() const
 {
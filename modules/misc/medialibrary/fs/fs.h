@@ -21,9 +21,11 @@
 #ifndef SD_FS_H
 #define SD_FS_H
 
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <vlc_common.h>
+#include <vlc_executor.h>
 #include <vlc_threads.h>
 #include <vlc_cxx_helpers.hpp>
 #include <medialibrary/filesystem/IFileSystemFactory.h>
@@ -47,6 +49,8 @@ public:
     SDFileSystemFactory(vlc_object_t *m_parent,
                         const std::string &scheme);
 
+    ~SDFileSystemFactory();
+
     bool
     initialize( const IMediaLibrary* ml ) override;
 
@@ -83,6 +87,20 @@ public:
     libvlc_int_t *
     libvlc() const;
 
+    /**
+     * Read the listing of the directories in advance, from a bounded pool of
+     * worker threads
+     */
+    void
+    prefetch(const std::vector<std::shared_ptr<IDirectory>> &dirs);
+
+    void
+    addFilesListed(size_t count);
+
+    /* Number of files listed since the creation of the factory */
+    uint64_t
+    filesListed() const;
+
     void
     onDeviceMounted(const std::string& uuid, const std::string& mountpoint, bool removable) override;
 
@@ -100,6 +118,10 @@ private:
 
     std::shared_ptr<fs::IDevice> deviceByMrl(const std::string& mrl) const;
 
+    struct PrefetchTask;
+    static void runPrefetch(void *data);
+    void stopPrefetch();
+
 private:
     vlc_object_t *const m_parent;
     const std::string m_scheme;
@@ -110,6 +132,11 @@ private:
     mutable vlc::threads::condition_variable m_cond;
     std::vector<std::shared_ptr<IDevice>> m_devices;
     std::shared_ptr<IDeviceLister> m_deviceLister;
+
+    vlc::threads::mutex m_prefetchMutex;
+    vlc_executor_t *m_executor = nullptr; /* protected by m_prefetchMutex */
+    std::vector<PrefetchTask *> m_prefetchTasks; /* protected by m_prefetchMutex */
+    std::atomic<uint64_t> m_filesListed{ 0 };
 };
 
   } /* namespace medialibrary */
@@ -267,8 +267,19 @@ void MediaLibrary::onFoldersDeleted( std::set<int64_t> folderIds )
                                     VLC_ML_EVENT_FOLDER_DELETED );
 }
 
+uint64_t MediaLibrary::filesListed() const
+{
+    uint64_t files = 0;
+    for ( const auto& fs : m_fsFactories )
+        files += fs->filesListed();
+    return files;
+}
+
 void MediaLibrary::onDiscoveryStarted()
 {
+    m_discoveryStart = vlc_tick_now();
+    m_discoveryFiles = filesListed();
+
     vlc_ml_event_t ev;
     ev.i_type = VLC_ML_EVENT_DISCOVERY_STARTED;
     m_vlc_ml->cbs->pf_send_event( m_vlc_ml, &ev );
@@ -284,6 +295,17 @@ void MediaLibrary::onDiscoveryProgress( const std::string& entryPoint )
 
 void MediaLibrary::onDiscoveryCompleted()
 {
+    if ( m_discoveryStart != VLC_TICK_INVALID )
+    {
+        vlc_tick_t elapsed = vlc_tick_now() - m_discoveryStart;
+        uint64_t files = filesListed() - m_discoveryFiles;
+
+        msg_Info( m_vlc_ml, "Discovery completed: %" PRIu64 " files listed in "
+                  "%.1f s (%.0f files/s)", files, secf_from_vlc_tick( elapsed ),
+                  files / secf_from_vlc_tick( __MAX( elapsed, 1 ) ) );
+        m_discoveryStart = VLC_TICK_INVALID;
+    }
+
     vlc_ml_event_t ev;
     ev.i_type = VLC_ML_EVENT_DISCOVERY_COMPLETED;
     m_vlc_ml->cbs->pf_send_event( m_vlc_ml, &ev );
@@ -336,6 +358,22 @@ void MediaLibrary::onRootUnbanned( const std::string& entryPoint, bool success )
 
 void MediaLibrary::onParsingStatsUpdated( uint32_t done, uint32_t scheduled )
 {
+    if ( m_parsingStart == VLC_TICK_INVALID && done < scheduled )
+    {
+        m_parsingStart = vlc_tick_now();
+        m_parsingDone = done;
+    }
+    else if ( m_parsingStart != VLC_TICK_INVALID && done >= scheduled )
+    {
+        vlc_tick_t elapsed = vlc_tick_now() - m_parsingStart;
+        uint32_t parsed = done - __MIN( m_parsingDone, done );
+
+        msg_Info( m_vlc_ml, "Parsing completed: %" PRIu32 " items in %.1f s "
+                  "(%.1f items/s)", parsed, secf_from_vlc_tick( elapsed ),
+                  parsed / secf_from_vlc_tick( __MAX( elapsed, 1 ) ) );
+        m_parsingStart = VLC_TICK_INVALID;
+    }
+
     vlc_ml_event_t ev;
     ev.i_type = VLC_ML_EVENT_PARSING_PROGRESS_UPDATED;
     ev.parsing_progress.i_percent = (float)done / (float)scheduled * 100.f;
@@ -409,12 +447,13 @@ MediaLibrary* MediaLibrary::create( vlc_medialibrary_module_t* vlc_ml )
     medialibrary::SetupConfig cfg;
     cfg.deviceListers = { { "smb://", std::make_shared<vlc::medialibrary::DeviceLister>(
                                            VLC_OBJECT(vlc_ml) ) } };
-    cfg.fsFactories = {
+    FsFactories fsFactories = {
         std::make_shared<vlc::medialibrary::SDFileSystemFactory>(
                                     VLC_OBJECT( vlc_ml ), "file://"),
         std::make_shared<vlc::medialibrary::SDFileSystemFactory>(
                                     VLC_OBJECT( vlc_ml ), "smb://")
     };
+    cfg.fsFactories.assign( fsFactories.begin(), fsFactories.end() );
 
     cfg.parserServices = {
         std::make_shared<MetadataExtractor>( VLC_OBJECT( vlc_ml ) )
@@ -429,13 +468,15 @@ MediaLibrary* MediaLibrary::create( vlc_medialibrary_module_t* vlc_ml )
     if ( !ml )
         return nullptr;
 
-    return new MediaLibrary( vlc_ml, ml );
+    return new MediaLibrary( vlc_ml, ml, std::move( fsFactories ) );
 }
 
 MediaLibrary::MediaLibrary( vlc_medialibrary_module_t* vlc_ml,
-                            medialibrary::IMediaLibrary* ml )
+                            medialibrary::IMediaLibrary* ml,
+                            FsFactories fsFactories )
     : m_vlc_ml( vlc_ml )
     , m_ml( ml )
+    , m_fsFactories( std::move( fsFactories ) )
 {
 }
 
@@ -2311,6 +2352,10 @@ static void Close( vlc_object_t* obj )
 
 #define ML_VERBOSE _( "Extra verbose media library logs" )
 
+#define ML_DISCOVERY_THREADS_TEXT N_( "Directory listing threads" )
+#define ML_DISCOVERY_THREADS_LONGTEXT N_( "Number of threads listing the " \
+    "subdirectories in advance during a scan, 0 to list them on demand only" )
+
 vlc_module_begin()
     set_shortname(N_("media library"))
     set_description(N_( "Organize your media" ))
@@ -2318,4 +2363,6 @@ vlc_module_begin()
     set_capability("medialibrary", 100)
     set_callbacks(Open, Close)
     add_bool( "ml-verbose", false, ML_VERBOSE, nullptr )
+    add_integer_with_range( "ml-discovery-threads", 4, 0, 32,
+                            ML_DISCOVERY_THREADS_TEXT, ML_DISCOVERY_THREADS_LONGTEXT )
 vlc_module_end()
@@ -36,7 +36,9 @@
 #include <vlc_cxx_helpers.hpp>
 
 #include <cstdarg>
+#include <memory>
 #include <type_traits>
+#include <vector>
 
 struct vlc_event_t;
 struct vlc_object_t;
@@ -44,6 +46,12 @@ struct vlc_preparser_t;
 
 class Logger;
 
+namespace vlc {
+  namespace medialibrary {
+class SDFileSystemFactory;
+  }
+}
+
 class EmbeddedThumbnail : public medialibrary::parser::IEmbeddedThumbnail
 {
 public:
@@ -137,7 +145,9 @@ public:
     void stop() override;
 
 private:
-    static void onThumbnailComplete( input_item_t *, int, picture_t* thumbnail, void *data );
+    static void onThumbnailComplete( input_item_t *, int,
+                                     picture_t *const *thumbnails,
+                                     size_t count, void *data );
 
 private:
     vlc_medialibrary_module_t* m_ml;
@@ -187,10 +197,23 @@ private:
     static medialibrary::SortingCriteria sortingCriteria( int sort );
 
 private:
-    MediaLibrary( vlc_medialibrary_module_t* vlc_ml, medialibrary::IMediaLibrary* ml );
+    using FsFactories = std::vector<std::shared_ptr<vlc::medialibrary::SDFileSystemFactory>>;
+
+    MediaLibrary( vlc_medialibrary_module_t* vlc_ml, medialibrary::IMediaLibrary* ml,
+                  FsFactories fsFactories );
+
+    uint64_t filesListed() const;
 
     vlc_medialibrary_module_t* m_vlc_ml;
     std::unique_ptr<medialibrary::IMediaLibrary> m_ml;
+    FsFactories m_fsFactories;
+
+    /* Scan rates, only accessed from the discoverer and the parser threads
+     * respectively */
+    vlc_tick_t m_discoveryStart = VLC_TICK_INVALID;
+    uint64_t m_discoveryFiles = 0;
+    vlc_tick_t m_parsingStart = VLC_TICK_INVALID;
+    uint32_t m_parsingDone = 0;
 
     vlc::threads::mutex m_mutex;
     bool m_initialized = false; /* protected by m_mutex */
@@ -58,6 +58,13 @@
     "\"Fast Start\" files are optimized for downloads and allow the user " \
     "to start previewing the file while it is downloading.")
 
+#define FASTSTART_DURATION_TEXT N_("Expected duration for \"Fast Start\" (s)")
+#define FASTSTART_DURATION_LONGTEXT N_(\
+    "Reserve room for the index of a recording of about this duration at " \
+    "the start of the file, so that \"Fast Start\" files do not need to " \
+    "be rewritten at the end. The data is only moved if the index does not " \
+    "fit. 0 disables the reservation.")
+
 static int  Open   (vlc_object_t *);
 static void Close  (vlc_object_t *);
 static void CloseFrag  (vlc_object_t *);
@@ -71,6 +78,9 @@ vlc_module_begin ()
 
     add_bool(SOUT_CFG_PREFIX "faststart", false,
               FASTSTART_TEXT, FASTSTART_LONGTEXT)
+    add_integer(SOUT_CFG_PREFIX "faststart-duration", 0,
+                FASTSTART_DURATION_TEXT, FASTSTART_DURATION_LONGTEXT)
+        change_integer_range(0, 86400 * 7)
     set_capability("sout mux", 5)
     add_shortcut("mp4", "mov", "3gp")
     set_callbacks(Open, Close)
@@ -89,7 +99,7 @@ vlc_module_end ()
  * Exported prototypes
  *****************************************************************************/
 static const char *const ppsz_sout_options[] = {
-    "faststart", NULL
+    "faststart", "faststart-duration", NULL
 };
 
 static int Control(sout_mux_t *, int, va_list);
@@ -159,6 +169,11 @@ typedef struct
     mp4mux_handle_t *muxh;
     bool b_3gp;
     bool b_fast_start;
+    vlc_tick_t i_fast_start_duration;
+
+    /* space reserved for the moov, as a free box */
+    uint64_t i_reserved_pos;
+    uint64_t i_reserved_size;
 
     /* global */
     bool     b_header_sent;
@@ -248,6 +263,120 @@ static void ReorderStreams(mp4_stream_t **pp_streams, unsigned int i_streams)
         mp4mux_track_ChangeID(pp_streams[i]->tinfo, i+1);
 }
 
+/* Upper bound of the moov bytes per sample: stsz, stts, ctts, stss,
+ * and a 64 bits chunk offset plus a stsc entry per chunk */
+#define MOOV_SAMPLE_MAX_SIZE 44
+#define MOOV_TRACK_MAX_SIZE  2048
+#define MOOV_RESERVE_MAX     (UINT64_C(256) << 20)
+
+static uint64_t EstimateMoovSize(const sout_mux_sys_t *p_sys)
+{
+    const double i_duration = secf_from_vlc_tick(p_sys->i_fast_start_duration);
+    uint64_t i_size = 1024; /* mvhd, udta */
+
+    for (unsigned int i = 0; i < p_sys->i_nb_streams; i++)
+    {
+        const es_format_t *fmt = mp4mux_track_GetFmt(p_sys->pp_streams[i]->tinfo);
+        double f_rate; /* samples per second */
+
+        switch (fmt->i_cat)
+        {
+            case VIDEO_ES:
+                f_rate = (fmt->video.i_frame_rate && fmt->video.i_frame_rate_base)
+                       ? (double)fmt->video.i_frame_rate / fmt->video.i_frame_rate_base
+                       : 60.;
+                break;
+            case AUDIO_ES:
+                f_rate = (double)(fmt->audio.i_rate ? fmt->audio.i_rate : 48000)
+                       / (fmt->audio.i_frame_length ? fmt->audio.i_frame_length : 1024);
+                break;
+            default:
+                f_rate = 2.;
+                break;
+        }
+
+        i_size += MOOV_TRACK_MAX_SIZE + fmt->i_extra;
+        i_size += (uint64_t)(f_rate * i_duration + 1.) * MOOV_SAMPLE_MAX_SIZE;
+    }
+
+    return __MIN(i_size, MOOV_RESERVE_MAX);
+}
+
+static int WriteReservedSpace(sout_mux_t *p_mux)
+{
+    sout_mux_sys_t *p_sys = p_mux->p_sys;
+    uint64_t i_size = EstimateMoovSize(p_sys);
+
+    msg_Dbg(p_mux, "reserving %"PRIu64" bytes for the moov", i_size);
+
+    /* The reservation can be large, write it by pieces */
+    for (uint64_t i_done = 0; i_done < i_size;)
+    {
+        size_t i_chunk = __MIN(32768, i_size - i_done);
+        block_t *p_free = block_Alloc(i_chunk);
+        if (!p_free)
+            return VLC_ENOMEM;
+
+        memset(p_free->p_buffer, 0, i_chunk);
+        if (i_done == 0)
+        {
+            SetDWBE(p_free->p_buffer, i_size);
+            memcpy(&p_free->p_buffer[4], "free", 4);
+        }
+        sout_AccessOutWrite(p_mux->p_access, p_free);
+        i_done += i_chunk;
+    }
+
+    p_sys->i_reserved_pos = p_sys->i_pos;
+    p_sys->i_reserved_size = i_size;
+    p_sys->i_pos += i_size;
+    p_sys->i_mdat_pos = p_sys->i_pos;
+
+    return VLC_SUCCESS;
+}
+
+/* Returns by how much the data must move for the moov to fit in place of
+ * the reserved space, if any */
+static uint64_t GetMoovShift(const sout_mux_sys_t *p_sys, uint64_t i_moov)
+{
+    if (i_moov > p_sys->i_reserved_size)
+        return i_moov - p_sys->i_reserved_size;
+
+    /* The remainder is too small for a free box: make it one */
+    uint64_t i_left = p_sys->i_reserved_size - i_moov;
+    return (i_left > 0 && i_left < 8) ? 8 - i_left : 0;
+}
+
+/* Writes the moov in place of the reserved free box, if it fits */
+static bool WriteReservedMoov(sout_mux_t *p_mux, bo_t *moov)
+{
+    sout_mux_sys_t *p_sys = p_mux->p_sys;
+    const uint64_t i_moov = bo_size(moov);
+
+    if (i_moov > p_sys->i_reserved_size)
+        return false;
+
+    /* The remainder must still be a valid box */
+    uint64_t i_left = p_sys->i_reserved_size - i_moov;
+    if (i_left > 0 && i_left < 8)
+        return false;
+
+    bo_t freebox;
+    if (i_left > 0)
+    {
+        if (!bo_init(&freebox, 8))
+            return false;
+        bo_add_32be(&freebox, i_left);
+        bo_add_fourcc(&freebox, "free");
+    }
+
+    sout_AccessOutSeek(p_mux->p_access, p_sys->i_reserved_pos);
+    box_send(p_mux, moov);
+    if (i_left > 0)
+        sout_AccessOutWrite(p_mux->p_access, freebox.b);
+    return true;
+}
+
 static int WriteSlowStartHeader(sout_mux_t *p_mux)
 {
     sout_mux_sys_t *p_sys = p_mux->p_sys;
@@ -265,6 +394,13 @@ static int WriteSlowStartHeader(sout_mux_t *p_mux)
         box_send(p_mux, box);
     }
 
+    if (p_sys->b_fast_start && p_sys->i_fast_start_duration > 0)
+    {
+        int i_ret = WriteReservedSpace(p_mux);
+        if (i_ret != VLC_SUCCESS)
+            return i_ret;
+    }
+
     /* Now add mdat header */
     box = box_new("mdat");
     if(!box)
@@ -311,6 +447,11 @@ static int Open(vlc_object_t *p_this)
     p_sys->pp_streams   = NULL;
     p_sys->i_mdat_pos   = 0;
     p_sys->b_header_sent = false;
+    p_sys->b_fast_start = var_GetBool(p_mux, SOUT_CFG_PREFIX "faststart");
+    p_sys->i_fast_start_duration = vlc_tick_from_sec(
+            var_GetInteger(p_mux, SOUT_CFG_PREFIX "faststart-duration"));
+    p_sys->i_reserved_pos = 0;
+    p_sys->i_reserved_size = 0;
 
     p_sys->i_read_duration   = 0;
     p_sys->i_written_duration= 0;
@@ -376,7 +517,19 @@ static void Close(vlc_object_t *p_this)
     bo_t *moov = mp4mux_GetMoov(p_sys->muxh, VLC_OBJECT(p_mux), 0);
 
     /* Check we need to create "fast start" files */
-    p_sys->b_fast_start = var_GetBool(p_this, SOUT_CFG_PREFIX "faststart");
+    if (p_sys->b_fast_start && moov && moov->b && p_sys->i_reserved_size > 0)
+    {
+        if (WriteReservedMoov(p_mux, moov))
+        {
+            moov = NULL;
+            p_sys->b_fast_start = false;
+        }
+        else
+            msg_Warn(p_this, "moov (%zu bytes) does not fit in the reserved "
+                     "space (%"PRIu64" bytes), moving data",
+                     bo_size(moov), p_sys->i_reserved_size);
+    }
+
     while (p_sys->b_fast_start && moov && moov->b)
     {
         /* Move data to the end of the file so we can fit the moov header
@@ -398,9 +551,13 @@ static void Close(vlc_object_t *p_this)
         }
         /* We now know our final MOOV size */
 
+        /* The moov replaces the reserved space, the data only moves by
+         * what is missing */
+        const uint64_t i_shift = GetMoovShift(p_sys, bo_size(moov));
+
         /* Fix-up samples to chunks table in MOOV header to they point to next MDAT location */
-        mp4mux_ShiftSamples(p_sys->muxh, bo_size(moov));
-        msg_Dbg(p_this,"Moving data by %"PRIu64, (uint64_t)bo_size(moov));
+        mp4mux_ShiftSamples(p_sys->muxh, i_shift);
+        msg_Dbg(p_this,"Moving data by %"PRIu64, i_shift);
         bo_t *shifted = mp4mux_GetMoov(p_sys->muxh, VLC_OBJECT(p_mux), 0);
         if(!shifted)
         {
@@ -428,7 +585,7 @@ static void Close(vlc_object_t *p_this)
                 break;
             }
             sout_AccessOutSeek(p_mux->p_access, p_sys->i_mdat_pos + i_mdatsize +
-                               bo_size(moov) - i_chunk);
+                               i_shift - i_chunk);
             sout_AccessOutWrite(p_mux->p_access, p_buf);
             i_mdatsize -= i_chunk;
         }
@@ -438,15 +595,27 @@ static void Close(vlc_object_t *p_this)
 
         /* Update pos pointers */
         i_moov_pos = p_sys->i_mdat_pos;
-        p_sys->i_mdat_pos += bo_size(moov);
+        p_sys->i_mdat_pos += i_shift;
 
         p_sys->b_fast_start = false;
+
+        if (p_sys->i_reserved_size > 0)
+        {
+            /* Which now fits the grown reserved space */
+            p_sys->i_reserved_size += i_shift;
+            if (WriteReservedMoov(p_mux, moov))
+                moov = NULL;
+            else
+                i_moov_pos = p_sys->i_reserved_pos;
+        }
     }
 
     /* Write MOOV header */
-    sout_AccessOutSeek(p_mux->p_access, i_moov_pos);
     if (moov != NULL)
+    {
+        sout_AccessOutSeek(p_mux->p_access, i_moov_pos);
         box_send(p_mux, moov);
+    }
 
 cleanup:
     /* Clean-up */
@@ -0,0 +1,132 @@
+/*****************************************************************************
+ * slab.c: recycled fixed size blocks
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+#include <vlc_block.h>
+#include <vlc_atomic.h>
+
+#include "slab.h"
+
+struct ts_slab_pool_t
+{
+    vlc_mutex_t lock;
+    vlc_atomic_rc_t rc; /* the owner and each block in use */
+    block_t *p_free;
+    unsigned i_free;
+    unsigned i_max_free;
+    size_t i_size;
+    bool b_deleted;
+};
+
+typedef struct
+{
+    block_t self;
+    ts_slab_pool_t *pool;
+    max_align_t data[];
+} ts_slab_t;
+
+static void PoolRelease( ts_slab_pool_t *pool )
+{
+    if( !vlc_atomic_rc_dec( &pool->rc ) )
+        return;
+
+    while( pool->p_free != NULL )
+    {
+        ts_slab_t *slab = container_of( pool->p_free, ts_slab_t, self );
+        pool->p_free = slab->self.p_next;
+        free( slab );
+    }
+    free( pool );
+}
+
+static void SlabRelease( block_t *p_block )
+{
+    ts_slab_t *slab = container_of( p_block, ts_slab_t, self );
+    ts_slab_pool_t *pool = slab->pool;
+
+    vlc_mutex_lock( &pool->lock );
+    if( !pool->b_deleted && pool->i_free < pool->i_max_free )
+    {
+        slab->self.p_next = pool->p_free;
+        pool->p_free = &slab->self;
+        pool->i_free++;
+        slab = NULL;
+    }
+    vlc_mutex_unlock( &pool->lock );
+
+    free( slab );
+    PoolRelease( pool );
+}
+
+static const struct vlc_block_callbacks slab_cbs = {
+    SlabRelease,
+};
+
+ts_slab_pool_t *ts_slab_pool_New( size_t i_size, unsigned i_max_free )
+{
+    ts_slab_pool_t *pool = malloc( sizeof(*pool) );
+    if( unlikely(pool == NULL) )
+        return NULL;
+
+    vlc_mutex_init( &pool->lock );
+    vlc_atomic_rc_init( &pool->rc );
+    pool->p_free = NULL;
+    pool->i_free = 0;
+    pool->i_max_free = i_max_free;
+    pool->i_size = i_size;
+    pool->b_deleted = false;
+    return pool;
+}
+
+void ts_slab_pool_Delete( ts_slab_pool_t *pool )
+{
+    vlc_mutex_lock( &pool->lock );
+    pool->b_deleted = true;
+    vlc_mutex_unlock( &pool->lock );
+    PoolRelease( pool );
+}
+
+block_t *ts_slab_Alloc( ts_slab_pool_t *pool )
+{
+    ts_slab_t *slab = NULL;
+
+    vlc_mutex_lock( &pool->lock );
+    if( pool->p_free != NULL )
+    {
+        slab = container_of( pool->p_free, ts_slab_t, self );
+        pool->p_free = slab->self.p_next;
+        pool->i_free--;
+    }
+    vlc_mutex_unlock( &pool->lock );
+
+    if( slab == NULL )
+    {
+        slab = malloc( sizeof(*slab) + pool->i_size );
+        if( unlikely(slab == NULL) )
+            return NULL;
+        slab->pool = pool;
+    }
+
+    vlc_atomic_rc_inc( &pool->rc );
+    return block_Init( &slab->self, &slab_cbs, slab->data, pool->i_size );
+}
@@ -0,0 +1,49 @@
+/*****************************************************************************
+ * slab.h: recycled fixed size blocks
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifndef VLC_MPEG_SLAB_H_
+#define VLC_MPEG_SLAB_H_
+
+/**
+ * Pool of blocks of a fixed size.
+ *
+ * Released blocks go back to the pool instead of the heap. Blocks can be
+ * released from any thread, including after the pool was deleted.
+ */
+typedef struct ts_slab_pool_t ts_slab_pool_t;
+
+/**
+ * Creates a pool.
+ *
+ * \param i_size size of the blocks
+ * \param i_max_free maximum number of released blocks kept for reuse
+ */
+ts_slab_pool_t *ts_slab_pool_New( size_t i_size, unsigned i_max_free );
+
+/**
+ * Deletes a pool. Blocks still in use are freed when released.
+ */
+void ts_slab_pool_Delete( ts_slab_pool_t * );
+
+/**
+ * Gets a block of the pool size, with default properties.
+ */
+block_t *ts_slab_Alloc( ts_slab_pool_t * );
+
+#endif
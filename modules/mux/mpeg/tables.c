@@ -84,6 +84,7 @@ error:
 
 void BuildPAT( dvbpsi_t *p_dvbpsi,
                void *p_opaque, PEStoTSCallback pf_callback,
+               PEStoTSAllocator pf_alloc,
                int i_tsid, int i_pat_version_number,
                tsmux_stream_t *p_pat,
                unsigned i_programs, tsmux_stream_t *p_pmt, const int *pi_programs_number )
@@ -102,7 +103,8 @@ void BuildPAT( dvbpsi_t *p_dvbpsi,
         block_t *p_block = WritePSISection( p_section );
         if( likely(p_block) )
         {
-            PEStoTS( p_opaque, pf_callback, p_block, p_pat->i_pid,
+            PEStoTS( p_opaque, pf_callback, pf_alloc,
+                     p_block, p_pat->i_pid,
                      &p_pat->b_discontinuity, &p_pat->i_continuity_counter );
         }
         dvbpsi_DeletePSISections( p_section );
@@ -431,6 +433,7 @@ static inline size_t Write_AnnexA_String( uint8_t *p_dest, const char *p_src )
 void BuildPMT( dvbpsi_t *p_dvbpsi, vlc_object_t *p_object,
                ts_mux_standard standard,
                void *p_opaque, PEStoTSCallback pf_callback,
+               PEStoTSAllocator pf_alloc,
                int i_tsid, int i_pmt_version_number,
                int i_pcr_pid,
                sdt_psi_t *p_sdt,
@@ -695,7 +698,8 @@ void BuildPMT( dvbpsi_t *p_dvbpsi, vlc_object_t *p_object,
             block_t *pmt = WritePSISection( sect );
             if( likely(pmt) )
             {
-                PEStoTS( p_opaque, pf_callback, pmt, p_pmt[i].i_pid,
+                PEStoTS( p_opaque, pf_callback, pf_alloc,
+                     pmt, p_pmt[i].i_pid,
                          &p_pmt[i].b_discontinuity, &p_pmt[i].i_continuity_counter );
             }
             dvbpsi_DeletePSISections(sect);
@@ -740,7 +744,8 @@ void BuildPMT( dvbpsi_t *p_dvbpsi, vlc_object_t *p_object,
             block_t *p_sdtblock = WritePSISection( sect );
             if( likely(p_sdtblock) )
             {
-                PEStoTS( p_opaque, pf_callback, p_sdtblock, p_sdt->ts.i_pid,
+                PEStoTS( p_opaque, pf_callback, pf_alloc,
+                     p_sdtblock, p_sdt->ts.i_pid,
                          &p_sdt->ts.b_discontinuity, &p_sdt->ts.i_continuity_counter );
             }
             dvbpsi_DeletePSISections( sect );
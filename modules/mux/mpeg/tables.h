@@ -37,6 +37,7 @@ block_t * WritePSISection( dvbpsi_psi_section_t* p_section );
 
 void BuildPAT( dvbpsi_t *p_dvbpsi,
                void *p_opaque, PEStoTSCallback pf_callback,
+               PEStoTSAllocator pf_alloc,
                int i_tsid, int i_pat_version_number,
                tsmux_stream_t *p_pat,
                unsigned i_programs, tsmux_stream_t *p_pmt, const int *pi_programs_number );
@@ -58,6 +59,7 @@ typedef enum ts_mux_standard
 void BuildPMT( dvbpsi_t *p_dvbpsi, vlc_object_t *p_object,
                ts_mux_standard,
                void *p_opaque, PEStoTSCallback pf_callback,
+               PEStoTSAllocator pf_alloc,
                int i_tsid, int i_pmt_version_number,
                int i_pcr_pid,
                sdt_psi_t *p_sdt,
@@ -48,6 +48,7 @@
 #include "pes.h"
 #include "csa.h"
 #include "tsutil.h"
+#include "slab.h"
 #include "streams.h"
 
 # include <dvbpsi/dvbpsi.h>
@@ -183,6 +184,11 @@ static const char *const ts_standards_list_text[] =
     "The encryption routines subtract the TS-header from the value before " \
     "encrypting." )
 
+#define SLAB_TEXT N_("TS packets per output block")
+#define SLAB_LONGTEXT N_("Write the TS packets into contiguous output " \
+    "blocks of this many packets, e.g. 7 to fill an UDP datagram. " \
+    "0 outputs one block per packet." )
+
 #define SOUT_CFG_PREFIX "sout-ts-"
 #define MAX_PMT 64       /* Maximum number of programs. FIXME: I just chose an arbitrary number. Where is the maximum in the spec? */
 #define MAX_PMT_PID 64       /* Maximum pids in each pmt.  FIXME: I just chose an arbitrary number. Where is the maximum in the spec? */
@@ -222,6 +228,8 @@ vlc_module_begin ()
 
     add_integer( SOUT_CFG_PREFIX "pcr", 70, PCR_TEXT, PCR_LONGTEXT)
     add_integer( SOUT_CFG_PREFIX "dts-delay", 400, DTS_TEXT, DTS_LONGTEXT)
+    add_integer( SOUT_CFG_PREFIX "slab", 0, SLAB_TEXT, SLAB_LONGTEXT)
+        change_integer_range( 0, 348 )
 
     add_obsolete_integer( "sout-ts-bmin" ) /* since 4.0.0 */
     add_obsolete_integer( "sout-ts-bmax" ) /* since 4.0.0 */
@@ -245,7 +253,7 @@ static const char *const ppsz_sout_options[] = {
     "netid", "sdtdesc",
     "es-id-pid", "shaping", "pcr", "use-key-frames",
     "dts-delay", "csa-ck", "csa2-ck", "csa-use", "csa-pkt", "crypt-audio", "crypt-video",
-    "muxpmt", "program-pmt", "alignment",
+    "muxpmt", "program-pmt", "alignment", "slab",
     NULL
 };
 
@@ -360,6 +368,10 @@ typedef struct
     int             i_csa_pkt_size;
     bool            b_crypt_audio;
     bool            b_crypt_video;
+
+    /* slab output, NULL if disabled */
+    ts_slab_pool_t  *p_packet_pool;
+    ts_slab_pool_t  *p_slab_pool;
 } sout_mux_sys_t;
 
 
@@ -702,6 +714,25 @@ static int Open( vlc_object_t *p_this )
 
     p_sys->b_use_key_frames = var_GetBool( p_mux, SOUT_CFG_PREFIX "use-key-frames" );
 
+    unsigned i_slab = var_GetInteger( p_mux, SOUT_CFG_PREFIX "slab" );
+    if( i_slab > 0 )
+    {
+        /* TS packets never leave the muxer, only the slabs do */
+        p_sys->p_packet_pool = ts_slab_pool_New( 188, 4096 );
+        p_sys->p_slab_pool = ts_slab_pool_New( 188 * i_slab, 256 );
+        if( !p_sys->p_packet_pool || !p_sys->p_slab_pool )
+        {
+            if( p_sys->p_packet_pool )
+                ts_slab_pool_Delete( p_sys->p_packet_pool );
+            if( p_sys->p_slab_pool )
+                ts_slab_pool_Delete( p_sys->p_slab_pool );
+            dvbpsi_delete( p_sys->p_dvbpsi );
+            free( p_sys );
+            return VLC_ENOMEM;
+        }
+        msg_Dbg( p_mux, "writing %u TS packets per block", i_slab );
+    }
+
     p_mux->p_sys        = p_sys;
 
     csaSetup( p_this );
@@ -739,6 +770,12 @@ static void Close( vlc_object_t * p_this )
         free( p_sys->sdt.desc[i].psz_provider );
     }
 
+    if( p_sys->p_slab_pool )
+    {
+        ts_slab_pool_Delete( p_sys->p_slab_pool );
+        ts_slab_pool_Delete( p_sys->p_packet_pool );
+    }
+
     free( p_sys );
 }
 
@@ -1492,6 +1529,8 @@ static int MuxStreams( sout_mux_t *p_mux )
 
         /* Build the TS packet */
         block_t *p_ts = TSNew( p_mux, p_stream, b_pcr );
+        if( unlikely(p_ts == NULL) )
+            break;
         if( p_stream->ts.b_scramble )
             p_ts->i_flags |= BLOCK_FLAG_SCRAMBLED;
 
@@ -1733,6 +1772,7 @@ static int TSDate( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
     /* msg_Dbg( p_mux, "real pck=%d", i_packet_count ); */
     block_t *p_list = NULL;
     block_t **pp_last = &p_list;
+    block_t *p_slab = NULL;
     for (int i = 0; i < i_packet_count; i++ )
     {
         block_t *p_ts = BufferChainGet( p_chain_ts );
@@ -1756,8 +1796,47 @@ static int TSDate( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
         /* latency */
         p_ts->i_dts += p_sys->i_shaping_delay * 3 / 2;
 
-        block_ChainLastAppend( &pp_last, p_ts );
+        if( p_sys->p_slab_pool == NULL )
+        {
+            block_ChainLastAppend( &pp_last, p_ts );
+            continue;
+        }
+
+        /* Start a new slab at segmentation points, so that the flags of
+         * the first packet still apply to the whole block */
+        if( p_slab != NULL && p_slab->i_buffer > 0 &&
+            ( p_ts->i_flags & (BLOCK_FLAG_HEADER|BLOCK_FLAG_TYPE_I) ) )
+        {
+            block_ChainLastAppend( &pp_last, p_slab );
+            p_slab = NULL;
+        }
+        if( p_slab == NULL )
+        {
+            p_slab = ts_slab_Alloc( p_sys->p_slab_pool );
+            if( unlikely(p_slab == NULL) )
+            {
+                block_ChainLastAppend( &pp_last, p_ts );
+                continue;
+            }
+            p_slab->i_buffer = 0;
+            p_slab->i_dts = p_ts->i_dts;
+            p_slab->i_flags = p_ts->i_flags & (BLOCK_FLAG_HEADER|BLOCK_FLAG_TYPE_I);
+        }
+
+        memcpy( &p_slab->p_buffer[p_slab->i_buffer], p_ts->p_buffer, 188 );
+        p_slab->i_buffer += 188;
+        p_slab->i_length += p_ts->i_length;
+        block_Release( p_ts );
+
+        if( p_slab->i_buffer + 188 > p_slab->i_size )
+        {
+            block_ChainLastAppend( &pp_last, p_slab );
+            p_slab = NULL;
+        }
     }
+    if( p_slab != NULL )
+        block_ChainLastAppend( &pp_last, p_slab );
+
     ssize_t written = 0;
     if ( p_list != NULL )
         written = sout_AccessOutWrite( p_mux->p_access, p_list );
@@ -1767,7 +1846,7 @@ static int TSDate( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
 static block_t *TSNew( sout_mux_t *p_mux, sout_input_sys_t *p_stream,
                        bool b_pcr )
 {
-    VLC_UNUSED(p_mux);
+    sout_mux_sys_t *p_sys = p_mux->p_sys;
     block_t *p_pes = p_stream->state.chain_pes.p_first;
 
     bool b_new_pes = false;
@@ -1787,7 +1866,10 @@ static block_t *TSNew( sout_mux_t *p_mux, sout_input_sys_t *p_stream,
         b_adaptation_field = true;
     }
 
-    block_t *p_ts = block_Alloc( 188 );
+    block_t *p_ts = p_sys->p_packet_pool ? ts_slab_Alloc( p_sys->p_packet_pool )
+                                         : block_Alloc( 188 );
+    if( unlikely(p_ts == NULL) )
+        return NULL;
 
     if (b_new_pes && !(p_pes->i_flags & BLOCK_FLAG_NO_KEYFRAME) && p_pes->i_flags & BLOCK_FLAG_TYPE_I)
     {
@@ -1880,12 +1962,32 @@ static void TSSetPCR( block_t *p_ts, vlc_tick_t i_dts )
     p_ts->p_buffer[11] = 0; /* we don't set PCR extension */
 }
 
+typedef struct
+{
+    sout_buffer_chain_t *c;
+    ts_slab_pool_t *p_pool;
+} psi_output_t;
+
+static void PSIAppend( void *p_opaque, block_t *p_ts )
+{
+    psi_output_t *out = p_opaque;
+    BufferChainAppend( out->c, p_ts );
+}
+
+static block_t *PSIAlloc( void *p_opaque )
+{
+    psi_output_t *out = p_opaque;
+    /* PSI packets are copied to the slabs along with the others */
+    return out->p_pool ? ts_slab_Alloc( out->p_pool ) : block_Alloc( 188 );
+}
+
 void GetPAT( sout_mux_t *p_mux, sout_buffer_chain_t *c )
 {
     sout_mux_sys_t       *p_sys = p_mux->p_sys;
+    psi_output_t out = { c, p_sys->p_packet_pool };
 
     BuildPAT( p_sys->p_dvbpsi,
-              c, (PEStoTSCallback)BufferChainAppend,
+              &out, PSIAppend, PSIAlloc,
               p_sys->i_tsid, p_sys->i_pat_version_number,
               &p_sys->pat,
               p_sys->i_num_pmt, p_sys->pmt, p_sys->i_pmt_program_number );
@@ -1894,6 +1996,7 @@ void GetPAT( sout_mux_t *p_mux, sout_buffer_chain_t *c )
 static void GetPMT( sout_mux_t *p_mux, sout_buffer_chain_t *c )
 {
     sout_mux_sys_t *p_sys = p_mux->p_sys;
+    psi_output_t out = { c, p_sys->p_packet_pool };
     pes_mapped_stream_t mapped[p_mux->i_nb_inputs];
 
     for (int i_stream = 0; i_stream < p_mux->i_nb_inputs; i_stream++ )
@@ -1913,7 +2016,7 @@ static void GetPMT( sout_mux_t *p_mux, sout_buffer_chain_t *c )
     }
 
     BuildPMT( p_sys->p_dvbpsi, VLC_OBJECT(p_mux), p_sys->standard,
-              c, (PEStoTSCallback)BufferChainAppend,
+              &out, PSIAppend, PSIAlloc,
               p_sys->i_tsid, p_sys->i_pmt_version_number,
               ((sout_input_sys_t *)p_sys->p_pcr_input->p_sys)->ts.i_pid,
               &p_sys->sdt,
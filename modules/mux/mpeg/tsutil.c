@@ -26,7 +26,8 @@
 
 #include "tsutil.h"
 
-void PEStoTS( void *p_opaque, PEStoTSCallback pf_callback, block_t *p_pes,
+void PEStoTS( void *p_opaque, PEStoTSCallback pf_callback,
+              PEStoTSAllocator pf_alloc, block_t *p_pes,
               uint16_t i_pid, bool *pb_discontinuity, uint8_t *pi_continuity_counter )
 {
     /* get PES total size */
@@ -50,7 +51,12 @@ void PEStoTS( void *p_opaque, PEStoTSCallback pf_callback, block_t *p_pes,
 
         int i_copy = __MIN( i_size, 184 );
         bool b_adaptation_field = i_size < 184;
-        block_t *p_ts = block_Alloc( 188 );
+        block_t *p_ts = pf_alloc ? pf_alloc( p_opaque ) : block_Alloc( 188 );
+        if( unlikely(p_ts == NULL) )
+        {
+            block_ChainRelease( p_pes );
+            return;
+        }
 
         p_ts->p_buffer[0] = 0x47;
         p_ts->p_buffer[1] = ( b_new_pes ? 0x40 : 0x00 )|
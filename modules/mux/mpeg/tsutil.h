@@ -21,8 +21,11 @@
 #define VLC_MPEG_TSUTIL_H_
 
 typedef void(*PEStoTSCallback)(void *, block_t *);
+/* Returns a block of 188 bytes, NULL to use the heap */
+typedef block_t *(*PEStoTSAllocator)(void *);
 
-void PEStoTS( void *p_opaque, PEStoTSCallback pf_callback, block_t *p_pes,
+void PEStoTS( void *p_opaque, PEStoTSCallback pf_callback,
+              PEStoTSAllocator pf_alloc, block_t *p_pes,
               uint16_t i_pid, bool *pb_discontinuity, uint8_t *pi_continuity_counter );
 
 #endif
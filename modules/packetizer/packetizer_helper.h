@@ -46,6 +46,7 @@ typedef struct
     int i_state;
     block_bytestream_t bytestream;
     size_t i_offset;
+    block_startcode_cursor_t cursor; /* next startcode lookup resume point */
 
     int i_startcode;
     const uint8_t *p_startcode;
@@ -78,6 +79,7 @@ static inline void packetizer_Init( packetizer_t *p_pack,
     p_pack->i_state = STATE_NOSYNC;
     block_BytestreamInit( &p_pack->bytestream );
     p_pack->i_offset = 0;
+    block_StartcodeCursorReset( &p_pack->cursor );
 
     p_pack->i_au_prepend = i_au_prepend;
     p_pack->p_au_prepend = p_au_prepend;
@@ -103,6 +105,7 @@ static inline void packetizer_Flush( packetizer_t *p_pack )
     p_pack->i_state = STATE_NOSYNC;
     block_BytestreamEmpty( &p_pack->bytestream );
     p_pack->i_offset = 0;
+    block_StartcodeCursorReset( &p_pack->cursor );
     p_pack->pf_reset( p_pack->p_private, true );
 }
 
@@ -122,6 +125,7 @@ static block_t *packetizer_PacketizeBlock( packetizer_t *p_pack, block_t **pp_bl
         p_pack->i_state = STATE_NOSYNC;
         block_BytestreamEmpty( &p_pack->bytestream );
         p_pack->i_offset = 0;
+        block_StartcodeCursorReset( &p_pack->cursor );
         p_pack->pf_reset( p_pack->p_private, false );
     }
 
@@ -153,11 +157,14 @@ static block_t *packetizer_PacketizeBlock( packetizer_t *p_pack, block_t **pp_bl
                 return NULL; /* Need more data */
 
             p_pack->i_offset = 1; /* To find next startcode */
+            block_StartcodeCursorReset( &p_pack->cursor );
             /* fallthrough */
 
         case STATE_NEXT_SYNC:
-            /* Find the next startcode */
-            if( block_FindStartcodeFromOffset( &p_pack->bytestream, &p_pack->i_offset,
+            /* Find the next startcode, resuming where the last lookup ended
+             * instead of walking the whole AU blocks chain again */
+            if( block_FindStartcodeFromCursor( &p_pack->bytestream, &p_pack->cursor,
+                                               &p_pack->i_offset,
                                                p_pack->p_startcode, p_pack->i_startcode,
                                                p_pack->pf_startcode_helper, NULL ) )
             {
@@ -176,6 +183,7 @@ static block_t *packetizer_PacketizeBlock( packetizer_t *p_pack, block_t **pp_bl
             }
 
             block_BytestreamFlush( &p_pack->bytestream );
+            block_StartcodeCursorReset( &p_pack->cursor );
 
             /* Get the new fragment and set the pts/dts */
             block_t *p_block_bytestream = p_pack->bytestream.p_block;
@@ -278,6 +286,7 @@ static inline void packetizer_Header( packetizer_t *p_pack,
     p_pack->i_state = STATE_NOSYNC;
     block_BytestreamEmpty( &p_pack->bytestream );
     p_pack->i_offset = 0;
+    block_StartcodeCursorReset( &p_pack->cursor );
 }
 
 #endif
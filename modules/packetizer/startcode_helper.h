@@ -119,6 +119,87 @@ static inline const uint8_t * startcode_FindAnnexB_SSE2( const uint8_t *p, const
 
 #endif
 
+#ifdef CAN_COMPILE_AVX2
+
+/* Compares 32 candidate positions at once against the whole 00 00 01
+ * pattern using 3 overlapping unaligned loads, so the match mask is exact
+ * and no per byte verification is needed. */
+__attribute__ ((__target__ ("avx2")))
+static inline const uint8_t * startcode_FindAnnexB_AVX2( const uint8_t *p, const uint8_t *end )
+{
+    static const uint8_t ones[32] = {
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    };
+
+    if( end - p >= 34 )
+    {
+        for( ; p <= end - 34; p += 32 )
+        {
+            uint32_t match;
+            asm volatile(
+                "vpxor     %%ymm3,   %%ymm3,   %%ymm3\n"
+                "vpcmpeqb  0(%[v]),  %%ymm3,   %%ymm0\n"
+                "vpcmpeqb  1(%[v]),  %%ymm3,   %%ymm1\n"
+                "vmovdqu   0(%[o]),  %%ymm2\n"
+                "vpcmpeqb  2(%[v]),  %%ymm2,   %%ymm2\n"
+                "vpand     %%ymm1,   %%ymm0,   %%ymm0\n"
+                "vpand     %%ymm2,   %%ymm0,   %%ymm0\n"
+                "vpmovmskb %%ymm0,   %[match]\n"
+                : [match]"=r"(match)
+                : [v]"r"(p), [o]"r"(ones)
+                : "xmm0", "xmm1", "xmm2", "xmm3", "memory"
+            );
+            if( match )
+            {
+                asm volatile("vzeroupper" ::: "memory");
+                return p + ctz( match );
+            }
+        }
+        asm volatile("vzeroupper" ::: "memory");
+    }
+
+    for (end -= 3; p <= end; p++) {
+        if (p[0] == 0 && p[1] == 0 && p[2] == 1)
+            return p;
+    }
+
+    return NULL;
+}
+
+#endif
+
+#if defined(__ARM_NEON)
+#  include <arm_neon.h>
+
+/* Same exact match as the AVX2 version, 16 positions at a time. NEON has
+ * no movemask, so the 0xFF/0x00 lanes are narrowed to a nibble mask. */
+static inline const uint8_t * startcode_FindAnnexB_NEON( const uint8_t *p, const uint8_t *end )
+{
+    const uint8x16_t zeros = vdupq_n_u8( 0 );
+    const uint8x16_t ones = vdupq_n_u8( 1 );
+
+    for( ; end - p >= 18; p += 16 )
+    {
+        uint8x16_t match = vandq_u8( vceqq_u8( vld1q_u8( p ), zeros ),
+                                     vceqq_u8( vld1q_u8( p + 1 ), zeros ) );
+        match = vandq_u8( match, vceqq_u8( vld1q_u8( p + 2 ), ones ) );
+        uint64_t nibbles = vget_lane_u64( vreinterpret_u64_u8(
+                              vshrn_n_u16( vreinterpretq_u16_u8( match ), 4 ) ), 0 );
+        if( nibbles )
+            return p + ctz( nibbles ) / 4;
+    }
+
+    for (end -= 3; p <= end; p++) {
+        if (p[0] == 0 && p[1] == 0 && p[2] == 1)
+            return p;
+    }
+
+    return NULL;
+}
+
+#endif
+
 /* That code is adapted from libav's ff_avc_find_startcode_internal
  * and i believe the trick originated from
  * https://graphics.stanford.edu/~seander/bithacks.html#ZeroInWord
@@ -150,14 +231,21 @@ static inline const uint8_t * startcode_FindAnnexB_Bits( const uint8_t *p, const
 }
 #undef TRY_MATCH
 
-#ifdef CAN_COMPILE_SSE2
+#if defined(CAN_COMPILE_SSE2) || defined(CAN_COMPILE_AVX2)
 static inline const uint8_t * startcode_FindAnnexB( const uint8_t *p, const uint8_t *end )
 {
+#  ifdef CAN_COMPILE_AVX2
+    if (vlc_CPU_AVX2())
+        return startcode_FindAnnexB_AVX2(p, end);
+#  endif
+#  ifdef CAN_COMPILE_SSE2
     if (vlc_CPU_SSE2())
         return startcode_FindAnnexB_SSE2(p, end);
-    else
-        return startcode_FindAnnexB_Bits(p, end);
+#  endif
+    return startcode_FindAnnexB_Bits(p, end);
 }
+#elif defined(__ARM_NEON)
+    #define startcode_FindAnnexB startcode_FindAnnexB_NEON
 #else
     #define startcode_FindAnnexB startcode_FindAnnexB_Bits
 #endif
@@ -35,6 +35,8 @@
 #include <vlc_fs.h>
 #include <vlc_interrupt.h>
 
+#include "prefetch_ring.h"
+
 struct stream_ctrl
 {
     struct stream_ctrl *next;
@@ -73,12 +75,77 @@ typedef struct
     uint64_t     stream_offset;
     size_t       buffer_length;
     size_t       buffer_size;
+    size_t       buffer_max;
     char        *buffer;
     size_t       seek_threshold;
+    size_t       history_size;
+    vlc_tick_t   readahead;
+
+    /* Consumption rate and upstream latency estimates */
+    vlc_tick_t   rate_start;
+    uint64_t     rate_bytes;
+    uint64_t     rate; /* bytes per second, 0 if unknown */
+    vlc_tick_t   latency;
+
+    struct
+    {
+        uint64_t hits; /* reads served without waiting */
+        uint64_t misses; /* reads waiting for upstream */
+        vlc_tick_t stalled;
+        unsigned seek_hits; /* seeks within the buffered data */
+        unsigned seek_misses;
+    } stats;
 
     struct stream_ctrl *controls;
 } stream_sys_t;
 
+/* Readahead until the consumption rate is known */
+#define PREFETCH_MIN_WINDOW (1 << 22)
+
+/**
+ * Computes how much unread data the background thread should keep buffered:
+ * enough for the configured playback time, plus a few upstream round trips,
+ * at the measured consumption rate.
+ */
+static size_t ReadaheadWindow(const stream_sys_t *sys)
+{
+    uint64_t window = sys->rate * (sys->readahead + 4 * sys->latency)
+                      / CLOCK_FREQ;
+
+    if (window < PREFETCH_MIN_WINDOW)
+        window = PREFETCH_MIN_WINDOW;
+    if (window > sys->buffer_max - sys->history_size)
+        window = sys->buffer_max - sys->history_size;
+    return window;
+}
+
+static void UpdateRate(stream_sys_t *sys, size_t bytes)
+{
+    vlc_tick_t now = vlc_tick_now();
+    vlc_tick_t elapsed = now - sys->rate_start;
+
+    sys->rate_bytes += bytes;
+    if (elapsed < VLC_TICK_FROM_SEC(1))
+        return;
+
+    uint64_t rate = sys->rate_bytes * CLOCK_FREQ / elapsed;
+
+    /* Follow increases at once, so that the readahead grows before the
+     * buffer runs dry, and decreases slowly. */
+    if (rate > sys->rate)
+        sys->rate = rate;
+    else
+        sys->rate = (7 * sys->rate + rate) / 8;
+    sys->rate_start = now;
+    sys->rate_bytes = 0;
+}
+
+static void ResetRate(stream_sys_t *sys)
+{
+    sys->rate_start = vlc_tick_now();
+    sys->rate_bytes = 0;
+}
+
 static ssize_t ThreadRead(stream_t *stream, void *buf, size_t length)
 {
     stream_sys_t *sys = stream->p_sys;
@@ -86,12 +153,42 @@ static ssize_t ThreadRead(stream_t *stream, void *buf, size_t length)
     vlc_mutex_unlock(&sys->lock);
     assert(length > 0);
 
+    vlc_tick_t start = vlc_tick_now();
     ssize_t val = vlc_stream_ReadPartial(stream->s, buf, length);
+    vlc_tick_t duration = vlc_tick_now() - start;
 
     vlc_mutex_lock(&sys->lock);
+    if (val > 0)
+        sys->latency = (3 * sys->latency + duration) / 4;
     return val;
 }
 
+/**
+ * Grows the circular buffer, keeping the data at the same offsets.
+ * Only the thread changes the buffer, so the lock is not held while
+ * allocating.
+ */
+static int ThreadGrow(stream_t *stream, size_t size)
+{
+    stream_sys_t *sys = stream->p_sys;
+
+    vlc_mutex_unlock(&sys->lock);
+    char *buffer = malloc(size);
+    vlc_mutex_lock(&sys->lock);
+
+    if (unlikely(buffer == NULL))
+        return -1;
+
+    prefetch_RingCopy(buffer, size, sys->buffer, sys->buffer_size,
+                      sys->buffer_offset, sys->buffer_length);
+    free(sys->buffer);
+    sys->buffer = buffer;
+    sys->buffer_size = size;
+    msg_Dbg(stream, "buffer grown to %zu bytes (%"PRIu64" bytes/s)", size,
+            sys->rate);
+    return 0;
+}
+
 static int ThreadSeek(stream_t *stream, uint64_t seek_offset)
 {
     stream_sys_t *sys = stream->p_sys;
@@ -223,18 +320,43 @@ static void *Thread(void *data)
 
         assert(sys->buffer_size >= sys->buffer_length);
 
+        size_t unread = 0;
+        if (history < sys->buffer_length)
+            unread = sys->buffer_length - history;
+
+        size_t window = ReadaheadWindow(sys);
+        if (unread >= window)
+        {   /* Far enough ahead, wait for data to be read */
+            vlc_cond_wait(&sys->wait_space, &sys->lock);
+            continue;
+        }
+
+        size_t needed = window + sys->history_size;
+        if (needed > sys->buffer_size && sys->buffer_size < sys->buffer_max)
+        {
+            if (needed < 2 * sys->buffer_size)
+                needed = 2 * sys->buffer_size;
+            if (needed > sys->buffer_max)
+                needed = sys->buffer_max;
+            if (ThreadGrow(stream, needed))
+                sys->buffer_max = sys->buffer_size; /* Stop trying */
+            continue;
+        }
+
         size_t len = sys->buffer_size - sys->buffer_length;
         if (len == 0)
-        {   /* Buffer is full */
-            if (history == 0)
+        {   /* Buffer is full: discard the historical data beyond the
+             * history window, kept for backward seeks. */
+            len = history > sys->history_size ? history - sys->history_size
+                                              : 0;
+            if (len > sys->buffer_length)
+                len = sys->buffer_length;
+            if (len == 0)
             {   /* Wait for data to be read */
                 vlc_cond_wait(&sys->wait_space, &sys->lock);
                 continue;
             }
 
-            /* Discard some historical data to make room. */
-            len = history > sys->buffer_length ? sys->buffer_length : history;
-
             sys->buffer_offset += len;
             sys->buffer_length -= len;
         }
@@ -274,8 +396,14 @@ static int Seek(stream_t *stream, uint64_t offset)
     stream_sys_t *sys = stream->p_sys;
 
     vlc_mutex_lock(&sys->lock);
+    if (offset >= sys->buffer_offset
+     && offset <= sys->buffer_offset + sys->buffer_length)
+        sys->stats.seek_hits++;
+    else
+        sys->stats.seek_misses++;
     sys->stream_offset = offset;
     sys->error = false;
+    ResetRate(sys);
     vlc_cond_signal(&sys->wait_space);
     vlc_mutex_unlock(&sys->lock);
     return 0;
@@ -302,6 +430,7 @@ static ssize_t Read(stream_t *stream, void *buf, size_t buflen)
     stream_sys_t *sys = stream->p_sys;
     size_t copy, offset;
     bool eof;
+    vlc_tick_t stall_start = VLC_TICK_INVALID;
 
     if (buflen == 0)
         return buflen;
@@ -324,11 +453,22 @@ static ssize_t Read(stream_t *stream, void *buf, size_t buflen)
             return 0;
         }
 
+        if (stall_start == VLC_TICK_INVALID)
+            stall_start = vlc_tick_now();
+
         vlc_interrupt_forward_start(sys->interrupt, data);
         vlc_cond_wait(&sys->wait_data, &sys->lock);
         vlc_interrupt_forward_stop(data);
     }
 
+    if (stall_start != VLC_TICK_INVALID)
+    {
+        sys->stats.misses++;
+        sys->stats.stalled += vlc_tick_now() - stall_start;
+    }
+    else if (copy > 0)
+        sys->stats.hits++;
+
     offset = sys->stream_offset % sys->buffer_size;
     if (copy > buflen)
         copy = buflen;
@@ -338,6 +478,7 @@ static ssize_t Read(stream_t *stream, void *buf, size_t buflen)
 
     memcpy(buf, sys->buffer + offset, copy);
     sys->stream_offset += copy;
+    UpdateRate(sys, copy);
     vlc_cond_signal(&sys->wait_space);
     vlc_mutex_unlock(&sys->lock);
     return copy;
@@ -394,6 +535,7 @@ static int Control(stream_t *stream, int query, va_list args)
 
             vlc_mutex_lock(&sys->lock);
             sys->paused = paused;
+            ResetRate(sys);
             vlc_cond_signal(&sys->wait_space);
             vlc_mutex_unlock (&sys->lock);
             break;
@@ -470,16 +612,32 @@ static int Open(vlc_object_t *obj)
     sys->buffer_offset = 0;
     sys->stream_offset = 0;
     sys->buffer_length = 0;
-    sys->buffer_size = var_InheritInteger(obj, "prefetch-buffer-size") << 10u;
+    sys->buffer_max = var_InheritInteger(obj, "prefetch-buffer-size") << 10u;
     sys->seek_threshold = var_InheritInteger(obj, "prefetch-seek-threshold");
+    sys->history_size =
+        var_InheritInteger(obj, "prefetch-history-size") << 10u;
+    sys->readahead =
+        VLC_TICK_FROM_MS(var_InheritInteger(obj, "prefetch-readahead"));
+    sys->rate = 0;
+    sys->latency = 0;
+    ResetRate(sys);
+    memset(&sys->stats, 0, sizeof (sys->stats));
     sys->controls = NULL;
 
     uint64_t size = stream_Size(stream->s);
     if (size > 0)
     {   /* No point allocating a buffer larger than the source stream */
-        if (sys->buffer_size > size)
-            sys->buffer_size = size;
+        if (sys->buffer_max > size)
+            sys->buffer_max = size;
     }
+    /* Leave at least half of the buffer for readahead */
+    if (sys->history_size > sys->buffer_max / 2)
+        sys->history_size = sys->buffer_max / 2;
+
+    /* Start small, the buffer grows with the consumption rate */
+    sys->buffer_size = PREFETCH_MIN_WINDOW + sys->history_size;
+    if (sys->buffer_size > sys->buffer_max)
+        sys->buffer_size = sys->buffer_max;
 
     sys->buffer = malloc(sys->buffer_size);
     if (sys->buffer == NULL)
@@ -501,7 +659,8 @@ static int Open(vlc_object_t *obj)
         goto error;
     }
 
-    msg_Dbg(stream, "using %zu bytes buffer", sys->buffer_size);
+    msg_Dbg(stream, "using %zu bytes buffer, up to %zu bytes",
+            sys->buffer_size, sys->buffer_max);
     stream->pf_read = Read;
     stream->pf_seek = Seek;
     stream->pf_control = Control;
@@ -531,6 +690,12 @@ static void Close (vlc_object_t *obj)
     vlc_join(sys->thread, NULL);
     vlc_interrupt_destroy(sys->interrupt);
 
+    msg_Dbg(stream, "reads: %"PRIu64" hits, %"PRIu64" misses (stalled for "
+            "%"PRId64" ms), seeks: %u in buffer, %u outside",
+            sys->stats.hits, sys->stats.misses,
+            MS_FROM_VLC_TICK(sys->stats.stalled), sys->stats.seek_hits,
+            sys->stats.seek_misses);
+
     while(sys->controls)
     {
         struct stream_ctrl *ctrl = sys->controls;
@@ -549,9 +714,17 @@ vlc_module_begin()
     set_description(N_("Stream prefetch filter"))
     set_callbacks(Open, Close)
 
-    add_integer("prefetch-buffer-size", 1 << 14, N_("Buffer size"),
-                N_("Prefetch buffer size (KiB)"))
+    add_integer("prefetch-buffer-size", 1 << 16, N_("Buffer size"),
+                N_("Maximum prefetch buffer size (KiB). The buffer grows up "
+                   "to this size with the consumption rate."))
         change_integer_range(4, 1 << 20)
+    add_integer("prefetch-readahead", 5000, N_("Readahead"),
+                N_("Playback time to read ahead, on top of the upstream "
+                   "latency (milliseconds)"))
+        change_integer_range(0, 60000)
+    add_integer("prefetch-history-size", 1 << 10, N_("History size"),
+                N_("Already read data kept for backward seeks (KiB)"))
+        change_integer_range(0, 1 << 19)
     add_obsolete_integer("prefetch-read-size") /* since 4.0.0 */
     add_integer("prefetch-seek-threshold", 1 << 14, N_("Seek threshold"),
                 N_("Prefetch forward seek threshold (bytes)"))
@@ -0,0 +1,50 @@
+/*****************************************************************************
+ * prefetch_ring.h: circular buffer helpers for the prefetch filter
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifndef VLC_PREFETCH_RING_H_
+#define VLC_PREFETCH_RING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Copies the data of a circular buffer to another one of a different size.
+ * The byte at the stream offset o is at o % size in either buffer.
+ */
+static inline void prefetch_RingCopy(char *dst, size_t dst_size,
+                                     const char *src, size_t src_size,
+                                     uint64_t offset, size_t length)
+{
+    for (uint64_t end = offset + length; offset < end;)
+    {
+        size_t from = offset % src_size;
+        size_t to = offset % dst_size;
+        size_t len = end - offset;
+
+        if (len > src_size - from)
+            len = src_size - from;
+        if (len > dst_size - to)
+            len = dst_size - to;
+        memcpy(dst + to, src + from, len);
+        offset += len;
+    }
+}
+
+#endif
@@ -1030,6 +1030,9 @@ static void Close(sout_stream_t *stream)
     if (sys->manifest != NULL)
         hls_storage_Destroy(sys->manifest);
 
+    if (sys->config.writer != NULL)
+        hls_storage_writer_Delete(sys->config.writer);
+
     hls_config_Clean(&sys->config);
 
     hls_variant_maps_Destroy(&sys->variant_stream_maps);
@@ -1049,11 +1052,13 @@ static int Open(vlc_object_t *this)
     stream->p_sys = sys;
 
     static const char *const options[] = {"base-url",
+                                          "fsync",
                                           "host-http",
                                           "max-memory",
                                           "num-seg",
                                           "out-dir",
                                           "pace",
+                                          "preallocate",
                                           "seg-len",
                                           "variants",
                                           NULL};
@@ -1069,6 +1074,10 @@ static int Open(vlc_object_t *this)
         VLC_TICK_FROM_SEC(var_GetInteger(stream, SOUT_CFG_PREFIX "seg-len"));
     sys->config.max_memory =
         BYTES_FROM_KB(var_GetInteger(stream, SOUT_CFG_PREFIX "max-memory"));
+    sys->config.sync = var_GetBool(stream, SOUT_CFG_PREFIX "fsync");
+    sys->config.preallocate =
+        var_GetBool(stream, SOUT_CFG_PREFIX "preallocate");
+    sys->config.writer = NULL;
 
     int status = VLC_EINVAL;
 
@@ -1092,6 +1101,18 @@ static int Open(vlc_object_t *this)
         goto variant_error;
     }
 
+    if (sys->config.outdir != NULL)
+    {
+        /* Keep the disk latency away from the muxing path */
+        sys->config.writer =
+            hls_storage_writer_New(vlc_object_logger(stream), &sys->config);
+        if (sys->config.writer == NULL)
+        {
+            status = VLC_ENOMEM;
+            goto error;
+        }
+    }
+
     if (var_GetBool(stream, SOUT_CFG_PREFIX "host-http"))
     {
         status = InitHTTP(stream);
@@ -1136,6 +1157,8 @@ static int Open(vlc_object_t *this)
 
     return VLC_SUCCESS;
 error:
+    if (sys->config.writer != NULL)
+        hls_storage_writer_Delete(sys->config.writer);
     hls_variant_maps_Destroy(&sys->variant_stream_maps);
 variant_error:
     hls_config_Clean(&sys->config);
@@ -1153,6 +1176,10 @@ variant_error:
 #define VARIANTS_TEXT                                                          \
     N_("Map that group ES string IDs into variant streams (mandatory)")
 #define BASEURL_TEXT N_("Base of the URL")
+#define FSYNC_LONGTEXT                                                         \
+    N_("Flush every segment and manifest to the disk before it is exposed. "  \
+       "The writes are done in the background and flushed in batches")
+#define FSYNC_TEXT N_("Synchronize the output files")
 #define HOSTHTTP_LONGTEXT                                                      \
     N_("The internal HTTP server will share the HLS output. This is "          \
        "unadvised for the common use case where an external HTTP server "      \
@@ -1173,6 +1200,9 @@ variant_error:
 #define PACE_LONGTEXT                                                          \
     N_("Enable input pacing, the media will play at playback rate")
 #define PACE_TEXT N_("Enable pacing")
+#define PREALLOCATE_LONGTEXT                                                   \
+    N_("Reserve the disk space of every output file before writing it")
+#define PREALLOCATE_TEXT N_("Preallocate the output files")
 #define SEGLEN_LONGTEXT N_("Length of segments in seconds")
 #define SEGLEN_TEXT N_("Segment length (sec)")
 
@@ -1186,11 +1216,14 @@ vlc_module_begin()
     add_string(SOUT_CFG_PREFIX "variants", NULL, VARIANTS_TEXT, VARIANTS_LONGTEXT)
 
     add_string(SOUT_CFG_PREFIX "base-url", "", BASEURL_TEXT, BASEURL_TEXT)
+    add_bool(SOUT_CFG_PREFIX "fsync", false, FSYNC_TEXT, FSYNC_LONGTEXT)
     add_bool(SOUT_CFG_PREFIX "host-http", false, HOSTHTTP_TEXT, HOSTHTTP_LONGTEXT)
     add_integer(SOUT_CFG_PREFIX "max-memory", 20000, MAXMEMORY_TEXT, MAXMEMORY_LONGTEXT)
     add_integer(SOUT_CFG_PREFIX "num-seg", 0, NUMSEG_TEXT, NUMSEG_TEXT)
     add_string(SOUT_CFG_PREFIX "out-dir", NULL, OUTDIR_TEXT, OUTDIR_LONGTEXT)
     add_bool(SOUT_CFG_PREFIX "pace", false, PACE_TEXT, PACE_LONGTEXT)
+    add_bool(SOUT_CFG_PREFIX "preallocate", false, PREALLOCATE_TEXT,
+             PREALLOCATE_LONGTEXT)
     add_integer(SOUT_CFG_PREFIX "seg-len", 4, SEGLEN_TEXT, SEGLEN_LONGTEXT)
 
     set_callback(Open)
@@ -34,6 +34,10 @@ struct hls_config
     bool pace;
     vlc_tick_t segment_length;
     size_t max_memory;
+    bool sync;
+    bool preallocate;
+    /** Asynchronous filesystem writer, NULL to write in place */
+    struct hls_storage_writer *writer;
 };
 
 #define BYTES_FROM_KB(x) ((x) * 1000)
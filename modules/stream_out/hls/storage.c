@@ -30,10 +30,42 @@
 
 #include <vlc_block.h>
 #include <vlc_fs.h>
+#include <vlc_list.h>
+#include <vlc_threads.h>
 
 #include "hls.h"
 #include "storage.h"
 
+struct hls_storage_writer
+{
+    struct vlc_logger *logger;
+    char *outdir;
+    bool sync;
+    bool preallocate;
+    size_t max_pending;
+
+    vlc_mutex_t lock;
+    vlc_cond_t wait;
+    struct vlc_list jobs;
+    size_t pending;
+    bool backlogged;
+    bool closing;
+    vlc_thread_t thread;
+};
+
+/** Filesystem write, queued to the writer thread or done in place. */
+struct hls_storage_job
+{
+    struct vlc_list node;
+    char *path;
+    char *temp_path;
+    block_t *content;
+    size_t size;
+    int fd;
+    /** Storage served from the job content until the file is written */
+    struct storage_priv *storage;
+};
+
 struct storage_priv
 {
     hls_storage_t storage;
@@ -50,6 +82,8 @@ struct storage_priv
         struct
         {
             char *path;
+            struct hls_storage_writer *writer;
+            struct hls_storage_job *job;
         } fs;
     };
 };
@@ -60,23 +94,29 @@ static void mem_storage_Destroy(struct storage_priv *priv)
     free(priv);
 }
 
-static ssize_t mem_storage_GetContent(const hls_storage_t *storage,
-                                      uint8_t **dest)
+static ssize_t storage_CopyBlocks(const block_t *content, size_t size,
+                                  uint8_t **dest)
 {
-    const struct storage_priv *priv =
-        container_of(storage, struct storage_priv, storage);
-
-    *dest = malloc(priv->size);
+    *dest = malloc(size);
     if (unlikely(*dest == NULL))
         return -1;
 
     uint8_t *cursor = *dest;
-    for (const block_t *it = priv->mem.content; it != NULL; it = it->p_next)
+    for (const block_t *it = content; it != NULL; it = it->p_next)
     {
         memcpy(cursor, it->p_buffer, it->i_buffer);
         cursor += it->i_buffer;
     }
-    return priv->size;
+    return size;
+}
+
+static ssize_t mem_storage_GetContent(const hls_storage_t *storage,
+                                      uint8_t **dest)
+{
+    const struct storage_priv *priv =
+        container_of(storage, struct storage_priv, storage);
+
+    return storage_CopyBlocks(priv->mem.content, priv->size, dest);
 }
 
 static hls_storage_t *mem_storage_FromBlock(block_t *content)
@@ -138,6 +178,22 @@ static ssize_t fs_storage_GetContent(const hls_storage_t *storage,
     const struct storage_priv *priv =
         container_of(storage, struct storage_priv, storage);
 
+    if (priv->fs.writer != NULL)
+    {
+        ssize_t ret = -1;
+        bool pending;
+
+        /* Not on disk yet: serve the queued content */
+        vlc_mutex_lock(&priv->fs.writer->lock);
+        pending = priv->fs.job != NULL;
+        if (pending)
+            ret = storage_CopyBlocks(priv->fs.job->content, priv->size, dest);
+        vlc_mutex_unlock(&priv->fs.writer->lock);
+
+        if (pending)
+            return ret;
+    }
+
     const int fd = vlc_open(priv->fs.path, O_RDONLY);
 
     if (fd == -1)
@@ -154,7 +210,7 @@ static ssize_t fs_storage_GetContent(const hls_storage_t *storage,
     close(fd);
     return read;
 err:
-    free(dest);
+    free(*dest);
     close(fd);
     return -1;
 }
@@ -177,8 +233,222 @@ static int fs_storage_Write(int fd, const uint8_t *data, size_t len)
     return VLC_SUCCESS;
 }
 
+static struct hls_storage_job *fs_storage_job_New(const char *path,
+                                                  block_t *content)
+{
+    struct hls_storage_job *job = malloc(sizeof(*job));
+    if (unlikely(job == NULL))
+        return NULL;
+
+    job->path = strdup(path);
+    if (unlikely(job->path == NULL))
+    {
+        free(job);
+        return NULL;
+    }
+
+    job->temp_path = NULL;
+    job->content = content;
+    block_ChainProperties(content, NULL, &job->size, NULL);
+    job->fd = -1;
+    job->storage = NULL;
+    return job;
+}
+
+static void fs_storage_job_Delete(struct hls_storage_job *job)
+{
+    block_ChainRelease(job->content);
+    free(job->temp_path);
+    free(job->path);
+    free(job);
+}
+
+/**
+ * Write the job content next to its final path.
+ *
+ * \return The open file descriptor of the temporary file, -1 on error.
+ */
+static int fs_storage_job_Open(struct hls_storage_job *job, bool preallocate)
+{
+    if (asprintf(&job->temp_path, "%s.tmp", job->path) == -1)
+    {
+        job->temp_path = NULL;
+        return -1;
+    }
+
+    const int fd =
+        vlc_open(job->temp_path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd == -1)
+        return -1;
+
+#ifdef HAVE_POSIX_FALLOCATE
+    /* Best effort: spares the filesystem from growing the file per write */
+    if (preallocate && job->size > 0)
+        posix_fallocate(fd, 0, job->size);
+#else
+    VLC_UNUSED(preallocate);
+#endif
+
+    for (const block_t *it = job->content; it != NULL; it = it->p_next)
+    {
+        if (fs_storage_Write(fd, it->p_buffer, it->i_buffer) != VLC_SUCCESS)
+        {
+            const int saved_errno = errno;
+            close(fd);
+            vlc_unlink(job->temp_path);
+            errno = saved_errno;
+            return -1;
+        }
+    }
+    return fd;
+}
+
+/**
+ * Write a batch of jobs to their final paths.
+ *
+ * Every file is written to a temporary path then renamed over its final path
+ * so that readers never see a partial file. The renames follow the batch
+ * order: a segment always lands before the manifest that references it.
+ *
+ * When syncing, all the files are written before the first flush so that the
+ * flushes of the batch overlap, and the directory is flushed once.
+ *
+ * \return VLC_SUCCESS if every job of the batch was written.
+ */
+static int fs_storage_Commit(struct vlc_list *jobs, const char *outdir,
+                             bool sync, bool preallocate,
+                             struct vlc_logger *logger)
+{
+    struct hls_storage_job *job;
+    int status = VLC_SUCCESS;
+    bool renamed = false;
+
+    vlc_list_foreach(job, jobs, node)
+    {
+        job->fd = fs_storage_job_Open(job, preallocate);
+        if (job->fd == -1)
+        {
+            vlc_error(logger, "Cannot write %s: %s", job->path,
+                      vlc_strerror_c(errno));
+            status = VLC_EGENERIC;
+        }
+    }
+
+    vlc_list_foreach(job, jobs, node)
+    {
+        if (job->fd == -1)
+            continue;
+
+        if (sync && fdatasync(job->fd) != 0)
+            vlc_warning(logger, "Cannot flush %s: %s", job->path,
+                        vlc_strerror_c(errno));
+        close(job->fd);
+        job->fd = -1;
+
+        if (vlc_rename(job->temp_path, job->path) != 0)
+        {
+            vlc_error(logger, "Cannot rename %s: %s", job->temp_path,
+                      vlc_strerror_c(errno));
+            vlc_unlink(job->temp_path);
+            status = VLC_EGENERIC;
+        }
+        else
+            renamed = true;
+    }
+
+#ifndef _WIN32
+    /* Make the renames themselves durable */
+    if (sync && renamed)
+    {
+        const int fd = vlc_open(outdir, O_RDONLY);
+        if (fd != -1)
+        {
+            fsync(fd);
+            close(fd);
+        }
+    }
+#else
+    VLC_UNUSED(outdir);
+    VLC_UNUSED(renamed);
+#endif
+    return status;
+}
+
+static void *fs_storage_WriterThread(void *data)
+{
+    struct hls_storage_writer *writer = data;
+
+    vlc_thread_set_name("vlc-hls-writer");
+
+    vlc_mutex_lock(&writer->lock);
+    for (;;)
+    {
+        while (vlc_list_is_empty(&writer->jobs) && !writer->closing)
+            vlc_cond_wait(&writer->wait, &writer->lock);
+        if (vlc_list_is_empty(&writer->jobs))
+            break;
+
+        /* Everything queued meanwhile is written as one batch */
+        struct vlc_list batch;
+        vlc_list_replace(&writer->jobs, &batch);
+        vlc_list_init(&writer->jobs);
+        vlc_mutex_unlock(&writer->lock);
+
+        fs_storage_Commit(&batch, writer->outdir, writer->sync,
+                          writer->preallocate, writer->logger);
+
+        struct hls_storage_job *job;
+
+        vlc_mutex_lock(&writer->lock);
+        vlc_list_foreach(job, &batch, node)
+        {
+            if (job->storage != NULL)
+                job->storage->fs.job = NULL;
+            writer->pending -= job->size;
+        }
+        if (writer->pending <= writer->max_pending)
+            writer->backlogged = false;
+        vlc_mutex_unlock(&writer->lock);
+
+        vlc_list_foreach(job, &batch, node)
+            fs_storage_job_Delete(job);
+
+        vlc_mutex_lock(&writer->lock);
+    }
+    vlc_mutex_unlock(&writer->lock);
+    return NULL;
+}
+
+static void fs_storage_Queue(struct hls_storage_writer *writer,
+                             struct hls_storage_job *job,
+                             struct storage_priv *priv)
+{
+    vlc_mutex_lock(&writer->lock);
+    job->storage = priv;
+    priv->fs.job = job;
+    vlc_list_append(&job->node, &writer->jobs);
+    writer->pending += job->size;
+    if (writer->pending > writer->max_pending && !writer->backlogged)
+    {
+        writer->backlogged = true;
+        vlc_warning(writer->logger,
+                    "Output storage is %zuKb behind, the disk is too slow",
+                    BYTES_TO_KB(writer->pending));
+    }
+    vlc_cond_signal(&writer->wait);
+    vlc_mutex_unlock(&writer->lock);
+}
+
 static void fs_storage_Destroy(struct storage_priv *priv)
 {
+    if (priv->fs.writer != NULL)
+    {
+        /* A pending write still happens, only the content is not served */
+        vlc_mutex_lock(&priv->fs.writer->lock);
+        if (priv->fs.job != NULL)
+            priv->fs.job->storage = NULL;
+        vlc_mutex_unlock(&priv->fs.writer->lock);
+    }
     free(priv->fs.path);
     free(priv);
 }
@@ -198,6 +468,7 @@ fs_storage_FromBlock(block_t *content,
                      const struct hls_storage_config *config,
                      const struct hls_config *hls_config)
 {
+    struct hls_storage_job *job = NULL;
     struct storage_priv *priv = malloc(sizeof(*priv));
     if (unlikely(priv == NULL))
         goto err;
@@ -206,29 +477,36 @@ fs_storage_FromBlock(block_t *content,
     if (unlikely(priv->fs.path == NULL))
         goto err;
 
-    const int fd = vlc_open(priv->fs.path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
-    if (fd == -1)
+    job = fs_storage_job_New(priv->fs.path, content);
+    if (unlikely(job == NULL))
         goto err;
 
-    size_t size = 0;
-    for (const block_t *it = content; it != NULL; it = it->p_next)
+    priv->storage.get_content = fs_storage_GetContent;
+    priv->size = job->size;
+    priv->destroy = fs_storage_Destroy;
+    priv->fs.writer = hls_config->writer;
+    priv->fs.job = NULL;
+
+    if (priv->fs.writer != NULL)
     {
-        const int status = fs_storage_Write(fd, it->p_buffer, it->i_buffer);
-        if (status != VLC_SUCCESS)
-        {
-            close(fd);
-            goto err;
-        }
-        size += it->i_buffer;
+        fs_storage_Queue(priv->fs.writer, job, priv);
+        return &priv->storage;
     }
 
-    close(fd);
-    block_ChainRelease(content);
-
-    priv->storage.get_content = fs_storage_GetContent;
-    priv->size = size;
-    priv->destroy = fs_storage_Destroy;
+    struct vlc_list batch;
+    vlc_list_init(&batch);
+    vlc_list_append(&job->node, &batch);
 
+    const int status = fs_storage_Commit(&batch, hls_config->outdir,
+                                         hls_config->sync,
+                                         hls_config->preallocate, NULL);
+    fs_storage_job_Delete(job);
+    if (status != VLC_SUCCESS)
+    {
+        free(priv->fs.path);
+        free(priv);
+        return NULL;
+    }
     return &priv->storage;
 err:
     block_ChainRelease(content);
@@ -244,36 +522,11 @@ fs_storage_FromBytes(void *bytes,
                      const struct hls_storage_config *config,
                      const struct hls_config *hls_config)
 {
-    struct storage_priv *priv = malloc(sizeof(*priv));
-    if (unlikely(priv == NULL))
+    block_t *content = block_heap_Alloc(bytes, size);
+    if (unlikely(content == NULL))
         return NULL;
 
-    priv->fs.path = fs_storage_CreatePath(hls_config->outdir, config->name);
-    if (unlikely(priv->fs.path == NULL))
-        goto err;
-
-    const int fd = vlc_open(priv->fs.path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
-    if (fd == -1)
-        goto err;
-
-    const int status = fs_storage_Write(fd, bytes, size);
-    close(fd);
-
-    if (unlikely(status != VLC_SUCCESS))
-        goto err;
-
-    priv->storage.get_content = fs_storage_GetContent;
-    priv->size = size;
-    priv->destroy = fs_storage_Destroy;
-
-    free(bytes);
-    return &priv->storage;
-err:
-    free(bytes);
-    if (priv != NULL)
-        free(priv->fs.path);
-    free(priv);
-    return NULL;
+    return fs_storage_FromBlock(content, config, hls_config);
 }
 
 hls_storage_t *hls_storage_FromBlocks(block_t *content,
@@ -307,6 +560,56 @@ hls_storage_t *hls_storage_FromBytes(void *data,
     return storage;
 }
 
+struct hls_storage_writer *
+hls_storage_writer_New(struct vlc_logger *logger,
+                       const struct hls_config *hls_config)
+{
+    assert(!hls_config_IsMemStorageEnabled(hls_config));
+
+    struct hls_storage_writer *writer = malloc(sizeof(*writer));
+    if (unlikely(writer == NULL))
+        return NULL;
+
+    writer->outdir = strdup(hls_config->outdir);
+    if (unlikely(writer->outdir == NULL))
+    {
+        free(writer);
+        return NULL;
+    }
+
+    writer->logger = logger;
+    writer->sync = hls_config->sync;
+    writer->preallocate = hls_config->preallocate;
+    writer->max_pending = hls_config->max_memory;
+    vlc_mutex_init(&writer->lock);
+    vlc_cond_init(&writer->wait);
+    vlc_list_init(&writer->jobs);
+    writer->pending = 0;
+    writer->backlogged = false;
+    writer->closing = false;
+
+    if (vlc_clone(&writer->thread, fs_storage_WriterThread, writer))
+    {
+        free(writer->outdir);
+        free(writer);
+        return NULL;
+    }
+    return writer;
+}
+
+void hls_storage_writer_Delete(struct hls_storage_writer *writer)
+{
+    vlc_mutex_lock(&writer->lock);
+    writer->closing = true;
+    vlc_cond_signal(&writer->wait);
+    vlc_mutex_unlock(&writer->lock);
+
+    vlc_join(writer->thread, NULL);
+    assert(vlc_list_is_empty(&writer->jobs));
+    free(writer->outdir);
+    free(writer);
+}
+
 size_t hls_storage_GetSize(const hls_storage_t *storage)
 {
     const struct storage_priv *priv =
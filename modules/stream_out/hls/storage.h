@@ -80,6 +80,35 @@ hls_storage_t *hls_storage_FromBytes(void *data,
 
 size_t hls_storage_GetSize(const hls_storage_t *);
 
+/**
+ * Background writer of the filesystem storages.
+ *
+ * While a writer is set in the HLS config, filesystem storages are created
+ * without touching the disk and written by the writer thread, in creation
+ * order. Their content is served from memory until then.
+ */
+struct hls_storage_writer;
+
+/**
+ * Start a writer thread for the output directory of the HLS config.
+ *
+ * \param logger The logger for the write errors.
+ * \param hls_config The global hls config.
+ *
+ * \return The writer.
+ * \retval NULL on allocation or thread creation error.
+ */
+struct hls_storage_writer *
+hls_storage_writer_New(struct vlc_logger *logger,
+                       const struct hls_config *hls_config) VLC_USED;
+
+/**
+ * Write all the pending storages then stop the writer thread.
+ *
+ * \note The storages created with the writer must be destroyed beforehand.
+ */
+void hls_storage_writer_Delete(struct hls_storage_writer *);
+
 void hls_storage_Destroy(hls_storage_t *);
 
 #endif
@@ -38,6 +38,15 @@
 #include <libswscale/swscale.h>
 #include <libswscale/version.h>
 
+/* Slice threading, with sws_scale_frame() */
+#if LIBSWSCALE_VERSION_INT >= AV_VERSION_INT( 6, 4, 100 )
+# define SWS_THREADED 1
+# include <libavutil/frame.h>
+# include <libavutil/opt.h>
+#else
+# define SWS_THREADED 0
+#endif
+
 #ifdef __APPLE__
 # include <TargetConditionals.h>
 #endif
@@ -53,6 +62,10 @@ static void CloseScaler( filter_t * );
 #define SCALEMODE_TEXT N_("Scaling mode")
 #define SCALEMODE_LONGTEXT NULL
 
+#define THREADS_TEXT N_("Threads")
+#define THREADS_LONGTEXT N_("Number of threads converting the horizontal " \
+    "bands of large pictures (0 for automatic, 1 to disable).")
+
 static const int pi_mode_values[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
 static const char *const ppsz_mode_descriptions[] =
 { N_("Fast bilinear"), N_("Bilinear"), N_("Bicubic (good quality)"),
@@ -67,6 +80,8 @@ vlc_module_begin ()
     set_callback_video_converter( OpenScaler, 150 )
     add_integer( "swscale-mode", 2, SCALEMODE_TEXT, SCALEMODE_LONGTEXT )
         change_integer_list( pi_mode_values, ppsz_mode_descriptions )
+    add_integer_with_range( "swscale-threads", 0, 0, 32,
+                            THREADS_TEXT, THREADS_LONGTEXT )
 vlc_module_end ()
 
 /* Version checking */
@@ -98,11 +113,22 @@ typedef struct
     bool b_copy;
     bool b_swap_uvi;
     bool b_swap_uvo;
+
+    int i_threads;
+#if SWS_THREADED
+    struct vlc_cpu_share *cpu_share;
+    AVFrame *frame_src;
+    AVFrame *frame_dst;
+    AVBufferRef *frame_buf;
+#endif
 } filter_sys_t;
 
 static picture_t *Filter( filter_t *, picture_t * );
 static int  Init( filter_t * );
 static void Clean( filter_t * );
+static unsigned GetThreads( filter_t * );
+static struct SwsContext *GetContext( filter_sys_t *, int, int, int,
+                                      int, int, int, int, unsigned );
 
 typedef struct
 {
@@ -130,6 +156,9 @@ static int GetParameters( ScalerConfiguration *,
 /* XXX is it always 3 even for BIG_ENDIAN (blend.c seems to think so) ? */
 #define OFFSET_A (3)
 
+/* Smaller pictures are not worth the synchronization of the threads */
+#define THREADED_MIN_PIXELS (1280 * 720)
+
 static const struct vlc_filter_operations filter_ops = {
     .filter_video = Filter, .close = CloseScaler,
 };
@@ -221,6 +250,7 @@ static int OpenScaler( filter_t *p_filter )
     case 10: p_sys->i_sws_flags = SWS_SPLINE; break;
     default: p_sys->i_sws_flags = SWS_BICUBIC; i_sws_mode = 2; break;
     }
+    p_sys->i_threads = var_InheritInteger( p_filter, "swscale-threads" );
 
     /* Misc init */
     memset( &p_sys->fmt_in,  0, sizeof(p_sys->fmt_in) );
@@ -417,16 +447,16 @@ static int Init( filter_t *p_filter )
 
     const unsigned i_fmti_visible_width = p_fmti->i_visible_width * p_sys->i_extend_factor;
     const unsigned i_fmto_visible_width = p_fmto->i_visible_width * p_sys->i_extend_factor;
+    const unsigned i_threads = GetThreads( p_filter );
     for( int n = 0; n < (cfg.b_has_a ? 2 : 1); n++ )
     {
         const int i_fmti = n == 0 ? cfg.i_fmti : AV_PIX_FMT_GRAY8;
         const int i_fmto = n == 0 ? cfg.i_fmto : AV_PIX_FMT_GRAY8;
         struct SwsContext *ctx;
 
-        ctx = sws_getContext( i_fmti_visible_width, p_fmti->i_visible_height, i_fmti,
-                              i_fmto_visible_width, p_fmto->i_visible_height, i_fmto,
-                              cfg.i_sws_flags,
-                              p_sys->p_filter, NULL, 0 );
+        ctx = GetContext( p_sys, i_fmti_visible_width, p_fmti->i_visible_height, i_fmti,
+                          i_fmto_visible_width, p_fmto->i_visible_height, i_fmto,
+                          cfg.i_sws_flags, i_threads );
         if( n == 0 )
             p_sys->ctx = ctx;
         else
@@ -489,6 +519,79 @@ static int Init( filter_t *p_filter )
     return VLC_SUCCESS;
 }
 
+/* Number of bands converted in parallel */
+static unsigned GetThreads( filter_t *p_filter )
+{
+#if SWS_THREADED
+    filter_sys_t *p_sys = p_filter->p_sys;
+    const video_format_t *p_fmti = &p_filter->fmt_in.video;
+    const video_format_t *p_fmto = &p_filter->fmt_out.video;
+
+    if( p_sys->i_threads > 0 )
+        return p_sys->i_threads;
+
+    if( __MAX( p_fmti->i_visible_width * p_fmti->i_visible_height,
+               p_fmto->i_visible_width * p_fmto->i_visible_height )
+        < THREADED_MIN_PIXELS )
+        return 1;
+
+    /* Share the cores with the codecs and the other converters */
+    p_sys->cpu_share = vlc_cpu_share_Join( 8 );
+    if( p_sys->cpu_share == NULL )
+        return 1;
+    return vlc_cpu_share_Threads( p_sys->cpu_share );
+#else
+    VLC_UNUSED(p_filter);
+    return 1;
+#endif
+}
+
+static struct SwsContext *GetContext( filter_sys_t *p_sys,
+                                      int i_srcw, int i_srch, int i_fmti,
+                                      int i_dstw, int i_dsth, int i_fmto,
+                                      int i_sws_flags, unsigned i_threads )
+{
+#if SWS_THREADED
+    if( i_threads > 1 )
+    {
+        struct SwsContext *ctx = sws_alloc_context();
+        if( ctx == NULL )
+            return NULL;
+
+        av_opt_set_int( ctx, "srcw", i_srcw, 0 );
+        av_opt_set_int( ctx, "srch", i_srch, 0 );
+        av_opt_set_int( ctx, "src_format", i_fmti, 0 );
+        av_opt_set_int( ctx, "dstw", i_dstw, 0 );
+        av_opt_set_int( ctx, "dsth", i_dsth, 0 );
+        av_opt_set_int( ctx, "dst_format", i_fmto, 0 );
+        av_opt_set_int( ctx, "sws_flags", i_sws_flags, 0 );
+        av_opt_set_int( ctx, "threads", i_threads, 0 );
+
+        /* The planes of the pictures are wrapped in frames for
+         * sws_scale_frame(), which references the buffers */
+        if( p_sys->frame_src == NULL )
+        {
+            p_sys->frame_src = av_frame_alloc();
+            p_sys->frame_dst = av_frame_alloc();
+            p_sys->frame_buf = av_buffer_alloc( 1 );
+        }
+
+        if( p_sys->frame_src == NULL || p_sys->frame_dst == NULL ||
+            p_sys->frame_buf == NULL ||
+            sws_init_context( ctx, p_sys->p_filter, NULL ) < 0 )
+        {
+            sws_freeContext( ctx );
+            return NULL;
+        }
+        return ctx;
+    }
+#else
+    VLC_UNUSED(i_threads);
+#endif
+    return sws_getContext( i_srcw, i_srch, i_fmti, i_dstw, i_dsth, i_fmto,
+                           i_sws_flags, p_sys->p_filter, NULL, 0 );
+}
+
 static void Clean( filter_t *p_filter )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
@@ -509,6 +612,14 @@ static void Clean( filter_t *p_filter )
     if( p_sys->ctx )
         sws_freeContext( p_sys->ctx );
 
+#if SWS_THREADED
+    av_frame_free( &p_sys->frame_src );
+    av_frame_free( &p_sys->frame_dst );
+    av_buffer_unref( &p_sys->frame_buf );
+    vlc_cpu_share_Leave( p_sys->cpu_share );
+    p_sys->cpu_share = NULL;
+#endif
+
     /* We have to set it to null has we call be called again :( */
     p_sys->ctx = NULL;
     p_sys->ctxA = NULL;
@@ -656,6 +767,40 @@ static void Convert( filter_t *p_filter, struct SwsContext *ctx,
     for (size_t i = 0; i < ARRAY_SIZE(src); i++)
         csrc[i] = src[i];
 
+#if SWS_THREADED
+    if( p_sys->frame_src != NULL )
+    {
+        AVFrame *in = p_sys->frame_src, *out = p_sys->frame_dst;
+        int64_t w, h, fmt;
+
+        av_opt_get_int( ctx, "srcw", 0, &w );
+        av_opt_get_int( ctx, "src_format", 0, &fmt );
+        in->width = w;
+        in->height = i_height;
+        in->format = fmt;
+        av_opt_get_int( ctx, "dstw", 0, &w );
+        av_opt_get_int( ctx, "dsth", 0, &h );
+        av_opt_get_int( ctx, "dst_format", 0, &fmt );
+        out->width = w;
+        out->height = h;
+        out->format = fmt;
+
+        for( size_t i = 0; i < ARRAY_SIZE(src); i++ )
+        {
+            in->data[i] = src[i];
+            in->linesize[i] = src_stride[i];
+            out->data[i] = dst[i];
+            out->linesize[i] = dst_stride[i];
+        }
+        /* Never written nor freed: only referenced */
+        in->buf[0] = out->buf[0] = p_sys->frame_buf;
+
+        if( sws_scale_frame( ctx, out, in ) < 0 )
+            msg_Warn( p_filter, "cannot convert the picture" );
+        in->buf[0] = out->buf[0] = NULL;
+        return;
+    }
+#endif
 #if LIBSWSCALE_VERSION_INT  >= ((0<<16)+(5<<8)+0)
     sws_scale( ctx, csrc, src_stride, 0, i_height,
                dst, dst_stride );
@@ -88,8 +88,12 @@ typedef struct vout_display_sys_t {
     void *(*lock)(void *sys, void **plane);
     void (*unlock)(void *sys, void *id, void *const *plane);
     void (*display)(void *sys, void *id);
+    void (*frame)(void *sys, picture_t *pic, void *const *plane,
+                  const unsigned *pitches, const unsigned *lines);
     void (*cleanup)(void *sys);
 
+    picture_t *pending; /* picture held for the frame callback */
+
     unsigned pitches[PICTURE_PLANE_MAX];
     unsigned lines[PICTURE_PLANE_MAX];
 } vout_display_sys_t;
@@ -124,7 +128,9 @@ static int Open(vout_display_t *vd,
     vlc_format_cb setup = var_InheritAddress(vd, "vmem-setup");
 
     sys->lock = var_InheritAddress(vd, "vmem-lock");
-    if (sys->lock == NULL) {
+    sys->frame = var_InheritAddress(vd, "vmem-frame");
+    sys->pending = NULL;
+    if (sys->lock == NULL && sys->frame == NULL) {
         msg_Err(vd, "missing lock callback");
         free(sys);
         return VLC_EGENERIC;
@@ -203,6 +209,8 @@ static void Close(vout_display_t *vd)
 {
     vout_display_sys_t *sys = vd->sys;
 
+    if (sys->pending != NULL)
+        picture_Release(sys->pending);
     if (sys->cleanup)
         sys->cleanup(sys->opaque);
     free(sys);
@@ -217,6 +225,19 @@ static void Prepare(vout_display_t *vd, picture_t *pic,
     picture_resource_t rsc = { .p_sys = NULL };
     void *planes[PICTURE_PLANE_MAX];
 
+    if (sys->frame != NULL) {
+        /* Zero-copy: the application gets a reference to the picture itself
+         * in Display(), and releases it with libvlc_video_frame_release(). */
+        if (sys->pending != NULL)
+            picture_Release(sys->pending);
+        sys->pending = picture_Hold(pic);
+        /* Subpictures are already blended into the picture: this display
+         * declares no subpicture chromas, so the core blends them into a
+         * picture of its own. */
+        assert(subpic == NULL);
+        return;
+    }
+
     sys->pic_opaque = sys->lock(sys->opaque, planes);
 
     picture_t *locked = picture_NewFromResource(vd->fmt, &rsc);
@@ -242,6 +263,26 @@ static void Display(vout_display_t *vd, picture_t *pic)
     vout_display_sys_t *sys = vd->sys;
     VLC_UNUSED(pic);
 
+    if (sys->frame != NULL) {
+        picture_t *frame = sys->pending;
+        void *planes[PICTURE_PLANE_MAX] = { NULL };
+        unsigned pitches[PICTURE_PLANE_MAX] = { 0 };
+        unsigned lines[PICTURE_PLANE_MAX] = { 0 };
+
+        if (frame == NULL)
+            return;
+        sys->pending = NULL;
+
+        for (int i = 0; i < frame->i_planes; i++) {
+            planes[i] = frame->p[i].p_pixels;
+            pitches[i] = frame->p[i].i_pitch;
+            lines[i] = frame->p[i].i_lines;
+        }
+        /* Ownership of the reference passes to the application */
+        sys->frame(sys->opaque, frame, planes, pitches, lines);
+        return;
+    }
+
     if (sys->display != NULL)
         sys->display(sys->opaque, sys->pic_opaque);
 }
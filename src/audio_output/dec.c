@@ -65,6 +65,8 @@ struct vlc_aout_stream
         float rate; /**< Play-out speed rate */
         vlc_tick_t resamp_start_drift; /**< Resampler drift absolute value */
         int resamp_type; /**< Resampler mode (FIXME: redundant / resampling) */
+        int resampling; /**< Current resampling (Hz) */
+        vlc_tick_t drift; /**< Last drift, for the metrics */
         bool played;
         vlc_tick_t request_delay;
         vlc_tick_t delay;
@@ -399,6 +401,8 @@ vlc_aout_stream * vlc_aout_stream_New(audio_output_t *p_aout,
 
     stream->sync.rate = 1.f;
     stream->sync.resamp_type = AOUT_RESAMPLING_NONE;
+    stream->sync.resampling = 0;
+    stream->sync.drift = VLC_TICK_INVALID;
     stream->sync.delay = stream->sync.request_delay = 0;
 
     stream->discontinuity.draining = false;
@@ -523,6 +527,7 @@ static int stream_CheckReady (vlc_aout_stream *stream)
 
         msg_Dbg (aout, "restarting filters...");
         stream->sync.resamp_type = AOUT_RESAMPLING_NONE;
+        stream->sync.resampling = 0;
 
         if (stream->mixer_format.i_format && !owner->bitexact)
         {
@@ -569,6 +574,7 @@ static void stream_StopResampling(vlc_aout_stream *stream)
     assert(stream->filters);
 
     stream->sync.resamp_type = AOUT_RESAMPLING_NONE;
+    stream->sync.resampling = 0;
     aout_FiltersAdjustResampling (stream->filters, 0);
 }
 
@@ -617,6 +623,7 @@ static void stream_HandleDrift(vlc_aout_stream *stream, vlc_tick_t drift,
                                  VLC_TRACE("id", stream->str_id),
                                  VLC_TRACE_TICK_NS("drift", drift),
                                  VLC_TRACE_END);
+    stream->sync.drift = drift;
 
     /* Following calculations expect an opposite drift. Indeed,
      * vlc_clock_Update() returns a positive relative time, corresponding to
@@ -720,11 +727,14 @@ static void stream_HandleDrift(vlc_aout_stream *stream, vlc_tick_t drift,
     if (!aout_FiltersAdjustResampling (stream->filters, adj))
     {   /* Everything is back to normal: stop resampling. */
         stream->sync.resamp_type = AOUT_RESAMPLING_NONE;
+        stream->sync.resampling = 0;
 
         if (tracer != NULL)
             vlc_tracer_TraceEvent(tracer, "RENDER", stream->str_id, "stop_resampling");
         msg_Dbg (aout, "resampling stopped (drift: %"PRId64" us)", drift);
     }
+    else
+        stream->sync.resampling += adj;
 }
 
 static void stream_Synchronize(vlc_aout_stream *stream, vlc_tick_t system_now,
@@ -974,6 +984,20 @@ void vlc_aout_stream_GetResetStats(vlc_aout_stream *stream, unsigned *restrict l
                                        memory_order_relaxed);
 }
 
+/**
+ * Reads the synchronization state, from the thread playing the stream.
+ */
+void vlc_aout_stream_GetSyncStats(vlc_aout_stream *stream,
+                                  vlc_tick_t *restrict drift,
+                                  float *restrict resampling)
+{
+    unsigned rate = stream->input_format.i_rate;
+
+    *drift = stream->sync.drift;
+    *resampling = (rate != 0) ? (float)(rate + stream->sync.resampling) / rate
+                              : 1.f;
+}
+
 void vlc_aout_stream_ChangePause(vlc_aout_stream *stream, bool paused, vlc_tick_t date)
 {
     audio_output_t *aout = aout_stream_aout(stream);
@@ -32,6 +32,7 @@
 #include <assert.h>
 
 #include <vlc_common.h>
+#include <vlc_atomic.h>
 #include <vlc_configuration.h>
 #include <vlc_dialog.h>
 #include <vlc_modules.h>
@@ -41,6 +42,141 @@
 #include "aout_internal.h"
 #include "../video_output/vout_internal.h" /* for vout_Request */
 
+#define AOUT_POOL_SIZE 8
+
+/** Output blocks recycled across the filters of a pipeline */
+struct aout_block_pool
+{
+    vlc_mutex_t lock;
+    vlc_atomic_rc_t rc; /**< pipeline reference, plus one per block in use */
+    unsigned count; /**< number of free blocks */
+    struct aout_pool_block *free[AOUT_POOL_SIZE];
+};
+
+struct aout_pool_block
+{
+    block_t self;
+    struct aout_block_pool *pool;
+    uint8_t *buf;
+    size_t capacity;
+};
+
+static struct aout_block_pool *aout_block_pool_New(void)
+{
+    struct aout_block_pool *pool = malloc(sizeof (*pool));
+    if (unlikely(pool == NULL))
+        return NULL;
+
+    vlc_mutex_init(&pool->lock);
+    vlc_atomic_rc_init(&pool->rc);
+    pool->count = 0;
+    return pool;
+}
+
+static void aout_pool_block_Free(struct aout_pool_block *pb)
+{
+    free(pb->buf);
+    free(pb);
+}
+
+static void aout_block_pool_Release(struct aout_block_pool *pool)
+{
+    if (!vlc_atomic_rc_dec(&pool->rc))
+        return;
+
+    for (unsigned i = 0; i < pool->count; i++)
+        aout_pool_block_Free(pool->free[i]);
+    free(pool);
+}
+
+static void aout_pool_block_Recycle(block_t *block)
+{
+    struct aout_pool_block *pb = container_of(block, struct aout_pool_block,
+                                              self);
+    struct aout_block_pool *pool = pb->pool;
+
+    vlc_mutex_lock(&pool->lock);
+    if (pool->count < AOUT_POOL_SIZE)
+    {
+        pool->free[pool->count++] = pb;
+        pb = NULL;
+    }
+    vlc_mutex_unlock(&pool->lock);
+
+    if (pb != NULL)
+        aout_pool_block_Free(pb);
+    /* The blocks may outlive the pipeline, e.g. in the audio output */
+    aout_block_pool_Release(pool);
+}
+
+static const struct vlc_block_callbacks aout_pool_block_cbs =
+{
+    aout_pool_block_Recycle,
+};
+
+static block_t *aout_block_pool_Get(struct aout_block_pool *pool, size_t size)
+{
+    struct aout_pool_block *pb = NULL;
+
+    vlc_mutex_lock(&pool->lock);
+    for (unsigned i = 0; i < pool->count; i++)
+        if (pool->free[i]->capacity >= size)
+        {
+            pb = pool->free[i];
+            pool->free[i] = pool->free[--pool->count];
+            break;
+        }
+    vlc_mutex_unlock(&pool->lock);
+
+    if (pb == NULL)
+    {
+        if (unlikely(size >> 28))
+            return NULL;
+
+        pb = malloc(sizeof (*pb));
+        if (unlikely(pb == NULL))
+            return NULL;
+
+        /* Leave room for the varying output of resamplers, and for filters
+         * widening the samples in place. */
+        pb->capacity = (size * 2 + 4095) & ~(size_t)4095;
+        pb->buf = malloc(pb->capacity);
+        if (unlikely(pb->buf == NULL))
+        {
+            free(pb);
+            return NULL;
+        }
+    }
+
+    pb->pool = pool;
+    vlc_atomic_rc_inc(&pool->rc);
+    block_Init(&pb->self, &aout_pool_block_cbs, pb->buf, pb->capacity);
+    pb->self.i_buffer = size;
+    return &pb->self;
+}
+
+static block_t *aout_filter_NewBuffer(filter_t *filter, size_t size)
+{
+    return aout_block_pool_Get(filter->owner.sys, size);
+}
+
+static const struct filter_audio_callbacks aout_filter_pool_cbs =
+{
+    .buffer_new = aout_filter_NewBuffer,
+};
+
+/**
+ * Makes a filter allocate its output blocks from the pipeline pool.
+ *
+ * This is done once the filter is opened, as the owner of user filters is
+ * only used from their Open callback.
+ */
+static void aout_filter_UsePool(filter_t *filter, struct aout_block_pool *pool)
+{
+    filter->owner.audio = &aout_filter_pool_cbs;
+    filter->owner.sys = pool;
+}
+
 struct aout_filter
 {
     filter_t *f;
@@ -369,6 +505,7 @@ struct aout_filters
     struct aout_filter resampler; /**< The resampler */
     int resampling; /**< Current resampling (Hz) */
     vlc_clock_t *clock_source;
+    struct aout_block_pool *pool; /**< Output blocks of the filters */
 
     unsigned count; /**< Number of filters */
     struct aout_filter tab[AOUT_MAX_FILTERS]; /**< Configured user filters
@@ -556,6 +693,12 @@ aout_filters_t *aout_FiltersNewWithClock(vlc_object_t *obj, vlc_clock_t *clock,
     filters->resampling = 0;
     filters->count = 0;
     filters->clock_source = clock;
+    filters->pool = aout_block_pool_New();
+    if (unlikely(filters->pool == NULL))
+    {
+        free(filters);
+        return NULL;
+    }
 
     /* Prepare format structure */
     aout_FormatPrint (obj, "input", infmt);
@@ -684,11 +827,17 @@ aout_filters_t *aout_FiltersNewWithClock(vlc_object_t *obj, vlc_clock_t *clock,
     if (filters->rate_filter == NULL)
         filters->rate_filter = filters->resampler.f;
 
+    for (unsigned i = 0; i < filters->count; i++)
+        aout_filter_UsePool(filters->tab[i].f, filters->pool);
+    if (filters->resampler.f != NULL)
+        aout_filter_UsePool(filters->resampler.f, filters->pool);
+
     return filters;
 
 error:
     aout_FiltersPipelineDestroy (filters->tab, filters->count);
     var_DelCallback(obj, "visual", VisualizationCallback, NULL);
+    aout_block_pool_Release(filters->pool);
     free (filters);
     return NULL;
 }
@@ -764,6 +913,7 @@ void aout_FiltersDelete (vlc_object_t *obj, aout_filters_t *filters)
         aout_FiltersPipelineDestroy(&filters->resampler, 1);
     aout_FiltersPipelineDestroy (filters->tab, filters->count);
     var_DelCallback(obj, "visual", VisualizationCallback, NULL);
+    aout_block_pool_Release(filters->pool);
     free (filters);
 }
 
@@ -148,6 +148,14 @@ struct vlc_input_decoder_t
 
     /* fifo */
     block_fifo_t *p_fifo;
+    /* FIFO bytes accounted in the budgets, protected by the FIFO lock */
+    size_t fifo_accounted;
+    struct vlc_input_decoder_budget *budget;
+    size_t total_budget;
+
+    /* Playback metrics slot, or NULL */
+    struct input_metrics *metrics;
+    struct input_metrics_es *metrics_es;
 
     /* Lock for communication with decoder thread */
     vlc_cond_t  wait_request;
@@ -244,6 +252,9 @@ struct vlc_input_decoder_t
     void           *mouse_opaque;
 };
 
+/* Bytes queued in all the decoder FIFOs of the process */
+static atomic_size_t decoder_fifo_total = 0;
+
 /* Pictures which are DECODER_BOGUS_VIDEO_DELAY or more in advance probably have
  * a bogus PTS and won't be displayed */
 #define DECODER_BOGUS_VIDEO_DELAY                ((vlc_tick_t)(DEFAULT_PTS_DELAY * 30))
@@ -262,6 +273,77 @@ static inline vlc_input_decoder_t *dec_get_owner( decoder_t *p_dec )
     return container_of( p_dec, vlc_input_decoder_t, dec );
 }
 
+/**
+ * Reports the FIFO occupancy changes to the input and process budgets.
+ */
+static void DecoderFifoAccountLocked( vlc_input_decoder_t *p_owner )
+{
+    vlc_fifo_Assert( p_owner->p_fifo );
+
+    size_t bytes = vlc_fifo_GetBytes( p_owner->p_fifo );
+    /* unsigned wrap-around handles shrinking FIFOs */
+    size_t delta = bytes - p_owner->fifo_accounted;
+
+    if( delta == 0 )
+        return;
+    p_owner->fifo_accounted = bytes;
+
+    if( p_owner->metrics_es != NULL )
+        input_metrics_SetQueue( p_owner->metrics_es,
+                                vlc_fifo_GetCount( p_owner->p_fifo ), bytes );
+
+    if( p_owner->budget != NULL )
+        atomic_fetch_add_explicit( &p_owner->budget->used, delta,
+                                   memory_order_relaxed );
+    atomic_fetch_add_explicit( &decoder_fifo_total, delta,
+                               memory_order_relaxed );
+}
+
+static bool DecoderFifoOverBudget( const vlc_input_decoder_t *p_owner )
+{
+    const struct vlc_input_decoder_budget *budget = p_owner->budget;
+
+    if( budget != NULL && budget->limit != 0
+     && atomic_load_explicit( &budget->used, memory_order_relaxed )
+            >= budget->limit )
+        return true;
+
+    return p_owner->total_budget != 0
+        && atomic_load_explicit( &decoder_fifo_total, memory_order_relaxed )
+            >= p_owner->total_budget;
+}
+
+/**
+ * Lets the input run again once the FIFO it is throttled on has drained.
+ */
+static void DecoderFifoUnthrottleLocked( vlc_input_decoder_t *p_owner,
+                                         bool force )
+{
+    struct vlc_input_decoder_budget *budget = p_owner->budget;
+
+    vlc_fifo_Assert( p_owner->p_fifo );
+    if( budget == NULL )
+        return;
+
+    vlc_mutex_lock( &budget->lock );
+    if( budget->throttled == p_owner
+     && ( force || vlc_fifo_IsEmpty( p_owner->p_fifo )
+       || !DecoderFifoOverBudget( p_owner ) ) )
+    {
+        budget->throttled = NULL;
+        vlc_cond_signal( &budget->wait );
+    }
+    vlc_mutex_unlock( &budget->lock );
+}
+
+void vlc_input_decoder_WaitBudget( struct vlc_input_decoder_budget *budget )
+{
+    vlc_mutex_lock( &budget->lock );
+    while( budget->throttled != NULL )
+        vlc_cond_wait( &budget->wait, &budget->lock );
+    vlc_mutex_unlock( &budget->lock );
+}
+
 /**
  * When the input decoder is being used only for packetizing (happen in stream output
  * configuration.), there's no need to spawn a decoder thread. The input_decoder is then considered
@@ -1411,15 +1493,32 @@ static void ModuleThread_QueueVideo( decoder_t *p_dec, picture_t *p_pic )
     unsigned displayed = 0;
     unsigned vout_lost = 0;
     unsigned vout_late = 0;
+    unsigned lateness[VLC_INPUT_METRICS_BUCKETS] = { 0 };
+    vlc_tick_t lateness_sum = 0;
     if( p_owner->p_vout != NULL )
     {
         vout_GetResetStatistic( p_owner->p_vout, &displayed, &vout_lost, &vout_late );
+        if( p_owner->metrics != NULL )
+            vout_GetResetLateness( p_owner->p_vout, lateness, &lateness_sum );
     }
     if (success != VLC_SUCCESS)
         vout_lost++;
 
     vlc_fifo_Unlock(p_owner->p_fifo);
 
+    struct input_metrics *metrics = p_owner->metrics;
+    if( metrics != NULL )
+    {
+        atomic_fetch_add_explicit( &metrics->displayed_pictures, displayed,
+                                   memory_order_relaxed );
+        atomic_fetch_add_explicit( &metrics->late_pictures, vout_late,
+                                   memory_order_relaxed );
+        atomic_fetch_add_explicit( &metrics->dropped_pictures, vout_lost,
+                                   memory_order_relaxed );
+        input_metrics_AddSamples( &metrics->lateness, lateness,
+                                  lateness_sum );
+    }
+
     decoder_Notify(p_owner, on_new_video_stats, 1, vout_lost, displayed, vout_late);
 }
 
@@ -1550,6 +1649,16 @@ static void ModuleThread_QueueAudio( decoder_t *p_dec, vlc_frame_t *p_aout_buf )
     if( p_owner->p_astream != NULL )
     {
         vlc_aout_stream_GetResetStats( p_owner->p_astream, &aout_lost, &played );
+
+        if( p_owner->metrics != NULL )
+        {
+            vlc_tick_t drift;
+            float resampling;
+
+            vlc_aout_stream_GetSyncStats( p_owner->p_astream, &drift,
+                                          &resampling );
+            input_metrics_SetAoutSync( p_owner->metrics, drift, resampling );
+        }
     }
     if (success != VLC_SUCCESS)
         aout_lost++;
@@ -1624,8 +1733,15 @@ static void DecoderThread_DecodeBlock( vlc_input_decoder_t *p_owner, vlc_frame_t
                             frame->i_pts, frame->i_dts );
     }
 
+    vlc_tick_t start = p_owner->metrics_es != NULL && frame != NULL
+                     ? vlc_tick_now() : VLC_TICK_INVALID;
+
     int ret = p_dec->pf_decode( p_dec, frame );
 
+    if( start != VLC_TICK_INVALID )
+        input_metrics_AddSample( &p_owner->metrics_es->decode_time,
+                                 vlc_tick_now() - start );
+
     vlc_fifo_Lock(p_owner->p_fifo);
     switch( ret )
     {
@@ -1847,6 +1963,8 @@ static void *DecoderThread( void *p_data )
         vlc_cond_signal( &p_owner->wait_fifo );
 
         vlc_frame_t *frame = vlc_fifo_DequeueUnlocked( p_owner->p_fifo );
+        DecoderFifoAccountLocked( p_owner );
+        DecoderFifoUnthrottleLocked( p_owner, false );
         if( frame == NULL )
         {
             if( likely(!p_owner->b_draining) )
@@ -1995,6 +2113,13 @@ CreateDecoder( vlc_object_t *p_parent, const struct vlc_input_decoder_cfg *cfg )
         vlc_object_delete(p_dec);
         return NULL;
     }
+    p_owner->fifo_accounted = 0;
+    p_owner->budget = cfg->budget;
+    p_owner->metrics = cfg->metrics;
+    p_owner->metrics_es = cfg->metrics != NULL
+                        ? input_metrics_AddES( cfg->metrics, fmt ) : NULL;
+    p_owner->total_budget =
+        (size_t)var_InheritInteger( p_dec, "decoder-fifo-total-budget" ) << 20;
 
     vlc_mutex_init( &p_owner->mouse_lock );
     vlc_cond_init( &p_owner->wait_request );
@@ -2107,7 +2232,14 @@ static void DeleteDecoder( vlc_input_decoder_t *p_owner, enum es_format_category
         vlc_video_context_Release( p_owner->vctx );
 
     /* Free all packets still in the decoder fifo. */
-    block_FifoEmpty( p_owner->p_fifo );
+    vlc_fifo_Lock( p_owner->p_fifo );
+    block_ChainRelease( vlc_fifo_DequeueAllUnlocked( p_owner->p_fifo ) );
+    DecoderFifoAccountLocked( p_owner );
+    DecoderFifoUnthrottleLocked( p_owner, true );
+    vlc_fifo_Unlock( p_owner->p_fifo );
+
+    if( p_owner->metrics_es != NULL )
+        input_metrics_DelES( p_owner->metrics_es );
 
     /* Cleanup */
     if( p_owner->p_sout_input )
@@ -2433,14 +2565,25 @@ void vlc_input_decoder_DecodeWithStatus(vlc_input_decoder_t *p_owner, vlc_frame_
         return;
     }
 
+    bool throttle = false;
+
     vlc_fifo_Lock( p_owner->p_fifo );
     if( !b_do_pace )
     {
         /* FIXME: ideally we would check the time amount of data
          * in the FIFO instead of its size. */
-        /* 400 MiB, i.e. ~ 50mb/s for 60s */
-        if( vlc_fifo_GetBytes( p_owner->p_fifo ) > 400*1024*1024 )
-        {
+        if( !p_owner->b_waiting && !p_owner->paused )
+        {   /* Throttle the input while the budgets are exhausted. Only wait
+             * for this FIFO to drain: the decoder thread always consumes it,
+             * whereas other FIFOs might be stalled. The input waits later,
+             * out of the ES output lock the decoder thread might need. */
+            throttle = p_owner->budget != NULL
+                    && !vlc_fifo_IsEmpty( p_owner->p_fifo )
+                    && DecoderFifoOverBudget( p_owner );
+        }
+        else if( p_owner->budget != NULL && p_owner->budget->limit != 0
+              && vlc_fifo_GetBytes( p_owner->p_fifo ) > p_owner->budget->limit )
+        {   /* The FIFO is not consumed, waiting would deadlock VLC */
             msg_Warn( &p_owner->dec, "decoder/packetizer fifo full (data not "
                       "consumed quickly enough), resetting fifo!" );
             block_ChainRelease( vlc_fifo_DequeueAllUnlocked( p_owner->p_fifo ) );
@@ -2457,6 +2600,13 @@ void vlc_input_decoder_DecodeWithStatus(vlc_input_decoder_t *p_owner, vlc_frame_
     }
 
     vlc_fifo_QueueUnlocked( p_owner->p_fifo, frame );
+    DecoderFifoAccountLocked( p_owner );
+    if( throttle )
+    {
+        vlc_mutex_lock( &p_owner->budget->lock );
+        p_owner->budget->throttled = p_owner;
+        vlc_mutex_unlock( &p_owner->budget->lock );
+    }
     if (status != NULL)
         GetStatusLocked(p_owner, status);
     vlc_fifo_Unlock( p_owner->p_fifo );
@@ -2518,6 +2668,8 @@ void vlc_input_decoder_Flush( vlc_input_decoder_t *p_owner )
 
     /* Empty the fifo */
     block_ChainRelease( vlc_fifo_DequeueAllUnlocked( p_owner->p_fifo ) );
+    DecoderFifoAccountLocked( p_owner );
+    DecoderFifoUnthrottleLocked( p_owner, false );
 
     /* Don't need to wait for the DecoderThread to flush. Indeed, if called a
      * second time, this function will clear the FIFO again before anything was
@@ -63,6 +63,10 @@ struct vlc_input_decoder_cfg
     unsigned cc_decoder;
     const struct vlc_input_decoder_callbacks *cbs;
     void *cbs_data;
+    /* FIFO budget of the input, or NULL */
+    struct vlc_input_decoder_budget *budget;
+    /* Playback metrics of the input, or NULL */
+    struct input_metrics *metrics;
 };
 
 vlc_input_decoder_t *
@@ -152,6 +156,16 @@ void vlc_input_decoder_DecodeWithStatus(vlc_input_decoder_t *p_dec,
                                         vlc_frame_t *frame, bool do_pace,
                                         struct vlc_input_decoder_status *status);
 
+/**
+ * Wait until the input can feed its decoders again.
+ *
+ * The decode functions do not block when the FIFO budgets are exhausted,
+ * they only mark the input as throttled. The input then waits with this
+ * function, once it does not hold any lock a decoder thread might need to
+ * drain its FIFO.
+ */
+void vlc_input_decoder_WaitBudget(struct vlc_input_decoder_budget *budget);
+
 /**
  * This function returns the current size in bytes of the decoder fifo
  */
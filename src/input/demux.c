@@ -70,6 +70,205 @@ static const char *demux_NameFromMimeType(const char *mime)
     return (type != NULL) ? type->name : "any";
 }
 
+/*
+ * Cheap content signatures, checked before probing the demuxers one by one.
+ * Only unambiguous ones belong here, as the matching demuxer is forced.
+ */
+#define PROBE_PEEK_SIZE (2 * 188 + 1)
+
+static const char *demux_NameFromSignature(const uint8_t *p, size_t len)
+{
+    static const struct
+    {
+        unsigned char offset;
+        unsigned char length;
+        char const magic[8];
+        char const name[8];
+    } signatures[] = {
+        { 0, 4, "\x1A\x45\xDF\xA3",                 "mkv"  },
+        { 0, 8, "\x30\x26\xB2\x75\x8E\x66\xCF\x11", "asf"  },
+        { 0, 4, "OggS",                             "ogg"  },
+        { 0, 4, "fLaC",                             "flac" },
+        { 0, 4, "caff",                             "caf"  },
+        { 0, 4, "\x00\x00\x01\xBA",                 "ps"   },
+        { 4, 4, "moov",                             "mp4"  },
+    };
+
+    for (size_t i = 0; i < ARRAY_SIZE(signatures); i++)
+        if (len >= (size_t)signatures[i].offset + signatures[i].length
+         && !memcmp(p + signatures[i].offset, signatures[i].magic,
+                    signatures[i].length))
+            return signatures[i].name;
+
+    if (len >= 12)
+    {
+        if (!memcmp(p, "RIFF", 4))
+        {
+            if (!memcmp(p + 8, "AVI ", 4))
+                return "avi";
+            /* The ES demuxer finds compressed audio in WAVE files, even in
+             * WAVE_FORMAT_PCM (DTS and A/52 streams), leave these to it */
+            if (!memcmp(p + 8, "WAVE", 4) && len >= 22
+             && !memcmp(p + 12, "fmt ", 4))
+            {
+                uint16_t tag = GetWLE(p + 20);
+
+                if (tag != 0x0001 /* PCM */ && tag != 0x0050 /* MPEG */
+                 && tag != 0x0055 /* MPEG layer 3 */
+                 && tag != 0x2000 /* A/52 */ && tag != 0x2001 /* DTS */)
+                    return "wav";
+            }
+        }
+        if (!memcmp(p, "FORM", 4)
+         && (!memcmp(p + 8, "AIFF", 4) || !memcmp(p + 8, "AIFC", 4)))
+            return "aiff";
+        /* Still images are handled by the HEIF demuxer */
+        if (!memcmp(p + 4, "ftyp", 4)
+         && memcmp(p + 8, "mif1", 4) && memcmp(p + 8, "msf1", 4)
+         && memcmp(p + 8, "heic", 4) && memcmp(p + 8, "heix", 4)
+         && memcmp(p + 8, "avif", 4) && memcmp(p + 8, "avis", 4))
+            return "mp4";
+    }
+
+    if (len >= PROBE_PEEK_SIZE
+     && p[0] == 0x47 && p[188] == 0x47 && p[2 * 188] == 0x47)
+        return "ts";
+    return NULL;
+}
+
+/*
+ * Probe results cache
+ *
+ * The same media is often opened more than once (preparsing then playback,
+ * short clips played in a loop). The demuxer that accepted it the previous
+ * time is tried first, as long as the first bytes and the size of the stream
+ * did not change.
+ */
+#define PROBE_CACHE_SIZE 256
+#define PROBE_HEAD_SIZE  32
+#define PROBE_NAME_SIZE  32
+
+struct demux_probe_key
+{
+    uint64_t size; /* UINT64_MAX if unknown */
+    size_t head_len;
+    uint8_t head[PROBE_HEAD_SIZE];
+};
+
+struct demux_probe_entry
+{
+    struct vlc_list node;
+    struct demux_probe_key key;
+    char module[PROBE_NAME_SIZE];
+    char url[];
+};
+
+struct demux_probe_cache
+{
+    vlc_mutex_t lock;
+    struct vlc_list entries; /* most recently used first */
+    size_t count;
+};
+
+struct demux_probe_cache *demux_ProbeCacheNew(void)
+{
+    struct demux_probe_cache *cache = malloc(sizeof (*cache));
+    if (unlikely(cache == NULL))
+        return NULL;
+
+    vlc_mutex_init(&cache->lock);
+    vlc_list_init(&cache->entries);
+    cache->count = 0;
+    return cache;
+}
+
+void demux_ProbeCacheDelete(struct demux_probe_cache *cache)
+{
+    struct demux_probe_entry *entry;
+
+    vlc_list_foreach(entry, &cache->entries, node)
+        free(entry);
+    free(cache);
+}
+
+static struct demux_probe_cache *demux_ProbeCacheGet(vlc_object_t *obj)
+{
+    return libvlc_priv(vlc_object_instance(obj))->probe_cache;
+}
+
+static struct demux_probe_entry *
+demux_ProbeCacheFind(struct demux_probe_cache *cache, const char *url)
+{
+    struct demux_probe_entry *entry;
+
+    vlc_list_foreach(entry, &cache->entries, node)
+        if (!strcmp(entry->url, url))
+            return entry;
+    return NULL;
+}
+
+static bool demux_ProbeCacheLookup(struct demux_probe_cache *cache,
+                                   const char *url,
+                                   const struct demux_probe_key *key,
+                                   char module[PROBE_NAME_SIZE])
+{
+    bool found = false;
+
+    vlc_mutex_lock(&cache->lock);
+    struct demux_probe_entry *entry = demux_ProbeCacheFind(cache, url);
+    if (entry != NULL && entry->key.size == key->size
+     && entry->key.head_len == key->head_len
+     && !memcmp(entry->key.head, key->head, key->head_len))
+    {
+        vlc_list_remove(&entry->node);
+        vlc_list_prepend(&entry->node, &cache->entries);
+        strcpy(module, entry->module);
+        found = true;
+    }
+    vlc_mutex_unlock(&cache->lock);
+    return found;
+}
+
+static void demux_ProbeCacheStore(struct demux_probe_cache *cache,
+                                  const char *url,
+                                  const struct demux_probe_key *key,
+                                  const char *module)
+{
+    if (strlen(module) >= PROBE_NAME_SIZE)
+        return;
+
+    vlc_mutex_lock(&cache->lock);
+    struct demux_probe_entry *entry = demux_ProbeCacheFind(cache, url);
+    if (entry != NULL)
+        vlc_list_remove(&entry->node);
+    else
+    {
+        size_t len = strlen(url) + 1;
+
+        if (cache->count >= PROBE_CACHE_SIZE)
+        {   /* Evict the least recently used entry */
+            entry = vlc_list_last_entry_or_null(&cache->entries,
+                                                struct demux_probe_entry,
+                                                node);
+            vlc_list_remove(&entry->node);
+            cache->count--;
+            free(entry);
+        }
+
+        entry = malloc(sizeof (*entry) + len);
+        if (unlikely(entry == NULL))
+            goto out;
+        memcpy(entry->url, url, len);
+        cache->count++;
+    }
+
+    entry->key = *key;
+    strcpy(entry->module, module);
+    vlc_list_prepend(&entry->node, &cache->entries);
+out:
+    vlc_mutex_unlock(&cache->lock);
+}
+
 demux_t *demux_New( vlc_object_t *p_obj, const char *module, const char *url,
                     stream_t *s, es_out_t *out )
 {
@@ -177,18 +376,50 @@ demux_t *demux_NewAdvanced( vlc_object_t *p_obj, input_thread_t *p_input,
         strict = false;
     }
 
-    if (strcasecmp(module, "any") == 0 && p_demux->psz_filepath != NULL)
-    {
-        const char *ext = strrchr(p_demux->psz_filepath, '.');
+    struct demux_probe_cache *cache = NULL;
+    struct demux_probe_key key;
 
-        if (ext != NULL) {
-            if (b_preparsing && !vlc_ascii_strcasecmp(ext, ".mp3"))
-                module = "mpga";
-            else
-            if (likely(asprintf(&modbuf, "ext-%s", ext + 1) >= 0))
-                module = modbuf;
+    if (strcasecmp(module, "any") == 0)
+    {
+        /* Try the demuxer found the last time, or the one matching the
+         * content signature, before the file extension and the scores. */
+        const char *hint = NULL;
+        char cached[PROBE_NAME_SIZE];
+        const uint8_t *peek;
+        ssize_t len = vlc_stream_Peek(s, &peek, PROBE_PEEK_SIZE);
+
+        if (len > 0)
+        {
+            key.head_len = __MIN((size_t)len, PROBE_HEAD_SIZE);
+            memcpy(key.head, peek, key.head_len);
+            if (vlc_stream_GetSize(s, &key.size))
+                key.size = UINT64_MAX;
+
+            cache = demux_ProbeCacheGet(p_obj);
+            if (cache != NULL
+             && demux_ProbeCacheLookup(cache, url, &key, cached))
+                hint = cached;
             else
+                hint = demux_NameFromSignature(peek, len);
+        }
+
+        const char *ext = NULL;
+        if (p_demux->psz_filepath != NULL)
+            ext = strrchr(p_demux->psz_filepath, '.');
+
+        if (ext != NULL && hint == NULL && b_preparsing
+         && !vlc_ascii_strcasecmp(ext, ".mp3"))
+            module = "mpga";
+        else
+        if (ext != NULL || hint != NULL)
+        {
+            if (unlikely(asprintf(&modbuf, "%s%s%s%s",
+                                  hint != NULL ? hint : "",
+                                  hint != NULL && ext != NULL ? "," : "",
+                                  ext != NULL ? "ext-" : "",
+                                  ext != NULL ? ext + 1 : "") < 0))
                 goto error;
+            module = modbuf;
         }
         strict = false;
     }
@@ -200,6 +431,10 @@ demux_t *demux_NewAdvanced( vlc_object_t *p_obj, input_thread_t *p_input,
     if (priv->module == NULL)
         goto error;
 
+    if (cache != NULL)
+        demux_ProbeCacheStore(cache, url, &key,
+                              module_get_object(priv->module));
+
     var_Create(p_demux, "module-name", VLC_VAR_STRING);
     var_SetString(p_demux, "module-name", module_get_object(priv->module));
 
@@ -457,7 +692,8 @@ int demux_vaControl( demux_t *demux, int query, va_list args )
             return VLC_EGENERIC;
         case DEMUX_SET_GROUP_ALL:
             if (demux->ops->demux.set_group_all != NULL) {
-                return demux->ops->demux.set_group_all(demux);
+                int group = va_arg(args, int);
+                return demux->ops->demux.set_group_all(demux, group);
             }
             return VLC_EGENERIC;
         case DEMUX_SET_GROUP_LIST:
@@ -34,6 +34,14 @@ demux_t *demux_NewAdvanced( vlc_object_t *p_obj, input_thread_t *p_parent_input,
                             const char *psz_demux, const char *url,
                             stream_t *s, es_out_t *out, bool );
 
+/**
+ * Cache of the demuxers found for the recently opened URLs.
+ *
+ * One cache is shared by all the inputs of a LibVLC instance.
+ */
+struct demux_probe_cache *demux_ProbeCacheNew(void);
+void demux_ProbeCacheDelete(struct demux_probe_cache *);
+
 unsigned demux_TestAndClearFlags( demux_t *, unsigned );
 int demux_GetTitle( demux_t * );
 int demux_GetSeekpoint( demux_t * );
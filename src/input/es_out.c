@@ -42,6 +42,7 @@
 #include <vlc_meta.h>
 #include <vlc_list.h>
 #include <vlc_decoder.h>
+#include <vlc_demux.h>
 #include <vlc_memstream.h>
 #include <vlc_tracer.h>
 
@@ -76,6 +77,7 @@ typedef struct
 
     bool b_selected;
     bool b_scrambled;
+    bool b_warm; /* next to the selected one, cf. EsOutProgramsUpdateWarm() */
 
     /* Clock for this program */
     input_clock_t    *p_input_clock;
@@ -157,6 +159,15 @@ struct es_out_id_t
 
     vlc_mouse_event mouse_event_cb;
     void* mouse_event_userdata;
+
+    /* Last GOP of an unselected ES from a warm program, replayed to the
+     * decoder when the program gets selected */
+    struct {
+        decoder_t *packetizer;
+        block_t   *gop;
+        block_t   **gop_last;
+        size_t    gop_size;
+    } warm;
 };
 
 typedef struct
@@ -203,6 +214,11 @@ typedef struct
     /* es/group to select */
     int         i_group_id;
 
+    /* number of programs kept warm next to the selected one */
+    unsigned    i_warm_programs;
+    /* size of the GOPs kept for all of them */
+    size_t      i_warm_size;
+
     /* delay */
     vlc_tick_t i_audio_delay;
     vlc_tick_t i_spu_delay;
@@ -259,6 +275,8 @@ static void EsOutDecodersChangePause(es_out_sys_t *out, bool b_paused, vlc_tick_
 static void EsOutChangePosition(es_out_sys_t *out, bool b_flush, es_out_id_t *p_next_frame_es);
 static void EsOutProgramChangePause(es_out_sys_t *out, bool b_paused, vlc_tick_t i_date);
 static void EsOutProgramsChangeRate(es_out_sys_t *out);
+static void EsOutWarmFlush(es_out_id_t *es);
+static void EsOutWarmStop(es_out_id_t *es);
 static void EsOutDecodersStopBuffering(es_out_sys_t *out, bool b_forced);
 static void EsOutGlobalMeta(es_out_sys_t *p_out, const vlc_meta_t *p_meta);
 static void EsOutMeta(es_out_sys_t *p_out, const vlc_meta_t *p_meta, const vlc_meta_t *p_progmeta);
@@ -625,6 +643,7 @@ static void EsOutTerminate(es_out_sys_t *p_sys)
             vlc_input_decoder_Flush(es->p_dec);
             vlc_input_decoder_Delete(es->p_dec);
         }
+        EsOutWarmStop(es);
 
         EsTerminate(es);
         EsRelease(es);
@@ -807,6 +826,7 @@ static int EsOutSetRecord(es_out_sys_t *p_sys, bool b_record, const char *dir_pa
             .cc_decoder = p_sys->cc_decoder,
             .cbs = &decoder_cbs,
             .cbs_data = p_es,
+            .budget = &input_priv(p_input)->decoder_budget,
         };
 
         p_es->p_dec_record = vlc_input_decoder_New(VLC_OBJECT(p_input), &cfg);
@@ -900,6 +920,12 @@ static void EsOutChangePosition(es_out_sys_t *p_sys, bool b_flush,
                     vlc_input_decoder_StartWait( p_es->p_dec_record );
             }
         }
+        else if( b_flush && p_es->warm.packetizer != NULL )
+        {
+            if( p_es->warm.packetizer->pf_flush != NULL )
+                p_es->warm.packetizer->pf_flush( p_es->warm.packetizer );
+            EsOutWarmFlush( p_es );
+        }
         p_es->i_pts_level = VLC_TICK_INVALID;
     }
 
@@ -1348,6 +1374,167 @@ static void EsOutProgramHandleClockSource(es_out_sys_t *p_sys, es_out_pgrm_t *p_
              p_pgrm->i_id, clock_source_str );
 }
 
+/* Above these sizes, per ES and for all the warm ES, the GOP is dropped until
+ * the next key frame */
+#define WARM_GOP_MAX_SIZE (16 * 1024 * 1024)
+#define WARM_TOTAL_MAX_SIZE (32 * 1024 * 1024)
+
+static void EsOutWarmFlush(es_out_id_t *es)
+{
+    es_out_sys_t *p_sys = PRIV(&es->out->out);
+
+    assert(p_sys->i_warm_size >= es->warm.gop_size);
+    p_sys->i_warm_size -= es->warm.gop_size;
+    block_ChainRelease(es->warm.gop);
+    es->warm.gop = NULL;
+    es->warm.gop_last = &es->warm.gop;
+    es->warm.gop_size = 0;
+}
+
+static void EsOutWarmStart(es_out_sys_t *p_sys, es_out_id_t *es)
+{
+    /* Audio and subtitles start from any packet, only the video needs the
+     * previous key frame */
+    if( es->warm.packetizer != NULL || EsIsSelected( es )
+     || es->fmt.i_cat != VIDEO_ES || es->p_master != NULL )
+        return;
+
+    es_format_t fmt;
+    if( es_format_Copy( &fmt, &es->fmt ) != VLC_SUCCESS )
+        return;
+
+    es->warm.packetizer = demux_PacketizerNew( VLC_OBJECT(p_sys->p_input),
+                                               &fmt, "warm program" );
+    if( es->warm.packetizer != NULL )
+        msg_Dbg( p_sys->p_input, "keeping ES 0x%x of program %d warm",
+                 es->fmt.i_id, es->p_pgrm->i_id );
+    EsOutWarmFlush(es);
+}
+
+static void EsOutWarmStop(es_out_id_t *es)
+{
+    if( es->warm.packetizer == NULL )
+        return;
+
+    demux_PacketizerDestroy( es->warm.packetizer );
+    es->warm.packetizer = NULL;
+    EsOutWarmFlush(es);
+}
+
+/* Keep the packets since the last key frame */
+static void EsOutWarmSend(es_out_id_t *es, block_t *p_block)
+{
+    es_out_sys_t *p_sys = PRIV(&es->out->out);
+    decoder_t *packetizer = es->warm.packetizer;
+    block_t *p_out;
+
+    while( (p_out = packetizer->pf_packetize( packetizer, &p_block )) )
+    {
+        while( p_out )
+        {
+            block_t *p_next = p_out->p_next;
+            const bool b_key = p_out->i_flags & BLOCK_FLAG_TYPE_I;
+
+            p_out->p_next = NULL;
+            if( b_key )
+                EsOutWarmFlush(es);
+
+            if( (es->warm.gop == NULL && !b_key)
+             || es->warm.gop_size + p_out->i_buffer > WARM_GOP_MAX_SIZE
+             || p_sys->i_warm_size + p_out->i_buffer > WARM_TOTAL_MAX_SIZE )
+            {
+                EsOutWarmFlush(es);
+                block_Release( p_out );
+            }
+            else
+            {
+                es->warm.gop_size += p_out->i_buffer;
+                p_sys->i_warm_size += p_out->i_buffer;
+                block_ChainLastAppend( &es->warm.gop_last, p_out );
+            }
+            p_out = p_next;
+        }
+    }
+}
+
+/* Feed the last GOP to the decoder of a newly selected ES, so that decoding
+ * starts from its last key frame instead of waiting for the next one. The
+ * replayed frames are already late, they are decoded but not displayed. */
+static void EsOutWarmReplay(es_out_sys_t *p_sys, es_out_id_t *es)
+{
+    if( es->warm.packetizer == NULL )
+        return;
+
+    block_t *p_block = es->warm.gop;
+    if( p_block != NULL )
+        msg_Dbg( p_sys->p_input, "replaying %zu bytes of ES 0x%x",
+                 es->warm.gop_size, es->fmt.i_id );
+    p_sys->i_warm_size -= es->warm.gop_size;
+    es->warm.gop = NULL;
+    es->warm.gop_size = 0;
+    EsOutWarmStop(es);
+
+    while( p_block != NULL )
+    {
+        block_t *p_next = p_block->p_next;
+
+        p_block->p_next = NULL;
+        p_block->i_flags |= BLOCK_FLAG_PREROLL;
+        vlc_input_decoder_Decode( es->p_dec, p_block,
+                                  input_priv(p_sys->p_input)->b_out_pace_control );
+        p_block = p_next;
+    }
+}
+
+/* EsOutProgramsUpdateWarm:
+ *  Keep the programs declared around the selected one warm, the next ones
+ *  first: +1, -1, +2, -2...
+ */
+static void EsOutProgramsUpdateWarm(es_out_sys_t *p_sys)
+{
+    es_out_pgrm_t *current = p_sys->p_pgrm;
+    es_out_pgrm_t *pgrm;
+    es_out_id_t *es;
+
+    vlc_list_foreach(pgrm, &p_sys->programs, node)
+        pgrm->b_warm = false;
+
+    if( p_sys->i_warm_programs > 0 && p_sys->i_mode == ES_OUT_MODE_AUTO
+     && p_sys->input_type == INPUT_TYPE_PLAYBACK && current != NULL )
+    {
+        size_t index = 0, current_index = 0;
+
+        vlc_list_foreach(pgrm, &p_sys->programs, node)
+            if( pgrm->source == current->source )
+            {
+                if( pgrm == current )
+                    current_index = index;
+                index++;
+            }
+
+        index = 0;
+        vlc_list_foreach(pgrm, &p_sys->programs, node)
+        {
+            if( pgrm->source != current->source )
+                continue;
+
+            size_t rank = index > current_index
+                        ? 2 * (index - current_index) - 1
+                        : 2 * (current_index - index);
+            pgrm->b_warm = pgrm != current && rank <= p_sys->i_warm_programs;
+            index++;
+        }
+    }
+
+    foreach_es_then_es_slaves(es)
+    {
+        if( es->p_pgrm != NULL && es->p_pgrm->b_warm )
+            EsOutWarmStart(p_sys, es);
+        else
+            EsOutWarmStop(es);
+    }
+}
+
 /* EsOutIsGroupSticky
  *
  * A sticky group can be attached to any other programs. This is the case for
@@ -1455,6 +1642,8 @@ static void EsOutProgramSelect(es_out_sys_t *p_sys, es_out_pgrm_t *p_pgrm)
         input_SendEventMeta( p_input );
         /* FIXME: we probably want to replace every input meta */
     }
+
+    EsOutProgramsUpdateWarm(p_sys);
 }
 
 /* EsOutAddProgram:
@@ -1479,6 +1668,7 @@ static es_out_pgrm_t *EsOutProgramAdd(es_out_sys_t *p_sys, input_source_t *sourc
     p_pgrm->i_es = 0;
     p_pgrm->b_selected = false;
     p_pgrm->b_scrambled = false;
+    p_pgrm->b_warm = false;
     p_pgrm->i_last_pcr = VLC_TICK_INVALID;
     p_pgrm->p_meta = NULL;
     p_pgrm->p_master_es_clock = NULL;
@@ -1525,6 +1715,8 @@ static es_out_pgrm_t *EsOutProgramAdd(es_out_sys_t *p_sys, input_source_t *sourc
 
     if( i_group == p_sys->i_group_id || ( !p_sys->p_pgrm && p_sys->i_group_id == 0 ) )
         EsOutProgramSelect(p_sys, p_pgrm);
+    else
+        EsOutProgramsUpdateWarm(p_sys);
 
     input_source_Hold( source );
 
@@ -1593,6 +1785,8 @@ static int EsOutProgramDel(es_out_sys_t *p_sys, input_source_t *source, int i_gr
     if( p_sys->p_pgrm == p_pgrm )
         p_sys->p_pgrm = NULL;
 
+    EsOutProgramsUpdateWarm(p_sys);
+
     /* Update "program" variable */
     input_SendEventProgramDel( p_input, i_group );
 
@@ -2193,6 +2387,10 @@ static es_out_id_t *EsOutAddLocked(es_out_sys_t *p_sys,
     es->mouse_event_userdata = NULL;
     es->i_pts_level = VLC_TICK_INVALID;
     es->delay = VLC_TICK_MAX;
+    es->warm.packetizer = NULL;
+    es->warm.gop = NULL;
+    es->warm.gop_last = &es->warm.gop;
+    es->warm.gop_size = 0;
 
     vlc_list_append(&es->node, es->p_master ? &p_sys->es_slaves : &p_sys->es);
 
@@ -2204,6 +2402,9 @@ static es_out_id_t *EsOutAddLocked(es_out_sys_t *p_sys,
     EsOutUpdateInfo(p_sys, es, NULL);
     EsOutSelect(p_sys, es, false);
 
+    if( es->p_pgrm != NULL && es->p_pgrm->b_warm )
+        EsOutWarmStart(p_sys, es);
+
     return es;
 }
 
@@ -2303,6 +2504,8 @@ static void EsOutCreateDecoder(es_out_sys_t *p_sys, es_out_id_t *p_es)
         .cc_decoder = p_sys->cc_decoder,
         .cbs = &decoder_cbs,
         .cbs_data = p_es,
+        .budget = &priv->decoder_budget,
+        .metrics = priv->metrics,
     };
     if (p_es->p_master != NULL)
     {
@@ -2335,6 +2538,7 @@ static void EsOutCreateDecoder(es_out_sys_t *p_sys, es_out_id_t *p_es)
                 .cc_decoder = p_sys->cc_decoder,
                 .cbs = &decoder_cbs,
                 .cbs_data = p_es,
+                .budget = &priv->decoder_budget,
             };
             p_es->p_dec_record = vlc_input_decoder_New( VLC_OBJECT(p_input), &rec_cfg );
 
@@ -2462,6 +2666,8 @@ static void EsOutSelectEs(es_out_sys_t *p_sys, es_out_id_t *es, bool b_force, en
     if( es->p_dec == NULL || es->p_pgrm != p_sys->p_pgrm )
         return;
 
+    EsOutWarmReplay(p_sys, es);
+
     /* Mark it as selected */
     EsOutSendEsEvent(p_sys, es, VLC_INPUT_ES_SELECTED, b_force, vout_order);
 
@@ -2941,7 +3147,10 @@ static int EsOutSend(es_out_t *out, es_out_id_t *es, block_t *p_block )
 
     if( !es->p_dec )
     {
-        block_Release( p_block );
+        if( es->warm.packetizer != NULL )
+            EsOutWarmSend( es, p_block );
+        else
+            block_Release( p_block );
         vlc_mutex_unlock( &p_sys->lock );
         return VLC_SUCCESS;
     }
@@ -2994,6 +3203,9 @@ static int EsOutSend(es_out_t *out, es_out_id_t *es, block_t *p_block )
 
     vlc_mutex_unlock( &p_sys->lock );
 
+    /* Out of the lock: the decoder threads take it to report their events */
+    vlc_input_decoder_WaitBudget( &input_priv(p_input)->decoder_budget );
+
     return VLC_SUCCESS;
 }
 
@@ -3038,6 +3250,7 @@ static void EsOutDelLocked(es_out_sys_t *p_sys, es_out_id_t *es)
         EsOutUnselectEs(p_sys, es, es->p_pgrm == p_sys->p_pgrm );
     }
 
+    EsOutWarmStop(es);
     EsTerminate(es);
 
     if( es->p_pgrm == p_sys->p_pgrm )
@@ -3498,6 +3711,11 @@ static int EsOutVaControlLocked(es_out_sys_t *p_sys, input_source_t *source,
 
         if(b_was_selected)
             EsOutCreateDecoder(p_sys, es);
+        else if( es->warm.packetizer != NULL )
+        {
+            EsOutWarmStop(es);
+            EsOutWarmStart(p_sys, es);
+        }
 
         EsOutSendEsEvent(p_sys, es, VLC_INPUT_ES_UPDATED, false, VLC_VOUT_ORDER_PRIMARY);
 
@@ -3687,6 +3905,7 @@ static int EsOutVaPrivControlLocked(es_out_sys_t *p_sys, input_source_t *source,
         {
             EsOutSelect(p_sys, es, false);
         }
+        EsOutProgramsUpdateWarm(p_sys);
 
         if( i_mode == ES_OUT_MODE_END )
             EsOutTerminate(p_sys);
@@ -4053,6 +4272,8 @@ input_EsOutNew(input_thread_t *p_input, input_source_t *main_source, float rate,
     p_sys->cc_decoder = var_InheritInteger( p_input, "captions" );
 
     p_sys->i_group_id = var_GetInteger( p_input, "program" );
+    p_sys->i_warm_programs = var_InheritInteger( p_input, "warm-programs" );
+    p_sys->i_warm_size = 0;
 
     p_sys->user_clock_source = clock_source_Inherit( VLC_OBJECT(p_input) );
 
@@ -298,6 +298,10 @@ input_thread_t * input_Create( vlc_object_t *p_parent, input_item_t *p_item,
 
     vlc_mutex_unlock( &p_item->lock );
 
+    /* The metrics of the previous playback, if any, are reset */
+    priv->metrics = priv->type == INPUT_TYPE_PLAYBACK
+                  ? input_item_ResetMetrics( p_item ) : NULL;
+
     /* No slave */
     priv->i_slave = 0;
     priv->slave   = NULL;
@@ -325,6 +329,13 @@ input_thread_t * input_Create( vlc_object_t *p_parent, input_item_t *p_item,
     input_item_SetNowPlaying( p_item, NULL );
     input_item_SetESNowPlaying( p_item, NULL );
 
+    atomic_init( &priv->decoder_budget.used, 0 );
+    priv->decoder_budget.limit =
+        (size_t)var_InheritInteger( p_input, "decoder-fifo-budget" ) << 20;
+    vlc_mutex_init( &priv->decoder_budget.lock );
+    vlc_cond_init( &priv->decoder_budget.wait );
+    priv->decoder_budget.throttled = NULL;
+
     /* */
     if( priv->type == INPUT_TYPE_PLAYBACK && var_InheritBool( p_input, "stats" ) )
         priv->stats = input_stats_Create();
@@ -463,8 +474,18 @@ static void MainLoopDemux( input_thread_t *p_input, bool *pb_changed )
     }
 
     if( i_ret == VLC_DEMUXER_SUCCESS )
+    {
+        vlc_tick_t start = vlc_tick_now();
+
         i_ret = demux_Demux( p_demux );
 
+        /* Demuxers only block while waiting for data */
+        vlc_tick_t duration = vlc_tick_now() - start;
+        if( p_priv->metrics != NULL && duration >= INPUT_METRICS_STALL )
+            input_metrics_AddSample( &p_priv->metrics->demux_stalls,
+                                     duration );
+    }
+
     i_ret = i_ret > 0 ? VLC_DEMUXER_SUCCESS : ( i_ret < 0 ? VLC_DEMUXER_EGENERIC : VLC_DEMUXER_EOF);
 
     if( i_ret == VLC_DEMUXER_SUCCESS )
@@ -594,6 +615,9 @@ static void MainLoopStatistics( input_thread_t *p_input )
     {
         struct input_stats_t new_stats;
         input_stats_Compute(priv->stats, &new_stats);
+        new_stats.i_decoder_fifo_bytes =
+            atomic_load_explicit(&priv->decoder_budget.used,
+                                 memory_order_relaxed);
 
         vlc_mutex_lock(&priv->p_item->lock);
         *priv->p_item->p_stats = new_stats;
@@ -1241,7 +1265,7 @@ static void InitPrograms( input_thread_t * p_input )
     if( i_es_out_mode == ES_OUT_MODE_ALL )
     {
         demux_Control( input_priv(p_input)->master->p_demux,
-                       DEMUX_SET_GROUP_ALL );
+                       DEMUX_SET_GROUP_ALL, 0 );
     }
     else if( i_es_out_mode == ES_OUT_MODE_PARTIAL )
     {
@@ -1249,6 +1273,13 @@ static void InitPrograms( input_thread_t * p_input )
                        DEMUX_SET_GROUP_LIST, count, tab );
         free(tab);
     }
+    else if( var_InheritInteger( p_input, "warm-programs" ) > 0 )
+    {
+        /* The es_out keeps the programs next to the selected one warm */
+        demux_Control( input_priv(p_input)->master->p_demux,
+                       DEMUX_SET_GROUP_ALL,
+                       es_out_GetGroupForced( input_priv(p_input)->p_es_out ) );
+    }
     else
     {
         int program = es_out_GetGroupForced( input_priv(p_input)->p_es_out );
@@ -1438,6 +1469,9 @@ static void End( input_thread_t * p_input )
         /* make sure we are up to date */
         vlc_mutex_lock( &item->lock );
         input_stats_Compute( priv->stats, item->p_stats );
+        item->p_stats->i_decoder_fifo_bytes =
+            atomic_load_explicit( &priv->decoder_budget.used,
+                                  memory_order_relaxed );
         vlc_mutex_unlock( &item->lock );
     }
 
@@ -2093,7 +2127,12 @@ static bool Control( input_thread_t *p_input,
                 break; /* Possible when called early, the group will be set on
                         * the demux from InitPrograms() */
 
-            if( param.val.i_int == 0 )
+            if( var_InheritInteger( p_input, "warm-programs" ) > 0 )
+                /* All the programs stay demuxed, only the selected one
+                 * changes */
+                demux_Control( priv->master->p_demux,
+                               DEMUX_SET_GROUP_ALL, (int)param.val.i_int );
+            else if( param.val.i_int == 0 )
                 demux_Control( priv->master->p_demux,
                                DEMUX_SET_GROUP_DEFAULT );
             else
@@ -2541,10 +2580,17 @@ static demux_t *InputDemuxNew( input_thread_t *p_input, es_out_t *p_es_out,
         p_stream = stream_FilterChainNew( p_stream, "record" );
 
     /* create a regular demux with the access stream created */
+    vlc_tick_t probe_start = vlc_tick_now();
     demux_t *demux = demux_NewAdvanced( obj, p_input, psz_demux, url, p_stream,
                                         p_es_out, preparsing );
     if( demux != NULL )
+    {
+        if( priv->metrics != NULL && p_source == priv->master )
+            atomic_store_explicit( &priv->metrics->demux_probe_time,
+                                   vlc_tick_now() - probe_start,
+                                   memory_order_relaxed );
         return demux;
+    }
 
 error:
     vlc_stream_Delete( p_stream );
@@ -438,6 +438,20 @@ typedef struct
 } input_control_t;
 
 /** Private input fields */
+/**
+ * Byte budget shared by the decoder FIFOs of an input
+ */
+struct vlc_input_decoder_budget
+{
+    atomic_size_t used;
+    size_t limit; /**< 0 if unlimited */
+
+    vlc_mutex_t lock;
+    vlc_cond_t wait;
+    /** Decoder whose FIFO the input must wait for, or NULL */
+    const struct vlc_input_decoder_t *throttled;
+};
+
 typedef struct input_thread_private_t
 {
     struct input_thread_t input;
@@ -497,6 +511,11 @@ typedef struct input_thread_private_t
 
     /* Stats counters */
     struct input_stats *stats;
+    /* Playback metrics, owned by the item */
+    struct input_metrics *metrics;
+
+    /* Decoder FIFOs occupancy */
+    struct vlc_input_decoder_budget decoder_budget;
 
     /* Buffer of pending actions */
     vlc_mutex_t lock_control;
@@ -723,4 +742,52 @@ void input_stats_Destroy(struct input_stats *);
 void input_rate_Add(input_rate_t *, uintmax_t);
 void input_stats_Compute(struct input_stats *, input_stats_t*);
 
+struct input_metrics_histogram {
+    atomic_uint_least64_t buckets[VLC_INPUT_METRICS_BUCKETS];
+    atomic_uint_least64_t count;
+    _Atomic vlc_tick_t sum;
+};
+
+struct input_metrics_es {
+    atomic_uint state; /* free, being set up, in use, or ended */
+    atomic_int id;
+    atomic_int cat;
+    atomic_uint codec;
+    atomic_uint queue_blocks;
+    atomic_uint_least64_t queue_bytes;
+    atomic_uint_least64_t queue_peak_bytes;
+    struct input_metrics_histogram decode_time;
+};
+
+/* Lock-free counterpart of struct vlc_input_metrics */
+struct input_metrics {
+    struct input_metrics_es es[VLC_INPUT_METRICS_MAX_ES];
+    struct input_metrics_histogram demux_stalls;
+    _Atomic vlc_tick_t demux_probe_time;
+    atomic_uint_least64_t displayed_pictures;
+    atomic_uint_least64_t late_pictures;
+    atomic_uint_least64_t dropped_pictures;
+    struct input_metrics_histogram lateness;
+    _Atomic vlc_tick_t aout_drift;
+    atomic_uint aout_resampling; /* float bits */
+};
+
+/* Demux calls blocking longer than this are accounted as stalls */
+#define INPUT_METRICS_STALL VLC_TICK_FROM_MS(50)
+
+struct input_metrics *input_metrics_New(void);
+void input_metrics_Reset(struct input_metrics *);
+void input_metrics_Read(struct input_metrics *, struct vlc_input_metrics *);
+void input_metrics_AddSample(struct input_metrics_histogram *, vlc_tick_t);
+void input_metrics_AddSamples(struct input_metrics_histogram *,
+                              const unsigned *buckets, vlc_tick_t sum);
+
+struct input_metrics_es *input_metrics_AddES(struct input_metrics *,
+                                             const es_format_t *);
+void input_metrics_DelES(struct input_metrics_es *);
+void input_metrics_SetQueue(struct input_metrics_es *, unsigned blocks,
+                            size_t bytes);
+void input_metrics_SetAoutSync(struct input_metrics *, vlc_tick_t drift,
+                               float resampling);
+
 #endif
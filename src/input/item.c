@@ -389,6 +389,33 @@ bool input_item_IsPreparsed( input_item_t *p_item )
     return b_preparsed;
 }
 
+struct input_metrics *input_item_ResetMetrics( input_item_t *p_item )
+{
+    vlc_mutex_lock( &p_item->lock );
+    if( p_item->p_metrics == NULL )
+        p_item->p_metrics = input_metrics_New();
+    else
+        input_metrics_Reset( p_item->p_metrics );
+    struct input_metrics *m = p_item->p_metrics;
+    vlc_mutex_unlock( &p_item->lock );
+    return m;
+}
+
+bool input_item_GetMetrics( input_item_t *p_item,
+                            struct vlc_input_metrics *metrics )
+{
+    /* The metrics are allocated once and live as long as the item: the lock
+     * only protects the pointer, the counters are read without it. */
+    vlc_mutex_lock( &p_item->lock );
+    struct input_metrics *m = p_item->p_metrics;
+    vlc_mutex_unlock( &p_item->lock );
+
+    if( m == NULL )
+        return false;
+    input_metrics_Read( m, metrics );
+    return true;
+}
+
 bool input_item_IsArtFetched( input_item_t *p_item )
 {
     vlc_mutex_lock( &p_item->lock );
@@ -416,6 +443,7 @@ void input_item_Release( input_item_t *p_item )
     free( p_item->psz_name );
     free( p_item->psz_uri );
     free( p_item->p_stats );
+    free( p_item->p_metrics );
     vlc_meta_Delete( p_item->p_meta );
 
     for( input_item_opaque_t *o = p_item->opaques, *next; o != NULL; o = next )
@@ -1013,6 +1041,7 @@ input_item_NewExt( const char *psz_uri, const char *psz_name,
     vlc_list_init( &p_input->categories );
     vlc_vector_init( &p_input->es_vec );
     p_input->p_stats = NULL;
+    p_input->p_metrics = NULL;
     TAB_INIT( p_input->i_epg, p_input->pp_epg );
     TAB_INIT( p_input->i_slaves, p_input->pp_slaves );
 
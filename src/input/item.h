@@ -29,6 +29,16 @@
 void input_item_UpdateTracksInfo( input_item_t *item, const es_format_t *fmt,
                                   const char *es_id, bool stable );
 
+struct input_metrics;
+
+/**
+ * Resets the metrics of an item for a new playback, allocating them the first
+ * time.
+ *
+ * \return the metrics, or NULL on allocation error
+ */
+struct input_metrics *input_item_ResetMetrics( input_item_t *item );
+
 typedef struct input_item_owner
 {
     input_item_t item;
@@ -140,3 +140,248 @@ void input_rate_Add(input_rate_t *counter, uintmax_t val)
     counter->samples[0].date = now;
     vlc_mutex_unlock(&counter->lock);
 }
+
+/*
+ * Playback metrics
+ *
+ * Every field is written and read with relaxed atomic operations, so that
+ * the decoder and output threads never wait for each other nor for the
+ * readers. A snapshot may mix older and newer values.
+ *
+ * The slot of a deleted decoder stays readable until the next playback, or
+ * until another ES needs it.
+ */
+enum {
+    METRICS_ES_FREE,
+    METRICS_ES_SETUP,
+    METRICS_ES_USED,
+    METRICS_ES_ENDED,
+};
+
+static void input_metrics_histogram_Reset(struct input_metrics_histogram *h)
+{
+    for (unsigned i = 0; i < VLC_INPUT_METRICS_BUCKETS; i++)
+        atomic_store_explicit(&h->buckets[i], 0, memory_order_relaxed);
+    atomic_store_explicit(&h->count, 0, memory_order_relaxed);
+    atomic_store_explicit(&h->sum, 0, memory_order_relaxed);
+}
+
+static void input_metrics_histogram_Read(struct input_metrics_histogram *h,
+                                         struct vlc_input_metrics_histogram *out)
+{
+    for (unsigned i = 0; i < VLC_INPUT_METRICS_BUCKETS; i++)
+        out->buckets[i] = atomic_load_explicit(&h->buckets[i],
+                                               memory_order_relaxed);
+    out->count = atomic_load_explicit(&h->count, memory_order_relaxed);
+    out->sum = atomic_load_explicit(&h->sum, memory_order_relaxed);
+}
+
+static void input_metrics_es_Reset(struct input_metrics_es *es)
+{
+    atomic_store_explicit(&es->queue_blocks, 0, memory_order_relaxed);
+    atomic_store_explicit(&es->queue_bytes, 0, memory_order_relaxed);
+    atomic_store_explicit(&es->queue_peak_bytes, 0, memory_order_relaxed);
+    input_metrics_histogram_Reset(&es->decode_time);
+}
+
+struct input_metrics *input_metrics_New(void)
+{
+    struct input_metrics *metrics = malloc(sizeof (*metrics));
+    if (unlikely(metrics == NULL))
+        return NULL;
+
+    for (unsigned i = 0; i < VLC_INPUT_METRICS_MAX_ES; i++)
+    {
+        struct input_metrics_es *es = &metrics->es[i];
+
+        atomic_init(&es->state, METRICS_ES_FREE);
+        atomic_init(&es->id, -1);
+        atomic_init(&es->cat, UNKNOWN_ES);
+        atomic_init(&es->codec, 0);
+    }
+    input_metrics_Reset(metrics);
+    return metrics;
+}
+
+void input_metrics_Reset(struct input_metrics *metrics)
+{
+    for (unsigned i = 0; i < VLC_INPUT_METRICS_MAX_ES; i++)
+    {
+        struct input_metrics_es *es = &metrics->es[i];
+        unsigned expected = METRICS_ES_ENDED;
+
+        atomic_compare_exchange_strong_explicit(&es->state, &expected,
+                                                METRICS_ES_FREE,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed);
+        input_metrics_es_Reset(es);
+    }
+    input_metrics_histogram_Reset(&metrics->demux_stalls);
+    atomic_store_explicit(&metrics->demux_probe_time, 0, memory_order_relaxed);
+    atomic_store_explicit(&metrics->displayed_pictures, 0,
+                          memory_order_relaxed);
+    atomic_store_explicit(&metrics->late_pictures, 0, memory_order_relaxed);
+    atomic_store_explicit(&metrics->dropped_pictures, 0, memory_order_relaxed);
+    input_metrics_histogram_Reset(&metrics->lateness);
+    input_metrics_SetAoutSync(metrics, VLC_TICK_INVALID, 1.f);
+}
+
+void input_metrics_Read(struct input_metrics *metrics,
+                        struct vlc_input_metrics *out)
+{
+    out->es_count = 0;
+    for (unsigned i = 0; i < VLC_INPUT_METRICS_MAX_ES; i++)
+    {
+        struct input_metrics_es *es = &metrics->es[i];
+
+        unsigned state = atomic_load_explicit(&es->state,
+                                              memory_order_acquire);
+        if (state != METRICS_ES_USED && state != METRICS_ES_ENDED)
+            continue;
+
+        struct vlc_input_metrics_es *o = &out->es[out->es_count++];
+        o->id = atomic_load_explicit(&es->id, memory_order_relaxed);
+        o->cat = atomic_load_explicit(&es->cat, memory_order_relaxed);
+        o->codec = atomic_load_explicit(&es->codec, memory_order_relaxed);
+        o->queue_blocks = atomic_load_explicit(&es->queue_blocks,
+                                               memory_order_relaxed);
+        o->queue_bytes = atomic_load_explicit(&es->queue_bytes,
+                                              memory_order_relaxed);
+        o->queue_peak_bytes = atomic_load_explicit(&es->queue_peak_bytes,
+                                                   memory_order_relaxed);
+        input_metrics_histogram_Read(&es->decode_time, &o->decode_time);
+    }
+
+    input_metrics_histogram_Read(&metrics->demux_stalls, &out->demux_stalls);
+    out->demux_probe_time = atomic_load_explicit(&metrics->demux_probe_time,
+                                                 memory_order_relaxed);
+
+    out->displayed_pictures =
+        atomic_load_explicit(&metrics->displayed_pictures,
+                             memory_order_relaxed);
+    out->late_pictures = atomic_load_explicit(&metrics->late_pictures,
+                                              memory_order_relaxed);
+    out->dropped_pictures = atomic_load_explicit(&metrics->dropped_pictures,
+                                                 memory_order_relaxed);
+    input_metrics_histogram_Read(&metrics->lateness, &out->lateness);
+
+    out->aout_drift = atomic_load_explicit(&metrics->aout_drift,
+                                           memory_order_relaxed);
+    unsigned bits = atomic_load_explicit(&metrics->aout_resampling,
+                                         memory_order_relaxed);
+    static_assert(sizeof (bits) == sizeof (out->aout_resampling),
+                  "float size mismatch");
+    memcpy(&out->aout_resampling, &bits, sizeof (bits));
+}
+
+void input_metrics_AddSample(struct input_metrics_histogram *h,
+                             vlc_tick_t duration)
+{
+    atomic_fetch_add_explicit(&h->buckets[vlc_input_metrics_Bucket(duration)],
+                              1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->sum, duration, memory_order_relaxed);
+}
+
+/**
+ * Merges samples accumulated elsewhere.
+ */
+void input_metrics_AddSamples(struct input_metrics_histogram *h,
+                              const unsigned *buckets, vlc_tick_t sum)
+{
+    if (sum != 0)
+        atomic_fetch_add_explicit(&h->sum, sum, memory_order_relaxed);
+
+    for (unsigned i = 0; i < VLC_INPUT_METRICS_BUCKETS; i++)
+    {
+        if (buckets[i] == 0)
+            continue;
+        atomic_fetch_add_explicit(&h->buckets[i], buckets[i],
+                                  memory_order_relaxed);
+        atomic_fetch_add_explicit(&h->count, buckets[i],
+                                  memory_order_relaxed);
+    }
+}
+
+static struct input_metrics_es *
+input_metrics_ClaimES(struct input_metrics *metrics, unsigned state,
+                      bool match_id, int id)
+{
+    for (unsigned i = 0; i < VLC_INPUT_METRICS_MAX_ES; i++)
+    {
+        struct input_metrics_es *es = &metrics->es[i];
+        unsigned expected = state;
+
+        if (match_id
+         && atomic_load_explicit(&es->id, memory_order_relaxed) != id)
+            continue;
+        if (atomic_compare_exchange_strong_explicit(&es->state, &expected,
+                                                    METRICS_ES_SETUP,
+                                                    memory_order_relaxed,
+                                                    memory_order_relaxed))
+            return es;
+    }
+    return NULL;
+}
+
+/**
+ * Claims the metrics slot of a decoder.
+ *
+ * \return the slot, or NULL if all the slots are in use
+ */
+struct input_metrics_es *input_metrics_AddES(struct input_metrics *metrics,
+                                             const es_format_t *fmt)
+{
+    /* A restarted decoder goes on with the metrics of its ES */
+    struct input_metrics_es *es =
+        input_metrics_ClaimES(metrics, METRICS_ES_ENDED, true, fmt->i_id);
+
+    if (es == NULL)
+    {
+        es = input_metrics_ClaimES(metrics, METRICS_ES_FREE, false, 0);
+        if (es == NULL)
+            es = input_metrics_ClaimES(metrics, METRICS_ES_ENDED, false, 0);
+        if (es == NULL)
+            return NULL;
+
+        atomic_store_explicit(&es->id, fmt->i_id, memory_order_relaxed);
+        input_metrics_es_Reset(es);
+    }
+
+    atomic_store_explicit(&es->cat, fmt->i_cat, memory_order_relaxed);
+    atomic_store_explicit(&es->codec, fmt->i_codec, memory_order_relaxed);
+    atomic_store_explicit(&es->state, METRICS_ES_USED,
+                          memory_order_release);
+    return es;
+}
+
+void input_metrics_DelES(struct input_metrics_es *es)
+{
+    /* Nothing left to decode */
+    input_metrics_SetQueue(es, 0, 0);
+    atomic_store_explicit(&es->state, METRICS_ES_ENDED, memory_order_release);
+}
+
+void input_metrics_SetQueue(struct input_metrics_es *es, unsigned blocks,
+                            size_t bytes)
+{
+    atomic_store_explicit(&es->queue_blocks, blocks, memory_order_relaxed);
+    atomic_store_explicit(&es->queue_bytes, bytes, memory_order_relaxed);
+
+    /* Only the decoder owning the slot writes the peak */
+    if (bytes > atomic_load_explicit(&es->queue_peak_bytes,
+                                     memory_order_relaxed))
+        atomic_store_explicit(&es->queue_peak_bytes, bytes,
+                              memory_order_relaxed);
+}
+
+void input_metrics_SetAoutSync(struct input_metrics *metrics,
+                               vlc_tick_t drift, float resampling)
+{
+    unsigned bits;
+
+    memcpy(&bits, &resampling, sizeof (bits));
+    atomic_store_explicit(&metrics->aout_drift, drift, memory_order_relaxed);
+    atomic_store_explicit(&metrics->aout_resampling, bits,
+                          memory_order_relaxed);
+}
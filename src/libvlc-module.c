@@ -554,6 +554,17 @@ static const char *const fit_descriptions[] = {
     "This defines the maximum input delay jitter that the synchronization " \
     "algorithms should try to compensate (in milliseconds)." )
 
+#define DEC_FIFO_BUDGET_TEXT N_("Decoder buffers budget (MiB)")
+#define DEC_FIFO_BUDGET_LONGTEXT N_( \
+    "Maximum amount of demuxed data waiting to be decoded for each input. " \
+    "When it is reached, demuxing is throttled until the decoders catch " \
+    "up. 0 means unlimited." )
+
+#define DEC_FIFO_TOTAL_BUDGET_TEXT N_("Total decoder buffers budget (MiB)")
+#define DEC_FIFO_TOTAL_BUDGET_LONGTEXT N_( \
+    "Maximum amount of demuxed data waiting to be decoded for all the " \
+    "inputs of the process. 0 means unlimited." )
+
 #define CLOCK_MASTER_TEXT N_("Clock master source")
 #define CLOCK_MASTER_LONGTEXT N_( "Select the clock master source:\n" \
     "auto: best clock source, input if the access can't be paced " \
@@ -614,6 +625,12 @@ static const char *const ppsz_clock_descriptions[] =
     "Only use this option if you want to read a multi-program stream " \
     "(like DVB streams for example)." )
 
+#define INPUT_WARM_PROGRAMS_TEXT N_("Warm programs")
+#define INPUT_WARM_PROGRAMS_LONGTEXT N_( \
+    "Number of programs next to the selected one whose last group of " \
+    "pictures is kept, so that switching to them shows a picture " \
+    "immediately. The whole multiplex is then demultiplexed.")
+
 /// \todo Document how to find it
 #define INPUT_VIDEOTRACK_TEXT N_("Video track")
 #define INPUT_VIDEOTRACK_LONGTEXT N_( \
@@ -1813,6 +1830,9 @@ vlc_module_begin ()
     add_string( "programs", "",
                 INPUT_PROGRAMS_TEXT, INPUT_PROGRAMS_LONGTEXT )
         change_safe ()
+    add_integer_with_range( "warm-programs", 0, 0, 16,
+                            INPUT_WARM_PROGRAMS_TEXT,
+                            INPUT_WARM_PROGRAMS_LONGTEXT )
     add_integer( "video-track", -1,
                  INPUT_VIDEOTRACK_TEXT, INPUT_VIDEOTRACK_LONGTEXT )
         change_safe ()
@@ -1987,6 +2007,12 @@ vlc_module_begin ()
     add_integer( "clock-jitter", 5000, CLOCK_JITTER_TEXT,
               CLOCK_JITTER_LONGTEXT )
         change_safe()
+    add_integer( "decoder-fifo-budget", 400, DEC_FIFO_BUDGET_TEXT,
+                 DEC_FIFO_BUDGET_LONGTEXT )
+        change_integer_range( 0, 65535 )
+    add_integer( "decoder-fifo-total-budget", 0, DEC_FIFO_TOTAL_BUDGET_TEXT,
+                 DEC_FIFO_TOTAL_BUDGET_LONGTEXT )
+        change_integer_range( 0, 65535 )
     add_string( "clock-master", "auto",
                  CLOCK_MASTER_TEXT, CLOCK_MASTER_LONGTEXT )
         change_string_list( ppsz_clock_master_values, ppsz_clock_master_descriptions )
@@ -42,6 +42,7 @@
 #include "modules/modules.h"
 #include "config/configuration.h"
 #include "media_source/media_source.h"
+#include "input/demux.h"
 
 #include <stdio.h>                                              /* sprintf() */
 #include <string.h>
@@ -96,6 +97,8 @@ libvlc_int_t * libvlc_InternalCreate( void )
     priv->main_playlist = NULL;
     priv->p_vlm = NULL;
     priv->media_source_provider = NULL;
+    priv->probe_cache = NULL;
+    priv->http_pool = NULL;
 
     vlc_ExitInit( &priv->exit );
 
@@ -235,6 +238,11 @@ int libvlc_InternalInit( libvlc_int_t *p_libvlc, int i_argc,
     if( !priv->media_source_provider )
         goto error;
 
+    /* Not fatal: the demuxers are then always probed from scratch */
+    priv->probe_cache = demux_ProbeCacheNew();
+    /* Not fatal either: idle HTTP connections are then closed */
+    priv->http_pool = vlc_http_pool_New();
+
     /* variables for signalling creation of new files */
     var_Create( p_libvlc, "snapshot-file", VLC_VAR_STRING );
     var_Create( p_libvlc, "record-file", VLC_VAR_STRING );
@@ -372,6 +380,13 @@ void libvlc_InternalCleanup( libvlc_int_t *p_libvlc )
     if( priv->media_source_provider )
         vlc_media_source_provider_Delete( priv->media_source_provider );
 
+    if( priv->probe_cache )
+        demux_ProbeCacheDelete( priv->probe_cache );
+
+    /* Idle connections use the logger and modules of the instance */
+    if( priv->http_pool )
+        vlc_http_pool_Delete( priv->http_pool );
+
     libvlc_InternalDialogClean( p_libvlc );
     libvlc_InternalKeystoreClean( p_libvlc );
     libvlc_InternalActionsClean( p_libvlc );
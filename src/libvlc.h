@@ -187,6 +187,8 @@ typedef struct libvlc_priv_t
     vlc_actions_t *actions; ///< Hotkeys handler
     struct vlc_medialibrary_t *p_media_library; ///< Media library instance
     struct vlc_tracer *tracer; ///< Tracer callbacks
+    struct demux_probe_cache *probe_cache; ///< Demuxers of the recent URLs
+    struct vlc_http_pool *http_pool; ///< Idle HTTP connections
 
     /* Exit callback */
     vlc_exit_t       exit;
@@ -204,6 +206,12 @@ void intf_DestroyAll( libvlc_int_t * );
 vlc_playlist_t *
 libvlc_GetMainPlaylist(libvlc_int_t *libvlc);
 
+/*
+ * Idle HTTP connections
+ */
+struct vlc_http_pool *vlc_http_pool_New(void);
+void vlc_http_pool_Delete(struct vlc_http_pool *);
+
 /*
  * Variables stuff
  */
@@ -33,6 +33,7 @@
 
 #include <vlc_common.h>
 #include <vlc_cpu.h>
+#include <vlc_list.h>
 #include <vlc_memstream.h>
 #include <vlc_modules.h>
 #include "libvlc.h"
@@ -216,3 +217,109 @@ void vlc_CPU_functions_init(const char *capability, void *restrict funcs)
 
     free(mods);
 }
+
+struct vlc_cpu_share
+{
+    unsigned max;
+    atomic_uint threads;
+    bool fixed; /* Rebalancing: capped to max */
+    struct vlc_list node;
+};
+
+static struct
+{
+    vlc_mutex_t lock;
+    struct vlc_list shares;
+} cpu_budget = { VLC_STATIC_MUTEX, VLC_LIST_INITIALIZER(&cpu_budget.shares) };
+
+/**
+ * Divides the cores between the shares: the shares capped below the even
+ * level get their maximum, the others divide the remaining cores evenly.
+ */
+static void vlc_cpu_share_Rebalance(void)
+{
+    struct vlc_cpu_share *share;
+    unsigned cores = vlc_GetCPUCount();
+    unsigned count = 0;
+
+    vlc_mutex_assert(&cpu_budget.lock);
+
+    vlc_list_foreach(share, &cpu_budget.shares, node)
+    {
+        share->fixed = false;
+        count++;
+    }
+
+    bool again;
+    do
+    {
+        unsigned level = count > 0 ? cores / count : cores;
+
+        again = false;
+        vlc_list_foreach(share, &cpu_budget.shares, node)
+            if (!share->fixed && share->max != 0 && share->max <= level)
+            {
+                share->fixed = true;
+                cores -= share->max;
+                count--;
+                again = true;
+            }
+    }
+    while (again);
+
+    /* The first shares get the remainder of the division */
+    unsigned level = count > 0 ? cores / count : 0;
+    unsigned extra = count > 0 ? cores % count : 0;
+
+    vlc_list_foreach(share, &cpu_budget.shares, node)
+    {
+        unsigned threads;
+
+        if (share->fixed)
+            threads = share->max;
+        else
+        {
+            threads = level;
+            if (extra > 0)
+            {
+                threads++;
+                extra--;
+            }
+        }
+        atomic_store_explicit(&share->threads, __MAX(threads, 1u),
+                              memory_order_relaxed);
+    }
+}
+
+struct vlc_cpu_share *vlc_cpu_share_Join(unsigned max)
+{
+    struct vlc_cpu_share *share = malloc(sizeof (*share));
+    if (unlikely(share == NULL))
+        return NULL;
+
+    share->max = max;
+    atomic_init(&share->threads, 1);
+
+    vlc_mutex_lock(&cpu_budget.lock);
+    vlc_list_append(&share->node, &cpu_budget.shares);
+    vlc_cpu_share_Rebalance();
+    vlc_mutex_unlock(&cpu_budget.lock);
+    return share;
+}
+
+unsigned vlc_cpu_share_Threads(const struct vlc_cpu_share *share)
+{
+    return atomic_load_explicit(&share->threads, memory_order_relaxed);
+}
+
+void vlc_cpu_share_Leave(struct vlc_cpu_share *share)
+{
+    if (share == NULL)
+        return;
+
+    vlc_mutex_lock(&cpu_budget.lock);
+    vlc_list_remove(&share->node);
+    vlc_cpu_share_Rebalance();
+    vlc_mutex_unlock(&cpu_budget.lock);
+    free(share);
+}
@@ -0,0 +1,187 @@
+/*****************************************************************************
+ * httppool.c: HTTP idle connections
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <vlc_common.h>
+#include <vlc_list.h>
+#include <vlc_http.h>
+#include "../libvlc.h"
+
+#define HTTP_POOL_TTL VLC_TICK_FROM_SEC(5)
+#define HTTP_POOL_MAX 5
+
+struct vlc_http_pool_entry
+{
+    struct vlc_list node;
+    void *data;
+    void (*release)(void *);
+    vlc_tick_t deadline;
+    char key[];
+};
+
+struct vlc_http_pool
+{
+    vlc_mutex_t lock;
+    vlc_timer_t timer;
+    struct vlc_list entries; /* oldest first */
+    size_t count;
+};
+
+static void vlc_http_pool_Release(struct vlc_list *list)
+{
+    struct vlc_http_pool_entry *entry;
+
+    vlc_list_foreach(entry, list, node)
+    {
+        entry->release(entry->data);
+        free(entry);
+    }
+}
+
+static void vlc_http_pool_Expire(void *data)
+{
+    struct vlc_http_pool *pool = data;
+    struct vlc_http_pool_entry *entry;
+    struct vlc_list expired;
+    vlc_tick_t now = vlc_tick_now();
+
+    vlc_list_init(&expired);
+    vlc_mutex_lock(&pool->lock);
+    vlc_list_foreach(entry, &pool->entries, node)
+    {
+        if (entry->deadline > now)
+        {
+            vlc_timer_schedule(pool->timer, true, entry->deadline, 0);
+            break;
+        }
+        vlc_list_remove(&entry->node);
+        vlc_list_append(&entry->node, &expired);
+        pool->count--;
+    }
+    vlc_mutex_unlock(&pool->lock);
+
+    /* The connections are closed without the lock, as this can block */
+    vlc_http_pool_Release(&expired);
+}
+
+struct vlc_http_pool *vlc_http_pool_New(void)
+{
+    struct vlc_http_pool *pool = malloc(sizeof (*pool));
+    if (unlikely(pool == NULL))
+        return NULL;
+
+    if (vlc_timer_create(&pool->timer, vlc_http_pool_Expire, pool))
+    {
+        free(pool);
+        return NULL;
+    }
+
+    vlc_mutex_init(&pool->lock);
+    vlc_list_init(&pool->entries);
+    pool->count = 0;
+    return pool;
+}
+
+void vlc_http_pool_Delete(struct vlc_http_pool *pool)
+{
+    vlc_timer_destroy(pool->timer);
+    vlc_http_pool_Release(&pool->entries);
+    free(pool);
+}
+
+static struct vlc_http_pool *vlc_http_pool_Get(vlc_object_t *obj)
+{
+    return libvlc_priv(vlc_object_instance(obj))->http_pool;
+}
+
+int vlc_http_pool_put(vlc_object_t *obj, const char *key, void *data,
+                      void (*release)(void *))
+{
+    struct vlc_http_pool *pool = vlc_http_pool_Get(obj);
+    if (pool == NULL)
+        return -1;
+
+    size_t keylen = strlen(key) + 1;
+    struct vlc_http_pool_entry *entry = malloc(sizeof (*entry) + keylen);
+    if (unlikely(entry == NULL))
+        return -1;
+
+    entry->data = data;
+    entry->release = release;
+    entry->deadline = vlc_tick_now() + HTTP_POOL_TTL;
+    memcpy(entry->key, key, keylen);
+
+    struct vlc_http_pool_entry *evicted = NULL;
+
+    vlc_mutex_lock(&pool->lock);
+    if (pool->count >= HTTP_POOL_MAX)
+    {
+        evicted = vlc_list_first_entry_or_null(&pool->entries,
+                                               struct vlc_http_pool_entry,
+                                               node);
+        vlc_list_remove(&evicted->node);
+        pool->count--;
+    }
+    if (vlc_list_is_empty(&pool->entries))
+        vlc_timer_schedule(pool->timer, true, entry->deadline, 0);
+    vlc_list_append(&entry->node, &pool->entries);
+    pool->count++;
+    vlc_mutex_unlock(&pool->lock);
+
+    if (evicted != NULL)
+    {
+        evicted->release(evicted->data);
+        free(evicted);
+    }
+    return 0;
+}
+
+void *vlc_http_pool_take(vlc_object_t *obj, const char *key)
+{
+    struct vlc_http_pool *pool = vlc_http_pool_Get(obj);
+    struct vlc_http_pool_entry *entry, *found = NULL;
+
+    if (pool == NULL)
+        return NULL;
+
+    vlc_mutex_lock(&pool->lock);
+    vlc_list_reverse_foreach(entry, &pool->entries, node)
+        if (strcmp(entry->key, key) == 0)
+        {   /* the most recent one is the most likely to be alive */
+            vlc_list_remove(&entry->node);
+            pool->count--;
+            found = entry;
+            break;
+        }
+    vlc_mutex_unlock(&pool->lock);
+
+    if (found == NULL)
+        return NULL;
+
+    void *data = found->data;
+    free(found);
+    return data;
+}
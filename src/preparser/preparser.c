@@ -25,16 +25,19 @@
 #include <vlc_common.h>
 #include <vlc_atomic.h>
 #include <vlc_executor.h>
+#include <vlc_interrupt.h>
 #include <vlc_preparser.h>
 
 #include "input/input_interface.h"
 #include "input/input_internal.h"
 #include "fetcher.h"
+#include "thumbnail.h"
 
 union vlc_preparser_cbs
 {
     const input_item_parser_cbs_t *parser;
     const struct vlc_thumbnailer_cbs *thumbnailer;
+    const struct vlc_thumbnailer_storyboard_cbs *storyboard;
 };
 
 struct vlc_preparser_t
@@ -56,6 +59,8 @@ struct task
     input_item_t *item;
     int options;
     struct vlc_preparser_seek_arg seek_arg;
+    struct vlc_preparser_seek_arg *seek_args; /**< storyboard, or NULL */
+    size_t seek_count;
     union vlc_preparser_cbs cbs;
     void *userdata;
     vlc_preparser_req_id id;
@@ -65,6 +70,7 @@ struct task
     vlc_sem_t preparse_ended;
     int preparse_status;
     atomic_bool interrupted;
+    vlc_interrupt_t *interrupt; /**< to abort a synchronous thumbnailer */
 
     struct vlc_runnable runnable; /**< to be passed to the executor */
 
@@ -86,6 +92,9 @@ TaskNew(vlc_preparser_t *preparser, void (*run)(void *), input_item_t *item,
     task->cbs = cbs;
     task->userdata = userdata;
     task->pic = NULL;
+    task->seek_args = NULL;
+    task->seek_count = 0;
+    task->interrupt = NULL;
 
     if (seek_arg == NULL)
         task->seek_arg = (struct vlc_preparser_seek_arg) {
@@ -109,6 +118,9 @@ TaskNew(vlc_preparser_t *preparser, void (*run)(void *), input_item_t *item,
 static void
 TaskDelete(struct task *task)
 {
+    if (task->interrupt != NULL)
+        vlc_interrupt_destroy(task->interrupt);
+    free(task->seek_args);
     input_item_Release(task->item);
     free(task);
 }
@@ -318,11 +330,46 @@ on_thumbnailer_input_event( input_thread_t *input,
 }
 
 static void
-ThumbnailerRun(void *userdata)
+ThumbnailSeek(input_thread_t *input, const struct vlc_preparser_seek_arg *seek_arg)
 {
-    vlc_thread_set_name("vlc-run-thumb");
+    assert(seek_arg->speed == VLC_PREPARSER_SEEK_PRECISE
+        || seek_arg->speed == VLC_PREPARSER_SEEK_FAST);
+    bool fast_seek = seek_arg->speed == VLC_PREPARSER_SEEK_FAST;
 
-    struct task *task = userdata;
+    switch (seek_arg->type)
+    {
+        case VLC_PREPARSER_SEEK_NONE:
+            break;
+        case VLC_PREPARSER_SEEK_TIME:
+            input_SetTime(input, seek_arg->time, fast_seek);
+            break;
+        case VLC_PREPARSER_SEEK_POS:
+            input_SetPosition(input, seek_arg->pos, fast_seek);
+            break;
+        default:
+            vlc_assert_unreachable();
+    }
+}
+
+static void
+ThumbnailWait(struct task *task, vlc_tick_t deadline)
+{
+    if (deadline == VLC_TICK_INVALID)
+        vlc_sem_wait(&task->preparse_ended);
+    else
+    {
+        if (vlc_sem_timedwait(&task->preparse_ended, deadline))
+            task->preparse_status = VLC_ETIMEOUT;
+    }
+
+    if (atomic_load(&task->interrupted))
+        task->preparse_status = -EINTR;
+}
+
+static int
+ThumbnailInput(struct task *task, const struct vlc_preparser_seek_arg *seek_arg,
+               vlc_tick_t deadline, input_thread_t **inputp)
+{
     vlc_preparser_t *preparser = task->preparser;
 
     static const struct vlc_input_thread_callbacks cbs = {
@@ -335,50 +382,41 @@ ThumbnailerRun(void *userdata)
         .cbs_data = task,
     };
 
-    vlc_tick_t deadline = preparser->timeout != VLC_TICK_INVALID ?
-                          vlc_tick_now() + preparser->timeout :
-                          VLC_TICK_INVALID;
-
     input_thread_t* input =
             input_Create( preparser->owner, task->item, &cfg );
     if (!input)
-        goto error;
+        return VLC_EGENERIC;
 
-    assert(task->seek_arg.speed == VLC_PREPARSER_SEEK_PRECISE
-        || task->seek_arg.speed == VLC_PREPARSER_SEEK_FAST);
-    bool fast_seek = task->seek_arg.speed == VLC_PREPARSER_SEEK_FAST;
-
-    switch (task->seek_arg.type)
-    {
-        case VLC_PREPARSER_SEEK_NONE:
-            break;
-        case VLC_PREPARSER_SEEK_TIME:
-            input_SetTime(input, task->seek_arg.time, fast_seek);
-            break;
-        case VLC_PREPARSER_SEEK_POS:
-            input_SetPosition(input, task->seek_arg.pos, fast_seek);
-            break;
-        default:
-            vlc_assert_unreachable();
-    }
+    ThumbnailSeek(input, seek_arg);
 
     int ret = input_Start(input);
     if (ret != VLC_SUCCESS)
     {
         input_Close(input);
-        goto error;
+        return ret;
     }
 
-    if (deadline == VLC_TICK_INVALID)
-        vlc_sem_wait(&task->preparse_ended);
-    else
-    {
-        if (vlc_sem_timedwait(&task->preparse_ended, deadline))
-            task->preparse_status = VLC_ETIMEOUT;
-    }
+    ThumbnailWait(task, deadline);
 
-    if (atomic_load(&task->interrupted))
-        task->preparse_status = -EINTR;
+    *inputp = input;
+    return VLC_SUCCESS;
+}
+
+static void
+ThumbnailerRun(void *userdata)
+{
+    vlc_thread_set_name("vlc-run-thumb");
+
+    struct task *task = userdata;
+    vlc_preparser_t *preparser = task->preparser;
+
+    vlc_tick_t deadline = preparser->timeout != VLC_TICK_INVALID ?
+                          vlc_tick_now() + preparser->timeout :
+                          VLC_TICK_INVALID;
+
+    input_thread_t *input;
+    if (ThumbnailInput(task, &task->seek_arg, deadline, &input) != VLC_SUCCESS)
+        goto error;
 
     picture_t* pic = task->pic;
     task->pic = NULL;
@@ -401,11 +439,154 @@ error:
     TaskDelete(task);
 }
 
+static void
+ThumbnailInputClose(struct task *task, input_thread_t *input)
+{
+    input_Stop(input);
+    input_Close(input);
+
+    /* Reset the events posted after the thumbnail */
+    while (vlc_sem_trywait(&task->preparse_ended) == 0);
+}
+
+/* Fallback for items that can only be demuxed from an input thread: a
+ * single input is seeked to each point in turn */
+static int
+StoryboardInput(struct task *task, vlc_tick_t deadline, picture_t **pics)
+{
+    input_thread_t *input = NULL;
+    int status = VLC_EGENERIC;
+
+    for (size_t i = 0; i < task->seek_count; i++)
+    {
+        bool reused = input != NULL;
+
+        task->preparse_status = VLC_EGENERIC;
+        if (reused)
+        {
+            /* The decoder outputs a new thumbnail after each seek */
+            while (vlc_sem_trywait(&task->preparse_ended) == 0);
+            ThumbnailSeek(input, &task->seek_args[i]);
+            ThumbnailWait(task, deadline);
+        }
+        else if (ThumbnailInput(task, &task->seek_args[i], deadline,
+                                &input) != VLC_SUCCESS)
+            break;
+
+        pics[i] = task->pic;
+        task->pic = NULL;
+        if (pics[i] != NULL)
+        {
+            status = VLC_SUCCESS;
+            continue;
+        }
+
+        if (task->preparse_status == VLC_ETIMEOUT
+         || task->preparse_status == -EINTR)
+        {
+            if (status != VLC_SUCCESS)
+                status = task->preparse_status;
+            break;
+        }
+
+        /* The input ended, maybe before processing the seek: try again
+         * from a new one */
+        ThumbnailInputClose(task, input);
+        input = NULL;
+        if (reused)
+            i--;
+    }
+
+    if (input != NULL)
+        ThumbnailInputClose(task, input);
+    return status;
+}
+
+static void
+OnStoryboardDeadline(void *data)
+{
+    struct task *task = data;
+
+    /* Abort the blocking calls of the synchronous thumbnailer */
+    vlc_interrupt_kill(task->interrupt);
+}
+
+static void
+StoryboardRun(void *userdata)
+{
+    vlc_thread_set_name("vlc-run-thumb");
+
+    struct task *task = userdata;
+    vlc_preparser_t *preparser = task->preparser;
+
+    vlc_tick_t deadline = preparser->timeout != VLC_TICK_INVALID ?
+                          vlc_tick_now() + preparser->timeout :
+                          VLC_TICK_INVALID;
+
+    picture_t **pics = vlc_alloc(task->seek_count, sizeof(*pics));
+    size_t count = pics != NULL ? task->seek_count : 0;
+    int status;
+
+    if (pics == NULL)
+        status = VLC_ENOMEM;
+    else if (atomic_load(&task->interrupted))
+    {
+        for (size_t i = 0; i < count; i++)
+            pics[i] = NULL;
+        status = -EINTR;
+    }
+    else
+    {
+        vlc_timer_t timer;
+        bool timer_armed = deadline != VLC_TICK_INVALID &&
+            vlc_timer_create(&timer, OnStoryboardDeadline, task) == 0;
+        if (timer_armed)
+            vlc_timer_schedule(timer, true, deadline, VLC_TIMER_FIRE_ONCE);
+
+        vlc_interrupt_t *oldint = vlc_interrupt_set(task->interrupt);
+        status = vlc_thumbnail_Decode(preparser->owner, task->item,
+                                      task->seek_args, task->seek_count,
+                                      deadline, pics);
+        vlc_interrupt_set(oldint);
+
+        if (timer_armed)
+            vlc_timer_destroy(timer);
+
+        if (status == -EINTR && !atomic_load(&task->interrupted))
+        {
+            /* Killed by the deadline timer */
+            status = VLC_ETIMEOUT;
+            for (size_t i = 0; i < count; i++)
+                if (pics[i] != NULL)
+                    status = VLC_SUCCESS;
+        }
+        else if (status == VLC_ENOTSUP)
+            status = StoryboardInput(task, deadline, pics);
+    }
+
+    if (atomic_load(&task->interrupted))
+        status = -EINTR;
+
+    PreparserRemoveTask(preparser, task);
+
+    task->cbs.storyboard->on_ended(task->item, status, pics, count,
+                                   task->userdata);
+
+    for (size_t i = 0; i < count; i++)
+        if (pics[i] != NULL)
+            picture_Release(pics[i]);
+    free(pics);
+
+    TaskDelete(task);
+}
+
 static void
 Interrupt(struct task *task)
 {
     atomic_store(&task->interrupted, true);
 
+    if (task->interrupt != NULL)
+        vlc_interrupt_kill(task->interrupt);
     vlc_sem_post(&task->preparse_ended);
 }
 
@@ -548,6 +729,44 @@ vlc_preparser_GenerateThumbnail( vlc_preparser_t *preparser, input_item_t *item,
     return id;
 }
 
+vlc_preparser_req_id
+vlc_preparser_GenerateThumbnails( vlc_preparser_t *preparser, input_item_t *item,
+                                  const struct vlc_preparser_seek_arg *seek_args,
+                                  size_t count,
+                                  const struct vlc_thumbnailer_storyboard_cbs *cbs,
+                                  void *cbs_userdata )
+{
+    assert(preparser->thumbnailer != NULL);
+    assert(seek_args != NULL && count > 0);
+    assert(cbs != NULL && cbs->on_ended != NULL);
+
+    union vlc_preparser_cbs task_cbs = {
+        .storyboard = cbs,
+    };
+
+    struct task *task =
+        TaskNew(preparser, StoryboardRun, item, VLC_PREPARSER_TYPE_THUMBNAIL,
+                NULL, task_cbs, cbs_userdata);
+    if (task == NULL)
+        return VLC_PREPARSER_REQ_ID_INVALID;
+
+    task->seek_args = vlc_alloc(count, sizeof(*seek_args));
+    task->interrupt = vlc_interrupt_create();
+    if (task->seek_args == NULL || task->interrupt == NULL)
+    {
+        TaskDelete(task);
+        return VLC_PREPARSER_REQ_ID_INVALID;
+    }
+    memcpy(task->seek_args, seek_args, count * sizeof(*seek_args));
+    task->seek_count = count;
+
+    vlc_preparser_req_id id = PreparserAddTask(preparser, task);
+
+    vlc_executor_Submit(preparser->thumbnailer, &task->runnable);
+
+    return id;
+}
+
 size_t vlc_preparser_Cancel( vlc_preparser_t *preparser, vlc_preparser_req_id id )
 {
     vlc_mutex_lock(&preparser->lock);
@@ -567,7 +786,11 @@ size_t vlc_preparser_Cancel( vlc_preparser_t *preparser, vlc_preparser_req_id id
                 vlc_list_remove(&task->node);
                 vlc_mutex_unlock(&preparser->lock);
                 task->preparse_status = -EINTR;
-                if (task->options == VLC_PREPARSER_TYPE_THUMBNAIL)
+                if (task->seek_args != NULL)
+                    task->cbs.storyboard->on_ended(task->item,
+                                                   task->preparse_status, NULL,
+                                                   0, task->userdata);
+                else if (task->options == VLC_PREPARSER_TYPE_THUMBNAIL)
                     task->cbs.thumbnailer->on_ended(task->item,
                                                     task->preparse_status, NULL,
                                                     task->userdata);
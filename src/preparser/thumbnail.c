@@ -0,0 +1,488 @@
+/*****************************************************************************
+ * thumbnail.c: lightweight keyframe thumbnailer
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <errno.h>
+
+#include <vlc_common.h>
+#include <vlc_codec.h>
+#include <vlc_demux.h>
+#include <vlc_es_out.h>
+#include <vlc_interrupt.h>
+#include <vlc_modules.h>
+#include <vlc_picture.h>
+
+#include "thumbnail.h"
+#include "input/demux.h"
+#include "input/stream.h"
+#include "input/input_internal.h"
+
+/*
+ * Unlike the input thread, there is no clock, no decoder thread and no video
+ * output: the demuxer is pulled from the calling thread and the blocks of the
+ * first video ES are decoded synchronously, until a picture comes out.
+ */
+
+struct es_out_id_t
+{
+    es_format_t fmt;
+};
+
+struct thumbnail_decoder
+{
+    decoder_t dec;
+    es_format_t fmt_in;
+    struct thumbnail_out *out;
+};
+
+struct thumbnail_out
+{
+    es_out_t out;
+    vlc_object_t *obj;
+
+    es_out_id_t *video; /**< selected video ES, or NULL */
+    decoder_t *packetizer; /**< NULL if the ES is already packetized */
+    struct thumbnail_decoder *dec; /**< created on the first packet */
+    bool failed; /**< the decoder can't be used for this ES */
+
+    vlc_tick_t target; /**< earliest accepted picture date, or INVALID */
+    picture_t *pic; /**< decoded thumbnail */
+};
+
+static inline struct thumbnail_decoder *dec_get_owner( decoder_t *dec )
+{
+    return container_of( dec, struct thumbnail_decoder, dec );
+}
+
+static vlc_decoder_device *DecoderGetDevice( decoder_t *dec )
+{
+    VLC_UNUSED(dec);
+    return NULL; /* no hardware decoding for a single picture */
+}
+
+static picture_t *DecoderNewBuffer( decoder_t *dec )
+{
+    struct thumbnail_out *out = dec_get_owner( dec )->out;
+
+    /* Don't bother allocating pictures past the thumbnail */
+    if( out->pic != NULL )
+        return NULL;
+    return picture_NewFromFormat( &dec->fmt_out.video );
+}
+
+static void DecoderQueue( decoder_t *dec, picture_t *pic )
+{
+    struct thumbnail_out *out = dec_get_owner( dec )->out;
+
+    if( out->pic == NULL
+     && ( out->target == VLC_TICK_INVALID || pic->date == VLC_TICK_INVALID
+       || pic->date >= out->target ) )
+        out->pic = pic;
+    else
+        picture_Release( pic );
+}
+
+static int DecoderNew( struct thumbnail_out *out, const es_format_t *fmt )
+{
+    struct thumbnail_decoder *owner =
+        vlc_custom_create( out->obj, sizeof( *owner ), "thumbnail decoder" );
+    if( unlikely(owner == NULL) )
+        return VLC_ENOMEM;
+
+    decoder_t *dec = &owner->dec;
+    owner->out = out;
+
+    decoder_Init( dec, &owner->fmt_in, fmt );
+
+    static const struct decoder_owner_callbacks dec_cbs =
+    {
+        .video = {
+            .get_device = DecoderGetDevice,
+            .buffer_new = DecoderNewBuffer,
+            .queue = DecoderQueue,
+        },
+    };
+    dec->cbs = &dec_cbs;
+
+    dec->p_module = module_need_var( dec, "video decoder", "codec" );
+    if( dec->p_module == NULL )
+    {
+        msg_Err( out->obj, "no suitable decoder module for fourcc `%4.4s'",
+                 (const char *)&fmt->i_codec );
+        es_format_Clean( &owner->fmt_in );
+        decoder_Destroy( dec );
+        return VLC_EGENERIC;
+    }
+
+    out->dec = owner;
+    return VLC_SUCCESS;
+}
+
+static void DecoderDelete( struct thumbnail_out *out )
+{
+    if( out->dec == NULL )
+        return;
+
+    /* The module may still reference fmt_in until unloaded */
+    decoder_Clean( &out->dec->dec );
+    es_format_Clean( &out->dec->fmt_in );
+    vlc_object_delete( &out->dec->dec );
+    out->dec = NULL;
+}
+
+static void OutDecodeBlock( struct thumbnail_out *out, block_t *block )
+{
+    if( out->dec == NULL )
+    {
+        const es_format_t *fmt = out->packetizer != NULL ?
+                                 &out->packetizer->fmt_out : &out->video->fmt;
+
+        if( out->failed || DecoderNew( out, fmt ) != VLC_SUCCESS )
+        {
+            out->failed = true;
+            if( block != NULL )
+                block_Release( block );
+            return;
+        }
+    }
+
+    decoder_t *dec = &out->dec->dec;
+    if( dec->pf_decode( dec, block ) == VLCDEC_ECRITICAL )
+    {
+        DecoderDelete( out );
+        out->failed = true;
+    }
+}
+
+/* Decodes a block of the selected ES, or drains it if block is NULL */
+static void OutDecode( struct thumbnail_out *out, block_t *block )
+{
+    if( out->packetizer == NULL )
+    {
+        if( block != NULL || out->dec != NULL )
+            OutDecodeBlock( out, block );
+        return;
+    }
+
+    block_t *packets;
+    while( ( packets = out->packetizer->pf_packetize( out->packetizer,
+                                            block != NULL ? &block : NULL ) ) )
+    {
+        while( packets != NULL )
+        {
+            block_t *next = packets->p_next;
+
+            packets->p_next = NULL;
+            if( out->pic == NULL )
+                OutDecodeBlock( out, packets );
+            else
+                block_Release( packets );
+            packets = next;
+        }
+    }
+
+    if( block == NULL && out->dec != NULL )
+        OutDecodeBlock( out, NULL );
+}
+
+static void OutFlush( struct thumbnail_out *out )
+{
+    if( out->packetizer != NULL && out->packetizer->pf_flush != NULL )
+        out->packetizer->pf_flush( out->packetizer );
+    if( out->dec != NULL && out->dec->dec.pf_flush != NULL )
+        out->dec->dec.pf_flush( &out->dec->dec );
+}
+
+static void OutUnselect( struct thumbnail_out *out )
+{
+    DecoderDelete( out );
+    if( out->packetizer != NULL )
+    {
+        demux_PacketizerDestroy( out->packetizer );
+        out->packetizer = NULL;
+    }
+    out->video = NULL;
+    out->failed = false;
+}
+
+static int OutSelect( struct thumbnail_out *out, es_out_id_t *es )
+{
+    if( !es->fmt.b_packetized )
+    {
+        es_format_t fmt;
+
+        if( es_format_Copy( &fmt, &es->fmt ) != VLC_SUCCESS )
+            return VLC_ENOMEM;
+        out->packetizer = demux_PacketizerNew( out->obj, &fmt, "thumbnail" );
+        if( out->packetizer == NULL )
+            return VLC_EGENERIC;
+    }
+    out->video = es;
+    return VLC_SUCCESS;
+}
+
+static es_out_id_t *OutAdd( es_out_t *out_, input_source_t *in,
+                            const es_format_t *fmt )
+{
+    struct thumbnail_out *out = container_of( out_, struct thumbnail_out, out );
+    VLC_UNUSED(in);
+
+    es_out_id_t *es = malloc( sizeof( *es ) );
+    if( unlikely(es == NULL) )
+        return NULL;
+
+    if( es_format_Copy( &es->fmt, fmt ) != VLC_SUCCESS )
+    {
+        free( es );
+        return NULL;
+    }
+
+    if( out->video == NULL && fmt->i_cat == VIDEO_ES )
+        OutSelect( out, es );
+    return es;
+}
+
+static int OutSend( es_out_t *out_, es_out_id_t *es, block_t *block )
+{
+    struct thumbnail_out *out = container_of( out_, struct thumbnail_out, out );
+
+    if( es != out->video || out->pic != NULL )
+        block_Release( block );
+    else
+        OutDecode( out, block );
+    return VLC_SUCCESS;
+}
+
+static void OutDel( es_out_t *out_, es_out_id_t *es )
+{
+    struct thumbnail_out *out = container_of( out_, struct thumbnail_out, out );
+
+    /* A later video ES, if any, will be picked instead */
+    if( es == out->video )
+        OutUnselect( out );
+    es_format_Clean( &es->fmt );
+    free( es );
+}
+
+static int OutControl( es_out_t *out_, input_source_t *in, int query,
+                       va_list args )
+{
+    struct thumbnail_out *out = container_of( out_, struct thumbnail_out, out );
+    VLC_UNUSED(in);
+
+    switch( query )
+    {
+        case ES_OUT_SET_ES:
+        case ES_OUT_UNSET_ES:
+        case ES_OUT_RESTART_ES:
+        case ES_OUT_SET_ES_DEFAULT:
+        case ES_OUT_SET_ES_STATE:
+        case ES_OUT_SET_ES_CAT_POLICY:
+        case ES_OUT_SET_ES_FMT:
+        case ES_OUT_SET_GROUP:
+        case ES_OUT_SET_PCR:
+        case ES_OUT_SET_GROUP_PCR:
+        case ES_OUT_RESET_PCR:
+        case ES_OUT_SET_NEXT_DISPLAY_TIME:
+        case ES_OUT_SET_GROUP_META:
+        case ES_OUT_SET_GROUP_EPG:
+        case ES_OUT_SET_GROUP_EPG_EVENT:
+        case ES_OUT_SET_EPG_TIME:
+        case ES_OUT_DEL_GROUP:
+        case ES_OUT_SET_META:
+        case ES_OUT_SET_ES_SCRAMBLED_STATE:
+            return VLC_SUCCESS;
+
+        case ES_OUT_GET_ES_STATE:
+        {
+            es_out_id_t *es = va_arg( args, es_out_id_t * );
+            *va_arg( args, bool * ) = es == out->video;
+            return VLC_SUCCESS;
+        }
+
+        case ES_OUT_GET_EMPTY:
+            *va_arg( args, bool * ) = true;
+            return VLC_SUCCESS;
+
+        default:
+            return VLC_EGENERIC;
+    }
+}
+
+static const struct es_out_callbacks thumbnail_out_cbs =
+{
+    .add = OutAdd,
+    .send = OutSend,
+    .del = OutDel,
+    .control = OutControl,
+};
+
+static demux_t *DemuxNew( vlc_object_t *obj, es_out_t *out, const char *url )
+{
+    stream_t *s = stream_AccessNew( obj, NULL, out, false, url );
+    if( s == NULL )
+        return NULL;
+
+    s = stream_FilterAutoNew( s );
+
+    if( ( s->ops != NULL && s->ops->stream.read == NULL
+       && s->ops->stream.block == NULL && s->ops->stream.readdir == NULL )
+     || ( s->ops == NULL && s->pf_read == NULL && s->pf_block == NULL
+       && s->pf_readdir == NULL ) )
+        return s; /* Combined access/demux */
+
+    demux_t *demux = demux_NewAdvanced( obj, NULL, "any", url, s, out, false );
+    if( demux == NULL )
+        vlc_stream_Delete( s );
+    return demux;
+}
+
+static void Seek( demux_t *demux, struct thumbnail_out *out,
+                  const struct vlc_preparser_seek_arg *arg )
+{
+    bool precise = arg->speed == VLC_PREPARSER_SEEK_PRECISE;
+    vlc_tick_t time = VLC_TICK_INVALID;
+    int ret;
+
+    switch( arg->type )
+    {
+        case VLC_PREPARSER_SEEK_NONE:
+            out->target = VLC_TICK_INVALID;
+            return;
+        case VLC_PREPARSER_SEEK_TIME:
+            time = __MAX( arg->time, 0 );
+            ret = demux_SetTime( demux, time, precise );
+            break;
+        case VLC_PREPARSER_SEEK_POS:
+        {
+            vlc_tick_t length;
+
+            if( vlc_demux_GetLength( demux, &length ) == VLC_SUCCESS
+             && length > 0 )
+                time = length * arg->pos;
+            ret = demux_SetPosition( demux, arg->pos, precise );
+            break;
+        }
+        default:
+            vlc_assert_unreachable();
+    }
+
+    if( ret == VLC_SUCCESS )
+        OutFlush( out );
+
+    /* Without a seek, the pictures are decoded up to the requested date */
+    if( time != VLC_TICK_INVALID && ( precise || ret != VLC_SUCCESS ) )
+        out->target = VLC_TICK_0 + time;
+    else
+        out->target = VLC_TICK_INVALID;
+}
+
+static int DecodeOne( demux_t *demux, struct thumbnail_out *out,
+                      vlc_tick_t deadline )
+{
+    while( out->pic == NULL )
+    {
+        if( vlc_killed() )
+            return -EINTR;
+        if( deadline != VLC_TICK_INVALID && vlc_tick_now() >= deadline )
+            return VLC_ETIMEOUT;
+
+        int ret = demux_Demux( demux );
+        if( ret != VLC_DEMUXER_SUCCESS )
+        {
+            /* Output what is left in the decoder */
+            if( ret == VLC_DEMUXER_EOF && out->video != NULL )
+                OutDecode( out, NULL );
+            break;
+        }
+    }
+
+    return out->pic != NULL ? VLC_SUCCESS : VLC_EGENERIC;
+}
+
+int vlc_thumbnail_Decode( vlc_object_t *parent, input_item_t *item,
+                          const struct vlc_preparser_seek_arg *args,
+                          size_t count, vlc_tick_t deadline,
+                          picture_t **pics )
+{
+    static const struct vlc_preparser_seek_arg first = {
+        .type = VLC_PREPARSER_SEEK_NONE,
+    };
+
+    if( args == NULL )
+    {
+        args = &first;
+        count = 1;
+    }
+
+    for( size_t i = 0; i < count; i++ )
+        pics[i] = NULL;
+
+    char *url = input_item_GetURI( item );
+    if( url == NULL )
+        return VLC_EGENERIC;
+
+    vlc_object_t *obj = vlc_object_create( parent, sizeof( *obj ) );
+    if( unlikely(obj == NULL) )
+    {
+        free( url );
+        return VLC_ENOMEM;
+    }
+    input_item_ApplyOptions( obj, item );
+
+    struct thumbnail_out out = {
+        .out = { .cbs = &thumbnail_out_cbs },
+        .obj = obj,
+        .target = VLC_TICK_INVALID,
+    };
+
+    int ret = VLC_ENOTSUP;
+    demux_t *demux = DemuxNew( obj, &out.out, url );
+    free( url );
+    if( demux == NULL )
+        goto end;
+
+    size_t done = 0;
+    for( size_t i = 0; i < count; i++ )
+    {
+        Seek( demux, &out, &args[i] );
+
+        ret = DecodeOne( demux, &out, deadline );
+        pics[i] = out.pic;
+        out.pic = NULL;
+        if( pics[i] != NULL )
+            done++;
+        else if( ret == VLC_ETIMEOUT || ret == -EINTR )
+            break;
+    }
+
+    if( done > 0 && ret != -EINTR )
+        ret = VLC_SUCCESS;
+
+    demux_Delete( demux );
+end:
+    if( out.video != NULL )
+        OutUnselect( &out );
+    vlc_object_delete( obj );
+    return ret;
+}
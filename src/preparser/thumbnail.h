@@ -0,0 +1,51 @@
+/*****************************************************************************
+ * thumbnail.h
+ *****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef _INPUT_THUMBNAIL_H
+#define _INPUT_THUMBNAIL_H 1
+
+#include <vlc_input_item.h>
+#include <vlc_preparser.h>
+
+/**
+ * This function decodes thumbnails of an item without an input thread.
+ *
+ * The demuxer is driven from the calling thread: for each seek argument, it
+ * is seeked to the nearest keyframe and exactly one picture is decoded,
+ * synchronously. Blocking reads can be aborted with the interrupt context of
+ * the calling thread.
+ *
+ * @param obj the parent object
+ * @param item the item to open
+ * @param args seek arguments, one per thumbnail, NULL to take the first
+ * picture
+ * @param count number of thumbnails to decode
+ * @param deadline date after which to give up, or VLC_TICK_INVALID
+ * @param pics array of count pictures, filled with the thumbnails or NULL
+ * @return VLC_SUCCESS if at least one thumbnail was decoded, VLC_ENOTSUP if
+ * the item can't be demuxed outside of an input thread, VLC_ETIMEOUT, -EINTR,
+ * or an error otherwise
+ */
+int vlc_thumbnail_Decode( vlc_object_t *obj, input_item_t *item,
+                          const struct vlc_preparser_seek_arg *args,
+                          size_t count, vlc_tick_t deadline,
+                          picture_t **pics );
+
+#endif
@@ -23,6 +23,7 @@
 #ifndef LIBVLC_VOUT_STATISTIC_H
 # define LIBVLC_VOUT_STATISTIC_H
 # include <stdatomic.h>
+# include <vlc_input_item.h>
 
 /* NOTE: Both statistics are atomic on their own, so one might be older than
  * the other one. Currently, only one of them is updated at a time, so this
@@ -31,6 +32,9 @@ typedef struct {
     atomic_uint displayed;
     atomic_uint lost;
     atomic_uint late;
+    /* Lateness of the late and dropped pictures */
+    atomic_uint lateness[VLC_INPUT_METRICS_BUCKETS];
+    _Atomic vlc_tick_t lateness_sum;
 } vout_statistic_t;
 
 static inline void vout_statistic_Init(vout_statistic_t *stat)
@@ -38,6 +42,9 @@ static inline void vout_statistic_Init(vout_statistic_t *stat)
     atomic_init(&stat->displayed, 0);
     atomic_init(&stat->lost, 0);
     atomic_init(&stat->late, 0);
+    for (unsigned i = 0; i < VLC_INPUT_METRICS_BUCKETS; i++)
+        atomic_init(&stat->lateness[i], 0);
+    atomic_init(&stat->lateness_sum, 0);
 }
 
 static inline void vout_statistic_Clean(vout_statistic_t *stat)
@@ -56,6 +63,17 @@ static inline void vout_statistic_GetReset(vout_statistic_t *stat,
     *late = atomic_exchange_explicit(&stat->late, 0, memory_order_relaxed);
 }
 
+static inline void vout_statistic_GetResetLateness(vout_statistic_t *stat,
+                                                   unsigned *lateness,
+                                                   vlc_tick_t *sum)
+{
+    for (unsigned i = 0; i < VLC_INPUT_METRICS_BUCKETS; i++)
+        lateness[i] = atomic_exchange_explicit(&stat->lateness[i], 0,
+                                               memory_order_relaxed);
+    *sum = atomic_exchange_explicit(&stat->lateness_sum, 0,
+                                    memory_order_relaxed);
+}
+
 static inline void vout_statistic_AddDisplayed(vout_statistic_t *stat,
                                                int displayed)
 {
@@ -73,4 +91,13 @@ static inline void vout_statistic_AddLate(vout_statistic_t *stat, int late)
     atomic_fetch_add_explicit(&stat->late, late, memory_order_relaxed);
 }
 
+static inline void vout_statistic_AddLateness(vout_statistic_t *stat,
+                                              vlc_tick_t late)
+{
+    atomic_fetch_add_explicit(&stat->lateness[vlc_input_metrics_Bucket(late)],
+                              1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&stat->lateness_sum, late,
+                              memory_order_relaxed);
+}
+
 #endif
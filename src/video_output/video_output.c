@@ -51,6 +51,7 @@
 #include <vlc_plugin.h>
 #include <vlc_codec.h>
 #include <vlc_tracer.h>
+#include <vlc_executor.h>
 #include <vlc_atomic.h>
 
 #include <libvlc.h>
@@ -169,6 +170,17 @@ typedef struct vout_thread_sys_t
         vout_chrono_t render;         /**< picture render time estimator */
     } chrono;
 
+    /* Static filtering of the next picture, while the current one waits for
+     * its display date */
+    struct {
+        vlc_executor_t      *executor;
+        struct vlc_runnable runnable;
+        bool                running;
+        picture_t           *next; // filtered, ready to become the current one
+        picture_t           *decoded; // source of next, not displayed yet
+        picture_t           *held; // decoded, needs the filters to be changed
+    } prerender;
+
     unsigned frame_next_count;
 
     vlc_atomic_rc_t rc;
@@ -181,8 +193,9 @@ typedef struct vout_thread_sys_t
 
 
 /* Amount of pictures in the private pool:
- * 3 for interactive+static filters, 1 for SPU blending, 1 for currently displayed */
-#define FILTER_POOL_SIZE  (3+1+1)
+ * 3 for interactive+static filters, 1 for SPU blending, 1 for currently displayed,
+ * 1 for the next picture filtered ahead */
+#define FILTER_POOL_SIZE  (3+1+1+1)
 
 /* Maximum delay between 2 displayed pictures.
  * XXX it is needed for now but should be removed in the long term.
@@ -278,6 +291,14 @@ void vout_GetResetStatistic(vout_thread_t *vout, unsigned *restrict displayed,
     vout_statistic_GetReset( &sys->statistic, displayed, lost, late );
 }
 
+void vout_GetResetLateness(vout_thread_t *vout, unsigned *lateness,
+                           vlc_tick_t *sum)
+{
+    vout_thread_sys_t *sys = VOUT_THREAD_TO_SYS(vout);
+    assert(!sys->dummy);
+    vout_statistic_GetResetLateness(&sys->statistic, lateness, sum);
+}
+
 bool vout_IsEmpty(vout_thread_t *vout)
 {
     vout_thread_sys_t *sys = VOUT_THREAD_TO_SYS(vout);
@@ -766,6 +787,18 @@ static picture_t *VoutVideoFilterStaticNewPicture(filter_t *filter)
 
 static void FilterFlush(vout_thread_sys_t *sys, bool is_locked)
 {
+    assert(!sys->prerender.running);
+    if (sys->prerender.next)
+    {
+        picture_Release( sys->prerender.next );
+        sys->prerender.next = NULL;
+    }
+    if (sys->prerender.decoded)
+    {
+        picture_Release( sys->prerender.decoded );
+        sys->prerender.decoded = NULL;
+    }
+
     if (sys->displayed.current)
     {
         picture_Release( sys->displayed.current );
@@ -978,10 +1011,13 @@ static bool IsPictureLateToStaticFilter(vout_thread_sys_t *vout,
     return IsPictureLateToProcess(vout, &static_es->video, time_until_display, prepare_decoded_duration);
 }
 
-/* */
+/* When ahead is set, the picture is prepared by the prerender worker while
+ * the vout thread waits for the display date of the current picture, so the
+ * filters are not changed, and the decoded picture is kept aside until it
+ * becomes the displayed one. */
 VLC_USED
 static picture_t *PreparePicture(vout_thread_sys_t *vout, bool reuse_decoded,
-                                 bool frame_by_frame)
+                                 bool frame_by_frame, bool ahead)
 {
     vout_thread_sys_t *sys = vout;
     bool is_late_dropped = sys->is_late_dropped && !frame_by_frame;
@@ -998,7 +1034,12 @@ static picture_t *PreparePicture(vout_thread_sys_t *vout, bool reuse_decoded,
             if (decoded == NULL)
                 break;
         } else {
-            decoded = picture_fifo_Pop(sys->decoder_fifo);
+            /* Picture left over by the prerender worker, if any */
+            decoded = sys->prerender.held;
+            if (decoded != NULL)
+                sys->prerender.held = NULL;
+            else
+                decoded = picture_fifo_Pop(sys->decoder_fifo);
             if (decoded == NULL)
                 break;
 
@@ -1030,6 +1071,8 @@ static picture_t *PreparePicture(vout_thread_sys_t *vout, bool reuse_decoded,
                 {
                     picture_Release(decoded);
                     vout_statistic_AddLost(&sys->statistic, 1);
+                    vout_statistic_AddLateness(&sys->statistic,
+                                               system_now - system_pts);
 
                     /* A picture dropped means discontinuity for the
                      * filters and we need to notify eg. deinterlacer. */
@@ -1040,6 +1083,14 @@ static picture_t *PreparePicture(vout_thread_sys_t *vout, bool reuse_decoded,
 
             if (!VideoFormatIsCropArEqual(&decoded->format, &sys->filter.src_fmt))
             {
+                if (ahead)
+                {
+                    /* Changing the filters releases the current picture,
+                     * leave it to the vout thread. */
+                    sys->prerender.held = decoded;
+                    break;
+                }
+
                 // we received an aspect ratio change
                 // Update the filters with the filter source format with the new aspect ratio
                 video_format_Clean(&sys->filter.src_fmt);
@@ -1055,16 +1106,35 @@ static picture_t *PreparePicture(vout_thread_sys_t *vout, bool reuse_decoded,
 
         reuse_decoded = false;
 
-        if (sys->displayed.decoded)
-            picture_Release(sys->displayed.decoded);
+        if (ahead)
+        {
+            if (sys->prerender.decoded)
+                picture_Release(sys->prerender.decoded);
+            sys->prerender.decoded = picture_Hold(decoded);
+        }
+        else
+        {
+            if (sys->displayed.decoded)
+                picture_Release(sys->displayed.decoded);
 
-        sys->displayed.decoded       = picture_Hold(decoded);
-        sys->displayed.timestamp     = decoded->date;
-        sys->displayed.is_interlaced = !decoded->b_progressive;
+            sys->displayed.decoded       = picture_Hold(decoded);
+            sys->displayed.timestamp     = decoded->date;
+            sys->displayed.is_interlaced = !decoded->b_progressive;
+        }
 
+        const vlc_tick_t start = vlc_tick_now();
         vout_chrono_Start(&sys->chrono.static_filter);
-        picture = filter_chain_VideoFilter(sys->filter.chain_static, sys->displayed.decoded);
+        picture = filter_chain_VideoFilter(sys->filter.chain_static, decoded);
         vout_chrono_Stop(&sys->chrono.static_filter);
+
+        struct vlc_tracer *tracer = GetTracer(vout);
+        if (tracer != NULL)
+            vlc_tracer_Trace(tracer, VLC_TRACE("type", "RENDER"),
+                             VLC_TRACE("id", sys->str_id),
+                             VLC_TRACE_TICK_NS("static_filter",
+                                               vlc_tick_now() - start),
+                             VLC_TRACE("ahead", (int64_t)ahead),
+                             VLC_TRACE_END);
     }
 
     vlc_mutex_unlock(&sys->filter.lock);
@@ -1072,6 +1142,103 @@ static picture_t *PreparePicture(vout_thread_sys_t *vout, bool reuse_decoded,
     return picture;
 }
 
+static void PrerenderRun(void *data)
+{
+    vout_thread_sys_t *sys = data;
+
+    assert(sys->prerender.next == NULL);
+    sys->prerender.next = PreparePicture(sys, false, false, true);
+}
+
+static void PrerenderStart(vout_thread_sys_t *sys)
+{
+    assert(!sys->prerender.running);
+
+    /* Hardware filters may share the device context of the display, keep
+     * them on the vout thread. */
+    if (sys->prerender.executor == NULL || sys->filter.src_vctx != NULL
+     || sys->prerender.next != NULL || sys->prerender.held != NULL
+     || sys->pause.is_on || sys->frame_next_count > 0)
+        return;
+
+    sys->prerender.running = true;
+    vlc_executor_Submit(sys->prerender.executor, &sys->prerender.runnable);
+}
+
+static void PrerenderWait(vout_thread_sys_t *sys)
+{
+    if (!sys->prerender.running)
+        return;
+
+    vlc_executor_WaitIdle(sys->prerender.executor);
+    sys->prerender.running = false;
+}
+
+/* The decoded picture filtered ahead becomes the displayed one */
+static void PrerenderCommit(vout_thread_sys_t *sys)
+{
+    picture_t *decoded = sys->prerender.decoded;
+    if (decoded == NULL)
+        return;
+
+    sys->prerender.decoded = NULL;
+    if (sys->displayed.decoded)
+        picture_Release(sys->displayed.decoded);
+
+    sys->displayed.decoded       = decoded;
+    sys->displayed.timestamp     = decoded->date;
+    sys->displayed.is_interlaced = !decoded->b_progressive;
+}
+
+static picture_t *GetNextPicture(vout_thread_sys_t *sys, bool reuse_decoded,
+                                 bool frame_by_frame)
+{
+    picture_t *next = sys->prerender.next;
+    if (next == NULL)
+    {
+        /* The static filters may have kept the picture filtered ahead */
+        PrerenderCommit(sys);
+        return PreparePicture(sys, reuse_decoded, frame_by_frame, false);
+    }
+
+    sys->prerender.next = NULL;
+
+    /* The picture was checked against its display date when it was filtered,
+     * check again now that the time has passed. */
+    if (sys->is_late_dropped && !frame_by_frame && !next->b_force)
+    {
+        const vlc_tick_t system_now = vlc_tick_now();
+        vlc_clock_Lock(sys->clock);
+        const vlc_tick_t system_pts =
+            vlc_clock_ConvertToSystem(sys->clock, system_now, next->date,
+                                      sys->rate, NULL);
+        vlc_clock_Unlock(sys->clock);
+
+        if (IsPictureLateToProcess(sys, &next->format,
+                                   system_pts - system_now,
+                                   GetRenderDelay(sys)))
+        {
+            picture_Release(next);
+            if (sys->prerender.decoded)
+            {
+                picture_Release(sys->prerender.decoded);
+                sys->prerender.decoded = NULL;
+            }
+            vout_statistic_AddLost(&sys->statistic, 1);
+            vout_statistic_AddLateness(&sys->statistic,
+                                       system_now - system_pts);
+
+            /* A picture dropped means discontinuity for the filters */
+            vlc_mutex_lock(&sys->filter.lock);
+            filter_chain_VideoFlush(sys->filter.chain_static);
+            vlc_mutex_unlock(&sys->filter.lock);
+            return PreparePicture(sys, false, frame_by_frame, false);
+        }
+    }
+    PrerenderCommit(sys);
+    return next;
+}
+
 static vlc_decoder_device * VoutHoldDecoderDevice(vlc_object_t *o, void *opaque)
 {
     VLC_UNUSED(o);
@@ -1263,6 +1430,10 @@ static int PrerenderPicture(vout_thread_sys_t *sys, picture_t *filtered,
                                           do_snapshot, spu_in_full_window, video_place);
         if (subpic) {
             picture_t *blent = picture_pool_Get(sys->private_pool);
+            if (blent == NULL)
+                /* The display may still hold the previous ones, as when
+                 * handing them out to the application */
+                blent = picture_NewFromFormat(&filtered->format);
             if (blent) {
                 video_format_CopyCropAr(&blent->format, &filtered->format);
                 picture_Copy(blent, filtered);
@@ -1334,6 +1505,7 @@ static int RenderPicture(vout_thread_sys_t *sys, bool render_now)
     vout_display_t *vd = sys->display;
 
     vout_chrono_Start(&sys->chrono.render);
+    const vlc_tick_t render_start = vlc_tick_now();
 
     picture_t *filtered = FilterPictureInteractive(sys);
     if (!filtered)
@@ -1344,6 +1516,7 @@ static int RenderPicture(vout_thread_sys_t *sys, bool render_now)
     vlc_clock_Unlock(sys->clock);
     vlc_queuedmutex_lock(&sys->display_lock);
 
+    const vlc_tick_t prerender_start = vlc_tick_now();
     picture_t *todisplay;
     vlc_render_subpicture *subpic;
     int ret = PrerenderPicture(sys, filtered, &todisplay, &subpic);
@@ -1352,6 +1525,7 @@ static int RenderPicture(vout_thread_sys_t *sys, bool render_now)
         vlc_queuedmutex_unlock(&sys->display_lock);
         return ret;
     }
+    const vlc_tick_t prepare_start = vlc_tick_now();
 
     vlc_tick_t system_now = vlc_tick_now();
     const vlc_tick_t pts = todisplay->date;
@@ -1377,6 +1551,21 @@ static int RenderPicture(vout_thread_sys_t *sys, bool render_now)
 
     struct vlc_tracer *tracer = GetTracer(sys);
     system_now = vlc_tick_now();
+    if (tracer != NULL)
+        vlc_tracer_TraceWithTs(tracer, system_now,
+                               VLC_TRACE("type", "RENDER"),
+                               VLC_TRACE("id", sys->str_id),
+                               VLC_TRACE_TICK_NS("interactive_filter",
+                                                 prerender_start - render_start),
+                               VLC_TRACE_TICK_NS("prerender",
+                                                 prepare_start - prerender_start),
+                               VLC_TRACE_TICK_NS("prepare",
+                                                 system_now - prepare_start),
+                               VLC_TRACE_END);
+
+    /* Filter the next picture while this one waits for its date */
+    if (!render_now)
+        PrerenderStart(sys);
     if (!render_now)
     {
         const vlc_tick_t late = system_now - system_pts;
@@ -1386,6 +1575,7 @@ static int RenderPicture(vout_thread_sys_t *sys, bool render_now)
                 vlc_tracer_TraceEvent(tracer, "RENDER", sys->str_id, "late");
             msg_Dbg(vd, "picture displayed late (missing %"PRId64" ms)", MS_FROM_VLC_TICK(late));
             vout_statistic_AddLate(&sys->statistic, 1);
+            vout_statistic_AddLateness(&sys->statistic, late);
 
             /* vd->prepare took too much time. Tell the clock that the pts was
              * rendered late. */
@@ -1454,6 +1644,8 @@ static int RenderPicture(vout_thread_sys_t *sys, bool render_now)
 
     vout_statistic_AddDisplayed(&sys->statistic, 1);
 
+    PrerenderWait(sys);
+
     if (tracer != NULL && system_pts != VLC_TICK_MAX)
         vlc_tracer_TraceWithTs(tracer, system_pts,
                                VLC_TRACE("type", "RENDER"),
@@ -1480,7 +1672,7 @@ static int DisplayNextFrame(vout_thread_sys_t *sys)
 {
     UpdateDeinterlaceFilter(sys);
 
-    picture_t *next = PreparePicture(sys, !sys->displayed.current, true);
+    picture_t *next = GetNextPicture(sys, !sys->displayed.current, true);
 
     if (next)
     {
@@ -1508,7 +1700,7 @@ static bool UpdateCurrentPicture(vout_thread_sys_t *sys)
 
     if (sys->displayed.current == NULL)
     {
-        sys->displayed.current = PreparePicture(sys, true, false);
+        sys->displayed.current = GetNextPicture(sys, true, false);
         return sys->displayed.current != NULL;
     }
 
@@ -1521,7 +1713,9 @@ static bool UpdateCurrentPicture(vout_thread_sys_t *sys)
      * when the clock is configured. */
     if (sys->first_picture)
     {
-        bool has_next_pic = !picture_fifo_IsEmpty(sys->decoder_fifo);
+        bool has_next_pic = sys->prerender.next != NULL ||
+                            sys->prerender.held != NULL ||
+                            !picture_fifo_IsEmpty(sys->decoder_fifo);
         if (!has_next_pic)
             return false;
 
@@ -1542,7 +1736,7 @@ static bool UpdateCurrentPicture(vout_thread_sys_t *sys)
         return true;
 
     // the current frame will be late, look for the next not late one
-    picture_t *next = PreparePicture(sys, false, false);
+    picture_t *next = GetNextPicture(sys, false, false);
     if (next == NULL)
         return false;
     /* We might have reset the current picture when preparing the next one,
@@ -1655,6 +1849,15 @@ static void vout_FlushUnlocked(vout_thread_sys_t *vout, bool below,
         }
     }
 
+    picture_t *held = sys->prerender.held;
+    if (held != NULL &&
+        ((date == VLC_TICK_INVALID) ||
+         ( below && held->date <= date) ||
+         (!below && held->date >= date))) {
+        picture_Release(held);
+        sys->prerender.held = NULL;
+    }
+
     picture_fifo_Flush(sys->decoder_fifo, date, below);
 
     vlc_queuedmutex_lock(&sys->display_lock);
@@ -1835,6 +2038,16 @@ static int vout_Start(vout_thread_sys_t *vout, vlc_video_context *vctx, const vo
     sys->displayed.timestamp     = VLC_TICK_INVALID;
     sys->displayed.is_interlaced = false;
 
+    sys->prerender.runnable.run      = PrerenderRun;
+    sys->prerender.runnable.userdata = vout;
+    sys->prerender.running = false;
+    sys->prerender.next    = NULL;
+    sys->prerender.decoded = NULL;
+    sys->prerender.held    = NULL;
+    sys->prerender.executor = vlc_executor_New(1);
+    if (sys->prerender.executor == NULL)
+        msg_Warn(&vout->obj, "cannot filter pictures ahead of their date");
+
     sys->pause.is_on = false;
     sys->pause.date  = VLC_TICK_INVALID;
 
@@ -1934,6 +2147,15 @@ static void vout_ReleaseDisplay(vout_thread_sys_t *vout)
         sys->private_pool = NULL;
     }
 
+    assert(!sys->prerender.running);
+    assert(sys->prerender.next == NULL && sys->prerender.decoded == NULL);
+    assert(sys->prerender.held == NULL);
+    if (sys->prerender.executor != NULL)
+    {
+        vlc_executor_Delete(sys->prerender.executor);
+        sys->prerender.executor = NULL;
+    }
+
     vlc_queuedmutex_lock(&sys->display_lock);
     vout_CloseWrapper(&vout->obj, sys->display);
     sys->display = NULL;
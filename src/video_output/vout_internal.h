@@ -219,6 +219,14 @@ void vout_ChangeSpuDelay( vout_thread_t *, size_t channel_id, vlc_tick_t delay )
 void vout_GetResetStatistic( vout_thread_t *p_vout, unsigned *pi_displayed,
                              unsigned *pi_lost, unsigned *pi_late );
 
+/**
+ * This function will return and reset the lateness distribution of the
+ * late and dropped pictures, in VLC_INPUT_METRICS_BUCKETS buckets, and the
+ * sum of their lateness.
+ */
+void vout_GetResetLateness( vout_thread_t *p_vout, unsigned *lateness,
+                            vlc_tick_t *sum );
+
 /**
  * This function will force to display the next picture while paused
  */
@@ -631,6 +631,74 @@ static void test_media_player_programs(const char** argv, int argc)
     libvlc_release (vlc);
 }
 
+static void check_histogram(const libvlc_media_metrics_histogram_t *h)
+{
+    uint64_t count = 0;
+
+    for (unsigned i = 0; i < LIBVLC_MEDIA_METRICS_BUCKETS; i++)
+        count += h->i_buckets[i];
+    assert (count == h->i_count);
+    assert (h->i_sum_us >= 0);
+    if (h->i_count == 0)
+        assert (h->i_sum_us == 0);
+}
+
+static void test_media_player_metrics(const char** argv, int argc)
+{
+    const char *file = "mock://video_track_count=1;audio_track_count=1;"
+                       "length=100000000";
+
+    test_log ("Testing the playback metrics of %s\n", file);
+
+    libvlc_instance_t *vlc = libvlc_new (argc, argv);
+    assert (vlc != NULL);
+
+    libvlc_media_t *md = libvlc_media_new_location (file);
+    assert (md != NULL);
+
+    libvlc_media_metrics_t metrics;
+    assert (!libvlc_media_get_metrics (md, &metrics));
+
+    libvlc_media_player_t *mp = libvlc_media_player_new_from_media (vlc, md);
+    assert (mp != NULL);
+
+    play_and_wait(mp);
+
+    /* The metrics are updated by the decoder threads, wait for them */
+    bool decoded;
+    do
+    {
+        assert (libvlc_media_get_metrics (md, &metrics));
+        assert (metrics.i_track_count <= LIBVLC_MEDIA_METRICS_MAX_TRACKS);
+
+        decoded = metrics.i_track_count == 2;
+        for (unsigned i = 0; i < metrics.i_track_count; i++)
+            if (metrics.tracks[i].decode_time.i_count == 0)
+                decoded = false;
+        if (!decoded)
+            vlc_tick_sleep (VLC_TICK_FROM_MS(10));
+    } while (!decoded);
+
+    /* Once the player is gone, no thread updates the metrics anymore, and
+     * those of the last playback are kept */
+    libvlc_media_player_stop_async (mp);
+    libvlc_media_player_release (mp);
+
+    assert (libvlc_media_get_metrics (md, &metrics));
+    assert (metrics.i_track_count == 2);
+    for (unsigned i = 0; i < metrics.i_track_count; i++)
+    {
+        assert (metrics.tracks[i].decode_time.i_count > 0);
+        assert (metrics.tracks[i].i_queue_blocks == 0);
+        check_histogram (&metrics.tracks[i].decode_time);
+    }
+    check_histogram (&metrics.demux_stalls);
+    check_histogram (&metrics.lateness);
+
+    libvlc_media_release (md);
+    libvlc_release (vlc);
+}
+
 /* Regression test when having multiple libvlc instances */
 static void test_media_player_multiple_instance(const char** argv, int argc)
 {
@@ -668,6 +736,7 @@ int main (void)
     test_media_player_pause_stop (test_defaults_args, test_defaults_nargs);
     test_media_player_tracks (test_defaults_args, test_defaults_nargs);
     test_media_player_programs (test_defaults_args, test_defaults_nargs);
+    test_media_player_metrics (test_defaults_args, test_defaults_nargs);
     test_media_player_multiple_instance (test_defaults_args, test_defaults_nargs);
 
     return 0;
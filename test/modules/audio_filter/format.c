@@ -0,0 +1,315 @@
+/*****************************************************************************
+ * format.c: audio sample conversion and volume test and benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <vlc_common.h>
+
+#include <vlc_aout.h>
+#include <vlc_aout_volume.h>
+#include <vlc_block.h>
+#include <vlc_cpu.h>
+#include <vlc_filter.h>
+#include <vlc_modules.h>
+
+#include "../../libvlc/test.h"
+#include "../lib/libvlc_internal.h"
+
+#include "../modules/audio_filter/converter/format_kernels.h"
+#include "../modules/audio_mixer/float_kernels.h"
+
+/* 10 seconds of 7.1 at 96 kHz */
+#define RATE     96000
+#define CHANNELS 8
+#define FRAMES   1024
+#define BLOCKS   (10 * RATE / FRAMES)
+#define GAIN     .5f
+
+/* The kernels of each instruction set, as selected by the modules */
+struct kernels
+{
+    const char *name;
+    void (*s16_fl32)(float *, const int16_t *, size_t);
+    void (*fl32_s16)(int16_t *, const float *, size_t);
+    void (*s32_fl32)(float *, const int32_t *, size_t);
+    void (*fl32_s32)(int32_t *, const float *, size_t);
+    void (*amplify_fl32)(float *, size_t, float);
+    void (*amplify_fl64)(double *, size_t, double);
+};
+
+static const struct kernels c_kernels = {
+    "C", S16toFl32_C_kernel, Fl32toS16_C_kernel, S32toFl32_C_kernel,
+    Fl32toS32_C_kernel, AmplifyFL32, AmplifyFL64,
+};
+
+/* Not a multiple of any vector size, so that the tails are checked too */
+static const size_t sizes[] = { 0, 1, 3, 7, 8, 9, 15, 16, 17, 31, 33, 64,
+                                FRAMES * CHANNELS + 13 };
+#define MAX_SAMPLES (FRAMES * CHANNELS + 13)
+
+static uint32_t Random(uint32_t *seed)
+{
+    *seed = *seed * 1664525 + 1013904223;
+    return *seed;
+}
+
+/* Full scale integers, including the extreme values */
+static void FillInts(void *buf, size_t size, size_t count)
+{
+    uint32_t seed = count;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t v = Random(&seed);
+        if (i % 11 == 0)
+            v = (i & 1) ? 0x7FFFFFFF : 0x80000000;
+        if (size == 2)
+            ((int16_t *)buf)[i] = v >> 16;
+        else
+            ((int32_t *)buf)[i] = v;
+    }
+}
+
+/* Floats up to twice the full scale, to check the clipping, including
+ * values halfway between two 16-bits steps, to check the rounding */
+static void FillFloats(float *buf, size_t count)
+{
+    uint32_t seed = count;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        int32_t v = Random(&seed);
+        if (i % 7 == 0)
+            buf[i] = ((v >> 16) + .5f) / 32768.f;
+        else
+            buf[i] = v / 1073741824.f;
+    }
+}
+
+/* Runs the conversions in place, as the converter does */
+static void CheckKernels(const struct kernels *k)
+{
+    static union {
+        float f[MAX_SAMPLES];
+        double d[MAX_SAMPLES];
+        int16_t s16[MAX_SAMPLES];
+        int32_t s32[MAX_SAMPLES];
+    } ref, out;
+
+    printf("checking %s kernels\n", k->name);
+
+    for (size_t i = 0; i < ARRAY_SIZE(sizes); i++)
+    {
+        size_t count = sizes[i];
+
+        FillInts(ref.s16, 2, count);
+        memcpy(out.s16, ref.s16, count * 2);
+        c_kernels.s16_fl32(ref.f, ref.s16, count);
+        k->s16_fl32(out.f, out.s16, count);
+        assert(memcmp(ref.f, out.f, count * sizeof (float)) == 0);
+
+        FillFloats(ref.f, count);
+        memcpy(out.f, ref.f, count * sizeof (float));
+        c_kernels.fl32_s16(ref.s16, ref.f, count);
+        k->fl32_s16(out.s16, out.f, count);
+        assert(memcmp(ref.s16, out.s16, count * 2) == 0);
+
+        FillInts(ref.s32, 4, count);
+        memcpy(out.s32, ref.s32, count * 4);
+        c_kernels.s32_fl32(ref.f, ref.s32, count);
+        k->s32_fl32(out.f, out.s32, count);
+        assert(memcmp(ref.f, out.f, count * sizeof (float)) == 0);
+
+        /* The C kernel rounds halfway values away from zero */
+        FillFloats(ref.f, count);
+        memcpy(out.f, ref.f, count * sizeof (float));
+        c_kernels.fl32_s32(ref.s32, ref.f, count);
+        k->fl32_s32(out.s32, out.f, count);
+        for (size_t j = 0; j < count; j++)
+            assert(llabs((long long)ref.s32[j] - out.s32[j]) <= 1);
+
+        FillFloats(ref.f, count);
+        memcpy(out.f, ref.f, count * sizeof (float));
+        c_kernels.amplify_fl32(ref.f, count, GAIN);
+        k->amplify_fl32(out.f, count, GAIN);
+        assert(memcmp(ref.f, out.f, count * sizeof (float)) == 0);
+
+        for (size_t j = 0; j < count; j++)
+            ref.d[j] = out.d[j] = (int32_t)(j * 2654435761u) / 2147483648.;
+        c_kernels.amplify_fl64(ref.d, count, GAIN);
+        k->amplify_fl64(out.d, count, GAIN);
+        assert(memcmp(ref.d, out.d, count * sizeof (double)) == 0);
+    }
+}
+
+static filter_t *CreateConverter(vlc_object_t *parent,
+                                 vlc_fourcc_t src, vlc_fourcc_t dst)
+{
+    filter_t *filter = vlc_object_create(parent, sizeof (*filter));
+    assert(filter != NULL);
+
+    es_format_Init(&filter->fmt_in, AUDIO_ES, src);
+    filter->fmt_in.audio.i_format = src;
+    filter->fmt_in.audio.i_rate = RATE;
+    filter->fmt_in.audio.i_physical_channels = AOUT_CHANS_7_1;
+    filter->fmt_in.audio.channel_type = AUDIO_CHANNEL_TYPE_BITMAP;
+    aout_FormatPrepare(&filter->fmt_in.audio);
+
+    es_format_Copy(&filter->fmt_out, &filter->fmt_in);
+    filter->fmt_out.i_codec = filter->fmt_out.audio.i_format = dst;
+    aout_FormatPrepare(&filter->fmt_out.audio);
+
+    if (vlc_filter_LoadModule(filter, "audio converter", "audio_format",
+                              true) == NULL)
+    {
+        vlc_object_delete(filter);
+        return NULL;
+    }
+    return filter;
+}
+
+static void FillBlock(block_t *block, unsigned index)
+{
+    int16_t *p = (int16_t *)block->p_buffer;
+
+    /* Full scale saw tooth, different on each channel */
+    for (size_t i = 0; i < FRAMES * CHANNELS; i++)
+        p[i] = (int16_t)((index * FRAMES + i) * (37 + i % CHANNELS));
+    block->i_buffer = FRAMES * CHANNELS * sizeof (int16_t);
+    block->i_nb_samples = FRAMES;
+}
+
+/* Plain C version of the same processing, as the reference */
+static void ProcessReference(int16_t *restrict dst, const int16_t *src)
+{
+    for (size_t i = 0; i < FRAMES * CHANNELS; i++)
+    {
+        float v = (src[i] / 32768.f) * GAIN * 32768.f;
+        dst[i] = v >= 32767.f ? 32767 : v <= -32768.f ? -32768 : lrintf(v);
+    }
+}
+
+int main(void)
+{
+    test_init();
+
+    CheckKernels(&c_kernels);
+#if defined(__i386__) || defined(__x86_64__)
+# ifdef HAVE_SSE2_INTRINSICS
+    if (vlc_CPU_SSE2())
+    {
+        static const struct kernels sse2_kernels = {
+            "SSE2", S16toFl32_SSE2_kernel, Fl32toS16_SSE2_kernel,
+            S32toFl32_SSE2_kernel, Fl32toS32_SSE2_kernel,
+            AmplifyFL32_SSE, AmplifyFL64_SSE2,
+        };
+        CheckKernels(&sse2_kernels);
+    }
+# endif
+# ifdef HAVE_AVX2_INTRINSICS
+    if (vlc_CPU_AVX2())
+    {
+        static const struct kernels avx2_kernels = {
+            "AVX2", S16toFl32_AVX2_kernel, Fl32toS16_AVX2_kernel,
+            S32toFl32_AVX2_kernel, Fl32toS32_AVX2_kernel,
+            AmplifyFL32_AVX, AmplifyFL64_AVX,
+        };
+        CheckKernels(&avx2_kernels);
+    }
+# endif
+#endif
+
+    const char *const args[] = {
+        "-v",
+    };
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(args), args);
+    if (vlc == NULL)
+        return 1;
+
+    vlc_object_t *parent = VLC_OBJECT(vlc->p_libvlc_int);
+    filter_t *to_float = CreateConverter(parent, VLC_CODEC_S16N,
+                                         VLC_CODEC_FL32);
+    filter_t *to_s16 = CreateConverter(parent, VLC_CODEC_FL32,
+                                       VLC_CODEC_S16N);
+
+    audio_volume_t *volume = vlc_object_create(parent, sizeof (*volume));
+    assert(volume != NULL);
+    volume->format = VLC_CODEC_FL32;
+    module_t *mixer = module_need(volume, "audio volume", "float_mixer", true);
+
+    if (to_float == NULL || to_s16 == NULL || mixer == NULL)
+    {
+        if (mixer != NULL)
+            module_unneed(volume, mixer);
+        vlc_object_delete(volume);
+        if (to_float != NULL)
+            vlc_filter_Delete(to_float);
+        if (to_s16 != NULL)
+            vlc_filter_Delete(to_s16);
+        libvlc_release(vlc);
+        return 77; /* Modules not built */
+    }
+
+    int16_t input[FRAMES * CHANNELS], reference[FRAMES * CHANNELS];
+    block_t *block = block_Alloc(FRAMES * CHANNELS * sizeof (float));
+    assert(block != NULL);
+
+    vlc_tick_t scalar = 0, modules = 0;
+
+    for (unsigned i = 0; i < BLOCKS; i++)
+    {
+        FillBlock(block, i);
+        memcpy(input, block->p_buffer, sizeof (input));
+
+        vlc_tick_t start = vlc_tick_now();
+        ProcessReference(reference, input);
+        scalar += vlc_tick_now() - start;
+
+        start = vlc_tick_now();
+        block = to_float->ops->filter_audio(to_float, block);
+        assert(block != NULL);
+        volume->amplify(volume, block, GAIN);
+        block = to_s16->ops->filter_audio(to_s16, block);
+        assert(block != NULL);
+        modules += vlc_tick_now() - start;
+
+        assert(block->i_buffer == sizeof (reference));
+        /* The modules may round differently, not by more than one step */
+        const int16_t *out = (const int16_t *)block->p_buffer;
+        for (size_t j = 0; j < FRAMES * CHANNELS; j++)
+            assert(abs(out[j] - reference[j]) <= 1);
+    }
+
+    double seconds = (double)BLOCKS * FRAMES / RATE;
+    printf("%.1f s of 7.1 %d Hz, s16 -> fl32 -> volume -> s16:\n"
+           " scalar reference: %.1fx real time\n"
+           " modules:          %.1fx real time\n", seconds, RATE,
+           seconds / secf_from_vlc_tick(__MAX(scalar, 1)),
+           seconds / secf_from_vlc_tick(__MAX(modules, 1)));
+
+    block_Release(block);
+    module_unneed(volume, mixer);
+    vlc_object_delete(volume);
+    vlc_filter_Delete(to_float);
+    vlc_filter_Delete(to_s16);
+    libvlc_release(vlc);
+    return 0;
+}
@@ -0,0 +1,459 @@
+/*****************************************************************************
+ * avi.c: AVI demuxer background indexing test
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+/* Define a builtin module for mocked parts */
+#define MODULE_NAME test_demux_avi
+#undef VLC_DYNAMIC_PLUGIN
+
+#include "../../libvlc/test.h"
+#include "../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_access.h>
+#include <vlc_demux.h>
+#include <vlc_es_out.h>
+#include <vlc_interrupt.h>
+#include <vlc_modules.h>
+
+#include <stdatomic.h>
+
+const char vlc_module_name[] = MODULE_STRING;
+
+#define FRAMES          250
+#define FRAME_DURATION  VLC_TICK_FROM_MS(40)
+#define AUDIO_SIZE      640 /* 40 ms of 16 bits mono at 8 kHz */
+
+/* No idx1: bigger video frames in the first half, so that the byte ratio
+ * lands before the middle frame */
+static uint8_t avi[FRAMES * (3008 + AUDIO_SIZE + 8) + 4096];
+static size_t avi_size;
+
+static void PutFourcc(const char *fourcc)
+{
+    memcpy(&avi[avi_size], fourcc, 4);
+    avi_size += 4;
+}
+
+static void PutDW(uint32_t value)
+{
+    SetDWLE(&avi[avi_size], value);
+    avi_size += 4;
+}
+
+static void PutW(uint16_t value)
+{
+    SetWLE(&avi[avi_size], value);
+    avi_size += 2;
+}
+
+/* Returns the offset of the size, set by EndChunk() */
+static size_t BeginChunk(const char *fourcc, const char *type)
+{
+    PutFourcc(fourcc);
+    size_t offset = avi_size;
+    PutDW(0);
+    if (type != NULL)
+        PutFourcc(type);
+    return offset;
+}
+
+static void EndChunk(size_t offset)
+{
+    SetDWLE(&avi[offset], avi_size - offset - 4);
+}
+
+static void PutStreamHeader(const char *type, const char *handler,
+                            uint32_t scale, uint32_t rate, uint32_t length,
+                            uint32_t samplesize)
+{
+    size_t strh = BeginChunk("strh", NULL);
+    PutFourcc(type);
+    PutFourcc(handler);
+    PutDW(0); /* flags */
+    PutW(0); /* priority */
+    PutW(0); /* language */
+    PutDW(0); /* initial frames */
+    PutDW(scale);
+    PutDW(rate);
+    PutDW(0); /* start */
+    PutDW(length);
+    PutDW(0); /* suggested buffer size */
+    PutDW(UINT32_MAX); /* quality */
+    PutDW(samplesize);
+    PutW(0); PutW(0); PutW(64); PutW(48); /* frame */
+    EndChunk(strh);
+}
+
+static void WriteAvi(void)
+{
+    size_t riff = BeginChunk("RIFF", "AVI ");
+    size_t hdrl = BeginChunk("LIST", "hdrl");
+
+    size_t avih = BeginChunk("avih", NULL);
+    PutDW(US_FROM_VLC_TICK(FRAME_DURATION));
+    PutDW(0); /* max bytes per second */
+    PutDW(0); /* padding */
+    PutDW(0x100); /* AVIF_ISINTERLEAVED */
+    PutDW(FRAMES);
+    PutDW(0); /* initial frames */
+    PutDW(2); /* streams */
+    PutDW(0); /* suggested buffer size */
+    PutDW(64);
+    PutDW(48);
+    for (unsigned i = 0; i < 4; i++)
+        PutDW(0);
+    EndChunk(avih);
+
+    size_t strl = BeginChunk("LIST", "strl");
+    PutStreamHeader("vids", "MJPG", 1, CLOCK_FREQ / FRAME_DURATION, FRAMES, 0);
+    size_t strf = BeginChunk("strf", NULL);
+    PutDW(40);
+    PutDW(64);
+    PutDW(48);
+    PutW(1); /* planes */
+    PutW(24); /* bit count */
+    PutFourcc("MJPG");
+    for (unsigned i = 0; i < 5; i++)
+        PutDW(0);
+    EndChunk(strf);
+    EndChunk(strl);
+
+    strl = BeginChunk("LIST", "strl");
+    PutStreamHeader("auds", "\0\0\0\0", 2, 16000, FRAMES * AUDIO_SIZE / 2, 2);
+    strf = BeginChunk("strf", NULL);
+    PutW(1); /* WAVE_FORMAT_PCM */
+    PutW(1); /* channels */
+    PutDW(8000);
+    PutDW(16000);
+    PutW(2); /* block align */
+    PutW(16);
+    PutW(0);
+    EndChunk(strf);
+    EndChunk(strl);
+
+    EndChunk(hdrl);
+
+    size_t movi = BeginChunk("LIST", "movi");
+    for (uint32_t i = 0; i < FRAMES; i++)
+    {
+        size_t chunk = BeginChunk("00dc", NULL);
+        PutDW(i); /* frame number */
+        avi_size += i < FRAMES / 2 ? 2996 : 996;
+        EndChunk(chunk);
+
+        chunk = BeginChunk("01wb", NULL);
+        avi_size += AUDIO_SIZE;
+        EndChunk(chunk);
+    }
+    EndChunk(movi);
+    EndChunk(riff);
+}
+
+/* The first access opened is the demuxer one, the next ones are held by the
+ * gate until the test opens it */
+static atomic_uint accesses;
+static vlc_sem_t gate;
+/* Posted once the gated accesses read the end of the file */
+static vlc_sem_t scanned;
+
+struct access_sys
+{
+    uint64_t offset;
+    bool gated;
+    bool end;
+};
+
+static ssize_t AccessRead(stream_t *access, void *buf, size_t len)
+{
+    struct access_sys *sys = access->p_sys;
+
+    if (sys->gated)
+    {
+        if (vlc_sem_wait_i11e(&gate))
+            return -1;
+        vlc_sem_post(&gate);
+    }
+
+    if (sys->offset >= avi_size)
+        return 0;
+    len = __MIN(len, avi_size - sys->offset);
+    memcpy(buf, &avi[sys->offset], len);
+    sys->offset += len;
+
+    if (sys->gated && !sys->end && sys->offset + 2048 >= avi_size)
+    {
+        sys->end = true;
+        vlc_sem_post(&scanned);
+    }
+    return len;
+}
+
+static int AccessSeek(stream_t *access, uint64_t offset)
+{
+    struct access_sys *sys = access->p_sys;
+
+    sys->offset = offset;
+    return VLC_SUCCESS;
+}
+
+static int AccessControl(stream_t *access, int query, va_list args)
+{
+    switch (query)
+    {
+        case STREAM_CAN_SEEK:
+        case STREAM_CAN_FASTSEEK:
+        case STREAM_CAN_PAUSE:
+        case STREAM_CAN_CONTROL_PACE:
+            *va_arg(args, bool *) = true;
+            break;
+        case STREAM_GET_SIZE:
+            *va_arg(args, uint64_t *) = avi_size;
+            break;
+        case STREAM_GET_PTS_DELAY:
+            *va_arg(args, vlc_tick_t *) = DEFAULT_PTS_DELAY;
+            break;
+        case STREAM_SET_PAUSE_STATE:
+            break;
+        default:
+            return VLC_EGENERIC;
+    }
+    (void) access;
+    return VLC_SUCCESS;
+}
+
+static int OpenAccess(vlc_object_t *obj)
+{
+    stream_t *access = (stream_t *)obj;
+
+    struct access_sys *sys = vlc_obj_malloc(obj, sizeof (*sys));
+    if (unlikely(sys == NULL))
+        return VLC_ENOMEM;
+
+    sys->offset = 0;
+    sys->gated = atomic_fetch_add(&accesses, 1) > 0;
+    sys->end = false;
+
+    access->pf_read = AccessRead;
+    access->pf_block = NULL;
+    access->pf_seek = AccessSeek;
+    access->pf_control = AccessControl;
+    access->p_sys = sys;
+    return VLC_SUCCESS;
+}
+
+vlc_module_begin()
+    set_capability("access", 0)
+    set_callback(OpenAccess)
+    add_shortcut("avitest")
+vlc_module_end()
+
+VLC_EXPORT const vlc_plugin_cb vlc_static_modules[] = {
+    VLC_SYMBOL(vlc_entry),
+    NULL
+};
+
+/* Video frames sent, in order */
+struct frame
+{
+    uint32_t number;
+    vlc_tick_t dts;
+    uint32_t flags;
+};
+static struct frame frames[4 * FRAMES];
+static size_t frames_sent, frames_read;
+
+struct test_es
+{
+    enum es_format_category_e cat;
+};
+
+static es_out_id_t *EsOutAdd(es_out_t *out, input_source_t *in,
+                             const es_format_t *fmt)
+{
+    (void) out; (void) in;
+    struct test_es *es = malloc(sizeof (*es));
+    assert(es != NULL);
+    es->cat = fmt->i_cat;
+    return (es_out_id_t *)es;
+}
+
+static int EsOutSend(es_out_t *out, es_out_id_t *id, block_t *block)
+{
+    const struct test_es *es = (const struct test_es *)id;
+    (void) out;
+
+    if (es->cat == VIDEO_ES)
+    {
+        assert(block->i_buffer >= 4 && frames_sent < ARRAY_SIZE(frames));
+        struct frame *frame = &frames[frames_sent++];
+        frame->number = GetDWLE(block->p_buffer);
+        frame->dts = block->i_dts;
+        frame->flags = block->i_flags;
+    }
+    block_Release(block);
+    return VLC_SUCCESS;
+}
+
+static void EsOutDel(es_out_t *out, es_out_id_t *id)
+{
+    (void) out;
+    free(id);
+}
+
+static int EsOutControl(es_out_t *out, input_source_t *in, int query,
+                        va_list args)
+{
+    (void) out; (void) in;
+
+    if (query != ES_OUT_GET_ES_STATE)
+        return VLC_EGENERIC;
+
+    /* Every track is selected */
+    (void) va_arg(args, es_out_id_t *);
+    *va_arg(args, bool *) = true;
+    return VLC_SUCCESS;
+}
+
+static const struct es_out_callbacks es_out_cbs = {
+    .add = EsOutAdd,
+    .send = EsOutSend,
+    .del = EsOutDel,
+    .control = EsOutControl,
+};
+
+static const struct frame *NextFrame(demux_t *demux)
+{
+    while (frames_read == frames_sent)
+        assert(demux_Demux(demux) == VLC_DEMUXER_SUCCESS);
+    return &frames[frames_read++];
+}
+
+/* Skips the frames demuxed already */
+static const struct frame *LastFrame(void)
+{
+    assert(frames_sent > 0);
+    frames_read = frames_sent;
+    return &frames[frames_sent - 1];
+}
+
+static void Seek(demux_t *demux, vlc_tick_t date)
+{
+    LastFrame();
+    assert(demux_Control(demux, DEMUX_SET_TIME, date, false) == VLC_SUCCESS);
+
+    vlc_tick_t time;
+    assert(demux_Control(demux, DEMUX_GET_TIME, &time) == VLC_SUCCESS);
+    assert(time == date);
+}
+
+static void Test(vlc_object_t *parent)
+{
+    es_out_t out = { .cbs = &es_out_cbs };
+
+    stream_t *s = vlc_stream_NewURL(parent, "avitest://");
+    assert(s != NULL);
+    demux_t *demux = demux_New(parent, "avi", "avitest://", s, &out);
+    assert(demux != NULL);
+
+    /* The length of the header, until indexed */
+    vlc_tick_t length;
+    assert(demux_Control(demux, DEMUX_GET_LENGTH, &length) == VLC_SUCCESS);
+    assert(length == FRAMES * FRAME_DURATION);
+
+    /* Plays right away, while the indexer is held */
+    const struct frame *frame = NextFrame(demux);
+    assert(frame->number == 0 && frame->dts == VLC_TICK_0);
+    frame = NextFrame(demux);
+    assert(frame->number == 1 && frame->dts == VLC_TICK_0 + FRAME_DURATION);
+
+    /* Beyond the indexed part, the seek does not wait for the indexer: the
+     * position comes from the byte ratio, and the timestamps from the date */
+    const vlc_tick_t middle = FRAMES / 2 * FRAME_DURATION;
+    Seek(demux, middle);
+
+    frame = NextFrame(demux);
+    test_log("coarse seek to frame %"PRIu32"\n", frame->number);
+    assert(frame->number < FRAMES / 2);
+    assert(frame->dts == VLC_TICK_0 + middle);
+    assert(frame->flags & BLOCK_FLAG_DISCONTINUITY);
+    const uint32_t coarse = frame->number;
+    frame = NextFrame(demux);
+    assert(frame->number == coarse + 1);
+    assert(frame->dts == VLC_TICK_0 + middle + FRAME_DURATION);
+
+    /* Once the index reaches the position, the timestamps come from it */
+    vlc_sem_post(&gate);
+    vlc_sem_wait(&scanned);
+
+    const uint32_t last = LastFrame()->number;
+    frame = NextFrame(demux);
+    test_log("resumed at frame %"PRIu32"\n", frame->number);
+    assert(frame->number == last + 1);
+    assert(frame->dts == VLC_TICK_0 + frame->number * FRAME_DURATION);
+    assert(frame->flags & BLOCK_FLAG_DISCONTINUITY);
+
+    /* Seeks within the index are exact */
+    Seek(demux, middle);
+    frame = NextFrame(demux);
+    assert(frame->number == FRAMES / 2);
+    assert(frame->dts == VLC_TICK_0 + middle);
+
+    int ret;
+    do
+        ret = demux_Demux(demux);
+    while (ret == VLC_DEMUXER_SUCCESS);
+    assert(ret == VLC_DEMUXER_EOF);
+    assert(LastFrame()->number == FRAMES - 1);
+
+    assert(demux_Control(demux, DEMUX_GET_LENGTH, &length) == VLC_SUCCESS);
+    assert(length == FRAMES * FRAME_DURATION);
+
+    demux_Delete(demux);
+}
+
+int main(void)
+{
+    test_init();
+
+    WriteAvi();
+    vlc_sem_init(&gate, 0);
+    vlc_sem_init(&scanned, 0);
+    atomic_init(&accesses, 0);
+
+    const char *const args[] = {
+        "-v", "--avi-index=4",
+    };
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(args), args);
+    assert(vlc != NULL);
+
+    int ret = 77; /* AVI demuxer not available */
+    if (module_exists("avi"))
+    {
+        Test(VLC_OBJECT(vlc->p_libvlc_int));
+        ret = 0;
+    }
+    libvlc_release(vlc);
+    return ret;
+}
@@ -0,0 +1,204 @@
+/*****************************************************************************
+ * ogg_index.c: Ogg seek index tests
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <vlc_common.h>
+
+#include "../../../modules/demux/ogg_index.h"
+
+#include "../../libvlc/test.h"
+
+static void CheckSorted(const ogg_index_t *idx)
+{
+    for (size_t i = 1; i < idx->size; i++)
+    {
+        assert(idx->data[i - 1].i_pagepos < idx->data[i].i_pagepos);
+        assert(idx->data[i - 1].i_value <= idx->data[i].i_value);
+    }
+}
+
+static void test_add(void)
+{
+    ogg_index_t idx;
+    vlc_vector_init(&idx);
+
+    /* inserted in random order, kept sorted */
+    static const int order[] = { 5, 2, 8, 1, 9, 3, 7, 4, 6 };
+    for (size_t i = 0; i < ARRAY_SIZE(order); i++)
+    {
+        const demux_index_entry_t *e =
+            OggIndex_Add(&idx, VLC_TICK_FROM_SEC(order[i]), order[i] * 1000);
+        assert(e != NULL);
+        assert(e->i_pagepos == order[i] * 1000);
+        assert(e->i_value == VLC_TICK_FROM_SEC(order[i]));
+        CheckSorted(&idx);
+    }
+    assert(idx.size == ARRAY_SIZE(order));
+    for (size_t i = 0; i < idx.size; i++)
+        assert(idx.data[i].i_pagepos == (int64_t)(i + 1) * 1000);
+
+    /* same page */
+    assert(OggIndex_Add(&idx, VLC_TICK_FROM_SEC(5), 5000) == NULL);
+    /* later page but earlier time */
+    assert(OggIndex_Add(&idx, VLC_TICK_FROM_SEC(2), 5500) == NULL);
+    /* earlier page but later time */
+    assert(OggIndex_Add(&idx, VLC_TICK_FROM_SEC(8), 5500) == NULL);
+    assert(OggIndex_Add(&idx, VLC_TICK_FROM_SEC(10), 500) == NULL);
+    /* invalid */
+    assert(OggIndex_Add(&idx, VLC_TICK_INVALID, 9500) == NULL);
+    assert(OggIndex_Add(&idx, VLC_TICK_FROM_SEC(10), 0) == NULL);
+    assert(OggIndex_Add(&idx, VLC_TICK_FROM_SEC(10), -1) == NULL);
+    assert(idx.size == ARRAY_SIZE(order));
+
+    /* in between and at both ends */
+    assert(OggIndex_Add(&idx, VLC_TICK_FROM_MS(5500), 5500) != NULL);
+    assert(OggIndex_Add(&idx, VLC_TICK_FROM_MS(500), 500) != NULL);
+    assert(OggIndex_Add(&idx, VLC_TICK_FROM_SEC(10), 10000) != NULL);
+    /* a page can hold several keyframes with the same time */
+    assert(OggIndex_Add(&idx, VLC_TICK_FROM_SEC(10), 10500) != NULL);
+    assert(idx.size == ARRAY_SIZE(order) + 4);
+    CheckSorted(&idx);
+
+    vlc_vector_destroy(&idx);
+}
+
+static void test_find(void)
+{
+    ogg_index_t idx;
+    vlc_vector_init(&idx);
+
+    int64_t lower = -1, upper = -1;
+    vlc_tick_t lower_ts = -1;
+    assert(!OggIndex_Find(&idx, VLC_TICK_FROM_SEC(1), &lower, &upper, &lower_ts));
+
+    for (int i = 1; i <= 4; i++)
+        assert(OggIndex_Add(&idx, VLC_TICK_FROM_SEC(i), i * 1000) != NULL);
+
+    /* before the first entry */
+    assert(!OggIndex_Find(&idx, VLC_TICK_FROM_MS(500), &lower, &upper, &lower_ts));
+
+    assert(OggIndex_Find(&idx, VLC_TICK_FROM_MS(2500), &lower, &upper, &lower_ts));
+    assert(lower == 2000 && upper == 3000 && lower_ts == VLC_TICK_FROM_SEC(2));
+
+    assert(OggIndex_Find(&idx, VLC_TICK_FROM_SEC(3), &lower, &upper, &lower_ts));
+    assert(lower == 3000 && upper == 4000 && lower_ts == VLC_TICK_FROM_SEC(3));
+
+    /* after the last entry, the upper bound is left alone */
+    upper = -1;
+    assert(OggIndex_Find(&idx, VLC_TICK_FROM_SEC(9), &lower, &upper, &lower_ts));
+    assert(lower == 4000 && upper == -1 && lower_ts == VLC_TICK_FROM_SEC(4));
+
+    vlc_vector_destroy(&idx);
+}
+
+static size_t Write7BitsVariableLE(uint8_t *p, uint64_t i_value)
+{
+    size_t i = 0;
+    do
+    {
+        p[i] = i_value & 0x7F;
+        i_value >>= 7;
+        if (i_value == 0)
+            p[i] |= 0x80; /* last byte */
+        i++;
+    } while (i_value);
+    return i;
+}
+
+static void test_keypoints(void)
+{
+    /* position and time deltas, as stored in a skeleton index */
+    static const struct
+    {
+        uint64_t i_pos;
+        uint64_t i_time;
+        bool b_indexed;
+    } keypoints[] = {
+        { 100,     0,  true },
+        { 70000,   40, true },
+        { 3,       0,  false }, /* before the time of page 70101 */
+        { 1 << 20, 25, true },
+    };
+    const int64_t stampden = VLC_TICK_FROM_MS(1);
+
+    uint8_t buf[ARRAY_SIZE(keypoints) * 20];
+    size_t size = 0;
+    for (size_t i = 0; i < ARRAY_SIZE(keypoints); i++)
+    {
+        size += Write7BitsVariableLE(&buf[size], keypoints[i].i_pos);
+        size += Write7BitsVariableLE(&buf[size], keypoints[i].i_time);
+    }
+
+    uint64_t val;
+    assert(Read7BitsVariableLE(buf, buf + size, &val) == buf + 1);
+    assert(val == 100);
+    assert(Read7BitsVariableLE(buf + 2, buf + size, &val) == buf + 5);
+    assert(val == 70000);
+
+    ogg_index_t idx;
+    vlc_vector_init(&idx);
+
+    /* already found while playing */
+    assert(OggIndex_Add(&idx, VLC_TICK_0 + VLC_TICK_FROM_MS(50), 70101) != NULL);
+
+    OggIndex_AddKeypoints(&idx, buf, size, ARRAY_SIZE(keypoints), stampden);
+    CheckSorted(&idx);
+    assert(idx.size == 4);
+
+    int64_t pos = 0;
+    vlc_tick_t time = 0;
+    for (size_t i = 0; i < ARRAY_SIZE(keypoints); i++)
+    {
+        pos += keypoints[i].i_pos;
+        time += keypoints[i].i_time * stampden;
+        bool b_found = false;
+        for (size_t j = 0; j < idx.size; j++)
+        {
+            if (idx.data[j].i_pagepos != pos)
+                continue;
+            assert(idx.data[j].i_value == VLC_TICK_0 + time);
+            b_found = true;
+        }
+        assert(b_found == keypoints[i].b_indexed);
+    }
+
+    /* the count and the buffer size both bound the parsing */
+    vlc_vector_clear(&idx);
+    OggIndex_AddKeypoints(&idx, buf, size, 2, stampden);
+    assert(idx.size == 2);
+    vlc_vector_clear(&idx);
+    OggIndex_AddKeypoints(&idx, buf, 2, ARRAY_SIZE(keypoints), stampden);
+    assert(idx.size == 1);
+
+    vlc_vector_destroy(&idx);
+}
+
+int main(void)
+{
+    test_init();
+
+    test_add();
+    test_find();
+    test_keypoints();
+
+    return 0;
+}
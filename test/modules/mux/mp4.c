@@ -0,0 +1,286 @@
+/*****************************************************************************
+ * mp4.c: MP4 muxer unit testing
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <vlc_common.h>
+
+#include <vlc_block.h>
+#include <vlc_plugin.h>
+#include <vlc_sout.h>
+
+#include "../../libvlc/test.h"
+#include "../lib/libvlc_internal.h"
+
+/* 1 hour of 25 fps video and MPEG audio, with tiny samples to keep the
+ * file in memory */
+#define DURATION     VLC_TICK_FROM_SEC(3600)
+#define VIDEO_FPS    25
+#define VIDEO_FRAME  96
+#define AUDIO_FRAME  32
+#define AUDIO_LENGTH VLC_TICK_FROM_MS(24)
+
+struct mem_file
+{
+    uint8_t *data;
+    size_t size;
+    size_t pos;
+    uint64_t written; /* total bytes written, including rewrites */
+};
+
+static ssize_t AccessOutWrite(sout_access_out_t *access, block_t *block)
+{
+    struct mem_file *file = access->p_sys;
+    ssize_t total = 0;
+
+    while (block != NULL)
+    {
+        block_t *next = block->p_next;
+
+        if (file->pos + block->i_buffer > file->size)
+        {
+            uint8_t *data = realloc(file->data, file->pos + block->i_buffer);
+            assert(data != NULL);
+            memset(&data[file->size], 0, file->pos - __MIN(file->pos, file->size));
+            file->data = data;
+            file->size = file->pos + block->i_buffer;
+        }
+        memcpy(&file->data[file->pos], block->p_buffer, block->i_buffer);
+        file->pos += block->i_buffer;
+        file->written += block->i_buffer;
+        total += block->i_buffer;
+
+        block_Release(block);
+        block = next;
+    }
+    return total;
+}
+
+static ssize_t AccessOutRead(sout_access_out_t *access, block_t *block)
+{
+    struct mem_file *file = access->p_sys;
+
+    if (file->pos >= file->size)
+        return 0;
+
+    size_t len = __MIN(block->i_buffer, file->size - file->pos);
+    memcpy(block->p_buffer, &file->data[file->pos], len);
+    file->pos += len;
+    return len;
+}
+
+static int AccessOutSeek(sout_access_out_t *access, uint64_t pos)
+{
+    struct mem_file *file = access->p_sys;
+
+    file->pos = pos;
+    return VLC_SUCCESS;
+}
+
+static sout_access_out_t *CreateAccessOut(vlc_object_t *parent,
+                                          struct mem_file *file)
+{
+    sout_access_out_t *access = vlc_object_create(parent, sizeof(*access));
+    if (unlikely(access == NULL))
+        return NULL;
+
+    access->psz_access = strdup("mock");
+    if (unlikely(access->psz_access == NULL))
+    {
+        vlc_object_delete(access);
+        return NULL;
+    }
+
+    access->p_cfg = NULL;
+    access->p_module = NULL;
+    access->p_sys = file;
+    access->psz_path = NULL;
+
+    access->pf_control = NULL;
+    access->pf_read = AccessOutRead;
+    access->pf_seek = AccessOutSeek;
+    access->pf_write = AccessOutWrite;
+    return access;
+}
+
+static block_t *NewFrame(size_t size, vlc_tick_t dts, vlc_tick_t length)
+{
+    block_t *frame = block_Alloc(size);
+    assert(frame != NULL);
+    memset(frame->p_buffer, 0x5a, size);
+    frame->i_pts = frame->i_dts = dts;
+    frame->i_length = length;
+    return frame;
+}
+
+/* Returns false if the muxer is not available */
+static bool Record(libvlc_instance_t *instance, const char *muxcfg,
+                   struct mem_file *file)
+{
+    sout_access_out_t *access =
+        CreateAccessOut(VLC_OBJECT(instance->p_libvlc_int), file);
+    assert(access != NULL);
+
+    sout_mux_t *mux = sout_MuxNew(access, muxcfg);
+    if (mux == NULL)
+    {
+        sout_AccessOutDelete(access);
+        return false;
+    }
+
+    es_format_t fmt;
+    es_format_Init(&fmt, VIDEO_ES, VLC_CODEC_MP4V);
+    fmt.video.i_width = fmt.video.i_visible_width = 320;
+    fmt.video.i_height = fmt.video.i_visible_height = 240;
+    fmt.video.i_frame_rate = VIDEO_FPS;
+    fmt.video.i_frame_rate_base = 1;
+    sout_input_t *video = sout_MuxAddStream(mux, &fmt);
+    assert(video != NULL);
+
+    es_format_Init(&fmt, AUDIO_ES, VLC_CODEC_MPGA);
+    fmt.audio.i_rate = 48000;
+    fmt.audio.i_channels = 2;
+    fmt.audio.i_frame_length = 1152;
+    sout_input_t *audio = sout_MuxAddStream(mux, &fmt);
+    assert(audio != NULL);
+
+    // Disable mux caching.
+    mux->b_waiting_stream = false;
+
+    const vlc_tick_t video_length = vlc_tick_rate_duration(VIDEO_FPS);
+    vlc_tick_t video_dts = VLC_TICK_0, audio_dts = VLC_TICK_0;
+
+    while (video_dts < VLC_TICK_0 + DURATION)
+    {
+        int ret = sout_MuxSendBuffer(mux, video,
+                        NewFrame(VIDEO_FRAME, video_dts, video_length));
+        assert(ret == VLC_SUCCESS);
+        video_dts += video_length;
+
+        while (audio_dts < video_dts)
+        {
+            ret = sout_MuxSendBuffer(mux, audio,
+                        NewFrame(AUDIO_FRAME, audio_dts, AUDIO_LENGTH));
+            assert(ret == VLC_SUCCESS);
+            audio_dts += AUDIO_LENGTH;
+        }
+    }
+
+    sout_MuxDeleteStream(mux, video);
+    sout_MuxDeleteStream(mux, audio);
+    sout_MuxDelete(mux);
+    sout_AccessOutDelete(access);
+    return true;
+}
+
+struct layout
+{
+    uint64_t moov; /* moov box size */
+    uint64_t free; /* free boxes total size */
+};
+
+/* Checks the top level boxes, and that the moov follows the ftyp */
+static struct layout CheckFastStart(const struct mem_file *file)
+{
+    struct layout layout = { 0, 0 };
+    size_t pos = 0;
+    unsigned index = 0;
+    bool mdat = false;
+
+    while (pos + 8 <= file->size)
+    {
+        uint64_t size = GetDWBE(&file->data[pos]);
+        const uint8_t *type = &file->data[pos + 4];
+
+        if (size == 1)
+            size = GetQWBE(&file->data[pos + 8]);
+        assert(size >= 8 && pos + size <= file->size);
+
+        if (index == 0)
+            assert(!memcmp(type, "ftyp", 4));
+        else if (index == 1)
+        {
+            assert(!memcmp(type, "moov", 4));
+            layout.moov = size;
+        }
+        else if (!memcmp(type, "free", 4))
+            layout.free += size;
+        else if (!memcmp(type, "mdat", 4))
+            mdat = true;
+        pos += size;
+        index++;
+    }
+
+    assert(pos == file->size);
+    assert(layout.moov > 0 && mdat);
+    return layout;
+}
+
+int main(void)
+{
+    test_init();
+
+    const char *const args[] = {
+        "-v",
+    };
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(args), args);
+    if (vlc == NULL)
+        return 1;
+
+    struct mem_file shifted = { 0 }, reserved = { 0 }, small = { 0 };
+
+    if (!Record(vlc, "mp4{faststart}", &shifted))
+    {
+        libvlc_release(vlc);
+        return 77; /* MP4 muxer not built */
+    }
+    Record(vlc, "mp4{faststart,faststart-duration=3600}", &reserved);
+    /* Underestimated duration: falls back to moving the data */
+    Record(vlc, "mp4{faststart,faststart-duration=60}", &small);
+
+    const struct layout shifted_layout = CheckFastStart(&shifted);
+    const struct layout reserved_layout = CheckFastStart(&reserved);
+    const struct layout small_layout = CheckFastStart(&small);
+
+    /* The data is moved once */
+    assert(shifted_layout.free == 0);
+    assert(shifted.written >= 2 * (shifted.size - shifted_layout.moov));
+
+    /* The data is written once, only the reserved space is written again
+     * with the moov, the mdat size and the remaining free box header */
+    assert(reserved_layout.moov == shifted_layout.moov);
+    assert(reserved.size == shifted.size + reserved_layout.free);
+    assert(reserved.written <= reserved.size + reserved_layout.moov + 32);
+
+    /* The reserved space is reused, and only the missing part is made by
+     * moving the data */
+    assert(small_layout.moov == shifted_layout.moov);
+    assert(small_layout.free < 16);
+    assert(small.size == shifted.size + small_layout.free);
+    assert(small.written > reserved.written);
+
+    free(shifted.data);
+    free(reserved.data);
+    free(small.data);
+
+    libvlc_release(vlc);
+    return 0;
+}
@@ -0,0 +1,287 @@
+/*****************************************************************************
+ * ts.c: MPEG-TS muxer unit testing
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <vlc_common.h>
+
+#include <vlc_block.h>
+#include <vlc_plugin.h>
+#include <vlc_sout.h>
+#include <vlc_tick.h>
+
+#include "../../libvlc/test.h"
+#include "../lib/libvlc_internal.h"
+
+#define PROGRAMS      4
+#define DURATION      VLC_TICK_FROM_SEC(2)
+#define BENCH_DURATION VLC_TICK_FROM_SEC(30) /* with VLC_BENCH set */
+#define VIDEO_FPS     25
+#define VIDEO_FRAME   4000
+#define AUDIO_FRAME   576
+#define AUDIO_LENGTH  VLC_TICK_FROM_MS(24)
+#define SLAB          7
+
+struct mux_output
+{
+    unsigned slab;
+    bool keep; /* the packets, to compare them */
+    uint8_t *packets;
+    size_t count;
+    size_t blocks;
+    vlc_tick_t elapsed;
+};
+
+static ssize_t AccessOutWrite(sout_access_out_t *access, block_t *block)
+{
+    struct mux_output *out = access->p_sys;
+    ssize_t total = 0;
+
+    while (block != NULL)
+    {
+        block_t *next = block->p_next;
+
+        assert(block->i_buffer > 0 && block->i_buffer % 188 == 0);
+        if (out->slab > 0)
+            assert(block->i_buffer <= 188 * out->slab);
+        else
+            assert(block->i_buffer == 188);
+
+        size_t count = block->i_buffer / 188;
+        if (out->keep)
+        {
+            out->packets = realloc(out->packets, (out->count + count) * 188);
+            assert(out->packets != NULL);
+            memcpy(&out->packets[out->count * 188], block->p_buffer,
+                   block->i_buffer);
+        }
+        out->count += count;
+        out->blocks++;
+        total += block->i_buffer;
+        block_Release(block);
+        block = next;
+    }
+    return total;
+}
+
+static sout_access_out_t *CreateAccessOut(vlc_object_t *parent,
+                                          struct mux_output *out)
+{
+    sout_access_out_t *access = vlc_object_create(parent, sizeof(*access));
+    if (unlikely(access == NULL))
+        return NULL;
+
+    access->psz_access = strdup("mock");
+    if (unlikely(access->psz_access == NULL))
+    {
+        vlc_object_delete(access);
+        return NULL;
+    }
+
+    access->p_cfg = NULL;
+    access->p_module = NULL;
+    access->p_sys = out;
+    access->psz_path = NULL;
+
+    access->pf_control = NULL;
+    access->pf_read = NULL;
+    access->pf_seek = NULL;
+    access->pf_write = AccessOutWrite;
+    return access;
+}
+
+static block_t *NewFrame(size_t size, vlc_tick_t dts, vlc_tick_t length)
+{
+    block_t *frame = block_Alloc(size);
+    assert(frame != NULL);
+    memset(frame->p_buffer, 0x5a, size);
+    frame->i_pts = frame->i_dts = dts;
+    frame->i_length = length;
+    return frame;
+}
+
+/* Returns false if the muxer is not available */
+static bool RunMux(libvlc_instance_t *instance, struct mux_output *out,
+                   vlc_tick_t duration)
+{
+    char muxcfg[256];
+    sout_input_t *inputs[PROGRAMS][2];
+
+    snprintf(muxcfg, sizeof(muxcfg), "ts{es-id-pid,slab=%u,"
+             "muxpmt=\"101,102,,201,202,,301,302,,401,402\"}", out->slab);
+
+    sout_access_out_t *access =
+        CreateAccessOut(VLC_OBJECT(instance->p_libvlc_int), out);
+    assert(access != NULL);
+
+    sout_mux_t *mux = sout_MuxNew(access, muxcfg);
+    if (mux == NULL)
+    {
+        sout_AccessOutDelete(access);
+        return false;
+    }
+
+    for (int i = 0; i < PROGRAMS; i++)
+    {
+        es_format_t fmt;
+
+        es_format_Init(&fmt, VIDEO_ES, VLC_CODEC_MPGV);
+        fmt.i_id = 100 * (i + 1) + 1;
+        inputs[i][0] = sout_MuxAddStream(mux, &fmt);
+        assert(inputs[i][0] != NULL);
+
+        es_format_Init(&fmt, AUDIO_ES, VLC_CODEC_MPGA);
+        fmt.i_id = 100 * (i + 1) + 2;
+        fmt.audio.i_rate = 48000;
+        fmt.audio.i_channels = 2;
+        inputs[i][1] = sout_MuxAddStream(mux, &fmt);
+        assert(inputs[i][1] != NULL);
+    }
+
+    // Disable mux caching.
+    mux->b_waiting_stream = false;
+
+    const vlc_tick_t video_length = vlc_tick_rate_duration(VIDEO_FPS);
+    vlc_tick_t video_dts = VLC_TICK_0, audio_dts = VLC_TICK_0;
+    const vlc_tick_t start = vlc_tick_now();
+
+    while (video_dts < VLC_TICK_0 + duration)
+    {
+        for (int i = 0; i < PROGRAMS; i++)
+        {
+            int ret = sout_MuxSendBuffer(mux, inputs[i][0],
+                        NewFrame(VIDEO_FRAME, video_dts, video_length));
+            assert(ret == VLC_SUCCESS);
+        }
+        video_dts += video_length;
+
+        while (audio_dts < video_dts)
+        {
+            for (int i = 0; i < PROGRAMS; i++)
+            {
+                int ret = sout_MuxSendBuffer(mux, inputs[i][1],
+                            NewFrame(AUDIO_FRAME, audio_dts, AUDIO_LENGTH));
+                assert(ret == VLC_SUCCESS);
+            }
+            audio_dts += AUDIO_LENGTH;
+        }
+    }
+
+    for (int i = 0; i < PROGRAMS; i++)
+    {
+        sout_MuxDeleteStream(mux, inputs[i][0]);
+        sout_MuxDeleteStream(mux, inputs[i][1]);
+    }
+    sout_MuxDelete(mux);
+    out->elapsed = vlc_tick_now() - start;
+    sout_AccessOutDelete(access);
+    return true;
+}
+
+static void Report(const struct mux_output *out)
+{
+    double secs = secf_from_vlc_tick(out->elapsed);
+
+    fprintf(stderr, "slab=%u: %zu packets in %zu blocks, %.0f pkt/s\n",
+            out->slab, out->count, out->blocks,
+            secs > 0. ? out->count / secs : 0.);
+}
+
+static unsigned GetPID(const uint8_t *packet)
+{
+    return ((packet[1] & 0x1f) << 8) | packet[2];
+}
+
+static bool IsESPID(unsigned pid)
+{
+    return pid / 100 >= 1 && pid / 100 <= PROGRAMS &&
+           (pid % 100 == 1 || pid % 100 == 2);
+}
+
+int main(void)
+{
+    test_init();
+
+    const char *const args[] = {
+        "-v",
+    };
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(args), args);
+    if (vlc == NULL)
+        return 1;
+
+    struct mux_output packets = { .slab = 0, .keep = true };
+    struct mux_output slabs = { .slab = SLAB, .keep = true };
+
+    if (!RunMux(vlc, &packets, DURATION))
+    {
+        libvlc_release(vlc);
+        return 77; /* TS muxer not built */
+    }
+    bool ok = RunMux(vlc, &slabs, DURATION);
+    assert(ok);
+    Report(&packets);
+    Report(&slabs);
+
+    /* Packets per second with and without slabs, on a longer mux */
+    if (getenv("VLC_BENCH") != NULL)
+    {
+        struct mux_output bench[] = {
+            { .slab = 0 }, { .slab = SLAB },
+        };
+
+        for (size_t i = 0; i < ARRAY_SIZE(bench); i++)
+        {
+            ok = RunMux(vlc, &bench[i], BENCH_DURATION);
+            assert(ok);
+            Report(&bench[i]);
+        }
+        assert(bench[0].count == bench[1].count);
+    }
+    libvlc_release(vlc);
+
+    /* Same mux, only the output blocks differ */
+    assert(packets.count > 0);
+    assert(packets.count == slabs.count);
+    assert(slabs.blocks < packets.blocks);
+    assert(slabs.blocks >= (slabs.count + SLAB - 1) / SLAB);
+
+    size_t es_packets = 0;
+    for (size_t i = 0; i < packets.count; i++)
+    {
+        const uint8_t *a = &packets.packets[i * 188];
+        const uint8_t *b = &slabs.packets[i * 188];
+
+        assert(a[0] == 0x47 && b[0] == 0x47);
+        assert(GetPID(a) == GetPID(b));
+        /* The PSI versions are random, the PES packets are not */
+        if (IsESPID(GetPID(a)))
+        {
+            assert(memcmp(a, b, 188) == 0);
+            es_packets++;
+        }
+    }
+    /* Not only tables */
+    assert(es_packets > 0 && es_packets < packets.count);
+
+    free(packets.packets);
+    free(slabs.packets);
+    return 0;
+}
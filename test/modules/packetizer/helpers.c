@@ -87,9 +87,144 @@ static int run_annexb_sets( const uint8_t *p_set, const uint8_t *p_end,
     }
     else printf("asm not built in, skipping test:\n");
 
+#ifdef CAN_COMPILE_SSE2
+    if( vlc_CPU_SSE2() )
+    {
+        printf("checking sse2:\n");
+        i_ret = check_set( p_set, p_end, p_results, i_results, i_results_offset,
+                           startcode_FindAnnexB_SSE2 );
+        if( i_ret != 0 )
+            return i_ret;
+    }
+#endif
+#ifdef CAN_COMPILE_AVX2
+    if( vlc_CPU_AVX2() )
+    {
+        printf("checking avx2:\n");
+        i_ret = check_set( p_set, p_end, p_results, i_results, i_results_offset,
+                           startcode_FindAnnexB_AVX2 );
+        if( i_ret != 0 )
+            return i_ret;
+    }
+#endif
+#ifdef __ARM_NEON
+    printf("checking neon:\n");
+    i_ret = check_set( p_set, p_end, p_results, i_results, i_results_offset,
+                       startcode_FindAnnexB_NEON );
+    if( i_ret != 0 )
+        return i_ret;
+#endif
+
     return 0;
 }
 
+/* Splits the data in blocks and looks up startcodes the way
+ * packetizer_helper does: pushing blocks one by one and resuming the
+ * lookup of the next startcode, then consuming up to it. */
+static size_t packetize_chain( const uint8_t *p_data, size_t i_data,
+                               size_t i_blocksize, bool b_cursor,
+                               size_t *pi_offsets, size_t i_max_offsets )
+{
+    static const uint8_t annexb_startcode[] = { 0, 0, 1 };
+    block_bytestream_t bs;
+    block_startcode_cursor_t cursor;
+    size_t i_offset = 1;
+    size_t i_consumed = 0;
+    size_t i_found = 0;
+
+    block_BytestreamInit( &bs );
+    block_StartcodeCursorReset( &cursor );
+
+    for( size_t i = 0; i < i_data; i += i_blocksize )
+    {
+        const size_t i_size = __MIN(i_blocksize, i_data - i);
+        block_t *p_block = block_Alloc( i_size );
+        assert( p_block );
+        memcpy( p_block->p_buffer, &p_data[i], i_size );
+        block_BytestreamPush( &bs, p_block );
+
+        while( block_FindStartcodeFromCursor( &bs, b_cursor ? &cursor : NULL,
+                                              &i_offset, annexb_startcode, 3,
+                                              startcode_FindAnnexB, NULL ) == VLC_SUCCESS )
+        {
+            i_consumed += i_offset;
+            if( i_found < i_max_offsets )
+                pi_offsets[i_found] = i_consumed;
+            i_found++;
+            block_SkipBytes( &bs, i_offset );
+            block_BytestreamFlush( &bs );
+            block_StartcodeCursorReset( &cursor );
+            i_offset = 1;
+        }
+    }
+
+    block_BytestreamRelease( &bs );
+    return i_found;
+}
+
+static int check_chained_lookup( void )
+{
+    const size_t i_data = 1 << 16;
+    uint8_t *p_data = malloc( i_data );
+    size_t *pi_ref = malloc( i_data * sizeof(*pi_ref) );
+    size_t *pi_res = malloc( i_data * sizeof(*pi_res) );
+    int i_ret = 0;
+    if( !p_data || !pi_ref || !pi_res )
+        goto end;
+
+    /* dense zeros to stress partial matches across block boundaries */
+    srand( 42 );
+    for( size_t i = 0; i < i_data; i++ )
+        p_data[i] = (rand() % 3) ? 0 : (rand() % 3);
+
+    const size_t blocksizes[] = { 1, 2, 3, 5, 17, 188, 1316, 4096 };
+    for( size_t i = 0; i < ARRAY_SIZE(blocksizes) && !i_ret; i++ )
+    {
+        size_t i_ref = packetize_chain( p_data, i_data, blocksizes[i], false,
+                                        pi_ref, i_data );
+        size_t i_res = packetize_chain( p_data, i_data, blocksizes[i], true,
+                                        pi_res, i_data );
+        printf("- blocksize %zu: %zu startcodes\n", blocksizes[i], i_res);
+        if( i_ref != i_res || memcmp( pi_ref, pi_res, i_ref * sizeof(*pi_ref) ) )
+            i_ret = 1;
+    }
+
+end:
+    free( pi_res );
+    free( pi_ref );
+    free( p_data );
+    return i_ret;
+}
+
+/* Synthetic high bitrate intra stream: large NAL units without
+ * emulated startcodes, carried in TS sized payloads */
+static void bench_chained_lookup( void )
+{
+    const size_t i_data = 32 << 20;
+    const size_t i_nal = 2 << 20;
+    uint8_t *p_data = malloc( i_data );
+    if( !p_data )
+        return;
+
+    for( size_t i = 0; i < i_data; i++ )
+        p_data[i] = 0x80 | (i * 7);
+    for( size_t i = 0; i + 4 < i_data; i += i_nal )
+        memcpy( &p_data[i], (const uint8_t[]){ 0, 0, 0, 1, 0x26 }, 5 );
+
+    for( int i_cursor = 0; i_cursor < 2; i_cursor++ )
+    {
+        vlc_tick_t start = vlc_tick_now();
+        size_t i_found = packetize_chain( p_data, i_data, 1316, i_cursor,
+                                          NULL, 0 );
+        vlc_tick_t elapsed = vlc_tick_now() - start;
+        printf("* %s lookup: %zu startcodes in %"PRId64" ms (%"PRId64" MiB/s)\n",
+               i_cursor ? "resumed" : "rescanning", i_found, MS_FROM_VLC_TICK(elapsed),
+               elapsed > 0 ? (int64_t)(i_data >> 20) * CLOCK_FREQ / elapsed : 0);
+    }
+
+    free( p_data );
+}
+
 int main( void )
 {
     const uint8_t test1_annexbdata[] = { 0, 0, 0, 1, 0x55, 0x55, 0x55, 0x55, 0x55, // 9
@@ -134,5 +269,12 @@ int main( void )
             return i_ret;
     }
 
+    printf("* Running chained lookup tests:\n");
+    i_ret = check_chained_lookup();
+    if( i_ret != 0 )
+        return i_ret;
+
+    bench_chained_lookup();
+
     return 0;
 }
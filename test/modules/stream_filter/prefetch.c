@@ -0,0 +1,87 @@
+/*****************************************************************************
+ * prefetch.c: prefetch circular buffer test
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+#include <stdlib.h>
+
+#include <vlc_common.h>
+
+#include "../modules/stream_filter/prefetch_ring.h"
+
+/* Byte expected at a given stream offset */
+static char Pattern(uint64_t offset)
+{
+    return (char)(offset * 7 + (offset >> 8));
+}
+
+static void CheckGrow(size_t size, size_t new_size, uint64_t offset,
+                      size_t length)
+{
+    char *src = malloc(size);
+    char *dst = malloc(new_size);
+    assert(src != NULL && dst != NULL);
+
+    memset(src, 0, size);
+    for (uint64_t o = offset; o < offset + length; o++)
+        src[o % size] = Pattern(o);
+
+    memset(dst, 0, new_size);
+    prefetch_RingCopy(dst, new_size, src, size, offset, length);
+
+    /* Every buffered byte is found at its offset in the new buffer */
+    for (uint64_t o = offset; o < offset + length; o++)
+        assert(dst[o % new_size] == Pattern(o));
+
+    free(dst);
+    free(src);
+}
+
+int main(void)
+{
+    static const size_t sizes[][2] = {
+        { 16, 32 }, { 16, 48 }, { 64, 128 }, { 100, 256 }, { 4096, 8192 },
+        { 4096, 12288 }, { 1000, 1001 },
+    };
+
+    for (size_t i = 0; i < ARRAY_SIZE(sizes); i++)
+    {
+        const size_t size = sizes[i][0], new_size = sizes[i][1];
+        const uint64_t offsets[] = {
+            0, 1, size / 2, size - 1, size, 3 * size + 5,
+            new_size - 1, 5 * new_size - size / 3, UINT64_C(1) << 40,
+        };
+
+        for (size_t j = 0; j < ARRAY_SIZE(offsets); j++)
+        {
+            /* Empty, partial, wrapping, and full buffers */
+            CheckGrow(size, new_size, offsets[j], 0);
+            CheckGrow(size, new_size, offsets[j], 1);
+            CheckGrow(size, new_size, offsets[j], size / 2);
+            CheckGrow(size, new_size, offsets[j], size - 1);
+            CheckGrow(size, new_size, offsets[j], size);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,213 @@
+/*****************************************************************************
+ * storage.c: HLS asynchronous storage unit tests
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#define MODULE_NAME test_hls_storage
+#undef VLC_DYNAMIC_PLUGIN
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+
+#include <vlc_block.h>
+#include <vlc_fs.h>
+#include <vlc_sout.h>
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../../../libvlc/test.h"
+#include "../../../../modules/stream_out/hls/hls.h"
+#include "../../../../modules/stream_out/hls/storage.h"
+
+const char vlc_module_name[] = MODULE_STRING;
+
+#define SEGMENTS 8
+#define SEGMENT_SIZE 4096
+#define WRITE_DELAY VLC_TICK_FROM_MS(100)
+
+static _Atomic vlc_tick_t write_delay = 0;
+
+/*
+ * Deliberately slow storage stand-in: every write to the output volume stalls
+ * as on a disk with latency spikes.
+ */
+ssize_t vlc_write(int fd, const void *buf, size_t len)
+{
+    const vlc_tick_t delay = atomic_load(&write_delay);
+    if (delay > 0)
+        vlc_tick_sleep(delay);
+    return write(fd, buf, len);
+}
+
+static block_t *make_segment(unsigned index)
+{
+    block_t *block = block_Alloc(SEGMENT_SIZE);
+    assert(block != NULL);
+    memset(block->p_buffer, 'a' + index, block->i_buffer);
+    return block;
+}
+
+static void check_content(const hls_storage_t *storage, char expected,
+                          size_t size)
+{
+    uint8_t *content;
+    const ssize_t read = storage->get_content(storage, &content);
+
+    assert(read == (ssize_t)size);
+    for (size_t i = 0; i < size; ++i)
+        assert(content[i] == expected);
+    free(content);
+}
+
+static void check_file(const char *dir, const char *name, char expected,
+                       size_t size)
+{
+    char *path;
+    assert(asprintf(&path, "%s/%s", dir, name) != -1);
+
+    FILE *file = vlc_fopen(path, "rb");
+    assert(file != NULL);
+
+    char buf[SEGMENT_SIZE + 1];
+    assert(fread(buf, 1, sizeof(buf), file) == size);
+    for (size_t i = 0; i < size; ++i)
+        assert(buf[i] == expected);
+    fclose(file);
+
+    /* The temporary file was renamed */
+    char *temp_path;
+    struct stat st;
+    assert(asprintf(&temp_path, "%s.tmp", path) != -1);
+    assert(vlc_stat(temp_path, &st) != 0);
+    free(temp_path);
+
+    vlc_unlink(path);
+    free(path);
+}
+
+static void test_async(const char *dir)
+{
+    struct hls_config config = {
+        .outdir = (char *)dir,
+        .sync = true,
+        .preallocate = true,
+        .max_memory = BYTES_FROM_KB(20000),
+    };
+    config.writer = hls_storage_writer_New(NULL, &config);
+    assert(config.writer != NULL);
+
+    atomic_store(&write_delay, WRITE_DELAY);
+
+    hls_storage_t *segments[SEGMENTS];
+    char names[SEGMENTS][16];
+    for (unsigned i = 0; i < SEGMENTS; ++i)
+    {
+        sprintf(names[i], "segment-%u.ts", i);
+        const struct hls_storage_config storage_config = {
+            .name = names[i],
+            .mime = "video/MP2T",
+        };
+
+        /* The muxing path does not wait for the disk */
+        const vlc_tick_t start = vlc_tick_now();
+        segments[i] =
+            hls_storage_FromBlocks(make_segment(i), &storage_config, &config);
+        assert(vlc_tick_now() - start < WRITE_DELAY);
+
+        assert(segments[i] != NULL);
+        assert(hls_storage_GetSize(segments[i]) == SEGMENT_SIZE);
+        assert(!strcmp(segments[i]->mime, "video/MP2T"));
+    }
+
+    const struct hls_storage_config manifest_config = {
+        .name = "index.m3u8",
+        .mime = "application/vnd.apple.mpegurl",
+    };
+    char *bytes = malloc(16);
+    assert(bytes != NULL);
+    memset(bytes, 'z', 16);
+
+    const vlc_tick_t start = vlc_tick_now();
+    hls_storage_t *manifest =
+        hls_storage_FromBytes(bytes, 16, &manifest_config, &config);
+    assert(vlc_tick_now() - start < WRITE_DELAY);
+    assert(manifest != NULL);
+
+    /* The pending content is served from memory */
+    for (unsigned i = 0; i < SEGMENTS; ++i)
+        check_content(segments[i], 'a' + i, SEGMENT_SIZE);
+    check_content(manifest, 'z', 16);
+
+    /* Storages released before being written are still written */
+    for (unsigned i = 0; i < SEGMENTS; ++i)
+        hls_storage_Destroy(segments[i]);
+    hls_storage_Destroy(manifest);
+
+    hls_storage_writer_Delete(config.writer);
+    atomic_store(&write_delay, 0);
+
+    for (unsigned i = 0; i < SEGMENTS; ++i)
+        check_file(dir, names[i], 'a' + i, SEGMENT_SIZE);
+    check_file(dir, "index.m3u8", 'z', 16);
+}
+
+static void test_sync(const char *dir)
+{
+    const struct hls_config config = {
+        .outdir = (char *)dir,
+    };
+    const struct hls_storage_config storage_config = {
+        .name = "segment.ts",
+        .mime = "video/MP2T",
+    };
+
+    /* Without a writer, the storage is written in place */
+    hls_storage_t *storage =
+        hls_storage_FromBlocks(make_segment(0), &storage_config, &config);
+    assert(storage != NULL);
+    hls_storage_Destroy(storage);
+
+    /* And replaces the previous file */
+    storage = hls_storage_FromBlocks(make_segment(1), &storage_config, &config);
+    assert(storage != NULL);
+    check_content(storage, 'b', SEGMENT_SIZE);
+    hls_storage_Destroy(storage);
+
+    check_file(dir, "segment.ts", 'b', SEGMENT_SIZE);
+}
+
+int main(void)
+{
+    test_init();
+
+    char dir[] = "/tmp/vlc-hls-storage-XXXXXX";
+    if (mkdtemp(dir) == NULL)
+        return 77;
+
+    test_async(dir);
+    test_sync(dir);
+
+    rmdir(dir);
+    return 0;
+}
@@ -0,0 +1,175 @@
+/*****************************************************************************
+ * swscale.c: slice-threaded scaling benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <vlc_common.h>
+
+#include <vlc_filter.h>
+#include <vlc_picture.h>
+
+#include "../../libvlc/test.h"
+#include "../lib/libvlc_internal.h"
+
+#define FRAMES 16
+
+static const struct
+{
+    vlc_fourcc_t src;
+    vlc_fourcc_t dst;
+    unsigned src_width, src_height;
+    unsigned dst_width, dst_height;
+} scenarios[] = {
+    { VLC_CODEC_I420,     VLC_CODEC_I420, 3840, 2160, 1920, 1080 },
+    { VLC_CODEC_NV12,     VLC_CODEC_I420, 3840, 2160, 1920, 1080 },
+    { VLC_CODEC_I420_10L, VLC_CODEC_I420, 3840, 2160, 1920, 1080 },
+    { VLC_CODEC_I420,     VLC_CODEC_RGBA, 3840, 2160, 1920, 1080 },
+    { VLC_CODEC_I420,     VLC_CODEC_I420, 1920, 1080, 3840, 2160 },
+    { VLC_CODEC_NV12,     VLC_CODEC_I420, 1920, 1080, 3840, 2160 },
+    { VLC_CODEC_I420,     VLC_CODEC_RGBA, 1920, 1080, 3840, 2160 },
+};
+
+static filter_t *CreateScaler(vlc_object_t *parent, size_t i, int threads)
+{
+    filter_t *filter = vlc_object_create(parent, sizeof (*filter));
+    assert(filter != NULL);
+
+    var_Create(filter, "swscale-threads", VLC_VAR_INTEGER);
+    var_SetInteger(filter, "swscale-threads", threads);
+
+    es_format_Init(&filter->fmt_in, VIDEO_ES, scenarios[i].src);
+    video_format_Setup(&filter->fmt_in.video, scenarios[i].src,
+                       scenarios[i].src_width, scenarios[i].src_height,
+                       scenarios[i].src_width, scenarios[i].src_height, 1, 1);
+    es_format_Init(&filter->fmt_out, VIDEO_ES, scenarios[i].dst);
+    video_format_Setup(&filter->fmt_out.video, scenarios[i].dst,
+                       scenarios[i].dst_width, scenarios[i].dst_height,
+                       scenarios[i].dst_width, scenarios[i].dst_height, 1, 1);
+
+    if (vlc_filter_LoadModule(filter, "video converter", "swscale",
+                              true) == NULL)
+    {
+        es_format_Clean(&filter->fmt_in);
+        es_format_Clean(&filter->fmt_out);
+        vlc_object_delete(filter);
+        return NULL;
+    }
+    return filter;
+}
+
+static picture_t *CreateSource(size_t i)
+{
+    video_format_t fmt;
+
+    video_format_Setup(&fmt, scenarios[i].src,
+                       scenarios[i].src_width, scenarios[i].src_height,
+                       scenarios[i].src_width, scenarios[i].src_height, 1, 1);
+
+    picture_t *pic = picture_NewFromFormat(&fmt);
+    assert(pic != NULL);
+
+    /* Diagonal gradient, so that the bands do not all look alike */
+    for (int p = 0; p < pic->i_planes; p++)
+        for (int y = 0; y < pic->p[p].i_lines; y++)
+            for (int x = 0; x < pic->p[p].i_pitch; x++)
+                pic->p[p].p_pixels[y * pic->p[p].i_pitch + x] = x + y + 64 * p;
+    return pic;
+}
+
+/* Returns the output of the last conversion */
+static picture_t *Run(vlc_object_t *parent, size_t i, int threads,
+                      picture_t *src)
+{
+    filter_t *filter = CreateScaler(parent, i, threads);
+    if (filter == NULL)
+        return NULL;
+
+    picture_t *out = NULL;
+    vlc_tick_t start = vlc_tick_now();
+
+    for (unsigned frame = 0; frame < FRAMES; frame++)
+    {
+        if (out != NULL)
+            picture_Release(out);
+        out = filter->ops->filter_video(filter, picture_Hold(src));
+        assert(out != NULL);
+    }
+
+    vlc_tick_t elapsed = vlc_tick_now() - start;
+
+    printf("%4.4s %ux%u -> %4.4s %ux%u, %s: %.1f frames/s\n",
+           (const char *)&scenarios[i].src,
+           scenarios[i].src_width, scenarios[i].src_height,
+           (const char *)&scenarios[i].dst,
+           scenarios[i].dst_width, scenarios[i].dst_height,
+           threads == 1 ? "1 thread " : "threaded",
+           FRAMES / secf_from_vlc_tick(__MAX(elapsed, 1)));
+
+    vlc_filter_Delete(filter);
+    return out;
+}
+
+int main(void)
+{
+    test_init();
+
+    const char *const args[] = {
+        "-v",
+    };
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(args), args);
+    if (vlc == NULL)
+        return 1;
+
+    vlc_object_t *parent = VLC_OBJECT(vlc->p_libvlc_int);
+    int ret = 0;
+
+    for (size_t i = 0; i < ARRAY_SIZE(scenarios); i++)
+    {
+        picture_t *src = CreateSource(i);
+        picture_t *single = Run(parent, i, 1, src);
+        picture_t *threaded = Run(parent, i, 0, src);
+
+        if (single == NULL || threaded == NULL)
+        {
+            ret = 77; /* Module or conversion not available */
+            if (single != NULL)
+                picture_Release(single);
+            if (threaded != NULL)
+                picture_Release(threaded);
+        }
+        else
+        {
+            /* The bands must join without seams */
+            for (int p = 0; p < single->i_planes; p++)
+                for (int y = 0; y < single->p[p].i_visible_lines; y++)
+                    assert(!memcmp(
+                        &single->p[p].p_pixels[y * single->p[p].i_pitch],
+                        &threaded->p[p].p_pixels[y * threaded->p[p].i_pitch],
+                        single->p[p].i_visible_pitch));
+            picture_Release(single);
+            picture_Release(threaded);
+        }
+        picture_Release(src);
+    }
+
+    libvlc_release(vlc);
+    return ret;
+}
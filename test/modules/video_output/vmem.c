@@ -0,0 +1,222 @@
+/*****************************************************************************
+ * vmem.c: memory video output frame callbacks test
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+/* Define a builtin module for mocked parts */
+#define MODULE_NAME test_vmem
+#undef VLC_DYNAMIC_PLUGIN
+
+#include "../../libvlc/test.h"
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_filter.h>
+#include <vlc_subpicture.h>
+
+const char vlc_module_name[] = MODULE_STRING;
+
+#define WIDTH 64
+#define HEIGHT 48
+#define SPU_SIZE 16
+#define SPU_LUMA 0xEB
+/* More than the core keeps for filtering and blending */
+#define HELD_FRAMES 12
+
+/* Sub source drawing an opaque white square in the top left corner */
+static subpicture_t *SourceSub(filter_t *filter, vlc_tick_t date)
+{
+    subpicture_t *subpic = filter_NewSubpicture(filter);
+    if (subpic == NULL)
+        return NULL;
+
+    subpic->i_start = date;
+    subpic->i_stop = VLC_TICK_INVALID;
+    subpic->b_ephemer = true;
+
+    video_format_t fmt;
+    video_format_Init(&fmt, VLC_CODEC_YUVA);
+    video_format_Setup(&fmt, VLC_CODEC_YUVA, SPU_SIZE, SPU_SIZE,
+                       SPU_SIZE, SPU_SIZE, 1, 1);
+
+    subpicture_region_t *region = subpicture_region_New(&fmt);
+    video_format_Clean(&fmt);
+    if (region == NULL)
+    {
+        subpicture_Delete(subpic);
+        return NULL;
+    }
+
+    static const uint8_t values[] = { SPU_LUMA, 0x80, 0x80, 0xFF };
+    picture_t *pic = region->p_picture;
+    for (int i = 0; i < pic->i_planes; i++)
+        memset(pic->p[i].p_pixels, values[i],
+               pic->p[i].i_pitch * pic->p[i].i_lines);
+
+    region->i_align = SUBPICTURE_ALIGN_LEFT | SUBPICTURE_ALIGN_TOP;
+    region->b_absolute = true;
+    region->i_x = region->i_y = 0;
+    vlc_spu_regions_push(&subpic->regions, region);
+    return subpic;
+}
+
+static int OpenSub(filter_t *filter)
+{
+    static const struct vlc_filter_operations ops = {
+        .source_sub = SourceSub,
+    };
+    filter->ops = &ops;
+    return VLC_SUCCESS;
+}
+
+static picture_t *Convert(filter_t *filter, picture_t *pic)
+{
+    (void) filter;
+    picture_Release(pic);
+    return NULL;
+}
+
+/* The SPU core requires a converter scaling YUVA to RGBA, usually swscale.
+ * The square is blended as is, so it is never used. */
+static int OpenConverter(filter_t *filter)
+{
+    static const struct vlc_filter_operations ops = {
+        .filter_video = Convert,
+    };
+
+    if (filter->fmt_in.video.i_chroma != VLC_CODEC_YUVA ||
+        filter->fmt_out.video.i_chroma != VLC_CODEC_RGBA)
+        return VLC_EGENERIC;
+    filter->ops = &ops;
+    return VLC_SUCCESS;
+}
+
+vlc_module_begin()
+    set_callback_sub_source(OpenSub, 0)
+
+    add_submodule()
+        set_callback_video_converter(OpenConverter, 1)
+vlc_module_end()
+
+VLC_EXPORT const vlc_plugin_cb vlc_static_modules[] = {
+    VLC_SYMBOL(vlc_entry),
+    NULL
+};
+
+struct frames
+{
+    vlc_mutex_t lock;
+    vlc_sem_t full;
+    libvlc_video_frame_t *held[HELD_FRAMES];
+    size_t count;
+};
+
+static void OnFrame(void *opaque, libvlc_video_frame_t *frame,
+                    void *const *planes, const unsigned *pitches,
+                    const unsigned *lines)
+{
+    struct frames *frames = opaque;
+
+    assert(lines[0] >= HEIGHT);
+    assert(pitches[0] >= WIDTH);
+
+    /* Once shown, the subpicture is blended into every frame, and only in
+     * its own area */
+    const uint8_t *luma = planes[0];
+    bool blended = true;
+    for (unsigned y = 0; y < SPU_SIZE; y++)
+        for (unsigned x = 0; x < SPU_SIZE; x++)
+            blended &= abs(luma[y * pitches[0] + x] - SPU_LUMA) <= 1;
+    const uint8_t *last = &luma[(HEIGHT - 1) * pitches[0] + WIDTH - 1];
+    assert(*last == luma[(SPU_SIZE + 1) * pitches[0]]);
+
+    /* The mock frames go through every luma value: those of the square
+     * cannot tell */
+    if (abs(*last - SPU_LUMA) <= 1)
+    {
+        libvlc_video_frame_release(frame);
+        return;
+    }
+
+    vlc_mutex_lock(&frames->lock);
+    if (!blended)
+    {
+        assert(frames->count == 0);
+        vlc_mutex_unlock(&frames->lock);
+        libvlc_video_frame_release(frame);
+        return;
+    }
+
+    /* Keep the frames, as an application rendering them later would */
+    if (frames->count < HELD_FRAMES)
+    {
+        frames->held[frames->count++] = frame;
+        frame = NULL;
+        if (frames->count == HELD_FRAMES)
+            vlc_sem_post(&frames->full);
+    }
+    vlc_mutex_unlock(&frames->lock);
+
+    if (frame != NULL)
+        libvlc_video_frame_release(frame);
+}
+
+int main(void)
+{
+    test_init();
+
+    const char * const args[] = {
+        "-vvv", "--aout=dummy", "--text-renderer=dummy",
+        "--no-auto-preparse", "--sub-source=" MODULE_STRING,
+    };
+
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(args), args);
+    assert(vlc != NULL);
+
+    libvlc_media_t *media = libvlc_media_new_location(
+        "mock://video_track_count=1;length=100000000;"
+        "video_width=64;video_height=48");
+    assert(media != NULL);
+
+    libvlc_media_player_t *mp =
+        libvlc_media_player_new_from_media(vlc, media);
+    assert(mp != NULL);
+    libvlc_media_release(media);
+
+    struct frames frames = { .count = 0 };
+    vlc_mutex_init(&frames.lock);
+    vlc_sem_init(&frames.full, 0);
+
+    libvlc_video_set_frame_callbacks(mp, OnFrame, &frames);
+    libvlc_video_set_format(mp, "I420", WIDTH, HEIGHT, WIDTH);
+
+    libvlc_media_player_play(mp);
+    vlc_sem_wait(&frames.full);
+    libvlc_media_player_stop_async(mp);
+    libvlc_media_player_release(mp);
+
+    /* The frames outlive the player */
+    for (size_t i = 0; i < frames.count; i++)
+        libvlc_video_frame_release(frames.held[i]);
+
+    libvlc_release(vlc);
+    return 0;
+}
@@ -0,0 +1,171 @@
+/*****************************************************************************
+ * filters.c: audio filters pipeline allocation benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "../../libvlc/test.h"
+#include "../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_aout.h>
+#include <vlc_block.h>
+
+#include <stdatomic.h>
+
+#define FRAMES  1024
+#define WARMUP  64
+#define BLOCKS  1024
+
+#ifdef __GLIBC__
+/* Count the heap allocations of the whole process, including the modules */
+extern void *__libc_malloc(size_t);
+extern void *__libc_memalign(size_t, size_t);
+
+static atomic_bool counting;
+static atomic_ulong allocations;
+
+static void CountAllocation(void)
+{
+    if (atomic_load_explicit(&counting, memory_order_relaxed))
+        atomic_fetch_add_explicit(&allocations, 1, memory_order_relaxed);
+}
+
+void *malloc(size_t size)
+{
+    CountAllocation();
+    return __libc_malloc(size);
+}
+
+void *aligned_alloc(size_t align, size_t size)
+{
+    CountAllocation();
+    return __libc_memalign(align, size);
+}
+
+int posix_memalign(void **ptr, size_t align, size_t size)
+{
+    CountAllocation();
+    *ptr = __libc_memalign(align, size);
+    return *ptr != NULL ? 0 : ENOMEM;
+}
+#endif
+
+int main(void)
+{
+#ifndef __GLIBC__
+    return 77;
+#else
+    test_init();
+
+    /* s16 → fl32, equalizer, remap, 44.1 → 48 kHz */
+    static const char *const args[] = {
+        "-v",
+        "--ignore-config",
+        "--no-audio-time-stretch",
+        "--audio-filter=equalizer",
+        "--audio-resampler=ugly",
+    };
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(args), args);
+    assert(vlc != NULL);
+
+    vlc_object_t *obj = vlc_object_create(vlc->p_libvlc_int, sizeof (*obj));
+    assert(obj != NULL);
+    var_Create(obj, "visual", VLC_VAR_STRING);
+
+    audio_sample_format_t infmt = {
+        .i_format = VLC_CODEC_S16N,
+        .i_rate = 44100,
+        .i_physical_channels = AOUT_CHANS_STEREO,
+        .channel_type = AUDIO_CHANNEL_TYPE_BITMAP,
+    };
+    aout_FormatPrepare(&infmt);
+
+    audio_sample_format_t outfmt = infmt;
+    outfmt.i_format = VLC_CODEC_FL32;
+    outfmt.i_rate = 48000;
+    aout_FormatPrepare(&outfmt);
+
+    aout_filters_cfg_t cfg = AOUT_FILTERS_CFG_INIT;
+    cfg.remap[AOUT_CHANIDX_LEFT] = AOUT_CHANIDX_RIGHT;
+    cfg.remap[AOUT_CHANIDX_RIGHT] = AOUT_CHANIDX_LEFT;
+
+    aout_filters_t *filters = aout_FiltersNew(obj, &infmt, &outfmt, &cfg);
+    if (filters == NULL)
+    {
+        vlc_object_delete(obj);
+        libvlc_release(vlc);
+        return 77; /* Converters not built */
+    }
+
+    /* The input blocks come from the decoder, out of the measurement */
+    block_t *blocks[WARMUP + BLOCKS];
+    for (size_t i = 0; i < ARRAY_SIZE(blocks); i++)
+    {
+        block_t *block = block_Alloc(FRAMES * infmt.i_bytes_per_frame);
+        assert(block != NULL);
+
+        memset(block->p_buffer, 0, block->i_buffer);
+        block->i_nb_samples = FRAMES;
+        block->i_pts = block->i_dts = VLC_TICK_0
+            + vlc_tick_from_samples(i * FRAMES, infmt.i_rate);
+        block->i_length = vlc_tick_from_samples(FRAMES, infmt.i_rate);
+        blocks[i] = block;
+    }
+
+    unsigned long frames = 0;
+    vlc_tick_t start = 0;
+
+    for (size_t i = 0; i < ARRAY_SIZE(blocks); i++)
+    {
+        if (i == WARMUP)
+        {
+            start = vlc_tick_now();
+            atomic_store(&counting, true);
+        }
+
+        block_t *out = aout_FiltersPlay(filters, blocks[i], 1.f);
+        if (out != NULL)
+        {
+            if (i >= WARMUP)
+                frames += out->i_nb_samples;
+            block_Release(out);
+        }
+    }
+
+    atomic_store(&counting, false);
+    vlc_tick_t elapsed = vlc_tick_now() - start;
+    unsigned long count = atomic_load(&allocations);
+
+    printf("%d blocks of %d frames: %lu allocations (%.2f per block), "
+           "%lu frames out, %.0f frames/s\n", BLOCKS, FRAMES, count,
+           (double)count / BLOCKS, frames,
+           frames / secf_from_vlc_tick(__MAX(elapsed, 1)));
+
+    /* The output blocks are recycled once the pipeline is warm */
+    assert(count < BLOCKS);
+
+    aout_FiltersDelete(obj, filters);
+    vlc_object_delete(obj);
+    libvlc_release(vlc);
+    return 0;
+#endif
+}
@@ -0,0 +1,361 @@
+/*****************************************************************************
+ * demux_probe.c: demuxer probing test and benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+/* Define a builtin module for mocked parts */
+#define MODULE_NAME test_demux_probe
+#undef VLC_DYNAMIC_PLUGIN
+
+#include "../../libvlc/test.h"
+#include "../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_demux.h>
+#include <vlc_es_out.h>
+#include <vlc_fs.h>
+#include <vlc_modules.h>
+#include <vlc_stream.h>
+#include <vlc_url.h>
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+const char vlc_module_name[] = MODULE_STRING;
+
+#define FILES 10000 /* with VLC_BENCH set */
+
+/* Calls to the demuxer below, tried before any other one when probing */
+static unsigned probes;
+
+static int OpenDemux(vlc_object_t *obj)
+{
+    (void) obj;
+    probes++;
+    return VLC_EGENERIC;
+}
+
+vlc_module_begin()
+    set_capability("demux", INT_MAX)
+    set_callback(OpenDemux)
+vlc_module_end()
+
+VLC_EXPORT const vlc_plugin_cb vlc_static_modules[] = {
+    VLC_SYMBOL(vlc_entry),
+    NULL
+};
+
+#define WAVE_FORMAT_PCM        0x0001
+#define WAVE_FORMAT_IEEE_FLOAT 0x0003
+
+static void WriteWav(const char *path, uint16_t tag, size_t samples)
+{
+    const uint16_t bits = tag == WAVE_FORMAT_PCM ? 16 : 32;
+    const uint32_t size = samples * (bits / 8);
+    uint8_t header[44];
+
+    memcpy(&header[0], "RIFF", 4);
+    SetDWLE(&header[4], 36 + size);
+    memcpy(&header[8], "WAVEfmt ", 8);
+    SetDWLE(&header[16], 16);
+    SetWLE(&header[20], tag);
+    SetWLE(&header[22], 1); /* channels */
+    SetDWLE(&header[24], 8000); /* rate */
+    SetDWLE(&header[28], 8000 * (bits / 8));
+    SetWLE(&header[32], bits / 8);
+    SetWLE(&header[34], bits);
+    memcpy(&header[36], "data", 4);
+    SetDWLE(&header[40], size);
+
+    FILE *f = vlc_fopen(path, "wb");
+    assert(f != NULL);
+    fwrite(header, sizeof (header), 1, f);
+    for (size_t i = 0; i < size; i++)
+        fputc(0, f);
+    fclose(f);
+}
+
+static void WriteTs(const char *path)
+{
+    uint8_t packet[188];
+
+    /* Null packets */
+    memset(packet, 0xFF, sizeof (packet));
+    packet[0] = 0x47;
+    packet[1] = 0x1F;
+    packet[2] = 0xFF;
+    packet[3] = 0x10;
+
+    FILE *f = vlc_fopen(path, "wb");
+    assert(f != NULL);
+    for (unsigned i = 0; i < 16; i++)
+        fwrite(packet, sizeof (packet), 1, f);
+    fclose(f);
+}
+
+static void WriteAu(const char *path)
+{
+    static const uint8_t header[] = {
+        '.', 's', 'n', 'd', 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x08, 0x00,
+        0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x1F, 0x40, 0x00, 0x00, 0x00, 0x01,
+    };
+
+    FILE *f = vlc_fopen(path, "wb");
+    assert(f != NULL);
+    fwrite(header, sizeof (header), 1, f);
+    for (size_t i = 0; i < 2048; i++)
+        fputc(0, f);
+    fclose(f);
+}
+
+static void WritePs(const char *path)
+{
+    static const uint8_t pack[] = {
+        0x00, 0x00, 0x01, 0xBA, 0x44, 0x00, 0x04, 0x00, 0x04, 0x01,
+        0x01, 0x89, 0xC3, 0xF8,
+    };
+    static const uint8_t end[] = { 0x00, 0x00, 0x01, 0xB9 };
+
+    FILE *f = vlc_fopen(path, "wb");
+    assert(f != NULL);
+    for (unsigned i = 0; i < 16; i++)
+        fwrite(pack, sizeof (pack), 1, f);
+    fwrite(end, sizeof (end), 1, f);
+    fclose(f);
+}
+
+static void WritePcm(const char *path)
+{
+    WriteWav(path, WAVE_FORMAT_PCM, 1024);
+}
+
+/* Short clips of a few formats, one with no signature known to the core */
+static const struct
+{
+    const char *ext;
+    void (*write)(const char *);
+} formats[] = {
+    { "wav", WritePcm },
+    { "au",  WriteAu  },
+    { "ts",  WriteTs  },
+    { "mpg", WritePs  },
+};
+
+static es_out_id_t *EsOutAdd(es_out_t *out, input_source_t *in,
+                             const es_format_t *fmt)
+{
+    (void) out; (void) in; (void) fmt;
+    return malloc(1);
+}
+
+static int EsOutSend(es_out_t *out, es_out_id_t *id, block_t *block)
+{
+    (void) out; (void) id;
+    block_Release(block);
+    return VLC_SUCCESS;
+}
+
+static void EsOutDel(es_out_t *out, es_out_id_t *id)
+{
+    (void) out;
+    free(id);
+}
+
+static int EsOutControl(es_out_t *out, input_source_t *in, int query,
+                        va_list args)
+{
+    (void) out; (void) in; (void) query; (void) args;
+    return VLC_EGENERIC;
+}
+
+static const struct es_out_callbacks es_out_cbs = {
+    .add = EsOutAdd,
+    .send = EsOutSend,
+    .del = EsOutDel,
+    .control = EsOutControl,
+};
+
+/* Opens the file, and checks the demuxer chosen, and whether the demuxers
+ * were probed one by one or the choice was made upfront */
+static void CheckOpen(vlc_object_t *parent, const char *path,
+                      const char *expected, bool probed)
+{
+    es_out_t out = { .cbs = &es_out_cbs };
+    char *url = vlc_path2uri(path, NULL);
+    assert(url != NULL);
+
+    stream_t *s = vlc_stream_NewURL(parent, url);
+    assert(s != NULL);
+
+    unsigned before = probes;
+    demux_t *demux = demux_New(parent, "any", url, s, &out);
+    assert(demux != NULL);
+
+    char *name = var_GetString(demux, "module-name");
+    assert(name != NULL);
+    test_log("%s: %s\n", path, name);
+    assert(strcmp(name, expected) == 0);
+    assert((probes != before) == probed);
+
+    free(name);
+    demux_Delete(demux);
+    free(url);
+}
+
+static vlc_tick_t Open(vlc_object_t *parent, const char *url, bool *opened)
+{
+    es_out_t out = { .cbs = &es_out_cbs };
+    vlc_tick_t start = vlc_tick_now();
+    stream_t *s = vlc_stream_NewURL(parent, url);
+
+    *opened = false;
+    if (s == NULL)
+        return vlc_tick_now() - start;
+
+    demux_t *demux = demux_New(parent, "any", url, s, &out);
+    vlc_tick_t elapsed = vlc_tick_now() - start;
+
+    if (demux != NULL)
+    {
+        demux_Delete(demux);
+        *opened = true;
+    }
+    else
+        vlc_stream_Delete(s);
+    return elapsed;
+}
+
+/* Each clip is opened twice in a row, as when it is preparsed then played:
+ * the first open probes the demuxers, the second one finds the demuxer in
+ * the cache. */
+static void Bench(vlc_object_t *parent, const char *dir)
+{
+    char **paths = malloc(FILES * sizeof (*paths));
+    char **urls = malloc(FILES * sizeof (*urls));
+    assert(paths != NULL && urls != NULL);
+
+    for (unsigned i = 0; i < FILES; i++)
+    {
+        size_t fmt = i % ARRAY_SIZE(formats);
+        int ret = asprintf(&paths[i], "%s/clip%05u.%s", dir, i,
+                           formats[fmt].ext);
+        assert(ret >= 0);
+        formats[fmt].write(paths[i]);
+
+        urls[i] = vlc_path2uri(paths[i], NULL);
+        assert(urls[i] != NULL);
+    }
+
+    vlc_tick_t cold = 0, cached = 0;
+    unsigned opened = 0;
+
+    for (unsigned i = 0; i < FILES; i++)
+    {
+        bool ok, ok_again;
+
+        cold += Open(parent, urls[i], &ok);
+        cached += Open(parent, urls[i], &ok_again);
+        assert(ok == ok_again);
+        opened += ok;
+    }
+
+    test_log("%u/%u files opened\n", opened, FILES);
+    test_log("cold probe: %.1f us per file\n",
+             (double)US_FROM_VLC_TICK(cold) / FILES);
+    test_log("cached probe: %.1f us per file\n",
+             (double)US_FROM_VLC_TICK(cached) / FILES);
+
+    for (unsigned i = 0; i < FILES; i++)
+    {
+        vlc_unlink(paths[i]);
+        free(paths[i]);
+        free(urls[i]);
+    }
+    free(paths);
+    free(urls);
+}
+
+int main(void)
+{
+    test_init();
+
+    char dir[] = "/tmp/vlc-demux-probe-XXXXXX";
+    if (mkdtemp(dir) == NULL)
+        return 77;
+
+    /* No file extension, to probe by content only */
+    char *pcm, *fl32, *ts;
+    if (asprintf(&pcm, "%s/pcm", dir) < 0
+     || asprintf(&fl32, "%s/fl32", dir) < 0
+     || asprintf(&ts, "%s/ts", dir) < 0)
+        abort();
+
+    WriteWav(pcm, WAVE_FORMAT_PCM, 1024);
+    WriteWav(fl32, WAVE_FORMAT_IEEE_FLOAT, 1024);
+    WriteTs(ts);
+
+    const char *const args[] = {
+        "-v",
+    };
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(args), args);
+    assert(vlc != NULL);
+
+    int ret = 77; /* Demuxers not available */
+    if (module_exists("wav") && module_exists("es"))
+    {
+        vlc_object_t *parent = VLC_OBJECT(vlc->p_libvlc_int);
+
+        /* PCM WAVE may hide DTS or A/52 for the ES demuxer, so the demuxers
+         * are all probed */
+        CheckOpen(parent, pcm, "wav", true);
+        /* The second time, the demuxer found before is used right away */
+        CheckOpen(parent, pcm, "wav", false);
+
+        /* The same URL with another content is probed again */
+        WriteWav(pcm, WAVE_FORMAT_PCM, 2048);
+        CheckOpen(parent, pcm, "wav", true);
+
+        /* Other WAVE formats are for the WAV demuxer only */
+        CheckOpen(parent, fl32, "wav", false);
+
+        if (module_exists("ts"))
+            CheckOpen(parent, ts, "ts", false);
+
+        /* Timed opens of many small files of mixed formats */
+        if (getenv("VLC_BENCH") != NULL)
+            Bench(parent, dir);
+        ret = 0;
+    }
+    libvlc_release(vlc);
+
+    vlc_unlink(pcm);
+    vlc_unlink(fl32);
+    vlc_unlink(ts);
+    free(pcm);
+    free(fl32);
+    free(ts);
+    rmdir(dir);
+    return ret;
+}
@@ -0,0 +1,212 @@
+/*****************************************************************************
+ * warm_programs.c: test switching to a program kept warm
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+/* Define a builtin module for mocked parts */
+#define MODULE_NAME test_warm_programs
+#undef VLC_DYNAMIC_PLUGIN
+
+#include "../../libvlc/test.h"
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_codec.h>
+
+#include <limits.h>
+
+const char vlc_module_name[] = MODULE_STRING;
+
+/* Default frame rate of the mock demux */
+#define FRAME_LENGTH VLC_TICK_FROM_MS(40)
+#define GOP_FRAMES 10
+#define PROGRAM_COUNT 3
+
+static struct
+{
+    vlc_mutex_t lock;
+    vlc_cond_t wait;
+
+    unsigned frames; /* received by the decoders */
+    int target; /* program to switch to, -1 before the switch */
+
+    /* blocks received by the decoder of the target program, until the first
+     * one that is not prerolled */
+    unsigned replayed;
+    int first_flags;
+    vlc_tick_t last_pts;
+    bool contiguous;
+    bool live;
+} state;
+
+static bool IsKeyFrame(vlc_tick_t pts)
+{
+    return (pts - VLC_TICK_0) / FRAME_LENGTH % GOP_FRAMES == 0;
+}
+
+/* Packetizer of the warm programs, with a key frame every GOP_FRAMES */
+static block_t *Packetize(decoder_t *dec, block_t **pp_block)
+{
+    (void) dec;
+    if (pp_block == NULL || *pp_block == NULL)
+        return NULL;
+
+    block_t *block = *pp_block;
+    *pp_block = NULL;
+    if (IsKeyFrame(block->i_pts))
+        block->i_flags |= BLOCK_FLAG_TYPE_I;
+    return block;
+}
+
+static int OpenPacketizer(vlc_object_t *obj)
+{
+    decoder_t *dec = (decoder_t *)obj;
+
+    if (dec->fmt_in->i_cat != VIDEO_ES)
+        return VLC_EGENERIC;
+
+    dec->pf_packetize = Packetize;
+    es_format_Clean(&dec->fmt_out);
+    es_format_Copy(&dec->fmt_out, dec->fmt_in);
+    return VLC_SUCCESS;
+}
+
+static int Decode(decoder_t *dec, block_t *block)
+{
+    if (block == NULL)
+        return VLCDEC_SUCCESS;
+
+    vlc_mutex_lock(&state.lock);
+    state.frames++;
+    if (dec->fmt_in->i_group == state.target && !state.live)
+    {
+        if (state.replayed == 0)
+            state.first_flags = block->i_flags;
+        else if (block->i_pts != state.last_pts + FRAME_LENGTH)
+            state.contiguous = false;
+
+        state.last_pts = block->i_pts;
+        if (block->i_flags & BLOCK_FLAG_PREROLL)
+            state.replayed++;
+        else
+            state.live = true;
+    }
+    vlc_cond_broadcast(&state.wait);
+    vlc_mutex_unlock(&state.lock);
+
+    block_Release(block);
+    return VLCDEC_SUCCESS;
+}
+
+static int OpenDecoder(vlc_object_t *obj)
+{
+    decoder_t *dec = (decoder_t *)obj;
+
+    if (dec->fmt_in->i_cat != VIDEO_ES)
+        return VLC_EGENERIC;
+
+    dec->pf_decode = Decode;
+    es_format_Clean(&dec->fmt_out);
+    es_format_Copy(&dec->fmt_out, dec->fmt_in);
+    return VLC_SUCCESS;
+}
+
+vlc_module_begin()
+    set_callback(OpenDecoder)
+    set_capability("video decoder", INT_MAX)
+
+    add_submodule()
+        set_callback(OpenPacketizer)
+        set_capability("packetizer", INT_MAX)
+vlc_module_end()
+
+VLC_EXPORT const vlc_plugin_cb vlc_static_modules[] = {
+    VLC_SYMBOL(vlc_entry),
+    NULL
+};
+
+int main(void)
+{
+    test_init();
+
+    vlc_mutex_init(&state.lock);
+    vlc_cond_init(&state.wait);
+    state.target = -1;
+    state.contiguous = true;
+
+    /* All the other programs are kept warm */
+    const char * const args[] = {
+        "-vvv", "--aout=dummy", "--vout=dummy", "--no-auto-preparse",
+        "--warm-programs=4",
+    };
+
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(args), args);
+    assert(vlc != NULL);
+
+    char location[] = "mock://video_track_count=1;program_count=x;"
+                      "can_control_pace=false;length=100000000";
+    *strchr(location, 'x') = '0' + PROGRAM_COUNT;
+
+    libvlc_media_t *media = libvlc_media_new_location(location);
+    assert(media != NULL);
+
+    libvlc_media_player_t *mp =
+        libvlc_media_player_new_from_media(vlc, media);
+    assert(mp != NULL);
+    libvlc_media_release(media);
+
+    libvlc_media_player_play(mp);
+
+    /* Let the warm programs gather a GOP, and more */
+    vlc_mutex_lock(&state.lock);
+    while (state.frames < GOP_FRAMES * 3 / 2)
+        vlc_cond_wait(&state.wait, &state.lock);
+    vlc_mutex_unlock(&state.lock);
+
+    libvlc_player_program_t *program =
+        libvlc_media_player_get_selected_program(mp);
+    assert(program != NULL);
+    const int target = program->i_group_id == 1 ? 2 : 1;
+    libvlc_player_program_delete(program);
+
+    vlc_mutex_lock(&state.lock);
+    state.target = target;
+    vlc_mutex_unlock(&state.lock);
+
+    libvlc_media_player_select_program_id(mp, target);
+
+    vlc_mutex_lock(&state.lock);
+    while (!state.live)
+        vlc_cond_wait(&state.wait, &state.lock);
+
+    /* The new decoder starts from the last key frame, without waiting for
+     * the next one, and gets every frame from there */
+    assert(state.replayed > 0);
+    assert(state.first_flags & BLOCK_FLAG_TYPE_I);
+    assert(state.first_flags & BLOCK_FLAG_PREROLL);
+    assert(state.contiguous);
+    vlc_mutex_unlock(&state.lock);
+
+    libvlc_media_player_stop_async(mp);
+    libvlc_media_player_release(mp);
+    libvlc_release(vlc);
+    return 0;
+}
@@ -0,0 +1,294 @@
+/*****************************************************************************
+ * cpu.c: CPU budget test and concurrent decoding benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "../../libvlc/test.h"
+
+#include <vlc_common.h>
+#include <vlc_cpu.h>
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define STREAMS 16
+#define OPENS   64 /* codecs opened per thread */
+#define FRAMES  64 /* with VLC_BENCH set */
+#define WORK    (1 << 21) /* iterations per frame */
+
+static void test_shares(void)
+{
+    unsigned cores = vlc_GetCPUCount();
+    struct vlc_cpu_share *shares[STREAMS];
+
+    /* A single codec gets all the cores, within its own limit */
+    shares[0] = vlc_cpu_share_Join(0);
+    assert(shares[0] != NULL);
+    assert(vlc_cpu_share_Threads(shares[0]) == cores);
+    vlc_cpu_share_Leave(shares[0]);
+
+    shares[0] = vlc_cpu_share_Join(1);
+    assert(shares[0] != NULL);
+    assert(vlc_cpu_share_Threads(shares[0]) == 1);
+
+    /* The cores left by the capped share are divided between the others */
+    for (unsigned i = 1; i < STREAMS; i++)
+    {
+        shares[i] = vlc_cpu_share_Join(0);
+        assert(shares[i] != NULL);
+
+        unsigned total = 0, min = UINT_MAX, max = 0;
+        for (unsigned j = 0; j <= i; j++)
+        {
+            unsigned threads = vlc_cpu_share_Threads(shares[j]);
+
+            assert(threads >= 1);
+            total += threads;
+            if (j > 0)
+            {
+                min = __MIN(min, threads);
+                max = __MAX(max, threads);
+            }
+        }
+        assert(max - min <= 1);
+        assert(total <= __MAX(cores, i + 1));
+        if (cores > i + 1)
+            assert(total == cores);
+    }
+
+    /* Leaving codecs give their cores back */
+    for (unsigned i = STREAMS - 1; i > 1; i--)
+        vlc_cpu_share_Leave(shares[i]);
+    assert(vlc_cpu_share_Threads(shares[1]) == __MAX(cores - 1, 1u));
+    vlc_cpu_share_Leave(shares[1]);
+    vlc_cpu_share_Leave(shares[0]);
+    vlc_cpu_share_Leave(NULL);
+}
+
+/*
+ * The codecs join the budget and read their thread count once, when they
+ * open: a codec keeps the count it read, even when later codecs rebalance
+ * the shares.
+ */
+static void test_open(void)
+{
+    unsigned cores = vlc_GetCPUCount();
+    struct vlc_cpu_share *shares[STREAMS];
+    unsigned opened[STREAMS];
+
+    for (unsigned i = 0; i < STREAMS; i++)
+    {
+        shares[i] = vlc_cpu_share_Join(0);
+        assert(shares[i] != NULL);
+        opened[i] = vlc_cpu_share_Threads(shares[i]);
+
+        /* The last codec gets the even share, without the remainder */
+        assert(opened[i] == __MAX(cores / (i + 1), 1u));
+        /* and never more than the codecs opened before it */
+        if (i > 0)
+            assert(opened[i] <= opened[i - 1]);
+    }
+
+    /* A capped codec takes its maximum, the others divide the rest */
+    struct vlc_cpu_share *capped = vlc_cpu_share_Join(1);
+    assert(capped != NULL);
+    assert(vlc_cpu_share_Threads(capped) == 1);
+    vlc_cpu_share_Leave(capped);
+
+    /* The codecs opened after others closed get the freed cores */
+    for (unsigned i = 1; i < STREAMS; i++)
+        vlc_cpu_share_Leave(shares[i]);
+
+    struct vlc_cpu_share *share = vlc_cpu_share_Join(0);
+    assert(share != NULL);
+    assert(vlc_cpu_share_Threads(share) == __MAX(cores / 2, 1u));
+    vlc_cpu_share_Leave(share);
+    vlc_cpu_share_Leave(shares[0]);
+
+    /* Nothing left behind: a new codec gets all the cores again */
+    share = vlc_cpu_share_Join(0);
+    assert(share != NULL);
+    assert(vlc_cpu_share_Threads(share) == cores);
+    vlc_cpu_share_Leave(share);
+}
+
+/* Codecs opening and closing from their own decoder threads */
+struct opener
+{
+    vlc_thread_t thread;
+    vlc_sem_t *start;
+    unsigned cores;
+};
+
+static void *Open(void *data)
+{
+    struct opener *opener = data;
+
+    vlc_sem_wait(opener->start);
+    for (unsigned i = 0; i < OPENS; i++)
+    {
+        struct vlc_cpu_share *share = vlc_cpu_share_Join(0);
+        assert(share != NULL);
+
+        unsigned threads = vlc_cpu_share_Threads(share);
+        assert(threads >= 1 && threads <= opener->cores);
+        vlc_cpu_share_Leave(share);
+    }
+    return NULL;
+}
+
+static void test_concurrent_open(void)
+{
+    struct opener openers[STREAMS];
+    vlc_sem_t start;
+
+    vlc_sem_init(&start, 0);
+    for (unsigned i = 0; i < STREAMS; i++)
+    {
+        openers[i].start = &start;
+        openers[i].cores = vlc_GetCPUCount();
+        if (vlc_clone(&openers[i].thread, Open, &openers[i]))
+            abort();
+    }
+    for (unsigned i = 0; i < STREAMS; i++)
+        vlc_sem_post(&start);
+    for (unsigned i = 0; i < STREAMS; i++)
+        vlc_join(openers[i].thread, NULL);
+
+    struct vlc_cpu_share *share = vlc_cpu_share_Join(0);
+    assert(share != NULL);
+    assert(vlc_cpu_share_Threads(share) == vlc_GetCPUCount());
+    vlc_cpu_share_Leave(share);
+}
+
+/*
+ * Each stream mimics a slice-threaded decoder: the frames are split between
+ * the threads of the stream, which wait for each other at the end of every
+ * frame. A preempted thread delays the whole frame.
+ */
+struct stream
+{
+    vlc_mutex_t lock;
+    vlc_cond_t wait;
+    unsigned threads;
+    unsigned frame;
+    unsigned pending;
+    vlc_thread_t *workers;
+};
+
+static void *Worker(void *data)
+{
+    struct stream *stream = data;
+    unsigned iterations = WORK / stream->threads;
+    volatile unsigned state = 1;
+
+    for (unsigned frame = 0; frame < FRAMES; frame++)
+    {
+        for (unsigned i = 0; i < iterations; i++)
+            state = state * 1664525 + 1013904223;
+
+        vlc_mutex_lock(&stream->lock);
+        if (--stream->pending == 0)
+        {
+            stream->frame++;
+            stream->pending = stream->threads;
+            vlc_cond_broadcast(&stream->wait);
+        }
+        else
+            while (stream->frame == frame)
+                vlc_cond_wait(&stream->wait, &stream->lock);
+        vlc_mutex_unlock(&stream->lock);
+    }
+    return NULL;
+}
+
+static void Decode(unsigned count, bool budget)
+{
+    struct stream streams[STREAMS];
+    struct vlc_cpu_share *shares[STREAMS];
+    unsigned total = 0;
+
+    /* The streams size their pool when they open, one after the other */
+    for (unsigned i = 0; i < count; i++)
+    {
+        struct stream *stream = &streams[i];
+
+        shares[i] = budget ? vlc_cpu_share_Join(0) : NULL;
+        assert(!budget || shares[i] != NULL);
+        stream->threads = budget ? vlc_cpu_share_Threads(shares[i])
+                                 : vlc_GetCPUCount();
+        total += stream->threads;
+    }
+
+    vlc_tick_t start = vlc_tick_now();
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        struct stream *stream = &streams[i];
+
+        vlc_mutex_init(&stream->lock);
+        vlc_cond_init(&stream->wait);
+        stream->frame = 0;
+        stream->pending = stream->threads;
+        stream->workers = malloc(stream->threads * sizeof (vlc_thread_t));
+        assert(stream->workers != NULL);
+
+        for (unsigned j = 0; j < stream->threads; j++)
+            if (vlc_clone(&stream->workers[j], Worker, stream))
+                abort();
+    }
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        for (unsigned j = 0; j < streams[i].threads; j++)
+            vlc_join(streams[i].workers[j], NULL);
+        free(streams[i].workers);
+        vlc_cpu_share_Leave(shares[i]);
+    }
+
+    vlc_tick_t elapsed = vlc_tick_now() - start;
+    double fps = count * FRAMES / secf_from_vlc_tick(__MAX(elapsed, 1));
+
+    test_log("%2u streams, %s: %4u threads, %.1f frames/s\n", count,
+             budget ? "budget" : "no budget", total, fps);
+}
+
+int main(void)
+{
+    test_init();
+    test_shares();
+    test_open();
+    test_concurrent_open();
+
+    /* Aggregate frame rate of N concurrent decodes, with and without the
+     * budget: run with VLC_TEST_TIMEOUT=0 on small machines */
+    if (getenv("VLC_BENCH") != NULL)
+    {
+        for (unsigned count = 1; count <= STREAMS; count *= 2)
+        {
+            Decode(count, false);
+            Decode(count, true);
+        }
+    }
+    return 0;
+}
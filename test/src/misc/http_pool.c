@@ -0,0 +1,96 @@
+/*****************************************************************************
+ * http_pool.c: test the idle HTTP connections of the instance
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+#include <vlc/vlc.h>
+
+#include "../../libvlc/test.h"
+#include "../../../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_http.h>
+
+#include <assert.h>
+
+#define CONNS 8
+
+static unsigned released[CONNS];
+
+static void Release(void *data)
+{
+    released[(uintptr_t)data]++;
+}
+
+static void *Conn(unsigned i)
+{
+    return (void *)(uintptr_t)i;
+}
+
+int main(void)
+{
+    test_init();
+
+    libvlc_instance_t *vlc = libvlc_new(0, NULL);
+    assert(vlc != NULL);
+    vlc_object_t *obj = VLC_OBJECT(vlc->p_libvlc_int);
+
+    libvlc_instance_t *other = libvlc_new(0, NULL);
+    assert(other != NULL);
+    vlc_object_t *other_obj = VLC_OBJECT(other->p_libvlc_int);
+
+    /* Connections only match their key, within their instance */
+    assert(vlc_http_pool_take(obj, "http://a:80") == NULL);
+    assert(vlc_http_pool_put(obj, "http://a:80", Conn(0), Release) == 0);
+    assert(vlc_http_pool_put(obj, "http://a:80", Conn(1), Release) == 0);
+    assert(vlc_http_pool_take(obj, "http://b:80") == NULL);
+    assert(vlc_http_pool_take(other_obj, "http://a:80") == NULL);
+    assert(vlc_http_pool_take(obj, "http://a:80") == Conn(1));
+    assert(vlc_http_pool_take(obj, "http://a:80") == Conn(0));
+    assert(vlc_http_pool_take(obj, "http://a:80") == NULL);
+    assert(released[0] == 0 && released[1] == 0);
+
+    /* The oldest connections are evicted beyond the limit */
+    for (unsigned i = 0; i < CONNS; i++)
+    {
+        char key[16];
+
+        snprintf(key, sizeof (key), "http://%u:80", i);
+        assert(vlc_http_pool_put(obj, key, Conn(i), Release) == 0);
+    }
+    assert(released[0] == 1);
+    assert(vlc_http_pool_take(obj, "http://0:80") == NULL);
+    assert(vlc_http_pool_take(obj, "http://7:80") == Conn(7));
+    assert(vlc_http_pool_put(other_obj, "http://7:80", Conn(7),
+                             Release) == 0);
+
+    assert(released[1] == 1 && released[2] == 1 && released[3] == 0);
+
+    /* The remaining connections are released with their instance */
+    libvlc_release(vlc);
+    for (unsigned i = 0; i < CONNS - 1; i++)
+        assert(released[i] == 1);
+    assert(released[7] == 0);
+
+    libvlc_release(other);
+    assert(released[7] == 1);
+    return 0;
+}
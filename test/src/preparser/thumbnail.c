@@ -231,6 +231,112 @@ static void test_cancel_thumbnail( libvlc_instance_t* p_vlc )
     vlc_preparser_Delete( p_thumbnailer );
 }
 
+#define STORYBOARD_COUNT 10
+
+struct storyboard_ctx
+{
+    vlc_sem_t sem;
+    size_t count;
+};
+
+static void storyboard_callback( input_item_t *item, int status,
+                                 picture_t *const *thumbnails, size_t count,
+                                 void *data )
+{
+    (void) item;
+    struct storyboard_ctx *ctx = data;
+
+    assert( status == VLC_SUCCESS );
+    assert( count == STORYBOARD_COUNT );
+    for ( size_t i = 0; i < count; ++i )
+    {
+        assert( thumbnails[i] != NULL );
+        assert( thumbnails[i]->format.i_chroma == VLC_CODEC_ARGB );
+    }
+    ctx->count = count;
+    vlc_sem_post( &ctx->sem );
+}
+
+static void storyboard_single_callback( input_item_t *item, int status,
+                                        picture_t* thumbnail, void *data )
+{
+    (void) item;
+    assert( status == VLC_SUCCESS && thumbnail != NULL );
+
+    vlc_sem_t *sem = data;
+    vlc_sem_post( sem );
+}
+
+static void test_storyboard( libvlc_instance_t* p_vlc )
+{
+    const struct vlc_preparser_cfg cfg = {
+        .types = VLC_PREPARSER_TYPE_THUMBNAIL,
+        .timeout = VLC_TICK_INVALID,
+    };
+    vlc_preparser_t* p_thumbnailer = vlc_preparser_New(
+                VLC_OBJECT( p_vlc->p_libvlc_int ), &cfg );
+    assert( p_thumbnailer != NULL );
+
+    char* psz_mrl;
+    if ( asprintf( &psz_mrl, "mock://video_track_count=1;audio_track_count=1"
+                   ";length=%" PRId64 ";video_chroma=ARGB", MOCK_DURATION ) < 0 )
+        assert( !"Failed to allocate mock mrl" );
+    input_item_t* p_item = input_item_New( psz_mrl, "mock item" );
+    assert( p_item != NULL );
+
+    struct vlc_preparser_seek_arg seek_args[STORYBOARD_COUNT];
+    for ( size_t i = 0; i < STORYBOARD_COUNT; ++i )
+    {
+        seek_args[i].type = VLC_PREPARSER_SEEK_TIME;
+        seek_args[i].time = MOCK_DURATION * i / STORYBOARD_COUNT;
+        seek_args[i].speed = VLC_PREPARSER_SEEK_FAST;
+    }
+
+    /* One input thread per thumbnail */
+    vlc_sem_t sem;
+    vlc_sem_init( &sem, 0 );
+    static const struct vlc_thumbnailer_cbs single_cbs = {
+        .on_ended = storyboard_single_callback,
+    };
+
+    vlc_tick_t start = vlc_tick_now();
+    for ( size_t i = 0; i < STORYBOARD_COUNT; ++i )
+    {
+        vlc_preparser_req_id id =
+            vlc_preparser_GenerateThumbnail( p_thumbnailer, p_item,
+                                             &seek_args[i], &single_cbs, &sem );
+        assert( id != VLC_PREPARSER_REQ_ID_INVALID );
+        vlc_sem_wait( &sem );
+    }
+    vlc_tick_t input_elapsed = vlc_tick_now() - start;
+
+    /* All the thumbnails from the synchronous engine */
+    struct storyboard_ctx ctx = { .count = 0 };
+    vlc_sem_init( &ctx.sem, 0 );
+    static const struct vlc_thumbnailer_storyboard_cbs cbs = {
+        .on_ended = storyboard_callback,
+    };
+
+    start = vlc_tick_now();
+    vlc_preparser_req_id id =
+        vlc_preparser_GenerateThumbnails( p_thumbnailer, p_item, seek_args,
+                                          STORYBOARD_COUNT, &cbs, &ctx );
+    assert( id != VLC_PREPARSER_REQ_ID_INVALID );
+    vlc_sem_wait( &ctx.sem );
+    vlc_tick_t storyboard_elapsed = vlc_tick_now() - start;
+    assert( ctx.count == STORYBOARD_COUNT );
+
+    printf( "%d thumbnails: %.1f thumbnails/s with input threads, "
+            "%.1f thumbnails/s with the keyframe engine\n", STORYBOARD_COUNT,
+            STORYBOARD_COUNT / secf_from_vlc_tick( __MAX(input_elapsed, 1) ),
+            STORYBOARD_COUNT / secf_from_vlc_tick( __MAX(storyboard_elapsed, 1) ) );
+
+    input_item_Release( p_item );
+    free( psz_mrl );
+
+    vlc_preparser_Delete( p_thumbnailer );
+}
+
 int main( void )
 {
     test_init();
@@ -244,6 +350,7 @@ int main( void )
 
     test_thumbnails( vlc );
     test_cancel_thumbnail( vlc );
+    test_storyboard( vlc );
 
     libvlc_release( vlc );
 }